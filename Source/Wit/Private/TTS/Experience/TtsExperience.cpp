@@ -91,6 +91,17 @@ void ATtsExperience::ConvertTextToSpeechWithSettings(const FTtsConfiguration& Cl
 	}
 }
 
+/**
+ * Cancel any synthesis in progress and discard any queued text
+ */
+void ATtsExperience::StopSynthesis()
+{
+	if (TtsService != nullptr)
+	{
+		TtsService->StopSynthesis();
+	}
+}
+
 /**
  * Fetch a list of available voices from Wit
  */
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/ScopeLock.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Constructor. The block storage is allocated once at its full capacity
+ *
+ * @param OwningPool [in] the pool the block belongs to
+ * @param Capacity [in] the size of the block in bytes
+ */
+FVoiceAudioBlock::FVoiceAudioBlock(const TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe>& OwningPool, const int32 Capacity)
+	: Pool(OwningPool)
+{
+	Data.SetNumUninitialized(Capacity);
+}
+
+/**
+ * Add a reference to the block
+ *
+ * @return the new reference count
+ */
+uint32 FVoiceAudioBlock::AddRef() const
+{
+	return static_cast<uint32>(RefCount.Increment());
+}
+
+/**
+ * Release a reference to the block. When the last reference is released the block goes back to its pool, or is deleted
+ * if the pool no longer exists
+ *
+ * @return the new reference count
+ */
+uint32 FVoiceAudioBlock::Release() const
+{
+	const int32 NewRefCount = RefCount.Decrement();
+
+	if (NewRefCount == 0)
+	{
+		FVoiceAudioBlock* MutableThis = const_cast<FVoiceAudioBlock*>(this);
+		const TSharedPtr<FVoiceAudioBlockPool, ESPMode::ThreadSafe> OwningPool = Pool.Pin();
+
+		if (OwningPool.IsValid())
+		{
+			OwningPool->Recycle(MutableThis);
+		}
+		else
+		{
+			delete MutableThis;
+		}
+	}
+
+	return static_cast<uint32>(NewRefCount);
+}
+
+/**
+ * Get the current reference count
+ *
+ * @return the reference count
+ */
+uint32 FVoiceAudioBlock::GetRefCount() const
+{
+	return static_cast<uint32>(RefCount.GetValue());
+}
+
+/**
+ * Get write access to the block data
+ *
+ * @return pointer to the start of the block data
+ */
+uint8* FVoiceAudioBlock::GetData()
+{
+	return Data.GetData();
+}
+
+/**
+ * Get read access to the block data
+ *
+ * @return pointer to the start of the block data
+ */
+const uint8* FVoiceAudioBlock::GetData() const
+{
+	return Data.GetData();
+}
+
+/**
+ * Get the number of valid bytes in the block
+ *
+ * @return the number of bytes
+ */
+int32 FVoiceAudioBlock::Num() const
+{
+	return NumBytes;
+}
+
+/**
+ * Set the number of valid bytes in the block
+ *
+ * @param NewNum [in] the number of bytes
+ */
+void FVoiceAudioBlock::SetNum(const int32 NewNum)
+{
+	NumBytes = FMath::Clamp(NewNum, 0, Data.Num());
+}
+
+/**
+ * Get the maximum number of bytes the block can hold
+ *
+ * @return the capacity in bytes
+ */
+int32 FVoiceAudioBlock::GetCapacity() const
+{
+	return Data.Num();
+}
+
+/**
+ * Construct a span covering the whole of a block
+ *
+ * @param InBlock [in] the block
+ */
+FVoiceAudioSpan::FVoiceAudioSpan(const FVoiceAudioBlockRef& InBlock)
+	: Block(InBlock)
+	, Offset(0)
+	, NumBytes(InBlock.IsValid() ? InBlock->Num() : 0)
+{
+	// Deliberately empty
+}
+
+/**
+ * Construct a span covering part of a block
+ *
+ * @param InBlock [in] the block
+ * @param InOffset [in] the offset in bytes of the span within the block
+ * @param InNumBytes [in] the number of bytes in the span
+ */
+FVoiceAudioSpan::FVoiceAudioSpan(const FVoiceAudioBlockRef& InBlock, const int32 InOffset, const int32 InNumBytes)
+	: Block(InBlock)
+	, Offset(InOffset)
+	, NumBytes(InNumBytes)
+{
+	check(!InBlock.IsValid() || InOffset + InNumBytes <= InBlock->Num());
+}
+
+/**
+ * Does the span contain any data?
+ *
+ * @return true if empty
+ */
+bool FVoiceAudioSpan::IsEmpty() const
+{
+	return !Block.IsValid() || NumBytes <= 0;
+}
+
+/**
+ * Get the number of bytes in the span
+ *
+ * @return the number of bytes
+ */
+int32 FVoiceAudioSpan::Num() const
+{
+	return IsEmpty() ? 0 : NumBytes;
+}
+
+/**
+ * Get read access to the span data
+ *
+ * @return pointer to the start of the span or nullptr if empty
+ */
+const uint8* FVoiceAudioSpan::GetData() const
+{
+	return IsEmpty() ? nullptr : Block->GetData() + Offset;
+}
+
+/**
+ * Get the span as an array view
+ *
+ * @return the view
+ */
+TArrayView<const uint8> FVoiceAudioSpan::GetView() const
+{
+	return TArrayView<const uint8>(GetData(), Num());
+}
+
+/**
+ * Constructor
+ *
+ * @param InBlockSize [in] the size in bytes of each block
+ */
+FVoiceAudioBlockPool::FVoiceAudioBlockPool(const int32 InBlockSize)
+	: BlockSize(InBlockSize)
+{
+	// Deliberately empty
+}
+
+/**
+ * Destructor. Only free blocks are deleted here. Blocks that are still referenced delete themselves when released
+ */
+FVoiceAudioBlockPool::~FVoiceAudioBlockPool()
+{
+	for (const FVoiceAudioBlock* FreeBlock : FreeBlocks)
+	{
+		delete FreeBlock;
+	}
+
+	FreeBlocks.Reset();
+}
+
+/**
+ * Acquire an empty block from the pool
+ *
+ * @return the block
+ */
+FVoiceAudioBlockRef FVoiceAudioBlockPool::Acquire()
+{
+	FVoiceAudioBlock* Block = nullptr;
+
+	{
+		FScopeLock Lock(&FreeBlocksCriticalSection);
+
+		if (FreeBlocks.Num() > 0)
+		{
+#if UE_VERSION_OLDER_THAN(5,4,0)
+			Block = FreeBlocks.Pop(false);
+#else
+			Block = FreeBlocks.Pop(EAllowShrinking::No);
+#endif
+		}
+	}
+
+	if (Block == nullptr)
+	{
+		Block = new FVoiceAudioBlock(AsShared(), BlockSize);
+
+		const int32 NumBlocks = NumAllocatedBlocks.Increment();
+
+		UE_LOG(LogWit, VeryVerbose, TEXT("VoiceAudioBlockPool - Acquire: grew pool to (%d) blocks of (%d) bytes"), NumBlocks, BlockSize);
+	}
+
+	Block->SetNum(0);
+
+	return FVoiceAudioBlockRef(Block);
+}
+
+/**
+ * Acquire a block from the pool and fill it with a copy of the given data
+ *
+ * @param Data [in] the data to copy. This must not be larger than the block size
+ * @return the block
+ */
+FVoiceAudioBlockRef FVoiceAudioBlockPool::Acquire(TArrayView<const uint8> Data)
+{
+	check(Data.Num() <= BlockSize);
+
+	FVoiceAudioBlockRef Block = Acquire();
+
+	FMemory::Memcpy(Block->GetData(), Data.GetData(), Data.Num());
+	Block->SetNum(Data.Num());
+
+	return Block;
+}
+
+/**
+ * Pre-allocate free blocks so that the pool does not need to grow later
+ *
+ * @param NumBlocks [in] the number of free blocks to ensure are available
+ */
+void FVoiceAudioBlockPool::Reserve(const int32 NumBlocks)
+{
+	FScopeLock Lock(&FreeBlocksCriticalSection);
+
+	while (FreeBlocks.Num() < NumBlocks)
+	{
+		FreeBlocks.Add(new FVoiceAudioBlock(AsShared(), BlockSize));
+		NumAllocatedBlocks.Increment();
+	}
+}
+
+/**
+ * Get the size in bytes of the blocks in this pool
+ *
+ * @return the size in bytes
+ */
+int32 FVoiceAudioBlockPool::GetBlockSize() const
+{
+	return BlockSize;
+}
+
+/**
+ * Get the number of blocks the pool has ever allocated
+ *
+ * @return the number of blocks
+ */
+int32 FVoiceAudioBlockPool::GetNumAllocatedBlocks() const
+{
+	return NumAllocatedBlocks.GetValue();
+}
+
+/**
+ * Return an unreferenced block to the free list
+ *
+ * @param Block [in] the block to return
+ */
+void FVoiceAudioBlockPool::Recycle(FVoiceAudioBlock* Block)
+{
+	FScopeLock Lock(&FreeBlocksCriticalSection);
+
+	FreeBlocks.Add(Block);
+}
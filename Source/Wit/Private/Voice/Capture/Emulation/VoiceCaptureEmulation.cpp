@@ -35,6 +35,9 @@ FVoiceCaptureEmulation::~FVoiceCaptureEmulation()
  */
 bool FVoiceCaptureEmulation::Init(const FString& DeviceName, int32 SampleRate, int32 NumChannels)
 {
+	Stream.SetFormat(SampleRate, NumChannels);
+	LoadedSoundWave = nullptr;
+
 	return true;
 }
 
@@ -51,74 +54,111 @@ void FVoiceCaptureEmulation::Shutdown()
  */
 bool FVoiceCaptureEmulation::Start()
 {
+	const bool bIsSoundWaveLoaded = SoundWave != nullptr && SoundWave == LoadedSoundWave;
+
+	if (!bIsSoundWaveLoaded)
+	{
+		if (SoundWave != nullptr)
+		{
+			if (!LoadSoundWave())
+			{
+				return false;
+			}
+		}
+		else
+		{
+			UE_LOG(LogWit, Verbose, TEXT("FVoiceCaptureEmulation: starting with no soundwave"));
+
+			Stream.SetSourceToSilence(OutputSoundDuration);
+		}
+
+		LoadedSoundWave = SoundWave;
+	}
+
 	bIsCapturing = true;
 	bIsProducingSound = true;
-	ProduceSoundTimer = 0.0f;
 
-	if (SoundWave != nullptr)
+	Stream.Start();
+
+	return true;
+}
+
+/**
+ * Convert the sound wave into the stream's source audio. In the editor the sound wave still has its original wav data
+ * otherwise we have to decompress it
+ *
+ * @return true if successful
+ */
+bool FVoiceCaptureEmulation::LoadSoundWave()
+{
+	int64 SoundWaveElementSize = 0;
+	
+#if UE_VERSION_OLDER_THAN(5,1,0)
+	SoundWaveElementSize = SoundWave->RawData.GetElementCount();
+#elif WITH_EDITORONLY_DATA
+	SoundWaveElementSize = SoundWave->RawData.GetPayloadSize();
+#endif
+	
+	UE_LOG(LogWit, Verbose, TEXT("FVoiceCaptureEmulation: starting with soundwave with duration (%f), element count (%llu), RawPCMDataSize (%lu), bDecompressedFromOgg (%s)"),
+		SoundWave->GetDuration(), SoundWaveElementSize, SoundWave->RawPCMDataSize, SoundWave->bDecompressedFromOgg? TEXT("yes"):TEXT("no"));
+
+	if (SoundWaveElementSize > 0)
 	{
-		int64 SoundWaveElementSize = 0;
-		
 #if UE_VERSION_OLDER_THAN(5,1,0)
-		SoundWaveElementSize = SoundWave->RawData.GetElementCount();
+		const uint8* SoundData = static_cast<const uint8*>(SoundWave->RawData.LockReadOnly());
+		Stream.SetSourceFromWav(SoundData, SoundWaveElementSize);
+		SoundWave->RawData.Unlock();
 #elif WITH_EDITORONLY_DATA
-		SoundWaveElementSize = SoundWave->RawData.GetPayloadSize();
+		const FSharedBuffer SoundData = SoundWave->RawData.GetPayload().Get();
+		Stream.SetSourceFromWav(static_cast<const uint8*>(SoundData.GetData()), SoundData.GetSize());
 #endif
-		
-		UE_LOG(LogWit, Verbose, TEXT("FVoiceCaptureEmulation: starting with soundwave with duration (%f), element count (%llu), RawPCMDataSize (%lu), bDecompressedFromOgg (%s)"),
-			SoundWave->GetDuration(), SoundWaveElementSize, SoundWave->RawPCMDataSize, SoundWave->bDecompressedFromOgg? TEXT("yes"):TEXT("no"));
+		return true;
+	}
 
-        if (SoundWaveElementSize == 0)
-        {
-			bHasPreviewSampleData = false;
-			
-			FAudioDevice* AudioDevice = GEngine ? GEngine->GetMainAudioDeviceRaw() : nullptr;
+	FAudioDevice* AudioDevice = GEngine ? GEngine->GetMainAudioDeviceRaw() : nullptr;
 
-			if (AudioDevice == nullptr)
-			{
-				return false;
-			}
+	if (AudioDevice == nullptr)
+	{
+		return false;
+	}
 
-			if (SoundWave == nullptr)
-			{
-				return false;
-			}
+	if (SoundWave->GetName() == TEXT("None"))
+	{
+		return false;
+	}
 
-			if (SoundWave->GetName() == TEXT("None"))
-			{
-				return false;
-			}
 #if UE_VERSION_OLDER_THAN(5, 3, 0)
-			SoundWave->InitAudioResource(AudioDevice->GetRuntimeFormat(SoundWave));
-			ICompressedAudioInfo* CompressedAudioInfo = AudioDevice->CreateCompressedAudioInfo(SoundWave);
+	SoundWave->InitAudioResource(AudioDevice->GetRuntimeFormat(SoundWave));
+	ICompressedAudioInfo* CompressedAudioInfo = AudioDevice->CreateCompressedAudioInfo(SoundWave);
 #else
-			SoundWave->InitAudioResource(SoundWave->GetRuntimeFormat());
-			ICompressedAudioInfo* CompressedAudioInfo = IAudioInfoFactoryRegistry::Get().Create(SoundWave->GetRuntimeFormat());
+	SoundWave->InitAudioResource(SoundWave->GetRuntimeFormat());
+	ICompressedAudioInfo* CompressedAudioInfo = IAudioInfoFactoryRegistry::Get().Create(SoundWave->GetRuntimeFormat());
 #endif
-			FSoundQualityInfo SoundQualityInfo = { 0 };
+
+	if (CompressedAudioInfo == nullptr)
+	{
+		return false;
+	}
+
+	FSoundQualityInfo SoundQualityInfo = { 0 };
 
 #if UE_VERSION_OLDER_THAN(5,0,0)
-			if (CompressedAudioInfo->ReadCompressedInfo(SoundWave->ResourceData, SoundWave->ResourceSize, &SoundQualityInfo))
+	if (CompressedAudioInfo->ReadCompressedInfo(SoundWave->ResourceData, SoundWave->ResourceSize, &SoundQualityInfo))
 #else
-        	if (CompressedAudioInfo->ReadCompressedInfo(SoundWave->GetResourceData(), SoundWave->GetResourceSize(), &SoundQualityInfo))
+	if (CompressedAudioInfo->ReadCompressedInfo(SoundWave->GetResourceData(), SoundWave->GetResourceSize(), &SoundQualityInfo))
 #endif
-			{
-				DecompressedRawPCMDataSize = SoundQualityInfo.SampleDataSize;
-				DecompressedRawPCMData.SetNumZeroed(DecompressedRawPCMDataSize);
-				CompressedAudioInfo->ExpandFile(DecompressedRawPCMData.GetData(), &SoundQualityInfo);
-			}
-        	
-			delete CompressedAudioInfo;
-        }
-		ProduceSoundDuration = SoundWave->Duration;
-	}
-	else
 	{
-		UE_LOG(LogWit, Verbose, TEXT("FVoiceCaptureEmulation: starting with no soundwave"));
-		
-		ProduceSoundDuration = OutputSoundDuration;
+		TArray<uint8> DecompressedRawPCMData;
+
+		DecompressedRawPCMData.SetNumZeroed(SoundQualityInfo.SampleDataSize);
+		CompressedAudioInfo->ExpandFile(DecompressedRawPCMData.GetData(), &SoundQualityInfo);
+
+		Stream.SetSource(reinterpret_cast<const int16*>(DecompressedRawPCMData.GetData()), DecompressedRawPCMData.Num() / sizeof(int16),
+			SoundQualityInfo.SampleRate, SoundQualityInfo.NumChannels);
 	}
 	
+	delete CompressedAudioInfo;
+
 	return true;
 }
 
@@ -151,20 +191,20 @@ bool FVoiceCaptureEmulation::IsCapturing()
  */
 EVoiceCaptureState::Type FVoiceCaptureEmulation::GetCaptureState(uint32& OutAvailableVoiceData) const
 {
-	OutAvailableVoiceData = UncompressedAudioBuffer.Num();
+	OutAvailableVoiceData = 0;
 	
 	if (!bIsCapturing)
 	{
-		OutAvailableVoiceData = 0;
 		return EVoiceCaptureState::NotCapturing;
 	}
 
 	if (!bIsProducingSound)
 	{
-		OutAvailableVoiceData = 0;
 		return EVoiceCaptureState::NoData;
 	}
 
+	OutAvailableVoiceData = Stream.GetNumAvailableBytes();
+
 	return EVoiceCaptureState::Ok;
 }
 
@@ -178,28 +218,28 @@ EVoiceCaptureState::Type FVoiceCaptureEmulation::GetVoiceData(uint8* OutVoiceBuf
 }
 
 /**
- * Get the latest available voice data
+ * Get the latest available voice data. If there is more available than fits in the buffer then the remainder is kept
+ * for the next call rather than being dropped
  */
 EVoiceCaptureState::Type FVoiceCaptureEmulation::GetVoiceData(uint8* OutVoiceBuffer, uint32 InVoiceBufferSize, uint32& OutAvailableVoiceData, uint64& OutSampleCounter)
 {
-	EVoiceCaptureState::Type CaptureState = GetCaptureState(OutAvailableVoiceData);
+	const EVoiceCaptureState::Type CaptureState = GetCaptureState(OutAvailableVoiceData);
 
 	OutAvailableVoiceData = 0;
-	OutSampleCounter = 0;
+	OutSampleCounter = Stream.GetNumFramesRead();
 	
-	if (CaptureState == EVoiceCaptureState::Ok)
+	if (CaptureState != EVoiceCaptureState::Ok)
 	{
-		if (InVoiceBufferSize >= static_cast<uint32>(UncompressedAudioBuffer.Num()))
-		{
-			OutAvailableVoiceData = UncompressedAudioBuffer.Num();
-			
-			FMemory::Memcpy(OutVoiceBuffer, UncompressedAudioBuffer.GetData(), OutAvailableVoiceData);
-			UncompressedAudioBuffer.Reset();
-		}
-		else
-		{
-			CaptureState = EVoiceCaptureState::BufferTooSmall;
-		}
+		return CaptureState;
+	}
+
+	OutAvailableVoiceData = Stream.Read(OutVoiceBuffer, InVoiceBufferSize);
+
+	// This gets set after the read so that we don't chop off some of the final data
+
+	if (Stream.IsFinished())
+	{
+		bIsProducingSound = false;
 	}
 	
 	return CaptureState;
@@ -210,7 +250,7 @@ EVoiceCaptureState::Type FVoiceCaptureEmulation::GetVoiceData(uint8* OutVoiceBuf
  */
 int32 FVoiceCaptureEmulation::GetBufferSize() const
 {
-	return 2048;
+	return Stream.GetBufferSize();
 }
 
 /**
@@ -239,98 +279,9 @@ float FVoiceCaptureEmulation::GetCurrentAmplitude() const
  */
 bool FVoiceCaptureEmulation::Tick(float DeltaTime)
 {
-	const float LastProduceSoundTimer = ProduceSoundTimer;
-	
 	if (bIsCapturing && bIsProducingSound)
 	{
-		ProduceSoundTimer += DeltaTime;
-
-		if (ProduceSoundTimer >= ProduceSoundDuration)
-		{
-			ProduceSoundTimer = ProduceSoundDuration;
-		}
-	}
-
-	if (!bIsProducingSound)
-	{
-		UncompressedAudioBuffer.Reset();
-		
-		return true;
-	}
-	
-	if (SoundWave != nullptr)
-	{
-#if UE_VERSION_OLDER_THAN(5,1,0)
-		uint64 ElementCount = SoundWave->RawData.GetElementCount();
-#elif WITH_EDITORONLY_DATA
-		uint64 ElementCount = SoundWave->RawData.GetPayloadSize();
-#else
-		uint64 ElementCount = SoundWave->RawPCMDataSize;
-#endif
-		
-		if (!bHasPreviewSampleData)
-		{
-			ElementCount = DecompressedRawPCMDataSize;
-		}
-		// Use the sound wave samples to generate capture data
-		
-		const uint64 LastSampleOffset = LastProduceSoundTimer / SoundWave->GetDuration() * static_cast<float>(ElementCount) / sizeof(int16);
-		const uint64 SampleOffset = ProduceSoundTimer / SoundWave->GetDuration() * static_cast<float>(ElementCount) / sizeof(int16);
-
-		uint64 LastDataIndex = LastSampleOffset * sizeof(int16);
-
-		if (LastDataIndex > ElementCount)
-		{
-			LastDataIndex = ElementCount;
-		}
-		
-		uint64 DataIndex = SampleOffset * sizeof(int16);
-
-		if (DataIndex > ElementCount)
-		{
-			DataIndex = ElementCount;
-		}
-		
-		const uint64 DataSizeToCopy = DataIndex - LastDataIndex;
-		const bool bIsAnyDataToCopy = DataSizeToCopy > 0;
-		
-		UncompressedAudioBuffer.Reset(DataSizeToCopy);
-
-		if (bIsAnyDataToCopy)
-		{
-			UncompressedAudioBuffer.AddUninitialized(DataSizeToCopy);
-			if (bHasPreviewSampleData)// on editor
-			{
-#if UE_VERSION_OLDER_THAN(5,1,0)
-				const uint8* SoundData = static_cast<const uint8*>(SoundWave->RawData.LockReadOnly());
-				FMemory::Memcpy(UncompressedAudioBuffer.GetData(), &SoundData[LastDataIndex], DataSizeToCopy);
-				SoundWave->RawData.Unlock();
-#elif WITH_EDITORONLY_DATA
-				const uint8* SoundData = static_cast<const uint8*>(SoundWave->RawData.GetPayload().Get().GetData());
-				FMemory::Memcpy(UncompressedAudioBuffer.GetData(), &SoundData[LastDataIndex], DataSizeToCopy);
-#endif
-			}
-			else
-			{
-				FMemory::Memcpy(UncompressedAudioBuffer.GetData(), &DecompressedRawPCMData[LastDataIndex], DataSizeToCopy);
-			}
-		}
-	}
-	else
-	{
-		// Generate N seconds of sound and then silence
-
-		for (auto i = 0; i < OutputSamplesPerFrame; ++i)
-		{
-			UncompressedAudioBuffer.Add(0xff);
-		}
-	}
-
-	// This gets set after the data copy so that we don't chop off some of the final data
-	
-	if (ProduceSoundTimer >= ProduceSoundDuration)
-	{
-		bIsProducingSound = false;
+		Stream.Advance(DeltaTime);
 	}
 	
 	return true;
@@ -343,3 +294,11 @@ void FVoiceCaptureEmulation::SetSoundWave(USoundWave* SoundWaveToUse)
 {
 	SoundWave = SoundWaveToUse;
 }
+
+/**
+ * Set the playback speed relative to realtime
+ */
+void FVoiceCaptureEmulation::SetSpeed(const float SpeedToUse)
+{
+	Stream.SetSpeed(SpeedToUse);
+}
@@ -12,9 +12,11 @@
 #include "Interfaces/VoiceCapture.h"
 #include "Misc/EngineVersionComparison.h"
 #include "Sound/SoundWave.h"
+#include "VoiceCaptureEmulationStream.h"
 
 /**
- * Null implementation of voice capture. This just returns 1 second of known input to hit the wake volume and then silence after
+ * Null implementation of voice capture. This plays back the given sound wave, or 1 second of silence if there is none, while
+ * reporting full volume so that the wake threshold is hit. Playback is sample accurate and can run faster than realtime
  */
 #if UE_VERSION_OLDER_THAN(5,0,0)
 class FVoiceCaptureEmulation final : public IVoiceCapture, public FTickerObjectBase
@@ -51,12 +53,15 @@ public:
 	/** Set the sound wave to use */
 	void SetSoundWave(USoundWave* SoundWaveToUse);
 
+	/** Set the playback speed relative to realtime. FVoiceCaptureEmulationStream::UnthrottledSpeed plays as fast as the capture is read */
+	void SetSpeed(const float SpeedToUse);
+
 private:
 
-	/** The number of samples we will output per frame*/
-	static constexpr int OutputSamplesPerFrame{4};
-	
-	/** The duration we will output sound for */
+	/** Convert the sound wave into the stream's source audio */
+	bool LoadSoundWave();
+
+	/** The duration we will output sound for when there is no sound wave */
 	static constexpr float OutputSoundDuration{1.0f};
 
 	/** Are we currently capturing? */
@@ -65,24 +70,12 @@ private:
 	/** Are we currently outputting sound? */
 	bool bIsProducingSound{false};
 
-	/** How long have we been producing sound for */
-	float ProduceSoundTimer{0.0f};
-
-	/** How long we should produce sound for */
-	float ProduceSoundDuration{OutputSoundDuration};
-
 	/** Sound wave to propagate to the voice capture */
 	USoundWave* SoundWave{};
 
-	/** Uncompressed audio buffer */
-	TArray<uint8> UncompressedAudioBuffer{};
-  
-    /** Whether the SoundWave has PreviewSampleData. SoundWave will have no PreviewSampleData(RawData) in packaged builds. For example running on Oculus */
-    bool bHasPreviewSampleData{true};
-  
-    /** When bHasPreviewSampleData is false, the SoundWave is compressed, the RawData is null. In this case we will decompress it. DecompressedRawPCMData is for holding the decompressed data */
-    TArray<uint8> DecompressedRawPCMData{};
-
-	/** Holds the size of DecompressedRawPCMData. */
-	uint32 DecompressedRawPCMDataSize{0};
+	/** The sound wave that the stream's source audio was last loaded from. Avoids converting it again on every start */
+	const USoundWave* LoadedSoundWave{};
+
+	/** The emulated audio */
+	FVoiceCaptureEmulationStream Stream{};
 };
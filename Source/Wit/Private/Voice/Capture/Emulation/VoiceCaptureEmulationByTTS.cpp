@@ -34,6 +34,8 @@ FVoiceCaptureEmulationByTts::~FVoiceCaptureEmulationByTts()
  */
 bool FVoiceCaptureEmulationByTts::Init(const FString& DeviceName, int32 SampleRate, int32 NumChannels)
 {
+	Stream.SetFormat(SampleRate, NumChannels);
+
 	return true;
 }
 
@@ -45,21 +47,20 @@ void FVoiceCaptureEmulationByTts::Shutdown()
 	Stop();
 }
 
+/**
+ * Called when the TTS experience has synthesized a response. The response is converted to the capture format and played
+ * back from the start
+ */
 void FVoiceCaptureEmulationByTts::OnSynthesizeRawResponse(const TArray<uint8>& BinaryData)
 {
-	const USoundWave* SoundWave = FWitHelperUtilities::CreateSoundWaveFromRawData(BinaryData.GetData(), BinaryData.Num(), EWitRequestAudioFormat::Wav, false);
-
-	if (SoundWave == nullptr)
+	if (BinaryData.Num() == 0)
 	{
 		UE_LOG(LogWit, Warning, TEXT("FVoiceCaptureEmulationByTts: starting with no soundwave"));
-		ProduceSoundDuration = OutputSoundDuration;
 		return;
 	}
-	ProduceSoundDuration = SoundWave->Duration;
-	
-	DecompressedRawPCMDataSize = BinaryData.Num();
-	DecompressedRawPCMData.SetNumZeroed(DecompressedRawPCMDataSize);
-	FMemory::Memcpy(DecompressedRawPCMData.GetData(), BinaryData.GetData(), DecompressedRawPCMDataSize);
+
+	Stream.SetSourceFromWav(BinaryData.GetData(), BinaryData.Num());
+	Stream.Start();
 	
 	bIsProducingSound = true;
 }
@@ -70,7 +71,8 @@ void FVoiceCaptureEmulationByTts::OnSynthesizeRawResponse(const TArray<uint8>& B
 bool FVoiceCaptureEmulationByTts::Start()
 {
 	bIsCapturing = true;
-	ProduceSoundTimer = 0.0f;
+
+	Stream.Start();
 	
 	const FWorldContext* World = GEngine->GetWorldContextFromGameViewport(GEngine->GameViewport);
 	const ATtsExperience* TtsExperience = FWitHelperUtilities::FindTtsExperience(World->World(), TtsExperienceTag);
@@ -116,20 +118,20 @@ bool FVoiceCaptureEmulationByTts::IsCapturing()
  */
 EVoiceCaptureState::Type FVoiceCaptureEmulationByTts::GetCaptureState(uint32& OutAvailableVoiceData) const
 {
-	OutAvailableVoiceData = UncompressedAudioBuffer.Num();
+	OutAvailableVoiceData = 0;
 	
 	if (!bIsCapturing)
 	{
-		OutAvailableVoiceData = 0;
 		return EVoiceCaptureState::NotCapturing;
 	}
 
 	if (!bIsProducingSound)
 	{
-		OutAvailableVoiceData = 0;
 		return EVoiceCaptureState::NoData;
 	}
 
+	OutAvailableVoiceData = Stream.GetNumAvailableBytes();
+
 	return EVoiceCaptureState::Ok;
 }
 
@@ -143,28 +145,28 @@ EVoiceCaptureState::Type FVoiceCaptureEmulationByTts::GetVoiceData(uint8* OutVoi
 }
 
 /**
- * Get the latest available voice data
+ * Get the latest available voice data. If there is more available than fits in the buffer then the remainder is kept
+ * for the next call rather than being dropped
  */
 EVoiceCaptureState::Type FVoiceCaptureEmulationByTts::GetVoiceData(uint8* OutVoiceBuffer, uint32 InVoiceBufferSize, uint32& OutAvailableVoiceData, uint64& OutSampleCounter)
 {
-	EVoiceCaptureState::Type CaptureState = GetCaptureState(OutAvailableVoiceData);
+	const EVoiceCaptureState::Type CaptureState = GetCaptureState(OutAvailableVoiceData);
 
 	OutAvailableVoiceData = 0;
-	OutSampleCounter = 0;
+	OutSampleCounter = Stream.GetNumFramesRead();
 	
-	if (CaptureState == EVoiceCaptureState::Ok)
+	if (CaptureState != EVoiceCaptureState::Ok)
 	{
-		if (InVoiceBufferSize >= static_cast<uint32>(UncompressedAudioBuffer.Num()))
-		{
-			OutAvailableVoiceData = UncompressedAudioBuffer.Num();
-			
-			FMemory::Memcpy(OutVoiceBuffer, UncompressedAudioBuffer.GetData(), OutAvailableVoiceData);
-			UncompressedAudioBuffer.Reset();
-		}
-		else
-		{
-			CaptureState = EVoiceCaptureState::BufferTooSmall;
-		}
+		return CaptureState;
+	}
+
+	OutAvailableVoiceData = Stream.Read(OutVoiceBuffer, InVoiceBufferSize);
+
+	// This gets set after the read so that we don't chop off some of the final data
+
+	if (Stream.IsFinished())
+	{
+		bIsProducingSound = false;
 	}
 	
 	return CaptureState;
@@ -175,7 +177,7 @@ EVoiceCaptureState::Type FVoiceCaptureEmulationByTts::GetVoiceData(uint8* OutVoi
  */
 int32 FVoiceCaptureEmulationByTts::GetBufferSize() const
 {
-	return 2048;
+	return Stream.GetBufferSize();
 }
 
 /**
@@ -204,73 +206,9 @@ float FVoiceCaptureEmulationByTts::GetCurrentAmplitude() const
  */
 bool FVoiceCaptureEmulationByTts::Tick(float DeltaTime)
 {
-	const float LastProduceSoundTimer = ProduceSoundTimer;
-	
 	if (bIsCapturing && bIsProducingSound)
 	{
-		ProduceSoundTimer += DeltaTime;
-
-		if (ProduceSoundTimer >= ProduceSoundDuration)
-		{
-			ProduceSoundTimer = ProduceSoundDuration;
-		}
-	}
-
-	if (!bIsProducingSound)
-	{
-		UncompressedAudioBuffer.Reset();
-		
-		return true;
-	}
-	
-	if (ProduceSoundDuration > 0)
-	{
-		const uint64 ElementCount = DecompressedRawPCMDataSize;
-		// Use the sound wave samples to generate capture data
-		
-		const uint64 LastSampleOffset = LastProduceSoundTimer / ProduceSoundDuration * static_cast<float>(ElementCount) / sizeof(int16);
-		const uint64 SampleOffset = ProduceSoundTimer / ProduceSoundDuration * static_cast<float>(ElementCount) / sizeof(int16);
-
-		uint64 LastDataIndex = LastSampleOffset * sizeof(int16);
-
-		if (LastDataIndex > ElementCount)
-		{
-			LastDataIndex = ElementCount;
-		}
-		
-		uint64 DataIndex = SampleOffset * sizeof(int16);
-
-		if (DataIndex > ElementCount)
-		{
-			DataIndex = ElementCount;
-		}
-		
-		const uint64 DataSizeToCopy = DataIndex - LastDataIndex;
-		const bool bIsAnyDataToCopy = DataSizeToCopy > 0;
-		
-		UncompressedAudioBuffer.Reset(DataSizeToCopy);
-
-		if (bIsAnyDataToCopy)
-		{
-			UncompressedAudioBuffer.AddUninitialized(DataSizeToCopy);
-			FMemory::Memcpy(UncompressedAudioBuffer.GetData(), &DecompressedRawPCMData[LastDataIndex], DataSizeToCopy);
-		}
-	}
-	else
-	{
-		// Generate N seconds of sound and then silence
-
-		for (auto i = 0; i < OutputSamplesPerFrame; ++i)
-		{
-			UncompressedAudioBuffer.Add(0xff);
-		}
-	}
-
-	// This gets set after the data copy so that we don't chop off some of the final data
-	
-	if (ProduceSoundTimer >= ProduceSoundDuration)
-	{
-		bIsProducingSound = false;
+		Stream.Advance(DeltaTime);
 	}
 	
 	return true;
@@ -284,3 +222,10 @@ void FVoiceCaptureEmulationByTts::SetTtsExperienceTag(const FName& TtsExperience
 	TtsExperienceTag = TtsExperienceTagToUse;
 }
 
+/**
+ * Set the playback speed relative to realtime
+ */
+void FVoiceCaptureEmulationByTts::SetSpeed(const float SpeedToUse)
+{
+	Stream.SetSpeed(SpeedToUse);
+}
@@ -11,6 +11,7 @@
 #include "Containers/Ticker.h"
 #include "Interfaces/VoiceCapture.h"
 #include "Misc/EngineVersionComparison.h"
+#include "VoiceCaptureEmulationStream.h"
 #include "Wit/TTS/WitTtsSpeaker.h"
 
 /**
@@ -52,6 +53,9 @@ public:
 
 	/** Set the TTS Speaker's tag to generate sound wave to use */
 	void SetTtsExperienceTag(const FName& TtsExperienceTag);
+
+	/** Set the playback speed relative to realtime. FVoiceCaptureEmulationStream::UnthrottledSpeed plays as fast as the capture is read */
+	void SetSpeed(const float SpeedToUse);
 	
 protected:
 	
@@ -61,12 +65,6 @@ protected:
 
 private:
 
-	/** The number of samples we will output per frame*/
-	static constexpr int OutputSamplesPerFrame{4};
-	
-	/** The duration we will output sound for */
-	static constexpr float OutputSoundDuration{1.0f};
-
 	/** Are we currently capturing? */
 	bool bIsCapturing{false};
 
@@ -77,21 +75,9 @@ private:
 	bool bIsRawSoundWaveReady{false};
 	bool bIsSoundWaveReady{false};
 
-	/** How long have we been producing sound for */
-	float ProduceSoundTimer{0.0f};
-
-	/** How long we should produce sound for */
-	float ProduceSoundDuration{OutputSoundDuration};
-
 	/** TTS Speaker to generate sound wave to propagate to the voice capture */
 	FName TtsExperienceTag{};
 
-	/** Uncompressed audio buffer */
-	TArray<uint8> UncompressedAudioBuffer{};
-  
-    /** When bHasPreviewSampleData is false, the SoundWave is compressed, the RawData is null. In this case we will decompress it. DecompressedRawPCMData is for holding the decompressed data */
-    TArray<uint8> DecompressedRawPCMData{};
-
-	/** Holds the size of DecompressedRawPCMData. */
-	uint32 DecompressedRawPCMDataSize{0};
+	/** The emulated audio */
+	FVoiceCaptureEmulationStream Stream{};
 };
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "VoiceCaptureEmulationStream.h"
+#include "Audio.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Set the format that the capture outputs
+ *
+ * @param InSampleRate [in] the output sample rate
+ * @param InNumChannels [in] the output number of channels
+ */
+void FVoiceCaptureEmulationStream::SetFormat(const int32 InSampleRate, const int32 InNumChannels)
+{
+	SampleRate = FMath::Max(InSampleRate, 1);
+	NumChannels = FMath::Max(InNumChannels, 1);
+}
+
+/**
+ * Set the playback speed relative to realtime
+ *
+ * @param InSpeed [in] the speed multiplier or UnthrottledSpeed to play as fast as the capture is read
+ */
+void FVoiceCaptureEmulationStream::SetSpeed(const float InSpeed)
+{
+	Speed = FMath::Max(InSpeed, UnthrottledSpeed);
+}
+
+/**
+ * Set the source audio. The audio is downmixed and linearly resampled to the output format once here so that reading is
+ * just a copy
+ *
+ * @param Samples [in] interleaved 16-bit samples
+ * @param NumSamples [in] the number of samples
+ * @param SourceSampleRate [in] the sample rate of the source audio
+ * @param SourceNumChannels [in] the number of channels in the source audio
+ */
+void FVoiceCaptureEmulationStream::SetSource(const int16* Samples, const int32 NumSamples, const int32 SourceSampleRate, const int32 SourceNumChannels)
+{
+	Source.Reset();
+
+	const bool bIsValidSource = Samples != nullptr && NumSamples > 0 && SourceSampleRate > 0 && SourceNumChannels > 0;
+
+	if (!bIsValidSource)
+	{
+		return;
+	}
+
+	// The common case is that the source already matches the output format
+
+	const bool bIsSameFormat = SourceSampleRate == SampleRate && SourceNumChannels == NumChannels;
+
+	if (bIsSameFormat)
+	{
+		Source.Append(Samples, NumSamples - NumSamples % NumChannels);
+		return;
+	}
+
+	const int32 NumSourceFrames = NumSamples / SourceNumChannels;
+
+	TArray<float> MonoFrames;
+	MonoFrames.SetNumUninitialized(NumSourceFrames);
+
+	for (int32 FrameIndex = 0; FrameIndex < NumSourceFrames; ++FrameIndex)
+	{
+		const int16* Frame = Samples + FrameIndex * SourceNumChannels;
+		float Sum = 0.0f;
+
+		for (int32 ChannelIndex = 0; ChannelIndex < SourceNumChannels; ++ChannelIndex)
+		{
+			Sum += Frame[ChannelIndex];
+		}
+
+		MonoFrames[FrameIndex] = Sum / SourceNumChannels;
+	}
+
+	const double Step = static_cast<double>(SourceSampleRate) / SampleRate;
+	const int32 NumOutputFrames = NumSourceFrames > 1 ? static_cast<int32>((NumSourceFrames - 1) / Step) + 1 : NumSourceFrames;
+
+	Source.SetNumUninitialized(NumOutputFrames * NumChannels);
+
+	for (int32 FrameIndex = 0; FrameIndex < NumOutputFrames; ++FrameIndex)
+	{
+		const double Position = FrameIndex * Step;
+		const int32 Index = FMath::Min(static_cast<int32>(Position), NumSourceFrames - 1);
+		const int32 NextIndex = FMath::Min(Index + 1, NumSourceFrames - 1);
+		const float Sample = FMath::Lerp(MonoFrames[Index], MonoFrames[NextIndex], static_cast<float>(Position - Index));
+		const int16 OutputSample = static_cast<int16>(FMath::Clamp(Sample, -32768.0f, 32767.0f));
+
+		for (int32 ChannelIndex = 0; ChannelIndex < NumChannels; ++ChannelIndex)
+		{
+			Source[FrameIndex * NumChannels + ChannelIndex] = OutputSample;
+		}
+	}
+}
+
+/**
+ * Set the source audio from the contents of a wav file
+ *
+ * @param WavData [in] the wav file data
+ * @param WavDataSize [in] the size of the wav file data
+ * @return true if the data was a valid wav file
+ */
+bool FVoiceCaptureEmulationStream::SetSourceFromWav(const uint8* WavData, const int32 WavDataSize)
+{
+	FWaveModInfo WaveInfo;
+
+	const bool bIsValidWav = WavData != nullptr && WaveInfo.ReadWaveInfo(WavData, WavDataSize) && *WaveInfo.pBitsPerSample == 16;
+
+	if (!bIsValidWav)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("FVoiceCaptureEmulationStream - SetSourceFromWav: data is not 16-bit wav - treating as raw samples"));
+
+		SetSource(reinterpret_cast<const int16*>(WavData), WavDataSize / sizeof(int16), SampleRate, NumChannels);
+		return false;
+	}
+
+	SetSource(reinterpret_cast<const int16*>(WaveInfo.SampleDataStart), WaveInfo.SampleDataSize / sizeof(int16), *WaveInfo.pSamplesPerSec, *WaveInfo.pChannels);
+
+	return true;
+}
+
+/**
+ * Set the source audio to the given duration of silence
+ *
+ * @param Duration [in] the duration in seconds
+ */
+void FVoiceCaptureEmulationStream::SetSourceToSilence(const float Duration)
+{
+	const int32 NumFrames = FMath::Max(FMath::RoundToInt(Duration * SampleRate), 0);
+
+	Source.Reset();
+	Source.SetNumZeroed(NumFrames * NumChannels);
+}
+
+/**
+ * Rewind to the start of the source audio
+ */
+void FVoiceCaptureEmulationStream::Start()
+{
+	ElapsedTime = 0.0;
+	NumFramesReleased = 0;
+	NumFramesRead = 0;
+}
+
+/**
+ * Advance emulated time releasing any source audio that is now due. The number of frames due is derived from the total
+ * elapsed time rather than accumulated per call so rounding never builds up
+ *
+ * @param DeltaTime [in] the time in seconds since the last advance
+ */
+void FVoiceCaptureEmulationStream::Advance(const double DeltaTime)
+{
+	const int64 NumFrames = GetNumFrames();
+
+	if (Speed <= UnthrottledSpeed)
+	{
+		NumFramesReleased = NumFrames;
+		return;
+	}
+
+	ElapsedTime += DeltaTime;
+
+	const int64 NumFramesDue = static_cast<int64>(FMath::FloorToDouble(ElapsedTime * Speed * SampleRate));
+
+	NumFramesReleased = FMath::Min(NumFramesDue, NumFrames);
+}
+
+/**
+ * Read released audio
+ *
+ * @param OutData [out] the buffer to read into
+ * @param Capacity [in] the size of the buffer in bytes
+ * @return the number of bytes read. Always a whole number of frames
+ */
+uint32 FVoiceCaptureEmulationStream::Read(uint8* OutData, const uint32 Capacity)
+{
+	const int32 FrameSize = GetFrameSize();
+	const int64 NumFramesToRead = FMath::Min<int64>(NumFramesReleased - NumFramesRead, Capacity / FrameSize);
+
+	if (NumFramesToRead <= 0)
+	{
+		return 0;
+	}
+
+	const uint32 NumBytesToRead = static_cast<uint32>(NumFramesToRead * FrameSize);
+
+	FMemory::Memcpy(OutData, Source.GetData() + NumFramesRead * NumChannels, NumBytesToRead);
+
+	NumFramesRead += NumFramesToRead;
+
+	return NumBytesToRead;
+}
+
+/**
+ * Get the number of released bytes waiting to be read
+ *
+ * @return the number of bytes
+ */
+uint32 FVoiceCaptureEmulationStream::GetNumAvailableBytes() const
+{
+	return static_cast<uint32>((NumFramesReleased - NumFramesRead) * GetFrameSize());
+}
+
+/**
+ * Get the number of frames read since the start
+ *
+ * @return the number of frames
+ */
+int64 FVoiceCaptureEmulationStream::GetNumFramesRead() const
+{
+	return NumFramesRead;
+}
+
+/**
+ * Has all of the source audio been read?
+ *
+ * @return true if finished
+ */
+bool FVoiceCaptureEmulationStream::IsFinished() const
+{
+	return NumFramesRead >= GetNumFrames();
+}
+
+/**
+ * Get the size of buffer that the capture needs to keep up with the current speed. This is enough for a tenth of a second
+ * of emulated audio per read or a full second when unthrottled
+ *
+ * @return the buffer size in bytes
+ */
+int32 FVoiceCaptureEmulationStream::GetBufferSize() const
+{
+	constexpr int32 MinimumBufferSize = 2048;
+
+	const float BufferDuration = Speed <= UnthrottledSpeed ? 1.0f : 0.1f * FMath::Max(Speed, 1.0f);
+	const int32 BufferSize = FMath::CeilToInt(BufferDuration * SampleRate) * GetFrameSize();
+
+	return FMath::Max(BufferSize, MinimumBufferSize);
+}
+
+/**
+ * Get the duration of the source audio
+ *
+ * @return the duration in seconds
+ */
+float FVoiceCaptureEmulationStream::GetDuration() const
+{
+	return static_cast<float>(GetNumFrames()) / SampleRate;
+}
+
+/**
+ * Get the size in bytes of a single output frame
+ */
+int32 FVoiceCaptureEmulationStream::GetFrameSize() const
+{
+	return NumChannels * sizeof(int16);
+}
+
+/**
+ * Get the number of output frames in the source audio
+ */
+int64 FVoiceCaptureEmulationStream::GetNumFrames() const
+{
+	return Source.Num() / NumChannels;
+}
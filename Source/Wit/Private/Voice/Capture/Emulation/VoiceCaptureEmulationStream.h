@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Sample accurate source of emulated voice data shared by the emulation captures. The source audio is converted once up
+ * front to the capture format and then released by sample count as emulated time passes so the output does not depend on
+ * the frame rate and nothing is dropped or duplicated. A speed multiplier allows faster than realtime playback for
+ * automated throughput tests
+ */
+class FVoiceCaptureEmulationStream final
+{
+public:
+
+	/** Speed value meaning the source is released as fast as the capture is read */
+	static constexpr float UnthrottledSpeed{0.0f};
+
+	/**
+	 * Set the format that the capture outputs
+	 *
+	 * @param InSampleRate [in] the output sample rate
+	 * @param InNumChannels [in] the output number of channels
+	 */
+	void SetFormat(const int32 InSampleRate, const int32 InNumChannels);
+
+	/**
+	 * Set the playback speed relative to realtime
+	 *
+	 * @param InSpeed [in] the speed multiplier or UnthrottledSpeed to play as fast as the capture is read
+	 */
+	void SetSpeed(const float InSpeed);
+
+	/**
+	 * Set the source audio. The audio is converted to the output format
+	 *
+	 * @param Samples [in] interleaved 16-bit samples
+	 * @param NumSamples [in] the number of samples
+	 * @param SourceSampleRate [in] the sample rate of the source audio
+	 * @param SourceNumChannels [in] the number of channels in the source audio
+	 */
+	void SetSource(const int16* Samples, const int32 NumSamples, const int32 SourceSampleRate, const int32 SourceNumChannels);
+
+	/**
+	 * Set the source audio from the contents of a wav file. If the data is not a valid wav file it is treated as raw
+	 * samples in the output format
+	 *
+	 * @param WavData [in] the wav file data
+	 * @param WavDataSize [in] the size of the wav file data
+	 * @return true if the data was a valid wav file
+	 */
+	bool SetSourceFromWav(const uint8* WavData, const int32 WavDataSize);
+
+	/**
+	 * Set the source audio to the given duration of silence
+	 *
+	 * @param Duration [in] the duration in seconds
+	 */
+	void SetSourceToSilence(const float Duration);
+
+	/**
+	 * Rewind to the start of the source audio
+	 */
+	void Start();
+
+	/**
+	 * Advance emulated time releasing any source audio that is now due
+	 *
+	 * @param DeltaTime [in] the time in seconds since the last advance
+	 */
+	void Advance(const double DeltaTime);
+
+	/**
+	 * Read released audio
+	 *
+	 * @param OutData [out] the buffer to read into
+	 * @param Capacity [in] the size of the buffer in bytes
+	 * @return the number of bytes read. Always a whole number of frames
+	 */
+	uint32 Read(uint8* OutData, const uint32 Capacity);
+
+	/**
+	 * Get the number of released bytes waiting to be read
+	 *
+	 * @return the number of bytes
+	 */
+	uint32 GetNumAvailableBytes() const;
+
+	/**
+	 * Get the number of frames read since the start
+	 *
+	 * @return the number of frames
+	 */
+	int64 GetNumFramesRead() const;
+
+	/**
+	 * Has all of the source audio been read?
+	 *
+	 * @return true if finished
+	 */
+	bool IsFinished() const;
+
+	/**
+	 * Get the size of buffer that the capture needs to keep up with the current speed
+	 *
+	 * @return the buffer size in bytes
+	 */
+	int32 GetBufferSize() const;
+
+	/**
+	 * Get the duration of the source audio
+	 *
+	 * @return the duration in seconds
+	 */
+	float GetDuration() const;
+
+private:
+
+	/** Get the size in bytes of a single output frame */
+	int32 GetFrameSize() const;
+
+	/** Get the number of output frames in the source audio */
+	int64 GetNumFrames() const;
+
+	/** The output sample rate */
+	int32 SampleRate{16000};
+
+	/** The output number of channels */
+	int32 NumChannels{1};
+
+	/** The playback speed relative to realtime */
+	float Speed{1.0f};
+
+	/** The source audio in the output format */
+	TArray<int16> Source{};
+
+	/** Emulated time since the start */
+	double ElapsedTime{0.0};
+
+	/** The number of frames released so far */
+	int64 NumFramesReleased{0};
+
+	/** The number of frames read so far */
+	int64 NumFramesRead{0};
+};
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Voice/Capture/Processing/VoiceInputProcessor.h"
+#include "DSP/FFTAlgorithm.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Wit/Utilities/WitConversionUtilities.h"
+#include "Wit/Utilities/WitLog.h"
+
+namespace
+{
+	/** The number of hops used to seed the noise estimate */
+	constexpr int32 NoiseLearningHops{10};
+
+	/** How quickly the noise estimate rises towards louder input. Kept slow so that speech is not learnt as noise */
+	constexpr float NoiseRiseRate{0.002f};
+
+	/** How quickly the noise estimate falls towards quieter input */
+	constexpr float NoiseFallRate{0.1f};
+
+	/** Smoothing applied to the per bin gains to reduce musical noise */
+	constexpr float BinGainSmoothing{0.5f};
+
+	/** Input quieter than this is not used to adjust automatic gain control so that background noise is not amplified */
+	constexpr float GainControlMinimumVolume{0.003f};
+
+	/** How quickly automatic gain control reduces gain */
+	constexpr float GainControlAttackRate{0.5f};
+
+	/** How quickly automatic gain control increases gain */
+	constexpr float GainControlReleaseRate{0.05f};
+
+	/**
+	 * Multiply two arrays element by element
+	 *
+	 * @param InValues [in] the first array
+	 * @param InOutValues [in,out] the second array which also receives the result
+	 * @param NumValues [in] the number of values in each array
+	 */
+	void MultiplyInPlace(const float* InValues, float* InOutValues, const int32 NumValues)
+	{
+		const int32 NumVectorValues = NumValues & ~3;
+
+		for (int32 i = 0; i < NumVectorValues; i += 4)
+		{
+			const VectorRegister Result = VectorMultiply(VectorLoad(InValues + i), VectorLoad(InOutValues + i));
+			VectorStore(Result, InOutValues + i);
+		}
+
+		for (int32 i = NumVectorValues; i < NumValues; ++i)
+		{
+			InOutValues[i] *= InValues[i];
+		}
+	}
+
+	/**
+	 * Multiply two arrays element by element, scale and accumulate the result into a third
+	 *
+	 * @param InValues [in] the first array
+	 * @param InOtherValues [in] the second array
+	 * @param Scale [in] the scale applied to each product
+	 * @param InOutValues [in,out] the array to accumulate into
+	 * @param NumValues [in] the number of values in each array
+	 */
+	void MultiplyAddInPlace(const float* InValues, const float* InOtherValues, const float Scale, float* InOutValues, const int32 NumValues)
+	{
+		const int32 NumVectorValues = NumValues & ~3;
+		const VectorRegister ScaleVector = VectorSetFloat1(Scale);
+
+		for (int32 i = 0; i < NumVectorValues; i += 4)
+		{
+			const VectorRegister Product = VectorMultiply(VectorMultiply(VectorLoad(InValues + i), VectorLoad(InOtherValues + i)), ScaleVector);
+			VectorStore(VectorAdd(Product, VectorLoad(InOutValues + i)), InOutValues + i);
+		}
+
+		for (int32 i = NumVectorValues; i < NumValues; ++i)
+		{
+			InOutValues[i] += InValues[i] * InOtherValues[i] * Scale;
+		}
+	}
+}
+
+/**
+ * Constructor
+ */
+FVoiceInputProcessor::FVoiceInputProcessor()
+{
+	// Deliberately empty
+}
+
+/**
+ * Destructor
+ */
+FVoiceInputProcessor::~FVoiceInputProcessor()
+{
+	// Deliberately empty
+}
+
+/**
+ * Configure the processor from the given voice configuration. All buffers are allocated here so that processing does not
+ * allocate once the stream is running
+ *
+ * @param VoiceConfiguration [in] the voice configuration to use
+ * @param SampleRate [in] the sample rate of the voice data
+ * @param NumChannels [in] the number of channels in the voice data. Only mono is supported
+ */
+void FVoiceInputProcessor::Configure(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels)
+{
+	bIsNoiseSuppressionEnabled = VoiceConfiguration.bIsNoiseSuppressionEnabled;
+	bIsGainControlEnabled = VoiceConfiguration.bIsAutomaticGainControlEnabled;
+	NoiseSuppressionStrength = VoiceConfiguration.NoiseSuppressionStrength;
+	NoiseSuppressionMinimumGain = VoiceConfiguration.NoiseSuppressionMinimumGain;
+	GainControlTargetVolume = VoiceConfiguration.AutomaticGainControlTargetVolume;
+	GainControlMaximumGain = VoiceConfiguration.AutomaticGainControlMaximumGain;
+
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	if (NumChannels != 1)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoiceInputProcessor - Configure: only mono voice input is supported - disabling processing"));
+
+		bIsNoiseSuppressionEnabled = false;
+		bIsGainControlEnabled = false;
+
+		return;
+	}
+
+	// The noise estimate is kept from one stream to the next so that it can be learnt from the audio heard before speech
+	// starts. It is only thrown away if the format changes
+
+	const int32 PreviousHopSize = HopSize;
+
+	HopSize = SampleRate / 100;
+	WindowSize = HopSize * 2;
+
+	PendingSamples.SetNumZeroed(HopSize);
+
+	if (bIsNoiseSuppressionEnabled)
+	{
+		const int32 Log2FFTSize = FMath::CeilLogTwo(WindowSize);
+
+		Audio::FFFTSettings Settings;
+
+		Settings.Log2Size = Log2FFTSize;
+		Settings.bArrayIsAligned = false;
+		Settings.bEnableHardwareAcceleration = true;
+
+		FFT = Audio::FFFTFactory::NewFFTAlgorithm(Settings);
+
+		if (!FFT.IsValid())
+		{
+			UE_LOG(LogWit, Warning, TEXT("VoiceInputProcessor - Configure: no FFT available for size (%d) - disabling noise suppression"), 1 << Log2FFTSize);
+
+			bIsNoiseSuppressionEnabled = false;
+		}
+	}
+
+	if (bIsNoiseSuppressionEnabled)
+	{
+		FFTSize = FFT->NumInputFloats();
+		NumBins = FFTSize / 2 + 1;
+
+		// A periodic square root Hann window used for analysis and synthesis sums to unity at 50% overlap
+
+		Window.SetNumUninitialized(WindowSize);
+
+		for (int32 i = 0; i < WindowSize; ++i)
+		{
+			Window[i] = FMath::Sqrt(0.5f * (1.0f - FMath::Cos(2.0f * PI * i / WindowSize)));
+		}
+
+		AnalysisFrame.SetNumZeroed(WindowSize);
+		TimeDomain.SetNumZeroed(FFTSize);
+		FrequencyDomain.SetNumZeroed(FFT->NumOutputFloats());
+		const bool bShouldResetNoise = HopSize != PreviousHopSize || NoisePower.Num() != NumBins;
+
+		if (bShouldResetNoise)
+		{
+			NoisePower.Reset();
+			NoisePower.SetNumZeroed(NumBins);
+			NumNoiseHops = 0;
+		}
+
+		BinGains.SetNumZeroed(NumBins * 2);
+		OverlapAdd.SetNumZeroed(WindowSize);
+
+		// The scaling applied by the FFT implementation differs between engine versions so we measure the round trip gain
+		// using an impulse rather than assuming it
+
+		TimeDomain[0] = 1.0f;
+
+		FFT->ForwardRealToComplex(TimeDomain.GetData(), FrequencyDomain.GetData());
+		FFT->InverseComplexToReal(FrequencyDomain.GetData(), TimeDomain.GetData());
+
+		InverseScale = FMath::IsNearlyZero(TimeDomain[0]) ? 1.0f : 1.0f / TimeDomain[0];
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("VoiceInputProcessor - Configure: noise suppression (%d) gain control (%d) hop size (%d) FFT size (%d)"),
+		bIsNoiseSuppressionEnabled, bIsGainControlEnabled, HopSize, FFTSize);
+
+	Reset();
+}
+
+/**
+ * Reset the processor ready for a new stream of voice data. The noise estimate is kept
+ */
+void FVoiceInputProcessor::Reset()
+{
+	NumHopsProcessed = 0;
+	NumPendingSamples = 0;
+	GainControlCurrentGain = 1.0f;
+
+	FMemory::Memzero(AnalysisFrame.GetData(), AnalysisFrame.Num() * sizeof(float));
+	FMemory::Memzero(TimeDomain.GetData(), TimeDomain.Num() * sizeof(float));
+	FMemory::Memzero(OverlapAdd.GetData(), OverlapAdd.Num() * sizeof(float));
+
+	for (float& BinGain : BinGains)
+	{
+		BinGain = 1.0f;
+	}
+}
+
+/**
+ * Process a span of 16-bit voice data. Input samples are accumulated until a full hop is available and only complete hops
+ * are output. Any remaining samples are held back until the next call
+ *
+ * @param VoiceData [in] the voice data to process
+ * @return the processed voice data. This is either the input span or a newly acquired block and may be empty
+ */
+FVoiceAudioSpan FVoiceInputProcessor::Process(const FVoiceAudioSpan& VoiceData)
+{
+	if (!IsEnabled() || VoiceData.IsEmpty())
+	{
+		return VoiceData;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FVoiceInputProcessor::Process);
+
+	// The output can be up to one hop larger than the input because of samples held back from the previous call. Sizing the
+	// pool from the input block capacity rather than the input size keeps it stable from frame to frame
+
+	const int32 RequiredBlockSize = VoiceData.Block->GetCapacity() + HopSize * sizeof(int16);
+	const bool bIsOutputPoolSuitable = OutputBlockPool.IsValid() && OutputBlockPool->GetBlockSize() >= RequiredBlockSize;
+
+	if (!bIsOutputPoolSuitable)
+	{
+		OutputBlockPool = MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(RequiredBlockSize);
+	}
+
+	const FVoiceAudioBlockRef OutputBlock = OutputBlockPool->Acquire();
+	const uint8* InputData = VoiceData.GetData();
+	const int32 NumSamples = VoiceData.Num() / sizeof(int16);
+	int32 NumSamplesConsumed = 0;
+	int32 NumOutputBytes = 0;
+
+	while (NumSamplesConsumed < NumSamples)
+	{
+		const int32 NumSamplesToConsume = FMath::Min(HopSize - NumPendingSamples, NumSamples - NumSamplesConsumed);
+
+		FWitConversionUtilities::ConvertSamples16BitToFloat(InputData + NumSamplesConsumed * sizeof(int16), NumSamplesToConsume,
+			PendingSamples.GetData() + NumPendingSamples);
+
+		NumSamplesConsumed += NumSamplesToConsume;
+		NumPendingSamples += NumSamplesToConsume;
+
+		if (NumPendingSamples < HopSize)
+		{
+			break;
+		}
+
+		ProcessHop(PendingSamples.GetData(), true);
+
+		FWitConversionUtilities::ConvertSamplesFloatTo16Bit(PendingSamples.GetData(), HopSize, OutputBlock->GetData() + NumOutputBytes);
+
+		NumOutputBytes += HopSize * sizeof(int16);
+		NumPendingSamples = 0;
+	}
+
+	OutputBlock->SetNum(NumOutputBytes);
+
+	return FVoiceAudioSpan(OutputBlock);
+}
+
+/**
+ * Learn the background noise from voice data that will not be streamed, such as the audio heard while waiting for speech
+ * to start. Nothing is output. Only noise suppression uses this
+ *
+ * @param VoiceData [in] the voice data to learn from
+ */
+void FVoiceInputProcessor::LearnNoise(const FVoiceAudioSpan& VoiceData)
+{
+	if (!bIsNoiseSuppressionEnabled || VoiceData.IsEmpty())
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FVoiceInputProcessor::LearnNoise);
+
+	const uint8* InputData = VoiceData.GetData();
+	const int32 NumSamples = VoiceData.Num() / sizeof(int16);
+	int32 NumSamplesConsumed = 0;
+
+	while (NumSamplesConsumed < NumSamples)
+	{
+		const int32 NumSamplesToConsume = FMath::Min(HopSize - NumPendingSamples, NumSamples - NumSamplesConsumed);
+
+		FWitConversionUtilities::ConvertSamples16BitToFloat(InputData + NumSamplesConsumed * sizeof(int16), NumSamplesToConsume,
+			PendingSamples.GetData() + NumPendingSamples);
+
+		NumSamplesConsumed += NumSamplesToConsume;
+		NumPendingSamples += NumSamplesToConsume;
+
+		if (NumPendingSamples < HopSize)
+		{
+			break;
+		}
+
+		AnalyseHop(PendingSamples.GetData());
+		UpdateNoise();
+
+		NumPendingSamples = 0;
+	}
+}
+
+/**
+ * Output everything still held by the processor at the end of a stream. This is the partial hop waiting for more input and,
+ * with noise suppression, the hop of delay from the overlapping windows. Silence is used to complete the final windows and
+ * the noise estimate is not updated from it
+ *
+ * @return the remaining processed voice data. This may be empty
+ */
+FVoiceAudioSpan FVoiceInputProcessor::Flush()
+{
+	if (!IsEnabled())
+	{
+		return FVoiceAudioSpan();
+	}
+
+	const int32 NumDelayedSamples = bIsNoiseSuppressionEnabled && NumHopsProcessed > 0 ? HopSize : 0;
+	int32 NumRemainingSamples = NumDelayedSamples + NumPendingSamples;
+
+	if (NumRemainingSamples == 0)
+	{
+		return FVoiceAudioSpan();
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FVoiceInputProcessor::Flush);
+
+	const int32 RequiredBlockSize = NumRemainingSamples * sizeof(int16);
+	const bool bIsOutputPoolSuitable = OutputBlockPool.IsValid() && OutputBlockPool->GetBlockSize() >= RequiredBlockSize;
+
+	if (!bIsOutputPoolSuitable)
+	{
+		OutputBlockPool = MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(RequiredBlockSize);
+	}
+
+	const FVoiceAudioBlockRef OutputBlock = OutputBlockPool->Acquire();
+	int32 NumOutputBytes = 0;
+
+	while (NumRemainingSamples > 0)
+	{
+		FMemory::Memzero(PendingSamples.GetData() + NumPendingSamples, (HopSize - NumPendingSamples) * sizeof(float));
+
+		ProcessHop(PendingSamples.GetData(), false);
+
+		const int32 NumOutputSamples = FMath::Min(HopSize, NumRemainingSamples);
+
+		FWitConversionUtilities::ConvertSamplesFloatTo16Bit(PendingSamples.GetData(), NumOutputSamples, OutputBlock->GetData() + NumOutputBytes);
+
+		NumOutputBytes += NumOutputSamples * sizeof(int16);
+		NumRemainingSamples -= NumOutputSamples;
+		NumPendingSamples = 0;
+	}
+
+	OutputBlock->SetNum(NumOutputBytes);
+
+	Reset();
+
+	return FVoiceAudioSpan(OutputBlock);
+}
+
+/**
+ * Is any processing enabled?
+ *
+ * @return true if enabled
+ */
+bool FVoiceInputProcessor::IsEnabled() const
+{
+	return bIsNoiseSuppressionEnabled || bIsGainControlEnabled;
+}
+
+/**
+ * Process a single hop of samples in place. The output is clamped as the conversion back to 16-bit assumes it is in range
+ *
+ * @param Samples [in,out] the samples to process
+ * @param bShouldUpdateNoise [in] should the noise estimate be updated from the samples
+ */
+void FVoiceInputProcessor::ProcessHop(float* Samples, const bool bShouldUpdateNoise)
+{
+	if (bIsNoiseSuppressionEnabled)
+	{
+		SuppressNoise(Samples, bShouldUpdateNoise);
+	}
+
+	if (bIsGainControlEnabled)
+	{
+		ControlGain(Samples);
+	}
+
+	for (int32 i = 0; i < HopSize; ++i)
+	{
+		Samples[i] = FMath::Clamp(Samples[i], -1.0f, 1.0f);
+	}
+
+	++NumHopsProcessed;
+}
+
+/**
+ * Slide the analysis frame along by one hop, window it and transform it into the frequency domain
+ *
+ * @param Samples [in] the samples of the next hop
+ */
+void FVoiceInputProcessor::AnalyseHop(const float* Samples)
+{
+	// The zero padding beyond the window is never written
+
+	FMemory::Memmove(AnalysisFrame.GetData(), AnalysisFrame.GetData() + HopSize, HopSize * sizeof(float));
+	FMemory::Memcpy(AnalysisFrame.GetData() + HopSize, Samples, HopSize * sizeof(float));
+	FMemory::Memcpy(TimeDomain.GetData(), AnalysisFrame.GetData(), WindowSize * sizeof(float));
+	FMemory::Memzero(TimeDomain.GetData() + WindowSize, (FFTSize - WindowSize) * sizeof(float));
+
+	MultiplyInPlace(Window.GetData(), TimeDomain.GetData(), WindowSize);
+
+	FFT->ForwardRealToComplex(TimeDomain.GetData(), FrequencyDomain.GetData());
+}
+
+/**
+ * Update the noise estimate from the most recently analysed hop. The first hops seed the estimate with their average and
+ * after that it is tracked continuously, falling quickly and rising slowly so that speech is not learnt as noise
+ */
+void FVoiceInputProcessor::UpdateNoise()
+{
+	const bool bIsLearningNoise = NumNoiseHops < NoiseLearningHops;
+
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		const float Real = FrequencyDomain[Bin * 2];
+		const float Imaginary = FrequencyDomain[Bin * 2 + 1];
+		const float Power = Real * Real + Imaginary * Imaginary;
+
+		float& Noise = NoisePower[Bin];
+
+		if (bIsLearningNoise)
+		{
+			Noise += (Power - Noise) / (NumNoiseHops + 1);
+		}
+		else
+		{
+			Noise += (Power - Noise) * (Power < Noise ? NoiseFallRate : NoiseRiseRate);
+		}
+	}
+
+	++NumNoiseHops;
+}
+
+/**
+ * Apply spectral subtraction noise suppression to a single hop of samples in place. The noise power in each frequency bin
+ * is tracked continuously and a gain derived from the estimated signal to noise ratio is applied to that bin
+ *
+ * @param Samples [in,out] the samples to process
+ * @param bShouldUpdateNoise [in] should the noise estimate be updated from the samples
+ */
+void FVoiceInputProcessor::SuppressNoise(float* Samples, const bool bShouldUpdateNoise)
+{
+	AnalyseHop(Samples);
+
+	if (bShouldUpdateNoise)
+	{
+		UpdateNoise();
+	}
+
+	for (int32 Bin = 0; Bin < NumBins; ++Bin)
+	{
+		const float Real = FrequencyDomain[Bin * 2];
+		const float Imaginary = FrequencyDomain[Bin * 2 + 1];
+		const float Power = Real * Real + Imaginary * Imaginary;
+		const float Noise = NoisePower[Bin];
+
+		const float SignalRatio = FMath::Max(1.0f - NoiseSuppressionStrength * Noise / (Power + SMALL_NUMBER), 0.0f);
+		const float Gain = FMath::Max(FMath::Sqrt(SignalRatio), NoiseSuppressionMinimumGain);
+		const float SmoothedGain = BinGainSmoothing * BinGains[Bin * 2] + (1.0f - BinGainSmoothing) * Gain;
+
+		BinGains[Bin * 2] = SmoothedGain;
+		BinGains[Bin * 2 + 1] = SmoothedGain;
+	}
+
+	MultiplyInPlace(BinGains.GetData(), FrequencyDomain.GetData(), NumBins * 2);
+
+	FFT->InverseComplexToReal(FrequencyDomain.GetData(), TimeDomain.GetData());
+
+	// Window again and overlap add. The first hop of the accumulator is now complete and becomes the output
+
+	MultiplyAddInPlace(TimeDomain.GetData(), Window.GetData(), InverseScale, OverlapAdd.GetData(), WindowSize);
+
+	FMemory::Memcpy(Samples, OverlapAdd.GetData(), HopSize * sizeof(float));
+	FMemory::Memmove(OverlapAdd.GetData(), OverlapAdd.GetData() + HopSize, HopSize * sizeof(float));
+	FMemory::Memzero(OverlapAdd.GetData() + HopSize, HopSize * sizeof(float));
+}
+
+/**
+ * Apply automatic gain control to a single hop of samples in place. The gain moves towards the value needed to reach the
+ * target volume without clipping and is ramped across the hop to avoid discontinuities
+ *
+ * @param Samples [in,out] the samples to process
+ */
+void FVoiceInputProcessor::ControlGain(float* Samples)
+{
+	float SumOfSquares = 0.0f;
+	float Peak = 0.0f;
+
+	for (int32 i = 0; i < HopSize; ++i)
+	{
+		SumOfSquares += Samples[i] * Samples[i];
+		Peak = FMath::Max(Peak, FMath::Abs(Samples[i]));
+	}
+
+	const float Volume = FMath::Sqrt(SumOfSquares / HopSize);
+
+	// We hold the current gain through silence so that background noise between words is not pumped up
+
+	float TargetGain = GainControlCurrentGain;
+
+	if (Volume > GainControlMinimumVolume)
+	{
+		TargetGain = FMath::Clamp(GainControlTargetVolume / Volume, 1.0f / GainControlMaximumGain, GainControlMaximumGain);
+		TargetGain = FMath::Min(TargetGain, 1.0f / Peak);
+	}
+
+	const float Rate = TargetGain < GainControlCurrentGain ? GainControlAttackRate : GainControlReleaseRate;
+	const float NextGain = GainControlCurrentGain + (TargetGain - GainControlCurrentGain) * Rate;
+	const float GainStep = (NextGain - GainControlCurrentGain) / HopSize;
+
+	for (int32 i = 0; i < HopSize; ++i)
+	{
+		Samples[i] *= GainControlCurrentGain + GainStep * i;
+	}
+
+	GainControlCurrentGain = NextGain;
+}
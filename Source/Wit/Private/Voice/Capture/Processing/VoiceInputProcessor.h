@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+
+struct FVoiceConfiguration;
+
+namespace Audio
+{
+	class IFFTAlgorithm;
+}
+
+/**
+ * DSP stage applied to captured 16-bit voice data before it is streamed. Provides spectral subtraction noise suppression and
+ * automatic gain control. Voice data is processed in 10ms hops using 50% overlapping windows so the output is delayed by a
+ * single hop relative to the input until the stream is flushed
+ */
+class FVoiceInputProcessor
+{
+public:
+
+	FVoiceInputProcessor();
+	~FVoiceInputProcessor();
+
+	/**
+	 * Configure the processor from the given voice configuration
+	 *
+	 * @param VoiceConfiguration [in] the voice configuration to use
+	 * @param SampleRate [in] the sample rate of the voice data
+	 * @param NumChannels [in] the number of channels in the voice data. Only mono is supported
+	 */
+	void Configure(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels);
+
+	/**
+	 * Reset the processor ready for a new stream of voice data. The noise estimate is kept
+	 */
+	void Reset();
+
+	/**
+	 * Process a span of 16-bit voice data
+	 *
+	 * @param VoiceData [in] the voice data to process
+	 * @return the processed voice data. This is either the input span or a newly acquired block and may be empty
+	 */
+	FVoiceAudioSpan Process(const FVoiceAudioSpan& VoiceData);
+
+	/**
+	 * Learn the background noise from voice data that will not be streamed
+	 *
+	 * @param VoiceData [in] the voice data to learn from
+	 */
+	void LearnNoise(const FVoiceAudioSpan& VoiceData);
+
+	/**
+	 * Output everything still held by the processor at the end of a stream
+	 *
+	 * @return the remaining processed voice data. This may be empty
+	 */
+	FVoiceAudioSpan Flush();
+
+	/**
+	 * Is any processing enabled?
+	 *
+	 * @return true if enabled
+	 */
+	bool IsEnabled() const;
+
+private:
+
+	/** Process a single hop of samples in place */
+	void ProcessHop(float* Samples, const bool bShouldUpdateNoise);
+
+	/** Slide the analysis frame along by one hop and transform it into the frequency domain */
+	void AnalyseHop(const float* Samples);
+
+	/** Update the noise estimate from the most recently analysed hop */
+	void UpdateNoise();
+
+	/** Apply noise suppression to a single hop of samples in place */
+	void SuppressNoise(float* Samples, const bool bShouldUpdateNoise);
+
+	/** Apply automatic gain control to a single hop of samples in place */
+	void ControlGain(float* Samples);
+
+	/** Is noise suppression enabled? */
+	bool bIsNoiseSuppressionEnabled{false};
+
+	/** Is automatic gain control enabled? */
+	bool bIsGainControlEnabled{false};
+
+	/** Noise suppression over-subtraction factor */
+	float NoiseSuppressionStrength{1.0f};
+
+	/** Noise suppression minimum gain */
+	float NoiseSuppressionMinimumGain{0.0f};
+
+	/** Automatic gain control target RMS volume */
+	float GainControlTargetVolume{0.1f};
+
+	/** Automatic gain control maximum gain */
+	float GainControlMaximumGain{1.0f};
+
+	/** The gain currently being applied by automatic gain control */
+	float GainControlCurrentGain{1.0f};
+
+	/** The number of samples in a single hop */
+	int32 HopSize{0};
+
+	/** The number of samples in a single analysis window. Always twice the hop size */
+	int32 WindowSize{0};
+
+	/** The size of the FFT. The smallest power of two that holds the window */
+	int32 FFTSize{0};
+
+	/** The number of frequency bins produced by the FFT */
+	int32 NumBins{0};
+
+	/** The number of hops processed since the last reset */
+	int32 NumHopsProcessed{0};
+
+	/** The number of hops the noise estimate has been learnt from. This is kept across resets */
+	int32 NumNoiseHops{0};
+
+	/** The number of samples waiting in the pending hop */
+	int32 NumPendingSamples{0};
+
+	/** The scale that makes a forward and inverse FFT round trip unity gain */
+	float InverseScale{1.0f};
+
+	/** The FFT used by noise suppression */
+	TUniquePtr<Audio::IFFTAlgorithm> FFT{};
+
+	/** Input samples waiting until a full hop is available */
+	TArray<float> PendingSamples{};
+
+	/** Square root Hann window used for both analysis and synthesis */
+	TArray<float> Window{};
+
+	/** The most recent window of input samples */
+	TArray<float> AnalysisFrame{};
+
+	/** Real input to the FFT */
+	TArray<float> TimeDomain{};
+
+	/** Interleaved complex output from the FFT */
+	TArray<float> FrequencyDomain{};
+
+	/** Estimated noise power per frequency bin */
+	TArray<float> NoisePower{};
+
+	/** Smoothed gain per frequency bin interleaved to match the complex FFT output */
+	TArray<float> BinGains{};
+
+	/** Overlap add accumulator for the synthesized output */
+	TArray<float> OverlapAdd{};
+
+	/** Pool of blocks that the processed 16-bit output is written to */
+	TSharedPtr<FVoiceAudioBlockPool, ESPMode::ThreadSafe> OutputBlockPool{};
+};
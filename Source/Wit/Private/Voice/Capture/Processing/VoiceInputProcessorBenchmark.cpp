@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+#include "Voice/Capture/Processing/VoiceInputProcessor.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Wit/Utilities/WitBenchmark.h"
+#include "Wit/Utilities/WitLog.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Runs the input processor over 10ms frames of a noisy tone at the 16kHz streamed rate and checks each configuration
+ * against the per frame budget. Usage: Wit.InputProcessorBenchmark [NumFrames]
+ */
+static FAutoConsoleCommand InputProcessorBenchmarkCommand(
+	TEXT("Wit.InputProcessorBenchmark"),
+	TEXT("Measures the cost of noise suppression and automatic gain control per 10ms frame of captured voice against the 0.2ms budget. Optional argument is the number of frames (defaults to 10000)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		constexpr int32 SampleRate = 16000;
+		constexpr int32 FrameSize = SampleRate / 100;
+		constexpr double FrameBudget = 0.0002;
+		constexpr int32 NumInputFrames = 100;
+
+		const int32 NumFrames = FWitBenchmark::GetArgument(Args, 0, 10000);
+
+		// A second of input is reused for every iteration so that the noise estimate sees a steady signal
+
+		const TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe> InputBlockPool = MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(FrameSize * sizeof(int16));
+		TArray<FVoiceAudioSpan> InputFrames;
+		TArray<int16> Samples;
+		FRandomStream RandomStream(0);
+
+		InputFrames.Reserve(NumInputFrames);
+		Samples.SetNumUninitialized(FrameSize);
+
+		for (int32 FrameIndex = 0; FrameIndex < NumInputFrames; ++FrameIndex)
+		{
+			for (int32 SampleIndex = 0; SampleIndex < FrameSize; ++SampleIndex)
+			{
+				const float Time = static_cast<float>(FrameIndex * FrameSize + SampleIndex) / SampleRate;
+				const float Sample = 0.2f * FMath::Sin(2.0f * PI * 220.0f * Time) + 0.02f * RandomStream.FRandRange(-1.0f, 1.0f);
+
+				Samples[SampleIndex] = static_cast<int16>(Sample * 32767.0f);
+			}
+
+			const TArrayView<const uint8> Data(reinterpret_cast<const uint8*>(Samples.GetData()), FrameSize * sizeof(int16));
+
+			InputFrames.Add(FVoiceAudioSpan(InputBlockPool->Acquire(Data)));
+		}
+
+		const auto MeasureConfiguration = [NumFrames, &InputFrames](const TCHAR* Name, const bool bIsNoiseSuppressionEnabled, const bool bIsGainControlEnabled)
+		{
+			FVoiceConfiguration VoiceConfiguration;
+
+			VoiceConfiguration.bIsNoiseSuppressionEnabled = bIsNoiseSuppressionEnabled;
+			VoiceConfiguration.bIsAutomaticGainControlEnabled = bIsGainControlEnabled;
+
+			FVoiceInputProcessor Processor;
+
+			Processor.Configure(VoiceConfiguration, SampleRate, 1);
+
+			int32 FrameIndex = 0;
+
+			const FWitBenchmarkResult Result = FWitBenchmark::Measure(NumFrames, [&Processor, &InputFrames, &FrameIndex]()
+			{
+				Processor.Process(InputFrames[FrameIndex]);
+				FrameIndex = (FrameIndex + 1) % InputFrames.Num();
+			});
+
+			const bool bIsWithinBudget = Result.Time <= FrameBudget;
+
+			if (bIsWithinBudget)
+			{
+				UE_LOG(LogWit, Display, TEXT("Wit.InputProcessorBenchmark: %s (%.2f) us per frame - within the (%.0f) us budget"), Name,
+					Result.Time * 1000000.0, FrameBudget * 1000000.0);
+			}
+			else
+			{
+				UE_LOG(LogWit, Warning, TEXT("Wit.InputProcessorBenchmark: %s (%.2f) us per frame - over the (%.0f) us budget"), Name,
+					Result.Time * 1000000.0, FrameBudget * 1000000.0);
+			}
+		};
+
+		UE_LOG(LogWit, Display, TEXT("Wit.InputProcessorBenchmark: (%d) frames of (%d) samples"), NumFrames, FrameSize);
+
+		MeasureConfiguration(TEXT("noise suppression"), true, false);
+		MeasureConfiguration(TEXT("automatic gain control"), false, true);
+		MeasureConfiguration(TEXT("both"), true, true);
+	}));
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Voice/Capture/Processing/VoiceSilenceSuppressor.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Wit/Utilities/WitConversionUtilities.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Configure the suppressor from the given voice configuration
+ *
+ * @param VoiceConfiguration [in] the voice configuration to use
+ * @param SampleRate [in] the sample rate of the voice data
+ * @param NumChannels [in] the number of channels in the voice data
+ */
+void FVoiceSilenceSuppressor::Configure(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels)
+{
+	// Durations are converted to whole frames of 16-bit samples so that we never split a sample when truncating the silence
+
+	const int32 BytesPerFrame = NumChannels * sizeof(int16);
+
+	bIsEnabled = VoiceConfiguration.bIsSilenceSuppressionEnabled;
+	MaximumVolume = VoiceConfiguration.SilenceSuppressionMaximumVolume;
+	MinimumSilenceBytes = static_cast<int64>(VoiceConfiguration.SilenceSuppressionMinimumTime * SampleRate) * BytesPerFrame;
+	ComfortSilenceBytes = static_cast<int32>(VoiceConfiguration.SilenceSuppressionComfortTime * SampleRate) * BytesPerFrame;
+
+	// The comfort silence is created once in its own pool. It is only ever read so the same block is shared by every insertion
+
+	const bool bIsComfortSilenceRequired = bIsEnabled && ComfortSilenceBytes > 0;
+	const bool bIsComfortSilenceChanged = !ComfortSilenceBlock.IsValid() || ComfortSilenceBlock->Num() != ComfortSilenceBytes;
+
+	if (bIsComfortSilenceRequired && bIsComfortSilenceChanged)
+	{
+		const TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe> ComfortSilencePool = MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(ComfortSilenceBytes);
+
+		ComfortSilenceBlock = ComfortSilencePool->Acquire();
+
+		FMemory::Memzero(ComfortSilenceBlock->GetData(), ComfortSilenceBytes);
+		ComfortSilenceBlock->SetNum(ComfortSilenceBytes);
+	}
+	else if (!bIsComfortSilenceRequired)
+	{
+		ComfortSilenceBlock.SafeRelease();
+	}
+
+	OutputSpans.Reserve(2);
+
+	Reset();
+}
+
+/**
+ * Reset the suppressor ready for a new stream of voice data
+ */
+void FVoiceSilenceSuppressor::Reset()
+{
+	if (bIsEnabled && NumSuppressedBytes > 0)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("SilenceSuppressor - Reset: suppressed (%lld) bytes of silence"), NumSuppressedBytes);
+	}
+
+	bIsSuppressing = false;
+	CurrentSilenceBytes = 0;
+	NumSuppressedBytes = 0;
+
+	OutputSpans.Reset();
+}
+
+/**
+ * Process a span of 16-bit voice data. Silence is passed through until the current stretch of silence exceeds the minimum
+ * duration. When voice input resumes after silence has been dropped then the comfort silence is streamed ahead of the voice data.
+ * No audio is copied; the output only references the input block and the shared comfort silence block
+ *
+ * @param VoiceData [in] the voice data to process
+ * @return the spans that should be streamed in order. This may be empty
+ */
+const TArray<FVoiceAudioSpan>& FVoiceSilenceSuppressor::Process(const FVoiceAudioSpan& VoiceData)
+{
+	OutputSpans.Reset();
+
+	if (VoiceData.IsEmpty())
+	{
+		return OutputSpans;
+	}
+
+	if (!bIsEnabled)
+	{
+		OutputSpans.Add(VoiceData);
+		return OutputSpans;
+	}
+
+	const int32 NumSamples = VoiceData.Num() / sizeof(int16);
+	const float Amplitude = FWitConversionUtilities::CalculateMaximumAmplitude16Bit(VoiceData.GetData(), NumSamples);
+	const bool bIsSilent = Amplitude <= MaximumVolume;
+
+	if (bIsSilent)
+	{
+		const int64 PreviousSilenceBytes = CurrentSilenceBytes;
+
+		CurrentSilenceBytes += VoiceData.Num();
+
+		if (CurrentSilenceBytes <= MinimumSilenceBytes)
+		{
+			OutputSpans.Add(VoiceData);
+			return OutputSpans;
+		}
+
+		if (!bIsSuppressing)
+		{
+			UE_LOG(LogWit, Verbose, TEXT("SilenceSuppressor - Process: starting to suppress silence"));
+
+			bIsSuppressing = true;
+		}
+
+		// The span that crosses the threshold is only partially passed through so that the retained silence is exact
+
+		const int32 NumBytesToPass = static_cast<int32>(FMath::Max<int64>(MinimumSilenceBytes - PreviousSilenceBytes, 0));
+
+		NumSuppressedBytes += VoiceData.Num() - NumBytesToPass;
+
+		if (NumBytesToPass > 0)
+		{
+			OutputSpans.Add(FVoiceAudioSpan(VoiceData.Block, VoiceData.Offset, NumBytesToPass));
+		}
+
+		return OutputSpans;
+	}
+
+	CurrentSilenceBytes = 0;
+
+	if (bIsSuppressing)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("SilenceSuppressor - Process: voice resumed - inserting (%d) bytes of comfort silence"), ComfortSilenceBytes);
+
+		bIsSuppressing = false;
+
+		if (ComfortSilenceBlock.IsValid())
+		{
+			OutputSpans.Add(FVoiceAudioSpan(ComfortSilenceBlock));
+		}
+	}
+
+	OutputSpans.Add(VoiceData);
+
+	return OutputSpans;
+}
+
+/**
+ * Is suppression enabled?
+ *
+ * @return true if enabled
+ */
+bool FVoiceSilenceSuppressor::IsEnabled() const
+{
+	return bIsEnabled;
+}
+
+/**
+ * Get the total number of bytes dropped since the last reset
+ *
+ * @return the number of bytes
+ */
+int64 FVoiceSilenceSuppressor::GetNumSuppressedBytes() const
+{
+	return NumSuppressedBytes;
+}
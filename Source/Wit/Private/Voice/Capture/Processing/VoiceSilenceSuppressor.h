@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+
+struct FVoiceConfiguration;
+
+/**
+ * Collapses long stretches of silence in a stream of 16-bit voice data. Silence is passed through unchanged until it exceeds
+ * a minimum duration after which it is dropped. When voice input resumes a short block of comfort silence is inserted in
+ * place of the dropped data so that the recognizer still sees a pause between words
+ */
+class FVoiceSilenceSuppressor
+{
+public:
+
+	/**
+	 * Configure the suppressor from the given voice configuration
+	 *
+	 * @param VoiceConfiguration [in] the voice configuration to use
+	 * @param SampleRate [in] the sample rate of the voice data
+	 * @param NumChannels [in] the number of channels in the voice data
+	 */
+	void Configure(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels);
+
+	/**
+	 * Reset the suppressor ready for a new stream of voice data
+	 */
+	void Reset();
+
+	/**
+	 * Process a span of 16-bit voice data
+	 *
+	 * @param VoiceData [in] the voice data to process
+	 * @return the spans that should be streamed in order. This may be empty
+	 */
+	const TArray<FVoiceAudioSpan>& Process(const FVoiceAudioSpan& VoiceData);
+
+	/**
+	 * Is suppression enabled?
+	 *
+	 * @return true if enabled
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * Get the total number of bytes dropped since the last reset
+	 *
+	 * @return the number of bytes
+	 */
+	int64 GetNumSuppressedBytes() const;
+
+private:
+
+	/** Is suppression enabled? */
+	bool bIsEnabled{false};
+
+	/** Are we currently dropping silence? */
+	bool bIsSuppressing{false};
+
+	/** Voice data with an amplitude below this is considered silent */
+	float MaximumVolume{0.0f};
+
+	/** The number of bytes of silence we pass through before dropping */
+	int64 MinimumSilenceBytes{0};
+
+	/** The number of bytes of comfort silence we insert when voice input resumes */
+	int32 ComfortSilenceBytes{0};
+
+	/** The number of bytes in the current stretch of silence */
+	int64 CurrentSilenceBytes{0};
+
+	/** The total number of bytes dropped since the last reset */
+	int64 NumSuppressedBytes{0};
+
+	/** Shared block of comfort silence. This is never modified once created so it can be streamed any number of times */
+	FVoiceAudioBlockRef ComfortSilenceBlock{};
+
+	/** The spans output from the most recent call to Process */
+	TArray<FVoiceAudioSpan> OutputSpans{};
+};
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Voice/Capture/VoiceCaptureSubscription.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/ScopeLock.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Constructor
+ *
+ * @param InName [in] the name of the subscriber. Used for logging
+ * @param InMaxQueuedBytes [in] the maximum number of bytes that can be queued before backpressure applies
+ * @param InBackpressure [in] what to do when the queue is full
+ */
+FVoiceCaptureSubscription::FVoiceCaptureSubscription(const FName& InName, const int32 InMaxQueuedBytes, const EVoiceCaptureBackpressure InBackpressure)
+	: Name(InName)
+	, MaxQueuedBytes(InMaxQueuedBytes)
+	, Backpressure(InBackpressure)
+{
+	QueuedSpans.Reserve(8);
+}
+
+/**
+ * Read the next span of queued voice data and advance the read cursor past it. A span is never larger than a single
+ * captured block so consumers that need more data should call this repeatedly until it returns false
+ *
+ * @param OutSpan [out] the span that was read
+ * @param MaxBytes [in] the maximum number of bytes to read. Should be a multiple of the sample size
+ * @return true if any data was read
+ */
+bool FVoiceCaptureSubscription::Read(FVoiceAudioSpan& OutSpan, const int32 MaxBytes)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (QueuedSpans.Num() == 0 || MaxBytes <= 0)
+	{
+		OutSpan = FVoiceAudioSpan();
+		return false;
+	}
+
+	FVoiceAudioSpan& FrontSpan = QueuedSpans[0];
+
+	const bool bIsWholeSpanRead = FrontSpan.Num() <= MaxBytes;
+
+	if (bIsWholeSpanRead)
+	{
+		OutSpan = FrontSpan;
+		RemoveFrontSpans(1);
+	}
+	else
+	{
+		OutSpan = FVoiceAudioSpan(FrontSpan.Block, FrontSpan.Offset, MaxBytes);
+		FrontSpan = FVoiceAudioSpan(FrontSpan.Block, FrontSpan.Offset + MaxBytes, FrontSpan.NumBytes - MaxBytes);
+	}
+
+	NumQueuedBytes -= OutSpan.Num();
+
+	return true;
+}
+
+/**
+ * Discard all queued voice data
+ */
+void FVoiceCaptureSubscription::Flush()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	QueuedSpans.Reset();
+	NumQueuedBytes = 0;
+}
+
+/**
+ * Get the number of bytes waiting to be read
+ *
+ * @return the number of bytes
+ */
+int32 FVoiceCaptureSubscription::GetNumQueuedBytes() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return NumQueuedBytes;
+}
+
+/**
+ * Get the total number of bytes discarded due to backpressure since the subscription was last started
+ *
+ * @return the number of bytes
+ */
+int64 FVoiceCaptureSubscription::GetNumDroppedBytes() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return NumDroppedBytes;
+}
+
+/**
+ * Is the subscription currently receiving voice data?
+ *
+ * @return true if active
+ */
+bool FVoiceCaptureSubscription::IsActive() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return bIsActive;
+}
+
+/**
+ * Get the name of the subscriber
+ *
+ * @return the name
+ */
+const FName& FVoiceCaptureSubscription::GetName() const
+{
+	return Name;
+}
+
+/**
+ * Set whether the subscription is receiving voice data. Any queued data is discarded
+ *
+ * @param bIsNewActive [in] whether the subscription should be active
+ */
+void FVoiceCaptureSubscription::SetActive(const bool bIsNewActive)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (!bIsNewActive && NumDroppedBytes > 0)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("VoiceCaptureSubscription - SetActive: subscriber (%s) dropped (%lld) bytes"), *Name.ToString(), NumDroppedBytes);
+	}
+
+	bIsActive = bIsNewActive;
+
+	QueuedSpans.Reset();
+	NumQueuedBytes = 0;
+
+	if (bIsNewActive)
+	{
+		NumDroppedBytes = 0;
+	}
+}
+
+/**
+ * Queue newly captured voice data applying the backpressure policy if the consumer has fallen behind
+ *
+ * @param Span [in] the span to queue
+ */
+void FVoiceCaptureSubscription::Push(const FVoiceAudioSpan& Span)
+{
+	if (Span.IsEmpty())
+	{
+		return;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (!bIsActive)
+	{
+		return;
+	}
+
+	const bool bIsQueueFull = Backpressure != EVoiceCaptureBackpressure::Unbounded && NumQueuedBytes + Span.Num() > MaxQueuedBytes;
+
+	if (!bIsQueueFull)
+	{
+		QueuedSpans.Add(Span);
+		NumQueuedBytes += Span.Num();
+		return;
+	}
+
+	if (Backpressure == EVoiceCaptureBackpressure::DropNewest)
+	{
+		UE_LOG(LogWit, VeryVerbose, TEXT("VoiceCaptureSubscription - Push: subscriber (%s) is full - dropping (%d) new bytes"), *Name.ToString(), Span.Num());
+
+		NumDroppedBytes += Span.Num();
+		return;
+	}
+
+	// Drop whole spans from the front until the new span fits. If the new span is larger than the whole queue then we
+	// keep only its most recent samples
+
+	int32 NumSpansToDrop = 0;
+	int32 NumBytesToDrop = 0;
+
+	while (NumSpansToDrop < QueuedSpans.Num() && NumQueuedBytes - NumBytesToDrop + Span.Num() > MaxQueuedBytes)
+	{
+		NumBytesToDrop += QueuedSpans[NumSpansToDrop].Num();
+		++NumSpansToDrop;
+	}
+
+	UE_LOG(LogWit, VeryVerbose, TEXT("VoiceCaptureSubscription - Push: subscriber (%s) is full - dropping (%d) old bytes"), *Name.ToString(), NumBytesToDrop);
+
+	RemoveFrontSpans(NumSpansToDrop);
+	NumQueuedBytes -= NumBytesToDrop;
+	NumDroppedBytes += NumBytesToDrop;
+
+	const int32 NumExcessBytes = Align(FMath::Max(Span.Num() - MaxQueuedBytes, 0), sizeof(int16));
+
+	if (NumExcessBytes >= Span.Num())
+	{
+		NumDroppedBytes += Span.Num();
+		return;
+	}
+
+	QueuedSpans.Add(FVoiceAudioSpan(Span.Block, Span.Offset + NumExcessBytes, Span.Num() - NumExcessBytes));
+	NumQueuedBytes += Span.Num() - NumExcessBytes;
+	NumDroppedBytes += NumExcessBytes;
+}
+
+/**
+ * Remove spans from the front of the queue. Releasing the spans allows their blocks to return to the capture pool
+ *
+ * @param NumSpans [in] the number of spans to remove
+ */
+void FVoiceCaptureSubscription::RemoveFrontSpans(const int32 NumSpans)
+{
+	if (NumSpans <= 0)
+	{
+		return;
+	}
+
+#if UE_VERSION_OLDER_THAN(5,4,0)
+	QueuedSpans.RemoveAt(0, NumSpans, false);
+#else
+	QueuedSpans.RemoveAt(0, NumSpans, EAllowShrinking::No);
+#endif
+}
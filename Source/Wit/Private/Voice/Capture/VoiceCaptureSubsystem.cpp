@@ -174,7 +174,7 @@ bool UVoiceCaptureSubsystem::CreateVoiceCapture()
 	VoiceCapture->DumpState();
 
 	MaxBufferSize = VoiceCapture->GetBufferSize();
-	VoiceBuffer.Reserve(MaxBufferSize);
+	CreateVoiceBlockPool();
 
 	UE_LOG(LogWit, Verbose, TEXT("CreateVoiceCapture: voice capture is ready with max buffer size (%d)"), MaxBufferSize);
 
@@ -191,20 +191,46 @@ void UVoiceCaptureSubsystem::CreateEmulationVoiceCapture()
 	{
 		const TSharedPtr<FVoiceCaptureEmulation> VoiceCaptureEmulation = MakeShared<FVoiceCaptureEmulation>();
 		VoiceCaptureEmulation->SetSoundWave(EmulationCaptureSoundWave);
+		VoiceCaptureEmulation->SetSpeed(EmulationCaptureSpeed);
 		EmulationVoiceCapture = VoiceCaptureEmulation;
 	}
 	else
 	{
 		const TSharedPtr<FVoiceCaptureEmulationByTts> VoiceCaptureEmulationByTts = MakeShared<FVoiceCaptureEmulationByTts>();
 		VoiceCaptureEmulationByTts->SetTtsExperienceTag(TtsExperienceTag);
+		VoiceCaptureEmulationByTts->SetSpeed(EmulationCaptureSpeed);
 		EmulationVoiceCapture = VoiceCaptureEmulationByTts;
 	}
+
+	// The buffer size of the emulation depends on its format and speed so these must be set first
+
+	EmulationVoiceCapture->Init(TEXT(""), SampleRate, NumChannels);
 	MaxBufferSize = EmulationVoiceCapture->GetBufferSize();
-	VoiceBuffer.Reserve(MaxBufferSize);
+	CreateVoiceBlockPool();
 
 	VoiceCapture = EmulationVoiceCapture;
 }
 
+/**
+ * Create the pool of blocks that voice data is read into. Blocks are recycled once every consumer has finished with them
+ * so after the first few frames no further allocations are needed
+ */
+void UVoiceCaptureSubsystem::CreateVoiceBlockPool()
+{
+	const bool bIsExistingPoolSuitable = VoiceBlockPool.IsValid() && VoiceBlockPool->GetBlockSize() == MaxBufferSize;
+
+	if (bIsExistingPoolSuitable)
+	{
+		return;
+	}
+
+	constexpr int32 NumInitialBlocks = 8;
+
+	VoiceBlockPool = MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(MaxBufferSize);
+	VoiceBlockPool->Reserve(NumInitialBlocks);
+	VoiceBlock.SafeRelease();
+}
+
 /**
  * Resets the voice capture after finishing. After calling this it is no longer valid to call Start/Read/Stop
  */
@@ -221,6 +247,11 @@ void UVoiceCaptureSubsystem::Shutdown()
 		VoiceCapture->Stop();
 	}
 
+	for (const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription : Subscriptions)
+	{
+		Subscription->SetActive(false);
+	}
+
 	VoiceCapture->Shutdown();
 	VoiceCapture.Reset();
 
@@ -228,9 +259,49 @@ void UVoiceCaptureSubsystem::Shutdown()
 }
 
 /**
- * Indicates that we want to start receiving data from the voice capture module
+ * Create a new subscription to the voice capture. The subscription does not receive any data until it is started
+ *
+ * @param Name [in] the name of the subscriber. Used for logging
+ * @param MaxQueuedBytes [in] the maximum number of bytes that can be queued before backpressure applies
+ * @param Backpressure [in] what to do when the subscriber falls behind
+ * @return the new subscription
  */
-bool UVoiceCaptureSubsystem::Start()
+TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe> UVoiceCaptureSubsystem::Subscribe(const FName& Name, const int32 MaxQueuedBytes, const EVoiceCaptureBackpressure Backpressure)
+{
+	const TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe> Subscription = MakeShared<FVoiceCaptureSubscription, ESPMode::ThreadSafe>(Name, MaxQueuedBytes, Backpressure);
+
+	Subscriptions.Add(Subscription);
+
+	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Subscribe: added subscriber (%s) - total subscribers (%d)"), *Name.ToString(), Subscriptions.Num());
+
+	return Subscription;
+}
+
+/**
+ * Remove a subscription. The subscription is stopped if it is still active
+ *
+ * @param Subscription [in] the subscription to remove
+ */
+void UVoiceCaptureSubsystem::Unsubscribe(const TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription)
+{
+	if (Subscription->IsActive())
+	{
+		Stop(Subscription);
+	}
+
+	Subscriptions.Remove(Subscription);
+
+	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Unsubscribe: removed subscriber (%s) - total subscribers (%d)"), *Subscription->GetName().ToString(), Subscriptions.Num());
+}
+
+/**
+ * Indicates that a subscription wants to start receiving data from the voice capture module. The device itself is only
+ * started if it is not already capturing for another subscription
+ *
+ * @param Subscription [in] the subscription to start
+ * @return true if successfully started
+ */
+bool UVoiceCaptureSubsystem::Start(const TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription)
 {
 	if (!IsCaptureAvailable())
 	{
@@ -238,16 +309,31 @@ bool UVoiceCaptureSubsystem::Start()
 		return false;
 	}
 
-	if (IsCapturing())
+	if (Subscription->IsActive())
 	{
-		UE_LOG(LogWit, Warning, TEXT("VoiceCapture - Start: attempting to start capture when it has already been started"));
+		UE_LOG(LogWit, Warning, TEXT("VoiceCapture - Start: attempting to start subscriber (%s) when it has already been started"), *Subscription->GetName().ToString());
 		return false;
 	}
 
-	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Start: starting capture"));
+	if (!IsCapturing())
+	{
+		UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Start: starting capture"));
+
+		VoiceBlock.SafeRelease();
+
+		const bool bIsCaptureStarted = VoiceCapture->Start();
+
+		if (!bIsCaptureStarted)
+		{
+			return false;
+		}
+	}
+
+	Subscription->SetActive(true);
 
-	VoiceBuffer.Reset();
-	return VoiceCapture->Start();
+	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Start: started subscriber (%s) - active subscribers (%d)"), *Subscription->GetName().ToString(), GetNumActiveSubscriptions());
+
+	return true;
 }
 
 /**
@@ -258,6 +344,18 @@ bool UVoiceCaptureSubsystem::Start()
  */
 bool UVoiceCaptureSubsystem::Read()
 {
+	// Every consumer calls Read each frame but we only want to pull from the device once and share the result
+
+	const bool bIsAlreadyReadThisFrame = LastReadFrameNumber == GFrameCounter;
+
+	if (bIsAlreadyReadThisFrame)
+	{
+		return bWasDataReadOnLastFrame;
+	}
+
+	LastReadFrameNumber = GFrameCounter;
+	bWasDataReadOnLastFrame = false;
+
 	if (!IsCaptureAvailable())
 	{
 		UE_LOG(LogWit, Warning, TEXT("VoiceCapture - Read: voice capture ptr is not valid. Make sure it is setup correctly"));
@@ -305,10 +403,11 @@ bool UVoiceCaptureSubsystem::Read()
 	{
 		UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Read: discarding (%u) noise bytes"), NumAvailableBytes);
 
-		VoiceBuffer.Reset();
-		VoiceBuffer.AddUninitialized(MaxBufferSize);
+		const FVoiceAudioBlockRef DiscardBlock = VoiceBlockPool->Acquire();
 		
-		VoiceCapture->GetVoiceData(VoiceBuffer.GetData(), VoiceBuffer.Num(), NumOutputBytes);
+		VoiceCapture->GetVoiceData(DiscardBlock->GetData(), DiscardBlock->GetCapacity(), NumOutputBytes);
+
+		VoiceBlock.SafeRelease();
 
 		return false;
 	}
@@ -324,38 +423,85 @@ bool UVoiceCaptureSubsystem::Read()
 		NumAvailableBytes = MaxBufferSize;
 	}
 
-	// Set our buffer to the required size before reading in the data
+	// Read directly into a fresh block. Any consumers still holding the previous block keep it alive until they are done
 
-	VoiceBuffer.Reset();
-	VoiceBuffer.AddUninitialized(NumAvailableBytes);
+	VoiceBlock = VoiceBlockPool->Acquire();
 
-	VoiceCapture->GetVoiceData(VoiceBuffer.GetData(), VoiceBuffer.Num(), NumOutputBytes);
+	VoiceCapture->GetVoiceData(VoiceBlock->GetData(), NumAvailableBytes, NumOutputBytes);
+	VoiceBlock->SetNum(NumOutputBytes);
 
 	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Read: read (%u) bytes, output (%u) bytes"), NumAvailableBytes, NumOutputBytes);
 
+	bWasDataReadOnLastFrame = NumOutputBytes > 0;
+
+	if (!bWasDataReadOnLastFrame)
+	{
+		return false;
+	}
+
+	// Fan the block out to every subscriber. They each hold a reference so the block is only recycled once all are done with it
+
+	const FVoiceAudioSpan VoiceSpan(VoiceBlock);
+
+	for (const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription : Subscriptions)
+	{
+		Subscription->Push(VoiceSpan);
+	}
+
 	return true;
 }
 
 /**
- * Stop receiving voice capture data
+ * Stop delivering voice data to a subscription. The device is stopped once no subscriptions remain active
+ *
+ * @param Subscription [in] the subscription to stop
  */
-void UVoiceCaptureSubsystem::Stop()
+void UVoiceCaptureSubsystem::Stop(const TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription)
 {
+	if (!Subscription->IsActive())
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoiceCapture - Stop: attempting to stop subscriber (%s) before it has been started"), *Subscription->GetName().ToString());
+		return;
+	}
+
+	Subscription->SetActive(false);
+
+	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Stop: stopped subscriber (%s) - active subscribers (%d)"), *Subscription->GetName().ToString(), GetNumActiveSubscriptions());
+
 	if (!IsCaptureAvailable())
 	{
 		UE_LOG(LogWit, Warning, TEXT("VoiceCapture - Stop: voice capture ptr is not valid. Make sure it is setup correctly"));
 		return;
 	}
 
-	if (!IsCapturing())
+	const bool bShouldStopCapture = IsCapturing() && GetNumActiveSubscriptions() == 0;
+
+	if (bShouldStopCapture)
 	{
-		UE_LOG(LogWit, Warning, TEXT("VoiceCapture - Stop: attempting to stop before capture has been started"));
-		return;
+		VoiceCapture->Stop();
+
+		UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Stop: stopping capture"));
 	}
+}
 
-	VoiceCapture->Stop();
+/**
+ * Get the number of subscriptions currently receiving voice data
+ *
+ * @return the number of active subscriptions
+ */
+int32 UVoiceCaptureSubsystem::GetNumActiveSubscriptions() const
+{
+	int32 NumActiveSubscriptions = 0;
 
-	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - Stop: stopping capture"));
+	for (const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription : Subscriptions)
+	{
+		if (Subscription->IsActive())
+		{
+			++NumActiveSubscriptions;
+		}
+	}
+
+	return NumActiveSubscriptions;
 }
 
 /**
@@ -383,7 +529,9 @@ float UVoiceCaptureSubsystem::GetCurrentAmplitude() const
 	// On some platforms the amplitude is not available. This seems to apply to the Android voice implementation. As a fallback we
 	// scan the current voice buffer and find the highest amplitude currently in the buffer
 
+	const TArrayView<const uint8> VoiceBuffer = GetVoiceBuffer();
 	const int32 NumSamples = VoiceBuffer.Num() / sizeof(int16);
+
 	return FWitConversionUtilities::CalculateMaximumAmplitude16Bit(VoiceBuffer.GetData(), NumSamples);
 }
 
@@ -410,21 +558,37 @@ bool UVoiceCaptureSubsystem::IsCapturing() const
 /**
  * Get read access to the latest voice data
  *
- * @return reference to the voice data
+ * @return view of the voice data
+ */
+TArrayView<const uint8> UVoiceCaptureSubsystem::GetVoiceBuffer() const
+{
+	if (!VoiceBlock.IsValid())
+	{
+		return TArrayView<const uint8>();
+	}
+
+	return TArrayView<const uint8>(VoiceBlock->GetData(), VoiceBlock->Num());
+}
+
+/**
+ * Get a shared reference to the block holding the latest voice data
+ *
+ * @return the block or an invalid reference if no data has been read
  */
-const TArray<uint8>& UVoiceCaptureSubsystem::GetVoiceBuffer() const
+const FVoiceAudioBlockRef& UVoiceCaptureSubsystem::GetVoiceBlock() const
 {
-	return VoiceBuffer;
+	return VoiceBlock;
 }
 
 /**
  * Enable use of the null capture
  */
-void UVoiceCaptureSubsystem::EnableEmulation(EVoiceCaptureEmulationMode EmulationModeToUse, USoundWave* SoundWaveToUse, const FName& TtsExperienceTagToUse)
+void UVoiceCaptureSubsystem::EnableEmulation(EVoiceCaptureEmulationMode EmulationModeToUse, USoundWave* SoundWaveToUse, const FName& TtsExperienceTagToUse, const float SpeedToUse)
 {
 	EmulationCaptureMode = EmulationModeToUse;
 	EmulationCaptureSoundWave = SoundWaveToUse;
 	TtsExperienceTag = TtsExperienceTagToUse;
+	EmulationCaptureSpeed = SpeedToUse;
 }
 
 /**
@@ -434,7 +598,16 @@ void UVoiceCaptureSubsystem::OnApplicationWillEnterBackground()
 {
 	UE_LOG(LogWit, Verbose, TEXT("VoiceCapture - OnApplicationWillEnterBackground"));
 
-	Stop();
+	if (IsCapturing())
+	{
+		VoiceCapture->Stop();
+	}
+
+	for (const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription : Subscriptions)
+	{
+		Subscription->SetActive(false);
+	}
+
 	VoiceCapture.Reset();
 }
 
@@ -0,0 +1,537 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Voice/Input/VoicePushInput.h"
+#include "Misc/ScopeLock.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+#include "Voice/Capture/VoiceCaptureSubscription.h"
+#include "Wit/Utilities/WitLog.h"
+
+namespace
+{
+	/** The sample rate Wit.ai is streamed at. Matches the voice capture */
+	constexpr int32 OutputSampleRate = 16000;
+
+	/** Size in bytes of each block of converted data. 100ms of output */
+	constexpr int32 OutputBlockSize = OutputSampleRate / 10 * sizeof(int16);
+
+	/** The most converted data we will queue before dropping new data. Longer than the longest allowed request */
+	constexpr int32 MaxQueuedDuration = 30;
+
+	/** Timestamps within this many seconds of the expected time are treated as contiguous */
+	constexpr double TimestampTolerance = 0.02;
+
+	/** The longest gap in seconds we will fill with silence when timestamps jump forward */
+	constexpr double MaximumGapDuration = 1.0;
+}
+
+/**
+ * Create a push input. The requested format is negotiated to the nearest format we support
+ *
+ * @param RequestedFormat [in] the format the caller would like to push
+ * @return the push input. Use GetFormat to find the format that must actually be pushed
+ */
+TSharedRef<FVoicePushInput, ESPMode::ThreadSafe> FVoicePushInput::Create(const FVoicePushFormat& RequestedFormat)
+{
+	FVoicePushFormat NegotiatedFormat{};
+
+	const bool bIsRequestedFormatSupported = NegotiateFormat(RequestedFormat, NegotiatedFormat);
+
+	if (!bIsRequestedFormatSupported)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoicePushInput - Create: requested format (%d Hz, %d channels) is not supported - using (%d Hz, %d channels)"),
+			RequestedFormat.SampleRate, RequestedFormat.NumChannels, NegotiatedFormat.SampleRate, NegotiatedFormat.NumChannels);
+	}
+
+	return MakeShared<FVoicePushInput, ESPMode::ThreadSafe>(NegotiatedFormat);
+}
+
+/**
+ * Negotiate a format against what we support. Any sample rate and channel count within our limits is accepted and converted
+ * to the streamed format internally
+ *
+ * @param RequestedFormat [in] the format the caller would like to push
+ * @param OutFormat [out] the nearest supported format
+ * @return true if the requested format is supported as is
+ */
+bool FVoicePushInput::NegotiateFormat(const FVoicePushFormat& RequestedFormat, FVoicePushFormat& OutFormat)
+{
+	OutFormat.SampleRate = FMath::Clamp(RequestedFormat.SampleRate, MinimumSampleRate, MaximumSampleRate);
+	OutFormat.NumChannels = FMath::Clamp(RequestedFormat.NumChannels, 1, MaximumNumChannels);
+	OutFormat.SampleFormat = RequestedFormat.SampleFormat;
+
+	return OutFormat.SampleRate == RequestedFormat.SampleRate && OutFormat.NumChannels == RequestedFormat.NumChannels;
+}
+
+/**
+ * Constructor
+ *
+ * @param InFormat [in] the format that will be pushed. This should already have been negotiated
+ */
+FVoicePushInput::FVoicePushInput(const FVoicePushFormat& InFormat)
+	: Format(InFormat)
+{
+	constexpr int32 MaxQueuedBytes = OutputSampleRate * sizeof(int16) * MaxQueuedDuration;
+
+	BlockPool = MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(OutputBlockSize);
+	Subscription = MakeShared<FVoiceCaptureSubscription, ESPMode::ThreadSafe>(TEXT("VoicePushInput"), MaxQueuedBytes, EVoiceCaptureBackpressure::DropNewest);
+	Subscription->SetActive(true);
+
+	CreateLowPassFilter();
+}
+
+/**
+ * Design the low pass filter used to prevent aliasing when downsampling. Linear interpolation alone folds everything above
+ * the output Nyquist frequency back into the speech band so we first remove it with a Blackman windowed sinc filter. The
+ * filter length scales with the downsampling ratio to keep the transition band the same width at the output rate
+ */
+void FVoicePushInput::CreateLowPassFilter()
+{
+	const bool bIsDownsampling = Format.SampleRate > OutputSampleRate;
+
+	if (!bIsDownsampling)
+	{
+		return;
+	}
+
+	const double Ratio = static_cast<double>(Format.SampleRate) / OutputSampleRate;
+	const double Cutoff = 0.45 / Ratio;
+	const int32 NumTaps = 2 * FMath::CeilToInt(8.0 * Ratio) + 1;
+	const double Center = (NumTaps - 1) / 2.0;
+
+	LowPassTaps.SetNumUninitialized(NumTaps);
+
+	double Sum = 0.0;
+
+	for (int32 TapIndex = 0; TapIndex < NumTaps; ++TapIndex)
+	{
+		const double Offset = TapIndex - Center;
+		const double Sinc = Offset == 0.0 ? 2.0 * Cutoff : FMath::Sin(2.0 * PI * Cutoff * Offset) / (PI * Offset);
+		const double Phase = 2.0 * PI * TapIndex / (NumTaps - 1);
+		const double Window = 0.42 - 0.5 * FMath::Cos(Phase) + 0.08 * FMath::Cos(2.0 * Phase);
+
+		LowPassTaps[TapIndex] = static_cast<float>(Sinc * Window);
+		Sum += Sinc * Window;
+	}
+
+	// Normalize so that the filter has unity gain at DC
+
+	for (float& Tap : LowPassTaps)
+	{
+		Tap = static_cast<float>(Tap / Sum);
+	}
+
+	LowPassHistory.SetNumZeroed(NumTaps - 1);
+}
+
+/**
+ * Destructor
+ */
+FVoicePushInput::~FVoicePushInput()
+{
+	// Deliberately empty
+}
+
+/**
+ * Push interleaved 16-bit samples. Can be called from any thread
+ *
+ * @param Samples [in] the samples to push. Must be a whole number of frames
+ * @param Timestamp [in] the time in seconds of the first frame relative to the start of the stream or a negative value if unknown
+ * @return true if the samples were accepted
+ */
+bool FVoicePushInput::Push(TArrayView<const int16> Samples, const double Timestamp)
+{
+	if (Format.SampleFormat != EVoicePushSampleFormat::Int16)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoicePushInput - Push: 16-bit samples pushed but the negotiated format is floating point"));
+		return false;
+	}
+
+	if (Samples.Num() % Format.NumChannels != 0)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoicePushInput - Push: (%d) samples is not a whole number of frames"), Samples.Num());
+		return false;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (bIsEndOfStream)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoicePushInput - Push: attempting to push after the end of the stream"));
+		return false;
+	}
+
+	const int32 NumFrames = Samples.Num() / Format.NumChannels;
+
+	// Data that is already in the streamed format does not need converting so we queue it directly
+
+	const bool bIsStreamedFormat = Format.SampleRate == OutputSampleRate && Format.NumChannels == 1;
+
+	if (bIsStreamedFormat && Timestamp < 0.0)
+	{
+		int32 MaximumSample = 0;
+
+		for (const int16 Sample : Samples)
+		{
+			MaximumSample = FMath::Max(MaximumSample, FMath::Abs(static_cast<int32>(Sample)));
+		}
+
+		CurrentAmplitude = MaximumSample / 32768.0f;
+		StreamTime += static_cast<double>(NumFrames) / Format.SampleRate;
+
+		WriteOutput(Samples.GetData(), NumFrames);
+
+		return true;
+	}
+
+	if (MonoFrames.Num() < NumFrames)
+	{
+		MonoFrames.SetNumUninitialized(NumFrames);
+	}
+
+	const float Scale = 1.0f / (32768.0f * Format.NumChannels);
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		int32 Sum = 0;
+
+		for (int32 ChannelIndex = 0; ChannelIndex < Format.NumChannels; ++ChannelIndex)
+		{
+			Sum += Samples[FrameIndex * Format.NumChannels + ChannelIndex];
+		}
+
+		MonoFrames[FrameIndex] = Sum * Scale;
+	}
+
+	PushMono(MonoFrames.GetData(), NumFrames, Timestamp);
+
+	return true;
+}
+
+/**
+ * Push interleaved floating point samples in the range [-1,1]. Can be called from any thread
+ *
+ * @param Samples [in] the samples to push. Must be a whole number of frames
+ * @param Timestamp [in] the time in seconds of the first frame relative to the start of the stream or a negative value if unknown
+ * @return true if the samples were accepted
+ */
+bool FVoicePushInput::Push(TArrayView<const float> Samples, const double Timestamp)
+{
+	if (Format.SampleFormat != EVoicePushSampleFormat::Float32)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoicePushInput - Push: floating point samples pushed but the negotiated format is 16-bit"));
+		return false;
+	}
+
+	if (Samples.Num() % Format.NumChannels != 0)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoicePushInput - Push: (%d) samples is not a whole number of frames"), Samples.Num());
+		return false;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	if (bIsEndOfStream)
+	{
+		UE_LOG(LogWit, Warning, TEXT("VoicePushInput - Push: attempting to push after the end of the stream"));
+		return false;
+	}
+
+	const int32 NumFrames = Samples.Num() / Format.NumChannels;
+
+	if (Format.NumChannels == 1)
+	{
+		PushMono(Samples.GetData(), NumFrames, Timestamp);
+		return true;
+	}
+
+	if (MonoFrames.Num() < NumFrames)
+	{
+		MonoFrames.SetNumUninitialized(NumFrames);
+	}
+
+	const float Scale = 1.0f / Format.NumChannels;
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		float Sum = 0.0f;
+
+		for (int32 ChannelIndex = 0; ChannelIndex < Format.NumChannels; ++ChannelIndex)
+		{
+			Sum += Samples[FrameIndex * Format.NumChannels + ChannelIndex];
+		}
+
+		MonoFrames[FrameIndex] = Sum * Scale;
+	}
+
+	PushMono(MonoFrames.GetData(), NumFrames, Timestamp);
+
+	return true;
+}
+
+/**
+ * Push mono floating point frames that have already been downmixed. If a timestamp is given it is compared with the
+ * current stream time. Gaps, such as from lost VOIP packets, are filled with silence and frames that overlap data we
+ * have already received are skipped
+ *
+ * @param Frames [in] the frames to push
+ * @param NumFrames [in] the number of frames
+ * @param Timestamp [in] the time in seconds of the first frame or a negative value if unknown
+ */
+void FVoicePushInput::PushMono(const float* Frames, const int32 NumFrames, const double Timestamp)
+{
+	int32 NumFramesToSkip = 0;
+
+	const bool bIsTimestamped = Timestamp >= 0.0;
+	const double Drift = bIsTimestamped ? Timestamp - StreamTime : 0.0;
+
+	if (Drift > TimestampTolerance)
+	{
+		const double GapDuration = FMath::Min(Drift, MaximumGapDuration);
+
+		UE_LOG(LogWit, Verbose, TEXT("VoicePushInput - PushMono: filling (%f) second gap with silence"), GapDuration);
+
+		WriteSilence(FMath::RoundToInt(GapDuration * OutputSampleRate));
+		StreamTime = Timestamp;
+	}
+	else if (Drift < -TimestampTolerance)
+	{
+		NumFramesToSkip = FMath::Min(FMath::RoundToInt(-Drift * Format.SampleRate), NumFrames);
+
+		UE_LOG(LogWit, Verbose, TEXT("VoicePushInput - PushMono: skipping (%d) overlapping frames"), NumFramesToSkip);
+	}
+
+	const int32 NumFramesToWrite = NumFrames - NumFramesToSkip;
+
+	if (NumFramesToWrite <= 0)
+	{
+		return;
+	}
+
+	float MaximumSample = 0.0f;
+
+	for (int32 FrameIndex = NumFramesToSkip; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		MaximumSample = FMath::Max(MaximumSample, FMath::Abs(Frames[FrameIndex]));
+	}
+
+	CurrentAmplitude = FMath::Min(MaximumSample, 1.0f);
+	StreamTime += static_cast<double>(NumFramesToWrite) / Format.SampleRate;
+
+	WriteMono(Frames + NumFramesToSkip, NumFramesToWrite);
+}
+
+/**
+ * Resample, convert and queue mono floating point frames. When downsampling the frames are first low pass filtered so
+ * that content above the output Nyquist frequency does not alias into the speech band. Resampling then uses linear
+ * interpolation, which is sufficient once the filtered signal is band limited. The filter history and read position are
+ * carried across pushes so that arbitrary push sizes produce a continuous stream
+ *
+ * @param Frames [in] the frames to write
+ * @param NumFrames [in] the number of frames
+ */
+void FVoicePushInput::WriteMono(const float* Frames, const int32 NumFrames)
+{
+	const double Step = static_cast<double>(Format.SampleRate) / OutputSampleRate;
+	const int32 MaxOutputSamples = FMath::CeilToInt(NumFrames / Step) + 2;
+
+	if (OutputSamples.Num() < MaxOutputSamples)
+	{
+		OutputSamples.SetNumUninitialized(MaxOutputSamples);
+	}
+
+	int32 NumOutputSamples = 0;
+
+	if (Format.SampleRate == OutputSampleRate)
+	{
+		for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			OutputSamples[NumOutputSamples++] = static_cast<int16>(FMath::Clamp(Frames[FrameIndex], -1.0f, 1.0f) * 32767.0f);
+		}
+	}
+	else
+	{
+		const int32 NumTaps = LowPassTaps.Num();
+		const float* ResampleFrames = Frames;
+
+		if (NumTaps > 0)
+		{
+			const int32 NumHistoryFrames = LowPassHistory.Num();
+			const int32 NumInputFrames = NumHistoryFrames + NumFrames;
+
+			if (FilterInput.Num() < NumInputFrames)
+			{
+				FilterInput.SetNumUninitialized(NumInputFrames);
+			}
+
+			if (FilteredFrames.Num() < NumFrames)
+			{
+				FilteredFrames.SetNumUninitialized(NumFrames);
+			}
+
+			FMemory::Memcpy(FilterInput.GetData(), LowPassHistory.GetData(), NumHistoryFrames * sizeof(float));
+			FMemory::Memcpy(FilterInput.GetData() + NumHistoryFrames, Frames, NumFrames * sizeof(float));
+
+			for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+			{
+				const float* Input = FilterInput.GetData() + FrameIndex;
+				float Sample = 0.0f;
+
+				for (int32 TapIndex = 0; TapIndex < NumTaps; ++TapIndex)
+				{
+					Sample += LowPassTaps[TapIndex] * Input[TapIndex];
+				}
+
+				FilteredFrames[FrameIndex] = Sample;
+			}
+
+			FMemory::Memcpy(LowPassHistory.GetData(), FilterInput.GetData() + NumFrames, NumHistoryFrames * sizeof(float));
+
+			ResampleFrames = FilteredFrames.GetData();
+		}
+
+		// Position -1 refers to the last frame of the previous push
+
+		while (true)
+		{
+			const int32 Index = FMath::FloorToInt(ResamplePosition);
+
+			if (Index + 1 >= NumFrames)
+			{
+				break;
+			}
+
+			const float From = Index < 0 ? PreviousFrame : ResampleFrames[Index];
+			const float To = ResampleFrames[Index + 1];
+			const float Sample = FMath::Lerp(From, To, static_cast<float>(ResamplePosition - Index));
+
+			OutputSamples[NumOutputSamples++] = static_cast<int16>(FMath::Clamp(Sample, -1.0f, 1.0f) * 32767.0f);
+			ResamplePosition += Step;
+		}
+
+		ResamplePosition -= NumFrames;
+		PreviousFrame = ResampleFrames[NumFrames - 1];
+	}
+
+	WriteOutput(OutputSamples.GetData(), NumOutputSamples);
+}
+
+/**
+ * Queue the given number of frames of silence at the output sample rate
+ *
+ * @param NumOutputFrames [in] the number of frames of silence
+ */
+void FVoicePushInput::WriteSilence(const int32 NumOutputFrames)
+{
+	const int32 BlockNumSamples = BlockPool->GetBlockSize() / sizeof(int16);
+	int32 NumSamplesWritten = 0;
+
+	while (NumSamplesWritten < NumOutputFrames)
+	{
+		const int32 NumSamplesToWrite = FMath::Min(BlockNumSamples, NumOutputFrames - NumSamplesWritten);
+		const int32 NumBytesToWrite = NumSamplesToWrite * sizeof(int16);
+		const FVoiceAudioBlockRef Block = BlockPool->Acquire();
+
+		FMemory::Memzero(Block->GetData(), NumBytesToWrite);
+		Block->SetNum(NumBytesToWrite);
+
+		Subscription->Push(FVoiceAudioSpan(Block));
+
+		NumSamplesWritten += NumSamplesToWrite;
+	}
+}
+
+/**
+ * Queue output samples. The samples are split across as many blocks as needed
+ *
+ * @param Samples [in] the samples to queue
+ * @param NumSamples [in] the number of samples
+ */
+void FVoicePushInput::WriteOutput(const int16* Samples, const int32 NumSamples)
+{
+	const TArrayView<const uint8> Data(reinterpret_cast<const uint8*>(Samples), NumSamples * sizeof(int16));
+	const int32 BlockSize = BlockPool->GetBlockSize();
+	int32 NumBytesWritten = 0;
+
+	while (NumBytesWritten < Data.Num())
+	{
+		const int32 NumBytesToWrite = FMath::Min(BlockSize, Data.Num() - NumBytesWritten);
+		const FVoiceAudioBlockRef Block = BlockPool->Acquire(Data.Slice(NumBytesWritten, NumBytesToWrite));
+
+		Subscription->Push(FVoiceAudioSpan(Block));
+
+		NumBytesWritten += NumBytesToWrite;
+	}
+}
+
+/**
+ * Indicate that no more data will be pushed
+ */
+void FVoicePushInput::EndOfStream()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	UE_LOG(LogWit, Verbose, TEXT("VoicePushInput - EndOfStream: stream ended after (%f) seconds"), StreamTime);
+
+	bIsEndOfStream = true;
+}
+
+/**
+ * Has the end of the stream been reached?
+ *
+ * @return true if EndOfStream has been called
+ */
+bool FVoicePushInput::IsEndOfStream() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return bIsEndOfStream;
+}
+
+/**
+ * Get the format that must be pushed
+ *
+ * @return the negotiated format
+ */
+const FVoicePushFormat& FVoicePushInput::GetFormat() const
+{
+	return Format;
+}
+
+/**
+ * Get the amplitude of the most recently pushed data
+ *
+ * @return the amplitude in the range [0,1]
+ */
+float FVoicePushInput::GetCurrentAmplitude() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return CurrentAmplitude;
+}
+
+/**
+ * Get the stream time in seconds of the end of the most recently pushed data
+ *
+ * @return the time in seconds
+ */
+double FVoicePushInput::GetStreamTime() const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return StreamTime;
+}
+
+/**
+ * Get the queue that converted voice data is delivered to
+ *
+ * @return the subscription
+ */
+TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe> FVoicePushInput::GetSubscription() const
+{
+	return Subscription.ToSharedRef();
+}
@@ -56,3 +56,23 @@ void UVoiceIntentMatcher::OnWitResponse(const bool bIsSuccessful, const FWitResp
 
 	AcceptPartialResponse(Response);
 }
+
+/**
+ * The sections of a response that this matcher uses
+ *
+ * @return the sections as flags
+ */
+EWitResponseChange UVoiceIntentMatcher::GetRelevantResponseChanges() const
+{
+	return EWitResponseChange::Intents;
+}
+
+/**
+ * The intent that a response must have as its top intent for this matcher to match
+ *
+ * @return the intent name
+ */
+FString UVoiceIntentMatcher::GetRequiredIntentName() const
+{
+	return IntentName;
+}
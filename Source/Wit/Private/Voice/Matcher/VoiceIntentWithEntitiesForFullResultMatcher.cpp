@@ -135,3 +135,13 @@ void UVoiceIntentWithEntitiesForFullResultMatcher::OnWitResponse(const bool bIsS
 		}
 	}
 }
+
+/**
+ * The intent that a response must have as its top intent for this matcher to match
+ *
+ * @return the intent name or empty if the intent is not required
+ */
+FString UVoiceIntentWithEntitiesForFullResultMatcher::GetRequiredIntentName() const
+{
+	return bIsIntentRequired ? IntentName : FString();
+}
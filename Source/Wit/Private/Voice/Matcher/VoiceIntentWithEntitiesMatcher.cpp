@@ -128,3 +128,13 @@ void UVoiceIntentWithEntitiesMatcher::OnWitResponse(const bool bIsSuccessful, co
 		}
 	}
 }
+
+/**
+ * The intent that a response must have as its top intent for this matcher to match
+ *
+ * @return the intent name or empty if the intent is not required
+ */
+FString UVoiceIntentWithEntitiesMatcher::GetRequiredIntentName() const
+{
+	return bIsIntentRequired ? IntentName : FString();
+}
@@ -85,3 +85,13 @@ void UVoiceIntentWithEntityForFullResultMatcher::OnWitResponse(const bool bIsSuc
 		AcceptPartialResponse(Response);
 	}
 }
+
+/**
+ * The intent that a response must have as its top intent for this matcher to match
+ *
+ * @return the intent name or empty if the intent is not required
+ */
+FString UVoiceIntentWithEntityForFullResultMatcher::GetRequiredIntentName() const
+{
+	return bIsIntentRequired ? IntentName : FString();
+}
@@ -77,3 +77,13 @@ void UVoiceIntentWithEntityMatcher::OnWitResponse(const bool bIsSuccessful, cons
 		AcceptPartialResponse(Response);
 	}
 }
+
+/**
+ * The intent that a response must have as its top intent for this matcher to match
+ *
+ * @return the intent name or empty if the intent is not required
+ */
+FString UVoiceIntentWithEntityMatcher::GetRequiredIntentName() const
+{
+	return bIsIntentRequired ? IntentName : FString();
+}
@@ -6,6 +6,7 @@
  */
 
 #include "Voice/Matcher/VoiceResponseMatcher.h"
+#include "Voice/Events/VoiceEvents.h"
 #include "Wit/Utilities/WitHelperUtilities.h"
 #include "Wit/Utilities/WitLog.h"
 
@@ -19,7 +20,8 @@ UVoiceResponseMatcher::UVoiceResponseMatcher()
 }
 
 /**
- * Called when play is started. Registers with the UWitVoiceService so we receive a callback when a new response is received
+ * Called when play is started. Registers with the voice experience's matcher registry so we receive a callback when a new
+ * response that we might match is received
  */
 void UVoiceResponseMatcher::BeginPlay()
 {
@@ -39,12 +41,76 @@ void UVoiceResponseMatcher::BeginPlay()
 
 	UE_LOG(LogWit, Verbose, TEXT("UVoiceResponseMatcher: Registering response callback"));
 
-	VoiceExperience->VoiceEvents->OnWitResponse.AddUniqueDynamic(this, &UVoiceResponseMatcher::OnWitResponse);
-		
-	if (bIsAlsoUsedForPartialResponse)
+	VoiceEvents = VoiceExperience->VoiceEvents;
+	VoiceEvents->MatcherRegistry.Register(this);
+}
+
+/**
+ * Called when play ends. Unregisters from the voice experience's matcher registry
+ *
+ * @param EndPlayReason [in] why play ended
+ */
+void UVoiceResponseMatcher::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (VoiceEvents.IsValid())
+	{
+		VoiceEvents->MatcherRegistry.Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+/**
+ * Re-register this matcher with its voice experience so that it is indexed by its current intent
+ */
+void UVoiceResponseMatcher::UpdateRegistration()
+{
+	if (VoiceEvents.IsValid())
+	{
+		VoiceEvents->MatcherRegistry.Register(this);
+	}
+}
+
+/**
+ * The intent that a response must have as its top intent for this matcher to match. The base matcher does not know what
+ * its subclasses match so it must see every response
+ *
+ * @return the intent name or empty if the matcher must see every response
+ */
+FString UVoiceResponseMatcher::GetRequiredIntentName() const
+{
+	return FString();
+}
+
+/**
+ * Callback that is called when a Wit.ai partial response is received. Successive partial responses often only differ in the
+ * transcription so we skip matching unless a section of the response that the matcher uses has changed
+ * 
+ * @param bIsSuccessful [in] true if the response was successful
+ * @param Response [in] the partial response as a UStruct
+ */
+void UVoiceResponseMatcher::OnWitPartialResponse(const bool bIsSuccessful, const FWitResponse& Response)
+{
+	const EWitResponseChange Changes = VoiceEvents.IsValid() ? static_cast<EWitResponseChange>(VoiceEvents->WitResponseChanges) : GetRelevantResponseChanges();
+	const bool bHasRelevantChanges = EnumHasAnyFlags(Changes, GetRelevantResponseChanges());
+
+	if (!bHasRelevantChanges)
 	{
-		VoiceExperience->VoiceEvents->OnWitPartialResponse.AddUniqueDynamic(this, &UVoiceResponseMatcher::OnWitResponse);
+		UE_LOG(LogWit, VeryVerbose, TEXT("UVoiceResponseMatcher: no relevant changes in the partial response - skipping"));
+		return;
 	}
+
+	OnWitResponse(bIsSuccessful, Response);
+}
+
+/**
+ * The sections of a response that this matcher uses
+ *
+ * @return the sections as flags
+ */
+EWitResponseChange UVoiceResponseMatcher::GetRelevantResponseChanges() const
+{
+	return EWitResponseChange::Intents | EWitResponseChange::Entities;
 }
 
 /**
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Voice/Matcher/VoiceResponseMatcherRegistry.h"
+#include "Voice/Matcher/VoiceResponseMatcher.h"
+#include "Wit/Request/WitResponse.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Register a matcher. If the matcher is already registered it is re-indexed
+ *
+ * @param Matcher [in] the matcher to register
+ */
+void FVoiceResponseMatcherRegistry::Register(UVoiceResponseMatcher* Matcher)
+{
+	if (Matcher == nullptr)
+	{
+		return;
+	}
+
+	Unregister(Matcher);
+
+	// Names are interned when matchers register so responses can look them up without adding to the name table
+
+	const FString RequiredIntentName = Matcher->GetRequiredIntentName();
+	const FName IntentName = RequiredIntentName.IsEmpty() ? NAME_None : FName(*RequiredIntentName);
+	const bool bIsIndexed = !IntentName.IsNone();
+
+	if (bIsIndexed)
+	{
+		MatchersByIntentName.FindOrAdd(IntentName).Add(Matcher);
+	}
+	else
+	{
+		UnindexedMatchers.Add(Matcher);
+	}
+
+	RegisteredIntentNames.Add(TObjectKey<UVoiceResponseMatcher>(Matcher), IntentName);
+
+	UE_LOG(LogWit, Verbose, TEXT("FVoiceResponseMatcherRegistry - Register: registered matcher (%s) with intent (%s)"), *Matcher->GetName(), *RequiredIntentName);
+}
+
+/**
+ * Unregister a matcher. Any entries for matchers that have since been destroyed are also removed from the same list
+ *
+ * @param Matcher [in] the matcher to unregister
+ */
+void FVoiceResponseMatcherRegistry::Unregister(UVoiceResponseMatcher* Matcher)
+{
+	FName IntentName;
+
+	if (!RegisteredIntentNames.RemoveAndCopyValue(TObjectKey<UVoiceResponseMatcher>(Matcher), IntentName))
+	{
+		return;
+	}
+
+	const TWeakObjectPtr<UVoiceResponseMatcher> WeakMatcher(Matcher);
+
+	auto IsMatcherOrStale = [&WeakMatcher](const TWeakObjectPtr<UVoiceResponseMatcher>& Entry)
+	{
+		return Entry == WeakMatcher || !Entry.IsValid();
+	};
+
+	if (IntentName.IsNone())
+	{
+		UnindexedMatchers.RemoveAll(IsMatcherOrStale);
+		return;
+	}
+
+	TArray<TWeakObjectPtr<UVoiceResponseMatcher>>* Matchers = MatchersByIntentName.Find(IntentName);
+
+	if (Matchers == nullptr)
+	{
+		return;
+	}
+
+	Matchers->RemoveAll(IsMatcherOrStale);
+
+	if (Matchers->Num() == 0)
+	{
+		MatchersByIntentName.Remove(IntentName);
+	}
+}
+
+/**
+ * Pass a final response to the candidate matchers
+ *
+ * @param bIsSuccessful [in] true if the response was successful
+ * @param Response [in] the response
+ */
+void FVoiceResponseMatcherRegistry::DispatchResponse(const bool bIsSuccessful, const FWitResponse& Response)
+{
+	TArray<TWeakObjectPtr<UVoiceResponseMatcher>> Candidates;
+
+	GatherCandidates(bIsSuccessful, Response, Candidates);
+
+	for (const TWeakObjectPtr<UVoiceResponseMatcher>& Candidate : Candidates)
+	{
+		if (UVoiceResponseMatcher* Matcher = Candidate.Get())
+		{
+			Matcher->OnWitResponse(bIsSuccessful, Response);
+		}
+	}
+}
+
+/**
+ * Pass a partial response to the candidate matchers that are also used for partial responses
+ *
+ * @param bIsSuccessful [in] true if the response was successful
+ * @param Response [in] the partial response
+ */
+void FVoiceResponseMatcherRegistry::DispatchPartialResponse(const bool bIsSuccessful, const FWitResponse& Response)
+{
+	TArray<TWeakObjectPtr<UVoiceResponseMatcher>> Candidates;
+
+	GatherCandidates(bIsSuccessful, Response, Candidates);
+
+	for (const TWeakObjectPtr<UVoiceResponseMatcher>& Candidate : Candidates)
+	{
+		UVoiceResponseMatcher* Matcher = Candidate.Get();
+
+		const bool bShouldDispatch = Matcher != nullptr && Matcher->bIsAlsoUsedForPartialResponse;
+		if (bShouldDispatch)
+		{
+			Matcher->OnWitPartialResponse(bIsSuccessful, Response);
+		}
+	}
+}
+
+/**
+ * Get the number of registered matchers
+ *
+ * @return the number of matchers
+ */
+int32 FVoiceResponseMatcherRegistry::Num() const
+{
+	return RegisteredIntentNames.Num();
+}
+
+/**
+ * Gather the matchers that might match the given response. Indexed matchers only ever match the top intent so they are
+ * only candidates when their intent is the top intent of a successful response. The lookup ignores case so it finds a
+ * superset of the matchers and each matcher still does its own exact check
+ *
+ * @param bIsSuccessful [in] true if the response was successful
+ * @param Response [in] the response
+ * @param OutCandidates [out] the matchers to pass the response to
+ */
+void FVoiceResponseMatcherRegistry::GatherCandidates(const bool bIsSuccessful, const FWitResponse& Response, TArray<TWeakObjectPtr<UVoiceResponseMatcher>>& OutCandidates) const
+{
+	const TArray<TWeakObjectPtr<UVoiceResponseMatcher>>* IndexedMatchers = nullptr;
+
+	const bool bHasTopIntent = bIsSuccessful && Response.Intents.Num() > 0;
+	if (bHasTopIntent)
+	{
+		// Finding rather than adding the name means a response with an unknown intent never grows the name table
+
+		const FName TopIntentName(*Response.Intents[0].Name, FNAME_Find);
+
+		IndexedMatchers = TopIntentName.IsNone() ? nullptr : MatchersByIntentName.Find(TopIntentName);
+	}
+
+	OutCandidates.Reserve(UnindexedMatchers.Num() + (IndexedMatchers != nullptr ? IndexedMatchers->Num() : 0));
+	OutCandidates.Append(UnindexedMatchers);
+
+	if (IndexedMatchers != nullptr)
+	{
+		OutCandidates.Append(*IndexedMatchers);
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+#include "Voice/Events/VoiceEvents.h"
+#include "Voice/Matcher/VoiceIntentMatcher.h"
+#include "Voice/Matcher/VoiceResponseMatcherRegistry.h"
+#include "Wit/Request/WitResponse.h"
+#include "Wit/Utilities/WitBenchmark.h"
+#include "Wit/Utilities/WitLog.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Each matcher matches a different intent so only one of them can match any response.
+ * Usage: Wit.MatcherRegistryBenchmark [NumMatchers] [NumIterations]
+ */
+static FAutoConsoleCommand MatcherRegistryBenchmarkCommand(
+	TEXT("Wit.MatcherRegistryBenchmark"),
+	TEXT("Compares dispatching responses through the matcher registry against binding every matcher to OnWitResponse. Optional arguments are the number of matchers (defaults to 1000) and iterations (defaults to 1000)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumMatchers = FWitBenchmark::GetArgument(Args, 0, 1000);
+		const int32 NumIterations = FWitBenchmark::GetArgument(Args, 1, 1000);
+
+		TArray<UVoiceIntentMatcher*> Matchers;
+		FOnWitResponseDelegate BoundMatchers;
+		FVoiceResponseMatcherRegistry Registry;
+
+		Matchers.Reserve(NumMatchers);
+
+		for (int32 Index = 0; Index < NumMatchers; ++Index)
+		{
+			UVoiceIntentMatcher* Matcher = NewObject<UVoiceIntentMatcher>(GetTransientPackage());
+
+			Matcher->IntentName = FString::Printf(TEXT("intent_%d"), Index);
+			Matcher->AddToRoot();
+
+			BoundMatchers.AddDynamic(Matcher, &UVoiceResponseMatcher::OnWitResponse);
+			Registry.Register(Matcher);
+
+			Matchers.Add(Matcher);
+		}
+
+		FWitResponse Response;
+
+		Response.Text = TEXT("benchmark");
+		Response.Is_Final = true;
+
+		FWitIntent& Intent = Response.Intents.AddDefaulted_GetRef();
+
+		Intent.Name = FString::Printf(TEXT("intent_%d"), NumMatchers / 2);
+		Intent.Confidence = 0.9f;
+
+		const FWitBenchmarkResult BroadcastResult = FWitBenchmark::Measure(NumIterations, [&BoundMatchers, &Response]()
+		{
+			BoundMatchers.Broadcast(true, Response);
+		});
+
+		const FWitBenchmarkResult DispatchResult = FWitBenchmark::Measure(NumIterations, [&Registry, &Response]()
+		{
+			Registry.DispatchResponse(true, Response);
+		});
+
+		for (UVoiceIntentMatcher* Matcher : Matchers)
+		{
+			Registry.Unregister(Matcher);
+			Matcher->RemoveFromRoot();
+		}
+
+		UE_LOG(LogWit, Display, TEXT("Wit.MatcherRegistryBenchmark: (%d) matchers (%d) iterations"), NumMatchers, NumIterations);
+
+		FWitBenchmark::LogComparison(TEXT("Wit.MatcherRegistryBenchmark"), TEXT("bound to every matcher"), BroadcastResult, TEXT("registry"), DispatchResult);
+	}));
+
+#endif
@@ -8,7 +8,11 @@
 #include "Wit/Composer/WitComposerService.h"
 #include "JsonObjectConverter.h"
 #include "GenericPlatform/GenericPlatformHttp.h"
+#include "Wit/Configuration/WitAppConfigurationAsset.h"
+#include "Wit/Request/WitRequest.h"
 #include "Wit/Request/WitRequestBuilder.h"
+#include "Wit/Request/WitRequestSubsystem.h"
+#include "Wit/Request/WitResponseDecoder.h"
 #include "Wit/Utilities/WitHelperUtilities.h"
 #include "Wit/Utilities/WitLog.h"
 
@@ -33,6 +37,8 @@ void UWitComposerService::BeginPlay()
 		UE_LOG(LogWit, Verbose, TEXT("BeginPlay: adding request customise callback"));
 		
 		VoiceExperience->VoiceEvents->OnRequestCustomize.BindUObject(this, &UWitComposerService::OnComposerRequestCustomize);
+		VoiceExperience->VoiceEvents->OnPartialTranscription.AddUniqueDynamic(this, &UWitComposerService::OnPrefetchPartialTranscription);
+		VoiceExperience->VoiceEvents->OnFinalTranscription.AddUniqueDynamic(this, &UWitComposerService::OnPrefetchFinalTranscription);
 	}
 
 	Super::BeginPlay();
@@ -48,7 +54,11 @@ void UWitComposerService::BeginDestroy()
 		UE_LOG(LogWit, Verbose, TEXT("BeginDestroy: removing request customise callback"));
 		
 		VoiceExperience->VoiceEvents->OnRequestCustomize.Unbind();
+		VoiceExperience->VoiceEvents->OnPartialTranscription.RemoveDynamic(this, &UWitComposerService::OnPrefetchPartialTranscription);
+		VoiceExperience->VoiceEvents->OnFinalTranscription.RemoveDynamic(this, &UWitComposerService::OnPrefetchFinalTranscription);
 	}
+
+	CancelPrefetchRequest();
 	
 	Super::BeginDestroy();
 }
@@ -64,6 +74,8 @@ void UWitComposerService::TickComponent(float DeltaTime, ELevelTick TickType, FA
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	UpdatePrefetch();
+
 	if (!bIsWaitingToContinue)
 	{
 		return;
@@ -251,6 +263,8 @@ void UWitComposerService::OnComposerRequestCustomize(FWitRequestConfiguration& R
 	FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::SessionId, FGenericPlatformHttp::UrlEncode(SessionId));
 
 	const bool bIsValidContextMap = CurrentContextMap != nullptr && CurrentContextMap->GetJsonObject() != nullptr;
+
+	FString EncodedContextMap;
 	
 	if (bIsValidContextMap)
 	{
@@ -259,7 +273,22 @@ void UWitComposerService::OnComposerRequestCustomize(FWitRequestConfiguration& R
 		const TSharedRef<TJsonWriter<TCHAR>> Writer = TJsonWriterFactory<TCHAR>::Create(&ContextJsonString);
 		FJsonSerializer::Serialize(CurrentContextMap->GetJsonObject().ToSharedRef(), Writer);
 
-		FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::ContextMap, FGenericPlatformHttp::UrlEncode(ContextJsonString));
+		EncodedContextMap = FGenericPlatformHttp::UrlEncode(ContextJsonString);
+
+		FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::ContextMap, EncodedContextMap);
+	}
+
+	// A voice turn may be prefetched from its partial transcriptions so remember the context map it was sent with
+
+	if (bIsSpeechEndpointRedirected)
+	{
+		EndPrefetchTurn();
+
+		SpeculativePrefetch.Reset(Configuration->bIsSpeculativePrefetchEnabled, Configuration->SpeculativePrefetchStableTime,
+			Configuration->SpeculativePrefetchMaximumRequests);
+
+		bIsPrefetchTurnActive = SpeculativePrefetch.IsEnabled();
+		PrefetchContextMap = EncodedContextMap;
 	}
 		
 	// Listen in to the raw response as it's different than a normal speech/message response and we will need to parse it to a different UStruct
@@ -273,7 +302,8 @@ void UWitComposerService::OnComposerRequestCustomize(FWitRequestConfiguration& R
  */
 void UWitComposerService::OnComposerResponse(const TArray<uint8>& BinaryResponse, TSharedPtr<FJsonObject> JsonResponse)
 {
-	const bool bIsConversionError = !FJsonObjectConverter::JsonObjectToUStruct(JsonResponse.ToSharedRef(), &ComposerResponse);
+	const bool bIsDecoded = FWitResponseDecoder::DecodeComposerResponse(BinaryResponse, ComposerResponse);
+	const bool bIsConversionError = !bIsDecoded && (!JsonResponse.IsValid() || !FJsonObjectConverter::JsonObjectToUStruct(JsonResponse.ToSharedRef(), &ComposerResponse));
 	
 	if (bIsConversionError)
 	{
@@ -490,3 +520,218 @@ bool UWitComposerService::CanContinue() const
 
 	return true;
 }
+
+/**
+ * Prefetch the turn if the partial transcription has been stable for long enough. The turn ends once the voice request is no longer
+ * in progress and any prefetch still outstanding is cancelled
+ */
+void UWitComposerService::UpdatePrefetch()
+{
+	if (!bIsPrefetchTurnActive)
+	{
+		return;
+	}
+
+	const bool bIsVoiceRequestInProgress = VoiceExperience != nullptr && VoiceExperience->IsRequestInProgress();
+
+	if (!bIsVoiceRequestInProgress)
+	{
+		EndPrefetchTurn();
+		return;
+	}
+
+	FString Transcription;
+
+	if (SpeculativePrefetch.ShouldSpeculate(FPlatformTime::Seconds(), Transcription))
+	{
+		StartPrefetchRequest(Transcription);
+	}
+}
+
+/**
+ * Send the given transcription to the composer event endpoint with a copy of the turn's context map. A throwaway session id is used
+ * so that the live session on the server is not advanced by a prefetch that may never be used
+ *
+ * @param Transcription [in] the transcription to send
+ */
+void UWitComposerService::StartPrefetchRequest(const FString& Transcription)
+{
+	CancelPrefetchRequest();
+
+	const bool bHasConfiguration = VoiceExperience != nullptr && VoiceExperience->Configuration != nullptr;
+
+	if (!bHasConfiguration)
+	{
+		return;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("StartPrefetchRequest: prefetching composer turn (%s)"), *Transcription);
+
+	const FWitAppConfiguration& Application = VoiceExperience->Configuration->Application;
+
+	FWitRequestConfiguration RequestConfiguration{};
+
+	FWitRequestBuilder::SetRequestConfigurationWithDefaults(RequestConfiguration, EWitRequestEndpoint::Event, Application.ClientAccessToken,
+		Application.Advanced.ApiVersion, Application.Advanced.URL);
+
+	FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::Text, FGenericPlatformHttp::UrlEncode(Transcription));
+	FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::SessionId, FGenericPlatformHttp::UrlEncode(GetDefaultSessionId()));
+
+	if (!PrefetchContextMap.IsEmpty())
+	{
+		FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::ContextMap, PrefetchContextMap);
+	}
+
+	RequestConfiguration.bShouldUseCustomHttpTimeout = Application.Advanced.bIsCustomHttpTimeout;
+	RequestConfiguration.HttpTimeout = Application.Advanced.HttpTimeout;
+	RequestConfiguration.ResponseDeadline = Application.Advanced.ResponseDeadline;
+
+	const uint32 SpeculationId = SpeculativePrefetch.GetSpeculationId();
+
+	// An accepted prefetch is handled like a live composer response which needs the context map from the Json
+
+	RequestConfiguration.bShouldKeepJsonResponse = true;
+	RequestConfiguration.OnRequestCompleteWithResponse.AddUObject(this, &UWitComposerService::OnPrefetchRequestComplete, SpeculationId);
+	RequestConfiguration.OnRequestError.AddUObject(this, &UWitComposerService::OnPrefetchRequestError, SpeculationId);
+
+	PrefetchRequest = UWitRequestSubsystem::CreateRequest();
+
+	PrefetchRequest->BeginStreamRequest(RequestConfiguration);
+	PrefetchRequest->EndStreamRequest();
+}
+
+/**
+ * Cancel the prefetch request if there is one. This must not be called from the prefetch request's own callbacks
+ */
+void UWitComposerService::CancelPrefetchRequest()
+{
+	if (!PrefetchRequest.IsValid())
+	{
+		return;
+	}
+
+	if (PrefetchRequest->IsRequestInProgress())
+	{
+		PrefetchRequest->CancelRequest();
+	}
+
+	PrefetchRequest.Reset();
+}
+
+/**
+ * Give up on the current turn's prefetch. A prefetch that was never resolved is counted as a miss
+ */
+void UWitComposerService::EndPrefetchTurn()
+{
+	SpeculativePrefetch.Abandon();
+	CancelPrefetchRequest();
+
+	bIsPrefetchTurnActive = false;
+	PrefetchContextMap.Reset();
+	PrefetchBinaryResponse.Reset();
+	PrefetchJsonResponse.Reset();
+}
+
+/**
+ * Use the prefetched response in place of the speech request's response. The speech request is cancelled so its own composer
+ * response never arrives and the prefetched phrase is spoken straight away
+ */
+void UWitComposerService::AcceptPrefetch()
+{
+	UE_LOG(LogWit, Display, TEXT("AcceptPrefetch: using prefetched composer turn - cancelling voice request"));
+
+	bIsPrefetchTurnActive = false;
+
+	if (VoiceExperience != nullptr)
+	{
+		VoiceExperience->AcceptPartialResponseAndCancelRequest(SpeculativePrefetch.GetResponse());
+	}
+
+	OnComposerResponse(PrefetchBinaryResponse, PrefetchJsonResponse);
+}
+
+/**
+ * Called when a prefetch request completes. If the final transcription has already matched then the prefetch is used immediately
+ *
+ * @param BinaryResponse [in] the binary response
+ * @param JsonResponse [in] the Json response
+ * @param Response [in] the response already converted off the game thread
+ * @param SpeculationId [in] the prefetch the response is for
+ */
+void UWitComposerService::OnPrefetchRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response,
+	const uint32 SpeculationId)
+{
+	if (!bIsPrefetchTurnActive || !SpeculativePrefetch.SetResponse(SpeculationId, Response))
+	{
+		return;
+	}
+
+	PrefetchBinaryResponse = BinaryResponse;
+	PrefetchJsonResponse = JsonResponse;
+
+	if (SpeculativePrefetch.ResolvePending())
+	{
+		AcceptPrefetch();
+	}
+}
+
+/**
+ * Called when a prefetch request errors. The voice turn carries on as normal
+ *
+ * @param ErrorMessage [in] the error message
+ * @param HumanReadableMessage [in] a longer human readable error message
+ * @param SpeculationId [in] the prefetch that failed
+ */
+void UWitComposerService::OnPrefetchRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const uint32 SpeculationId)
+{
+	UE_LOG(LogWit, Verbose, TEXT("OnPrefetchRequestError: prefetch failed (%s)"), *ErrorMessage);
+
+	SpeculativePrefetch.SetFailed(SpeculationId);
+}
+
+/**
+ * Track the partial transcription of the current voice turn
+ *
+ * @param Transcription [in] the partial transcription
+ */
+void UWitComposerService::OnPrefetchPartialTranscription(const FString& Transcription)
+{
+	if (bIsPrefetchTurnActive)
+	{
+		SpeculativePrefetch.UpdateTranscription(Transcription, FPlatformTime::Seconds());
+	}
+}
+
+/**
+ * Compare the final transcription of the current voice turn against the prefetch
+ *
+ * @param Transcription [in] the final transcription
+ */
+void UWitComposerService::OnPrefetchFinalTranscription(const FString& Transcription)
+{
+	if (!bIsPrefetchTurnActive)
+	{
+		return;
+	}
+
+	const EWitSpeculationResult Result = SpeculativePrefetch.ResolveFinalTranscription(Transcription);
+
+	if (Result == EWitSpeculationResult::Hit)
+	{
+		AcceptPrefetch();
+	}
+	else if (Result == EWitSpeculationResult::Miss)
+	{
+		CancelPrefetchRequest();
+	}
+}
+
+/**
+ * Get the fraction of voice turns with a prefetch where the prefetched response was used
+ *
+ * @return the hit rate in the range 0 to 1
+ */
+float UWitComposerService::GetSpeculativePrefetchHitRate() const
+{
+	return SpeculativePrefetch.GetHitRate();
+}
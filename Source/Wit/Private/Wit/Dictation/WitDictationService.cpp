@@ -10,6 +10,7 @@
 #include "Wit/Request/WitRequestBuilder.h"
 #include "Wit/Utilities/WitHelperUtilities.h"
 #include "Wit/Utilities/WitLog.h"
+#include "Wit/Voice/WitVoiceService.h"
 
 /**
  * Called when the component starts playing
@@ -86,6 +87,18 @@ void UWitDictationService::TickComponent(float DeltaTime, ELevelTick TickType, F
 	{
 		LastActivateTime = Configuration->MaximumRecordingTime;
 	}
+
+	// Continuous dictation never stops between requests so the maximum duration is enforced here instead
+
+	const bool bIsContinuousDictationTooLong = Configuration->bIsContinuousDictationEnabled && LastActivateTime >= Configuration->MaximumRecordingTime
+		&& IsDictationActive();
+
+	if (bIsContinuousDictationTooLong)
+	{
+		UE_LOG(LogWit, Display, TEXT("TickComponent: deactivating continuous dictation after %.2f seconds"), LastActivateTime);
+
+		VoiceExperience->DeactivateVoiceInput();
+	}
 }
 
 /**
@@ -97,6 +110,8 @@ bool UWitDictationService::ActivateDictation()
 {
 	LastActivateTime = 0.0f;
 	bWasManuallyDeactivated = false;
+
+	ConfigureContinuousDictation();
 	
 	if (VoiceExperience != nullptr)
 	{
@@ -115,6 +130,8 @@ bool UWitDictationService::ActivateDictationWithRequestOptions(const FString& Re
 {
 	LastActivateTime = 0.0f;
 	bWasManuallyDeactivated = false;
+
+	ConfigureContinuousDictation();
 	
 	if (VoiceExperience != nullptr)
 	{
@@ -131,6 +148,8 @@ bool UWitDictationService::ActivateDictationWithRequestOptions(const FString& Re
  */
 bool UWitDictationService::ActivateDictationImmediately()
 {
+	ConfigureContinuousDictation();
+
 	if (VoiceExperience != nullptr)
 	{
 		return VoiceExperience->ActivateVoiceInputImmediately();
@@ -186,6 +205,22 @@ bool UWitDictationService::IsRequestInProgress() const
 	return false;
 }
 
+/**
+ * Pass the continuous dictation settings on to the voice service. Continuous streaming is only supported by the Wit voice service
+ */
+void UWitDictationService::ConfigureContinuousDictation() const
+{
+	UWitVoiceService* WitVoiceService = VoiceExperience != nullptr ? Cast<UWitVoiceService>(VoiceExperience->VoiceService) : nullptr;
+
+	if (Configuration == nullptr || WitVoiceService == nullptr)
+	{
+		return;
+	}
+
+	WitVoiceService->SetContinuousStreaming(Configuration->bIsContinuousDictationEnabled, Configuration->ContinuousSegmentTime,
+		Configuration->ContinuousOverlapTime);
+}
+
 /**
  * Callback to redirect the speech endpoint to the dictation equivalent
  */
@@ -264,7 +299,10 @@ void UWitDictationService::OnWitResponse(const bool bIsSuccessful, const FWitRes
 		return;
 	}
 	
-	const bool bShouldAutoActivateInput = VoiceExperience != nullptr && Configuration->bShouldAutoActivateInput && !bWasManuallyDeactivated;
+	// In continuous dictation voice input is still active when earlier requests complete so there is nothing to reactivate
+
+	const bool bShouldAutoActivateInput = VoiceExperience != nullptr && Configuration->bShouldAutoActivateInput && !bWasManuallyDeactivated
+		&& !VoiceExperience->IsVoiceInputActive();
 	const bool bIsTooLongSinceFirstActivated = LastActivateTime >= Configuration->MaximumRecordingTime;
 	
 	if (bShouldAutoActivateInput && !bIsTooLongSinceFirstActivated)
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Request/WitMessageCache.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Wit/Configuration/WitAppConfiguration.h"
+#include "Wit/Request/WitResponse.h"
+#include "Wit/Request/WitResponseDecoder.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Apply the cache settings from the given configuration
+ *
+ * @param Configuration [in] the app configuration
+ */
+void FWitMessageCache::Configure(const FWitAppConfiguration& Configuration)
+{
+	const FWitAppAdvancedConfiguration& Advanced = Configuration.Advanced;
+
+	bIsEnabled = Advanced.bIsMessageCacheEnabled;
+	bIsPersistent = Advanced.bIsMessageCachePersistent;
+	TimeToLive = Advanced.MessageCacheTimeToLive;
+	MaximumEntries = FMath::Max(Advanced.MessageCacheMaximumEntries, 1);
+
+	// The access token identifies the app but is hashed so that it is never written to disk
+
+	KeyPrefix = FString::Printf(TEXT("%08x|%s|%s|"), FCrc::StrCrc32(*Configuration.ClientAccessToken), *Advanced.MessageCacheAppVersion, *Advanced.ApiVersion);
+
+	// A different app or version is saved to a different file so anything cached for the previous one is saved and dropped
+
+	const FString NewFilePath = MakeFilePath();
+
+	const bool bIsFileChanged = !FilePath.IsEmpty() && !FilePath.Equals(NewFilePath);
+	if (bIsFileChanged)
+	{
+		Save();
+
+		Entries.Empty();
+		bHasLoaded = false;
+		bIsDirty = false;
+	}
+
+	FilePath = NewFilePath;
+
+	const bool bShouldLoad = bIsEnabled && bIsPersistent && !bHasLoaded;
+	if (bShouldLoad)
+	{
+		Load();
+	}
+
+	Trim();
+}
+
+/**
+ * Is the cache enabled?
+ *
+ * @return true if enabled
+ */
+bool FWitMessageCache::IsEnabled() const
+{
+	return bIsEnabled;
+}
+
+/**
+ * Find the cached response for the given text. Expired responses are removed when they are found
+ *
+ * @param Text [in] the text that was sent
+ * @param OutResponse [out] the cached response
+ * @return true if a valid response was found
+ */
+bool FWitMessageCache::Find(const FString& Text, FWitResponse& OutResponse)
+{
+	if (!bIsEnabled)
+	{
+		return false;
+	}
+
+	const FString Key = MakeKey(Text);
+	FEntry* Entry = Entries.Find(Key);
+
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	OutResponse.Reset();
+
+	const bool bIsValid = !IsExpired(*Entry, FDateTime::UtcNow()) && FWitResponseDecoder::DecodeResponse(Entry->ResponseBody, OutResponse);
+	if (!bIsValid)
+	{
+		Entries.Remove(Key);
+		bIsDirty = true;
+
+		return false;
+	}
+
+	Entry->LastUseCount = ++UseCount;
+
+	return true;
+}
+
+/**
+ * Add the response for the given text to the cache
+ *
+ * @param Text [in] the text that was sent
+ * @param ResponseBody [in] the body of the response
+ */
+void FWitMessageCache::Add(const FString& Text, const TArray<uint8>& ResponseBody)
+{
+	if (!bIsEnabled)
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.Add(MakeKey(Text));
+
+	Entry.ResponseBody = ResponseBody;
+	Entry.CreationTime = FDateTime::UtcNow();
+	Entry.LastUseCount = ++UseCount;
+
+	bIsDirty = true;
+
+	Trim();
+
+	// Saving as responses are added means they survive a crash while the interval keeps the cost of saving down
+
+	const bool bIsSaveDue = FPlatformTime::Seconds() - LastSaveTime >= SaveInterval;
+	if (bIsSaveDue)
+	{
+		Save();
+	}
+}
+
+/**
+ * Remove every cached response
+ */
+void FWitMessageCache::Empty()
+{
+	bIsDirty = bIsDirty || Entries.Num() > 0;
+
+	Entries.Empty();
+}
+
+/**
+ * Save the cache to disk if it is persistent and has changed. Entries saved by other instances since the cache was loaded
+ * are merged first so that they are not lost. Expired entries are not saved
+ */
+void FWitMessageCache::Save()
+{
+	if (!bIsPersistent || !bIsDirty || FilePath.IsEmpty())
+	{
+		return;
+	}
+
+	LastSaveTime = FPlatformTime::Seconds();
+
+	Merge();
+	Trim();
+
+	const FDateTime Now = FDateTime::UtcNow();
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	int32 Version = FileVersion;
+	int32 NumEntries = 0;
+
+	for (const TPair<FString, FEntry>& Entry : Entries)
+	{
+		NumEntries += IsExpired(Entry.Value, Now) ? 0 : 1;
+	}
+
+	Writer << Version;
+	Writer << NumEntries;
+
+	for (const TPair<FString, FEntry>& Entry : Entries)
+	{
+		if (IsExpired(Entry.Value, Now))
+		{
+			continue;
+		}
+
+		FString Key = Entry.Key;
+		int64 CreationTicks = Entry.Value.CreationTime.GetTicks();
+		TArray<uint8> ResponseBody = Entry.Value.ResponseBody;
+
+		Writer << Key;
+		Writer << CreationTicks;
+		Writer << ResponseBody;
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Data, *FilePath))
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitMessageCache - Save: failed to save the cache (%s)"), *FilePath);
+		return;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitMessageCache - Save: saved (%d) responses to (%s)"), NumEntries, *FilePath);
+
+	bIsDirty = false;
+}
+
+/**
+ * Normalize text for use as a cache key. Case is ignored and whitespace is trimmed and collapsed
+ *
+ * @param Text [in] the text to normalize
+ * @return the normalized text
+ */
+FString FWitMessageCache::NormalizeText(const FString& Text)
+{
+	FString NormalizedText;
+	NormalizedText.Reserve(Text.Len());
+
+	bool bIsPendingSpace = false;
+
+	for (const TCHAR Character : Text)
+	{
+		if (FChar::IsWhitespace(Character))
+		{
+			bIsPendingSpace = NormalizedText.Len() > 0;
+			continue;
+		}
+
+		if (bIsPendingSpace)
+		{
+			NormalizedText.AppendChar(TEXT(' '));
+			bIsPendingSpace = false;
+		}
+
+		NormalizedText.AppendChar(FChar::ToLower(Character));
+	}
+
+	return NormalizedText;
+}
+
+/**
+ * Make the key for the given text
+ *
+ * @param Text [in] the text that was sent
+ * @return the key
+ */
+FString FWitMessageCache::MakeKey(const FString& Text) const
+{
+	return KeyPrefix + NormalizeText(Text);
+}
+
+/**
+ * Has the given entry expired?
+ *
+ * @param Entry [in] the entry to check
+ * @param Now [in] the current time
+ * @return true if expired
+ */
+bool FWitMessageCache::IsExpired(const FEntry& Entry, const FDateTime& Now) const
+{
+	return TimeToLive > 0.0 && (Now - Entry.CreationTime).GetTotalSeconds() > TimeToLive;
+}
+
+/**
+ * Discard the least recently used entries until the cache is within its size limit
+ */
+void FWitMessageCache::Trim()
+{
+	const int32 NumToRemove = Entries.Num() - MaximumEntries;
+
+	if (NumToRemove <= 0)
+	{
+		return;
+	}
+
+	TArray<TPair<uint64, FString>> EntriesByUse;
+	EntriesByUse.Reserve(Entries.Num());
+
+	for (const TPair<FString, FEntry>& Entry : Entries)
+	{
+		EntriesByUse.Emplace(Entry.Value.LastUseCount, Entry.Key);
+	}
+
+	EntriesByUse.Sort([](const TPair<uint64, FString>& A, const TPair<uint64, FString>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	for (int32 Index = 0; Index < NumToRemove; ++Index)
+	{
+		Entries.Remove(EntriesByUse[Index].Value);
+	}
+
+	bIsDirty = true;
+}
+
+/**
+ * Load the cache from disk
+ */
+void FWitMessageCache::Load()
+{
+	bHasLoaded = true;
+
+	Merge();
+}
+
+/**
+ * Merge the entries saved on disk into the cache. Entries already in memory take precedence over those loaded. Expired
+ * entries are skipped
+ */
+void FWitMessageCache::Merge()
+{
+	TArray<uint8> Data;
+
+	if (!FPaths::FileExists(FilePath) || !FFileHelper::LoadFileToArray(Data, *FilePath))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Data);
+
+	int32 Version = 0;
+	int32 NumEntries = 0;
+
+	Reader << Version;
+	Reader << NumEntries;
+
+	const bool bIsValidFile = !Reader.IsError() && Version == FileVersion && NumEntries >= 0;
+	if (!bIsValidFile)
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitMessageCache - Merge: ignoring invalid or outdated cache (%s)"), *FilePath);
+		return;
+	}
+
+	const FDateTime Now = FDateTime::UtcNow();
+	int32 NumLoaded = 0;
+
+	for (int32 Index = 0; Index < NumEntries; ++Index)
+	{
+		FString Key;
+		int64 CreationTicks = 0;
+		FEntry Entry;
+
+		Reader << Key;
+		Reader << CreationTicks;
+		Reader << Entry.ResponseBody;
+
+		if (Reader.IsError())
+		{
+			UE_LOG(LogWit, Warning, TEXT("FWitMessageCache - Merge: cache is truncated (%s)"), *FilePath);
+			break;
+		}
+
+		Entry.CreationTime = FDateTime(CreationTicks);
+
+		const bool bShouldSkip = IsExpired(Entry, Now) || Entries.Contains(Key);
+		if (bShouldSkip)
+		{
+			continue;
+		}
+
+		Entries.Add(Key, MoveTemp(Entry));
+		++NumLoaded;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitMessageCache - Merge: loaded (%d) responses from (%s)"), NumLoaded, *FilePath);
+}
+
+/**
+ * Get the path of the file the cache for the current app and version is saved to. The file is named after a hash of the
+ * key prefix so that different apps and versions never share a file
+ *
+ * @return the path
+ */
+FString FWitMessageCache::MakeFilePath() const
+{
+	const FString FileName = FString::Printf(TEXT("MessageCache_%08x.bin"), FCrc::StrCrc32(*KeyPrefix));
+
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Wit"), FileName);
+}
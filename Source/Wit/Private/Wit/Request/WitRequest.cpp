@@ -0,0 +1,755 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Request/WitRequest.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Wit/Utilities/WitLog.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Dom/JsonObject.h"
+#include "Wit/Request/HTTP/WitHttpRequest.h"
+#include "Wit/Request/WitRequestStream.h"
+#include "Wit/Request/WitResponseDecoder.h"
+#include "Wit/Utilities/WitHelperUtilities.h"
+
+/**
+ * Get the pool used for content data that is copied into request streams. The pool is shared by every request
+ *
+ * @return the pool
+ */
+TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe> FWitRequest::GetContentBlockPool()
+{
+	constexpr int32 ContentBlockSize = 4096;
+
+	static const TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe> ContentBlockPool = MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(ContentBlockSize);
+
+	return ContentBlockPool;
+}
+
+/**
+ * Constructor
+ */
+FWitRequest::FWitRequest()
+{
+	ContentStream = MakeShared<FWitRequestStream, ESPMode::ThreadSafe>(GetContentBlockPool());
+}
+
+/**
+ * Start a Wit.ai request. Depending on the request endpoint this may be a streaming request or not. Only
+ * the /speech endpoint supports streaming. This should always be paired with a call to EndStreamRequest
+ *
+ * @param RequestConfiguration [in] the configuration to use to setup the request
+ */
+void FWitRequest::BeginStreamRequest(const FWitRequestConfiguration& RequestConfiguration)
+{
+	if (IsRequestInProgress())
+	{
+		UE_LOG(LogWit, Warning, TEXT("BeginRequest: Attempting to begin request when one is already in progress"));
+		return;
+	}
+
+	// A previous request may still hold a reference to its stream so we always start a new one rather than resetting it
+
+	ContentStream = MakeShared<FWitRequestStream, ESPMode::ThreadSafe>(GetContentBlockPool());
+
+	Configuration = RequestConfiguration;
+	LastResponseSize = 0;
+	ResponseCode = 0;
+	LastResponseDelivered = NumResponsesDispatched;
+	++RequestGeneration;
+	bHasConfiguration = true;
+
+	// When streaming we start the request immediately. Data will be passed to the server as it becomes available
+	
+	if (RequestConfiguration.bShouldUseChunkedTransfer)
+	{
+		SendRequest();
+	}
+}
+
+/**
+ * Finish a Wit.ai request. In the case of a streaming request this should be called when there is no more
+ * data to send. In the case of one shot requests it can be called immediately after BeginStreamRequest
+ */
+void FWitRequest::EndStreamRequest()
+{
+	ContentStream->Close();
+	
+	if (Configuration.bShouldUseChunkedTransfer)
+	{
+		const TSharedPtr<FWitHttpRequest, ESPMode::ThreadSafe> StreamRequest = StaticCastSharedPtr<FWitHttpRequest, IHttpRequest>(HttpRequest);
+		StreamRequest->CloseStreamRequest();
+	}
+	else
+	{
+		SendRequest();
+	}
+
+	StartResponseDeadline();
+}
+
+/**
+ * Start the response deadline for the current request if it has one. The deadline is tagged with the request generation so it
+ * has no effect once the request has completed or been replaced
+ */
+void FWitRequest::StartResponseDeadline()
+{
+	if (Configuration.ResponseDeadline <= 0.0f || !IsRequestInProgress())
+	{
+		return;
+	}
+
+	const uint32 Generation = RequestGeneration;
+
+	TWeakPtr<FWitRequest, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+	const FTickerDelegate DeadlineDelegate = FTickerDelegate::CreateLambda([WeakThis, Generation](float DeltaTime)
+	{
+		const TSharedPtr<FWitRequest, ESPMode::ThreadSafe> This = WeakThis.Pin();
+
+		if (This.IsValid())
+		{
+			This->OnResponseDeadline(Generation);
+		}
+
+		return false;
+	});
+
+#if UE_VERSION_OLDER_THAN(5,0,0)
+	FTicker::GetCoreTicker().AddTicker(DeadlineDelegate, Configuration.ResponseDeadline);
+#else
+	FTSTicker::GetCoreTicker().AddTicker(DeadlineDelegate, Configuration.ResponseDeadline);
+#endif
+}
+
+/**
+ * Called when the response deadline passes. The request is cancelled and reported as failed if it is still the same request
+ *
+ * @param Generation [in] the generation of the request the deadline was started for
+ */
+void FWitRequest::OnResponseDeadline(const uint32 Generation)
+{
+	const bool bIsExpired = Generation == RequestGeneration && IsRequestInProgress();
+
+	if (!bIsExpired)
+	{
+		return;
+	}
+
+	UE_LOG(LogWit, Warning, TEXT("OnResponseDeadline: Cancelling request because no response arrived within (%f) seconds"), Configuration.ResponseDeadline);
+
+	// The error handler may begin another request on this channel so we broadcast from a copy
+
+	const FOnWitRequestErrorDelegate OnRequestError = Configuration.OnRequestError;
+
+	CancelRequest();
+
+	OnRequestError.Broadcast(TEXT("Deadline exceeded"), TEXT("The response did not arrive before the request deadline"));
+}
+
+/**
+ * Actually sends the HTTP request
+ */
+void FWitRequest::SendRequest()
+{
+	if (IsRequestInProgress())
+	{
+		UE_LOG(LogWit, Warning, TEXT("SendRequest: Attempting to process request when one is already in progress"));
+		return;
+	}
+
+	if (!bHasConfiguration)
+	{
+		UE_LOG(LogWit, Warning, TEXT("SendRequest: No configuration has been specified for the request"));
+		return;
+	}
+
+	// If we are using streaming then we use our custom HTTP request otherwise we fallback to UE4's standard HTTP request
+
+	HttpRequest = TSharedRef<IHttpRequest, ESPMode::ThreadSafe>(dynamic_cast<IHttpRequest*>(new FWitHttpRequest()));
+
+	// Construct the final URL for the request
+	
+	FString Url = FString::Format(TEXT("{0}/{1}"), { Configuration.BaseUrl, Configuration.Endpoint });
+
+	const bool bIsVersionParameter = !Configuration.Version.IsEmpty();
+	const bool bIsUrlParameters = bIsVersionParameter || Configuration.Parameters.Num() > 0;
+
+	if (bIsUrlParameters)
+	{
+		Url.Append("?");
+	}
+	
+	if (bIsVersionParameter)
+	{
+		Url.Append(TEXT("v="));
+		Url.Append(Configuration.Version);
+	}
+
+	for (const TPair<FString, FString >& ParameterPair : Configuration.Parameters)
+	{
+		Url.Append(ParameterPair.Key);
+		Url.Append(ParameterPair.Value);
+	}
+
+	HttpRequest->SetURL(Url);
+	HttpRequest->SetVerb(Configuration.Verb);
+
+	// Add headers. This varies per endpoint but all requests require the Authorization header
+	
+	const FString Authorization = FString::Format(TEXT("Bearer {0}"), { Configuration.AuthToken });
+
+	HttpRequest->SetHeader("Authorization", Authorization);
+	HttpRequest->SetHeader("User-Agent", FWitHttpRequest::GetUserAgent());
+
+	if (!Configuration.Accept.IsEmpty())
+	{
+		HttpRequest->SetHeader("Accept", Configuration.Accept);
+	}
+	
+	FString ContentType;
+	bool bIsSeparatorRequired = false;
+	
+	for (const TPair<FString, FString >& ContentTypePair : Configuration.ContentTypes)
+	{
+		if (bIsSeparatorRequired)
+		{
+			ContentType.Append(";");
+		}
+		else
+		{
+			bIsSeparatorRequired = true;
+		}
+		
+		ContentType.Append(ContentTypePair.Key);
+		ContentType.Append(ContentTypePair.Value);		
+	}
+
+	if (!ContentType.IsEmpty())
+	{
+		HttpRequest->SetHeader("Content-Type", ContentType);
+	}
+	
+	if (Configuration.bShouldUseChunkedTransfer)
+	{
+		HttpRequest->SetHeader("Transfer-Encoding", TEXT("chunked"));
+	}
+
+	// Add body content. This can be either streamed or fixed depending on the endpoint
+	
+	HttpRequest->SetContentFromStream(ContentStream.ToSharedRef());
+
+	// Setup callbacks to inform of request progress and request completion
+
+	HttpRequest->OnRequestProgress().BindSP(AsShared(), &FWitRequest::OnRequestProgress);
+	HttpRequest->OnProcessRequestComplete().BindSP(AsShared(), &FWitRequest::OnRequestComplete);
+
+	// Set custom timeout
+
+	if (Configuration.bShouldUseCustomHttpTimeout)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("SendRequest: Setting custom timeout to (%f)"), Configuration.HttpTimeout);
+
+		HttpRequest->SetTimeout(Configuration.HttpTimeout);	
+	}
+
+	// Finally send off the request
+	
+	if (HttpRequest != nullptr)
+	{
+		HttpRequest->ProcessRequest();
+
+		UE_LOG(LogWit, Verbose, TEXT("SendRequest: Url is (%s), Content type is (%s) and Content length is (%lld)"), *HttpRequest->GetURL(), *HttpRequest->GetHeader("Content-Type"), ContentStream->TotalSize());
+	}
+	else
+	{
+		UE_LOG(LogWit, Warning, TEXT("SendRequest: failed"));
+	}
+}
+
+/**
+ * Writes the given data to the internal stream that the request is using
+ *
+ * @param Data [in] the content to add to the stream buffer
+ */
+void FWitRequest::WriteBinaryData(const TArray<uint8>& Data)
+{
+	WriteBinaryData(TArrayView<const uint8>(Data));
+}
+
+/**
+ * Writes a copy of the given binary data to the internal stream that the request is using
+ *
+ * @param Data [in] the content to add to the stream buffer
+ */
+void FWitRequest::WriteBinaryData(TArrayView<const uint8> Data)
+{
+	const int32 NumBytesToCopy = Data.Num();
+	
+	if (NumBytesToCopy <= 0)
+	{
+		return;
+	}
+
+	ContentStream->Write(Data);
+
+	UE_LOG(LogWit, Verbose, TEXT("WriteBinaryData: Wrote (%d) bytes. New stream size is (%lld)"), NumBytesToCopy, ContentStream->TotalSize());
+}
+
+/**
+ * Writes the given shared audio to the internal stream that the request is using. The audio is referenced rather than copied
+ *
+ * @param Data [in] the content to add to the stream buffer
+ */
+void FWitRequest::WriteBinaryData(const FVoiceAudioSpan& Data)
+{
+	if (Data.IsEmpty())
+	{
+		return;
+	}
+
+	ContentStream->Write(Data);
+
+	UE_LOG(LogWit, Verbose, TEXT("WriteBinaryData: Referenced (%d) bytes. New stream size is (%lld)"), Data.Num(), ContentStream->TotalSize());
+}
+
+/**
+ * Writes the given data to the internal stream that the request is using
+ *
+ * @param Data [in] the content to add to the stream buffer
+ */
+void FWitRequest::WriteJsonData(const TSharedRef<FJsonObject> Data)
+{
+	// Stringify the Json object
+	
+	FString ContentString;
+	const TSharedRef<TJsonWriter<TCHAR>> Writer = TJsonWriterFactory<TCHAR>::Create(&ContentString);
+	
+	FJsonSerializer::Serialize(Data, Writer);
+
+	// Convert the string to UTF8 and copy into the stream
+	
+	const FTCHARToUTF8 ContentAsUtf8(*ContentString, ContentString.Len());
+	const int32 NumBytesToCopy = ContentAsUtf8.Length();
+
+	if (NumBytesToCopy <= 0)
+	{
+		return;
+	}
+
+	ContentStream->Write(TArrayView<const uint8>(reinterpret_cast<const uint8*>(ContentAsUtf8.Get()), NumBytesToCopy));
+
+	UE_LOG(LogWit, Verbose, TEXT("WriteJsonData: Wrote (%d) bytes. New stream size is (%lld)"), NumBytesToCopy, ContentStream->TotalSize());
+}
+
+/**
+ * Cancels an inflight Wit.ai request
+ */
+void FWitRequest::CancelRequest()
+{
+	if (!IsRequestInProgress())
+	{
+		return;
+	}
+
+	// Any response still being parsed belongs to the cancelled request so it is discarded when it arrives. The HTTP callbacks are
+	// unbound first so that the cancelled request reports nothing more and late data is never parsed
+
+	++RequestGeneration;
+	bIsFinalResponsePending = false;
+
+	if (HttpRequest != nullptr)
+	{
+		const FHttpRequestPtr CancelledRequest = HttpRequest;
+
+		HttpRequest = nullptr;
+
+		CancelledRequest->OnRequestProgress().Unbind();
+		CancelledRequest->OnProcessRequestComplete().Unbind();
+		CancelledRequest->CancelRequest();
+	}
+}
+
+/**
+ * Get the number of bytes written to the request that the network has not yet accepted
+ *
+ * @return the number of bytes
+ */
+int64 FWitRequest::GetNumBytesPendingUpload() const
+{
+	return ContentStream->GetNumBytesRemaining();
+}
+
+/**
+ * Get the HTTP response code of the most recently completed request
+ *
+ * @return the response code or zero if there is no response
+ */
+int32 FWitRequest::GetResponseCode() const
+{
+	return ResponseCode;
+}
+
+/**
+ * Is a Wit.ai request currently in progress?
+ *
+ * @return true if a request is in progress
+ */
+bool FWitRequest::IsRequestInProgress() const
+{
+	return HttpRequest != nullptr || bIsFinalResponsePending;
+}
+
+/**
+ * Called when an HTTP request is in progress to retrieve any changes to the response payload
+ *
+ * @param Request the in progress request
+ * @param BytesSent the amount of bytes that have so far been sent to server
+ * @param BytesReceived the amount of bytes that have so far been received from server
+ */
+void FWitRequest::OnRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived)
+{
+	if (Request != HttpRequest)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("OnRequestProgress: Ignoring progress from a request that is no longer current"));
+		return;
+	}
+
+	if (!Configuration.OnRequestProgress.IsBound())
+	{
+		return;	
+	}
+	
+	const TArray<uint8>& ContentAsBytes(Request->GetResponse()->GetContent());
+	const bool bIsNewResponseData = ContentAsBytes.Num() != LastResponseSize;
+
+	if (!bIsNewResponseData)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("OnRequestProgress: Ignoring response progress because size has not changed"));
+		return;	
+	}
+	
+	const FString Url = Request->GetURL();
+	if (Url.Contains("synthesize"))
+	{
+		Configuration.OnRequestProgress.Broadcast(ContentAsBytes, nullptr);
+		return;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("OnRequestProgress: Content size (%d) bytes received (%d)"), ContentAsBytes.Num(), BytesReceived);
+
+	// Parsing happens in the background so we record the size now to avoid dispatching the same response again
+
+	LastResponseSize = ContentAsBytes.Num();
+
+	DispatchResponse(ContentAsBytes, false);
+}
+
+/**
+ * Called when an HTTP request is fully completed to process the response payload
+ *
+ * @param Request the completed request
+ * @param Response the full and final response
+ * @param bIsSuccessful whether the request successfully completed
+ */
+void FWitRequest::OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bIsSuccessful)
+{
+	if (Request != HttpRequest)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("OnRequestComplete: Ignoring completion of a request that is no longer current"));
+		return;
+	}
+
+	HttpRequest = nullptr;
+	ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+	
+	if (!bIsSuccessful)
+	{
+		// A cancelled or unreachable request has no response
+
+		const FString ErrorMessage = FString::Format(TEXT("HTTP Error {0}"), { ResponseCode });
+		const FString HumanReadableErrorMessage = FString::Format(TEXT("Request failed with error code {0}"), { ResponseCode });
+		
+		Configuration.OnRequestError.Broadcast(ErrorMessage, HumanReadableErrorMessage);
+		
+		return;
+	}
+
+	const FString ContentType = Response->GetContentType();
+
+	const bool bIsJsonContentType = ContentType.Contains(TEXT("application/json"));
+	const bool bIsAudioContentType = ContentType.Contains(TEXT("audio/wav")) || ContentType.Contains(TEXT("audio/raw"));
+
+	if (bIsJsonContentType)
+	{
+		// Parsing large responses can take several milliseconds so it happens in the background. The request remains in
+		// progress until the result has been delivered
+
+		bIsFinalResponsePending = true;
+
+		DispatchResponse(Response->GetContent(), true);
+	}
+	else if (bIsAudioContentType)
+	{
+		// The synthesize endpoint returns binary data in the form of a wav
+		
+		Configuration.OnRequestComplete.Broadcast(Response->GetContent(), nullptr);
+	}
+	else
+	{
+		Configuration.OnRequestError.Broadcast(TEXT("Invalid content type"), TEXT("Response has invalid content type"));
+	}
+}
+
+/**
+ * Parse a response in a background task and deliver the result on the game thread. The content is copied into the task
+ * and everything the task creates is moved to the game thread when it finishes so nothing is shared between threads. Each
+ * response is numbered so that one which finishes parsing after a more recent response is discarded
+ *
+ * @param Content [in] the response content
+ * @param bIsFinal [in] is this the final response to the request?
+ */
+void FWitRequest::DispatchResponse(const TArray<uint8>& Content, const bool bIsFinal)
+{
+	const uint32 ResponseNumber = ++NumResponsesDispatched;
+	const uint32 Generation = RequestGeneration;
+	const bool bShouldConvert = bIsFinal ? Configuration.OnRequestCompleteWithResponse.IsBound() : Configuration.OnRequestProgressWithResponse.IsBound();
+	const bool bIsJsonBound = bIsFinal ? Configuration.OnRequestComplete.IsBound() : Configuration.OnRequestProgress.IsBound();
+	const bool bShouldBuildJson = !bShouldConvert || bIsJsonBound || Configuration.bShouldKeepJsonResponse;
+
+	TWeakPtr<FWitRequest, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+	Async(EAsyncExecution::TaskGraph, [WeakThis, Content, ResponseNumber, Generation, bIsFinal, bShouldConvert, bShouldBuildJson]() mutable
+	{
+		FParsedResponse ParsedResponse;
+
+		ParseResponse(Content, bShouldConvert, bShouldBuildJson, ParsedResponse);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Content = MoveTemp(Content), ParsedResponse = MoveTemp(ParsedResponse), ResponseNumber, Generation, bIsFinal]()
+		{
+			const TSharedPtr<FWitRequest, ESPMode::ThreadSafe> This = WeakThis.Pin();
+
+			const bool bIsStale = !This.IsValid() || This->RequestGeneration != Generation || ResponseNumber <= This->LastResponseDelivered;
+			if (bIsStale)
+			{
+				UE_LOG(LogWit, Verbose, TEXT("DispatchResponse: Discarding response (%u) because a more recent response has been delivered"), ResponseNumber);
+				return;
+			}
+
+			This->LastResponseDelivered = ResponseNumber;
+			This->DeliverResponse(Content, ParsedResponse, bIsFinal);
+		});
+	});
+}
+
+/**
+ * Parse a response. This runs in a background task so it must only use its arguments. Responses that are converted are
+ * decoded directly from the content and the Json is only built if it is also wanted or decoding fails
+ *
+ * @param Content [in] the response content
+ * @param bShouldConvert [in] should the response be converted to an FWitResponse?
+ * @param bShouldBuildJson [in] should the response be parsed as Json?
+ * @param OutParsedResponse [out] the result
+ */
+void FWitRequest::ParseResponse(const TArray<uint8>& Content, const bool bShouldConvert, const bool bShouldBuildJson, FParsedResponse& OutParsedResponse)
+{
+	UE_LOG(LogWit, Verbose, TEXT("ParseResponse: Content size (%d)"), Content.Num());
+
+	if (bShouldConvert)
+	{
+		OutParsedResponse.bIsConverted = FWitResponseDecoder::DecodeResponse(Content, OutParsedResponse.Response, &OutParsedResponse.Checksums);
+
+		// A decode that fails partway leaves the response partly filled in so it is reset before the reflection fallback
+
+		if (!OutParsedResponse.bIsConverted)
+		{
+			OutParsedResponse.Response.Reset();
+		}
+	}
+
+	const bool bIsJsonNeeded = bShouldBuildJson || (bShouldConvert && !OutParsedResponse.bIsConverted);
+	if (bIsJsonNeeded)
+	{
+		ParseResponseJson(Content, OutParsedResponse);
+	}
+
+	if (bShouldConvert && !OutParsedResponse.bIsConverted && OutParsedResponse.Json.IsValid())
+	{
+		OutParsedResponse.bIsConverted = FWitHelperUtilities::ConvertJsonToWitResponse(OutParsedResponse.Json, &OutParsedResponse.Response);
+
+		// The checksums stay invalid so every section is treated as changed but the kind of chunk is still needed
+
+		FString ChunkType;
+
+		OutParsedResponse.Checksums.bHasText = OutParsedResponse.Json->HasField(TEXT("text"));
+		OutParsedResponse.Checksums.bHasIntents = OutParsedResponse.Json->HasField(TEXT("intents"));
+		OutParsedResponse.Checksums.bIsFinalTranscription = OutParsedResponse.Json->TryGetStringField(TEXT("type"), ChunkType)
+			&& ChunkType.Equals(TEXT("FINAL_TRANSCRIPTION"));
+	}
+}
+
+/**
+ * Parse the most recent chunk of a response as Json. This runs in a background task so it must only use its arguments
+ *
+ * @param Content [in] the response content
+ * @param OutParsedResponse [out] the result
+ */
+void FWitRequest::ParseResponseJson(const TArray<uint8>& Content, FParsedResponse& OutParsedResponse)
+{
+	const FUTF8ToTCHAR ContentAsTChar(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num());
+	const FString ContentAsString(ContentAsTChar.Length(), ContentAsTChar.Get());
+
+	// The speech endpoint returns chunked responses which contain multiple JSON objects. The final chunk represents the most recent response
+	// while the other chunks are intermediate results that can be safely ignored
+
+	TArray<FString> ChunkedResponses;
+
+	SplitResponseIntoChunks(ContentAsString, ChunkedResponses);
+
+	const bool bIsMalformedResponse = (ChunkedResponses.Num() == 0);
+	if (bIsMalformedResponse)
+	{
+		OutParsedResponse.ErrorMessage = TEXT("Invalid response");
+		OutParsedResponse.HumanReadableErrorMessage = TEXT("Response is incomplete or otherwise invalid");
+		return;
+	}
+
+	TSharedPtr<FJsonObject> Json = MakeShareable(new FJsonObject());
+	const TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(ChunkedResponses.Last());
+
+	const bool bIsDeserializationError = !FJsonSerializer::Deserialize(Reader, Json) || !Json.IsValid();
+	if (bIsDeserializationError)
+	{
+		OutParsedResponse.ErrorMessage = TEXT("Deserialization failed");
+		OutParsedResponse.HumanReadableErrorMessage = TEXT("Deserializing the response to JSON failed");
+		return;
+	}
+
+	OutParsedResponse.Json = Json;
+}
+
+/**
+ * Called on the game thread with a parsed response
+ *
+ * @param Content [in] the response content
+ * @param ParsedResponse [in] the result of parsing the response
+ * @param bIsFinal [in] is this the final response to the request?
+ */
+void FWitRequest::DeliverResponse(const TArray<uint8>& Content, const FParsedResponse& ParsedResponse, const bool bIsFinal)
+{
+	if (!bIsFinal)
+	{
+		const bool bIsValidPartialTranscription = ParsedResponse.Json.IsValid() ? ParsedResponse.Json->HasField("text")
+			: ParsedResponse.bIsConverted && ParsedResponse.Checksums.bHasText;
+		if (!bIsValidPartialTranscription)
+		{
+			return;
+		}
+
+		Configuration.OnRequestProgress.Broadcast(Content, ParsedResponse.Json);
+
+		if (ParsedResponse.bIsConverted)
+		{
+			Configuration.OnRequestProgressWithResponse.Broadcast(Content, ParsedResponse.Json, ParsedResponse.Response, ParsedResponse.Checksums);
+		}
+
+		return;
+	}
+
+	bIsFinalResponsePending = false;
+
+	const bool bIsParseError = !ParsedResponse.Json.IsValid() && (!ParsedResponse.bIsConverted || Configuration.OnRequestComplete.IsBound());
+	if (bIsParseError)
+	{
+		Configuration.OnRequestError.Broadcast(ParsedResponse.ErrorMessage, ParsedResponse.HumanReadableErrorMessage);
+		return;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("DeliverResponse: calling delegate"));
+
+	Configuration.OnRequestComplete.Broadcast(Content, ParsedResponse.Json);
+
+	if (!Configuration.OnRequestCompleteWithResponse.IsBound())
+	{
+		return;
+	}
+
+	// Error bodies such as rate limiting decode to an empty response so they are passed on as errors instead
+
+	const bool bIsErrorResponse = ResponseCode < 200 || ResponseCode >= 300;
+	if (bIsErrorResponse)
+	{
+		const FString ErrorMessage = FString::Format(TEXT("HTTP Error {0}"), { ResponseCode });
+		const FString HumanReadableErrorMessage = FString::Format(TEXT("Request failed with error code {0}"), { ResponseCode });
+
+		Configuration.OnRequestError.Broadcast(ErrorMessage, HumanReadableErrorMessage);
+		return;
+	}
+
+	if (ParsedResponse.bIsConverted)
+	{
+		Configuration.OnRequestCompleteWithResponse.Broadcast(Content, ParsedResponse.Json, ParsedResponse.Response);
+	}
+	else
+	{
+		Configuration.OnRequestError.Broadcast(TEXT("Json To UStruct failed"), TEXT("Converting the Json response to a UStruct failed"));
+	}
+}
+
+/**
+ * Splits a response JSON string into chunks as defined by the Wit.ai response format
+ *
+ * @param Response the string version of the response
+ * @param ChunkedResponses the response broken down into brace delimited chunks
+ */
+void FWitRequest::SplitResponseIntoChunks(const FString& Response, TArray<FString>& ChunkedResponses)
+{
+	int32 StringIndex = 0;
+
+	ChunkedResponses.Reset();
+
+	// The speech endpoint implements chunked responses by using a JSON format that does not strictly conform to the JSON specification.
+	// Because of this UE4's JSON object converter cannot handle it without some preprocessing to break each chunk down into its own
+	// conforming chunk. See the Wit.ai documentation for the specifics of the response format; it consists of a sequence of brace
+	// delimited JSON objects
+
+	while (StringIndex < Response.Len())
+	{
+		const int32 OpeningBraceIndex = Response.Find(TEXT("{"), ESearchCase::IgnoreCase, ESearchDir::FromStart, StringIndex);
+
+		const bool bIsStartOfNewChunk = (OpeningBraceIndex != INDEX_NONE);
+		if (!bIsStartOfNewChunk)
+		{
+			return;
+		}
+
+		StringIndex = OpeningBraceIndex + 1;
+		int32 BraceCount = 1;
+
+		while (BraceCount > 0 && StringIndex < Response.Len())
+		{
+			if (Response[StringIndex] == L'{')
+			{
+				++BraceCount;
+			}
+			else if (Response[StringIndex] == L'}')
+			{
+				--BraceCount;
+			}
+
+			++StringIndex;
+		}
+
+		FString ChunkedResponseString{Response.Mid(OpeningBraceIndex, StringIndex - OpeningBraceIndex)};
+
+		ChunkedResponses.Add(ChunkedResponseString);
+
+		UE_LOG(LogWit, VeryVerbose, TEXT("Chunk string found (%s)"), *ChunkedResponseString);
+	}
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Http.h"
+#include "Wit/Request/WitRequestConfiguration.h"
+#include "Wit/Request/WitResponse.h"
+
+class FJsonObject;
+class FVoiceAudioBlockPool;
+class FWitRequestStream;
+struct FVoiceAudioSpan;
+
+/**
+ * A single Wit.ai request channel. It essentially wraps a UE4 HTTP request while also providing a streaming read buffer.
+ * Any number of these can be in flight at once so each voice session owns its own. Must be created with MakeShared
+ */
+class FWitRequest final : public TSharedFromThis<FWitRequest, ESPMode::ThreadSafe>
+{
+public:
+
+	FWitRequest();
+
+	/**
+	 * Start a Wit.ai request. Depending on the request endpoint this may be a streaming request or not. Only
+	 * the /speech endpoint supports streaming. This should always be paired with a call to EndStreamRequest
+	 *
+	 * @param RequestConfiguration [in] The configuration to use to setup the request
+	 */
+	void BeginStreamRequest(const FWitRequestConfiguration& RequestConfiguration);
+
+	/**
+	 * Finish a Wit.ai request. In the case of a streaming request this should be called when there is no more
+	 * data to send. In the case of one shot requests it can be called immediately after BeginStreamRequest
+	 */
+	void EndStreamRequest();
+
+	/**
+	 * Cancels an inflight Wit.ai request
+	 */
+	void CancelRequest();
+
+	/**
+	 * Is a Wit.ai request currently in progress?
+	 *
+	 * @return true if a request is in progress
+	 */
+	bool IsRequestInProgress() const;
+
+	/**
+	 * Get the number of bytes written to the request that the network has not yet accepted. Callers streaming large
+	 * amounts of data can use this to only write more once earlier data has been sent
+	 *
+	 * @return the number of bytes
+	 */
+	int64 GetNumBytesPendingUpload() const;
+
+	/**
+	 * Get the HTTP response code of the most recently completed request. Error responses such as rate limiting have a body
+	 * so they are delivered as completed requests and callers that care must check this
+	 *
+	 * @return the response code or zero if there is no response
+	 */
+	int32 GetResponseCode() const;
+
+	/**
+	 * Writes the given binary data to the internal stream that the request is using
+	 *
+	 * @param Data [in] the content to add to the stream buffer
+	 */
+	void WriteBinaryData(const TArray<uint8>& Data);
+
+	/**
+	 * Writes a copy of the given binary data to the internal stream that the request is using
+	 *
+	 * @param Data [in] the content to add to the stream buffer
+	 */
+	void WriteBinaryData(TArrayView<const uint8> Data);
+
+	/**
+	 * Writes the given shared audio to the internal stream that the request is using. The audio is referenced rather than copied
+	 *
+	 * @param Data [in] the content to add to the stream buffer
+	 */
+	void WriteBinaryData(const FVoiceAudioSpan& Data);
+
+	/**
+	 * Writes the given Json data to the internal stream that the request is using
+	 *
+	 * @param Data [in] the content to add to the stream buffer
+	 */
+	void WriteJsonData(const TSharedRef<FJsonObject> Data);
+
+private:
+
+	/** Get the pool used for content data that is copied into request streams */
+	static TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe> GetContentBlockPool();
+
+	/** Actually sends the HTTP request */
+	void SendRequest();
+
+	/** Start the response deadline for the current request if it has one */
+	void StartResponseDeadline();
+
+	/** Called when the response deadline passes */
+	void OnResponseDeadline(const uint32 Generation);
+
+	/** Called when an HTTP request is in progress to retrieve any changes to the response payload */
+	void OnRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived);
+
+	/** Called when an HTTP request is fully completed to process the response payload */
+	void OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bIsSuccessful);
+
+	/** Splits a response JSON string into chunks as defined by the Wit.ai response format */
+	static void SplitResponseIntoChunks(const FString& Response, TArray<FString>& ChunkedResponses);
+
+	/** The result of parsing a response off the game thread */
+	struct FParsedResponse
+	{
+		/** The most recent chunk of the response as Json. Null if it was not wanted or parsing failed */
+		TSharedPtr<FJsonObject> Json{};
+
+		/** The response converted to a UStruct if requested */
+		FWitResponse Response{};
+
+		/** Checksums of the sections of the converted response if it was decoded directly */
+		FWitResponseChecksums Checksums{};
+
+		/** Was the response converted to a UStruct? */
+		bool bIsConverted{false};
+
+		/** The error if parsing failed */
+		FString ErrorMessage{};
+
+		/** The human readable error if parsing failed */
+		FString HumanReadableErrorMessage{};
+	};
+
+	/** Parse a response in a background task and deliver the result on the game thread */
+	void DispatchResponse(const TArray<uint8>& Content, const bool bIsFinal);
+
+	/** Parse a response. This is called off the game thread so must not touch the request */
+	static void ParseResponse(const TArray<uint8>& Content, const bool bShouldConvert, const bool bShouldBuildJson, FParsedResponse& OutParsedResponse);
+
+	/** Parse the most recent chunk of a response as Json. This is called off the game thread so must not touch the request */
+	static void ParseResponseJson(const TArray<uint8>& Content, FParsedResponse& OutParsedResponse);
+
+	/** Called on the game thread with a parsed response */
+	void DeliverResponse(const TArray<uint8>& Content, const FParsedResponse& ParsedResponse, const bool bIsFinal);
+
+	/** Used to track if a configuration has been set or not */
+	bool bHasConfiguration{false};
+
+	/** The current configuration setup */
+	FWitRequestConfiguration Configuration{};
+
+	/** The underlying UE4 HTTP request that is used to process the Wit.ai request */
+	FHttpRequestPtr HttpRequest{nullptr};
+
+	/** The content data that makes up the body of a POST request. A new stream is used for each request */
+	TSharedPtr<FWitRequestStream, ESPMode::ThreadSafe> ContentStream{};
+
+	/** The most recently received response length */
+	int32 LastResponseSize{0};
+
+	/** The HTTP response code of the most recently completed request */
+	int32 ResponseCode{0};
+
+	/** Incremented whenever a request begins or is cancelled so that responses and deadlines for an earlier request are discarded */
+	uint32 RequestGeneration{0};
+
+	/** The number of responses dispatched for parsing. Used to discard responses that finish parsing out of order */
+	uint32 NumResponsesDispatched{0};
+
+	/** The number of the most recent response delivered */
+	uint32 LastResponseDelivered{0};
+
+	/** Is the final response being parsed? The request is still in progress until it has been delivered */
+	bool bIsFinalResponsePending{false};
+};
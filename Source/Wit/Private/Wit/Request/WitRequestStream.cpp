@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Request/WitRequestStream.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Misc/ScopeLock.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Constructor
+ *
+ * @param InBlockPool [in] the pool used to hold any data that is written by copy rather than by reference
+ */
+FWitRequestStream::FWitRequestStream(const TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe>& InBlockPool)
+	: BlockPool(InBlockPool)
+{
+	this->SetIsLoading(true);
+	this->SetIsPersistent(false);
+}
+
+/**
+ * Append a span of shared audio to the stream without copying it
+ *
+ * @param Span [in] the span to append
+ */
+void FWitRequestStream::Write(const FVoiceAudioSpan& Span)
+{
+	if (Span.IsEmpty())
+	{
+		return;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+
+	Spans.Add(Span);
+	NumBytesWritten += Span.Num();
+}
+
+/**
+ * Append a copy of the given data to the stream. The data is split across as many pooled blocks as needed
+ *
+ * @param Data [in] the data to append
+ */
+void FWitRequestStream::Write(TArrayView<const uint8> Data)
+{
+	const int32 BlockSize = BlockPool->GetBlockSize();
+	int32 NumBytesCopied = 0;
+
+	while (NumBytesCopied < Data.Num())
+	{
+		const int32 NumBytesToCopy = FMath::Min(BlockSize, Data.Num() - NumBytesCopied);
+		const FVoiceAudioBlockRef Block = BlockPool->Acquire(Data.Slice(NumBytesCopied, NumBytesToCopy));
+
+		Write(FVoiceAudioSpan(Block));
+
+		NumBytesCopied += NumBytesToCopy;
+	}
+}
+
+/**
+ * Get the number of bytes written that have not yet been read
+ *
+ * @return the number of bytes
+ */
+int64 FWitRequestStream::GetNumBytesRemaining()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return NumBytesWritten - ReadPosition;
+}
+
+/**
+ * Read data from the current position. Any spans that have been fully read are released so that their blocks can be
+ * reused while the rest of the stream is still being written
+ *
+ * @param Data [out] the buffer to read into
+ * @param Num [in] the number of bytes to read
+ */
+void FWitRequestStream::Serialize(void* Data, int64 Num)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	uint8* Destination = static_cast<uint8*>(Data);
+	int64 NumBytesRemaining = Num;
+
+	while (NumBytesRemaining > 0 && ReadSpanIndex < Spans.Num())
+	{
+		const FVoiceAudioSpan& Span = Spans[ReadSpanIndex];
+		const int32 NumBytesToCopy = static_cast<int32>(FMath::Min<int64>(Span.Num() - ReadSpanOffset, NumBytesRemaining));
+
+		FMemory::Memcpy(Destination, Span.GetData() + ReadSpanOffset, NumBytesToCopy);
+
+		Destination += NumBytesToCopy;
+		NumBytesRemaining -= NumBytesToCopy;
+		ReadPosition += NumBytesToCopy;
+		ReadSpanOffset += NumBytesToCopy;
+
+		if (ReadSpanOffset >= Span.Num())
+		{
+			++ReadSpanIndex;
+			ReadSpanOffset = 0;
+		}
+	}
+
+	const bool bHasReadSpans = ReadSpanIndex > 0;
+
+	if (bHasReadSpans)
+	{
+		for (int32 i = 0; i < ReadSpanIndex; ++i)
+		{
+			NumBytesReleased += Spans[i].Num();
+		}
+
+#if UE_VERSION_OLDER_THAN(5,4,0)
+		Spans.RemoveAt(0, ReadSpanIndex, false);
+#else
+		Spans.RemoveAt(0, ReadSpanIndex, EAllowShrinking::No);
+#endif
+		ReadSpanIndex = 0;
+	}
+
+	if (NumBytesRemaining > 0)
+	{
+		UE_LOG(LogWit, Warning, TEXT("RequestStream - Serialize: attempted to read (%lld) bytes past the end of the stream"), NumBytesRemaining);
+
+		FMemory::Memzero(Destination, NumBytesRemaining);
+		SetError();
+	}
+}
+
+/**
+ * Move the read position. Data that has already been read is released so it is not possible to seek back before it
+ *
+ * @param InPos [in] the new read position
+ */
+void FWitRequestStream::Seek(int64 InPos)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	const bool bIsBeforeReleasedData = InPos < NumBytesReleased;
+
+	if (bIsBeforeReleasedData)
+	{
+		UE_LOG(LogWit, Warning, TEXT("RequestStream - Seek: cannot seek to (%lld) as data before (%lld) has been released"), InPos, NumBytesReleased);
+
+		SetError();
+	}
+
+	ReadPosition = FMath::Clamp<int64>(InPos, NumBytesReleased, NumBytesWritten);
+	ReadSpanIndex = 0;
+	ReadSpanOffset = 0;
+
+	int64 NumBytesToSkip = ReadPosition - NumBytesReleased;
+
+	while (ReadSpanIndex < Spans.Num() && NumBytesToSkip >= Spans[ReadSpanIndex].Num())
+	{
+		NumBytesToSkip -= Spans[ReadSpanIndex].Num();
+		++ReadSpanIndex;
+	}
+
+	ReadSpanOffset = static_cast<int32>(NumBytesToSkip);
+}
+
+/**
+ * Get the current read position
+ *
+ * @return the read position
+ */
+int64 FWitRequestStream::Tell()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return ReadPosition;
+}
+
+/**
+ * Get the total number of bytes written to the stream so far
+ *
+ * @return the number of bytes
+ */
+int64 FWitRequestStream::TotalSize()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	return NumBytesWritten;
+}
+
+/**
+ * Get the name of the archive for debugging
+ *
+ * @return the name
+ */
+FString FWitRequestStream::GetArchiveName() const
+{
+	return TEXT("FWitRequestStream");
+}
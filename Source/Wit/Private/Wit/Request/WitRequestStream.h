@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+
+/**
+ * Archive used as the body of a streaming Wit.ai request. Data is held as a sequence of shared audio spans so that
+ * captured audio can be queued for upload without being copied. Writes happen on the game thread while reads happen
+ * on the HTTP thread so all access is guarded. The HTTP layer reads the body strictly in order so spans are released as
+ * soon as they have been read, returning their blocks to the pool while the request is still streaming
+ */
+class FWitRequestStream final : public FArchive
+{
+public:
+
+	/**
+	 * Constructor
+	 *
+	 * @param InBlockPool [in] the pool used to hold any data that is written by copy rather than by reference
+	 */
+	explicit FWitRequestStream(const TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe>& InBlockPool);
+
+	/**
+	 * Append a span of shared audio to the stream without copying it
+	 *
+	 * @param Span [in] the span to append
+	 */
+	void Write(const FVoiceAudioSpan& Span);
+
+	/**
+	 * Append a copy of the given data to the stream
+	 *
+	 * @param Data [in] the data to append
+	 */
+	void Write(TArrayView<const uint8> Data);
+
+	/**
+	 * Get the number of bytes written that have not yet been read
+	 *
+	 * @return the number of bytes
+	 */
+	int64 GetNumBytesRemaining();
+
+	/**
+	 * FArchive overrides
+	 */
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual void Seek(int64 InPos) override;
+	virtual int64 Tell() override;
+	virtual int64 TotalSize() override;
+	virtual FString GetArchiveName() const override;
+
+private:
+
+	/** Guards access from the game and HTTP threads */
+	FCriticalSection CriticalSection{};
+
+	/** The pool used for copied data */
+	TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe> BlockPool;
+
+	/** The spans that make up the stream in order */
+	TArray<FVoiceAudioSpan> Spans{};
+
+	/** The total number of bytes written */
+	int64 NumBytesWritten{0};
+
+	/** The number of bytes at the start of the stream whose spans have been released */
+	int64 NumBytesReleased{0};
+
+	/** The current read position */
+	int64 ReadPosition{0};
+
+	/** The span containing the current read position. Spans before this have been fully read */
+	int32 ReadSpanIndex{0};
+
+	/** The offset of the current read position within its span */
+	int32 ReadSpanOffset{0};
+};
@@ -9,19 +9,18 @@
 
 #include "CoreMinimal.h"
 #include "Http.h"
-#include "Serialization/BufferArchive.h"
 #include "Wit/Request/WitRequestConfiguration.h"
 #include "Subsystems/EngineSubsystem.h"
-#include "Serialization/MemoryReader.h"
 #include "WitRequestSubsystem.generated.h"
 
 class FJsonObject;
-class FMemoryReader;
 class FSubsystemCollectionBase;
+class FWitRequest;
+struct FVoiceAudioSpan;
 
 /**
- * A class to track an in progress Wit.ai request. It essentially wraps a UE4 HTTP request
- * while also providing a streaming read buffer
+ * Engine wide access to Wit.ai requests. Provides a default request for one shot utilities such as TTS and configuration
+ * and creates independent requests for anything that needs to run concurrently such as voice sessions
  */
 UCLASS()
 class UWitRequestSubsystem final : public UEngineSubsystem
@@ -44,6 +43,13 @@ public:
 	 */
 	virtual void Deinitialize() override;
 
+	/**
+	 * Create a new independent request. The request can run at the same time as any other request
+	 *
+	 * @return the new request
+	 */
+	static TSharedRef<FWitRequest, ESPMode::ThreadSafe> CreateRequest();
+
 	/**
 	 * Start a Wit.ai request. Depending on the request endpoint this may be a streaming request or not. Only
 	 * the /speech endpoint supports streaming. This should always be paired with a call to EndStreamRequest
@@ -77,6 +83,13 @@ public:
 	 */
 	void WriteBinaryData(const TArray<uint8>& Data);
 
+	/**
+	 * Writes the given shared audio to the internal stream that the request is using. The audio is referenced rather than copied
+	 *
+	 * @param Data [in] the content to add to the stream buffer
+	 */
+	void WriteBinaryData(const FVoiceAudioSpan& Data);
+
 	/**
 	 * Writes the given Json data to the internal stream that the request is using
 	 *
@@ -86,33 +99,6 @@ public:
 
 private:
 
-	/** Actually sends the HTTP request */
-	void SendRequest();
-
-	/** Called when an HTTP request is in progress to retrieve any changes to the response payload */
-	void OnRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived);
-
-	/** Called when an HTTP request is fully completed to process the response payload */
-	void OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bIsSuccessful);
-	
-	/** Splits a response JSON string into chunks as defined by the Wit.ai response format */
-	static void SplitResponseIntoChunks(const FString& Response, TArray<FString>& ChunkedResponses);
-
-	/** Used to track if a configuration has been set or not */
-	bool bHasConfiguration{false};
-
-	/** The current configuration setup */
-	FWitRequestConfiguration Configuration{};
-
-	/** The underlying UE4 HTTP request that is used to process the Wit.ai request */
-	FHttpRequestPtr HttpRequest{nullptr};
-
-	/** The raw content data that makes up the body of a POST request */
-	TArray<uint8> ContentStream{};
-
-	/** Wraps the ContentStream to provide an FArchive interface for a streaming Wit.ai request */
-	TSharedPtr<FMemoryReader, ESPMode::ThreadSafe> MemoryReader{};
-
-	/** The most recently received response length */
-	int32 LastResponseSize{0};
+	/** The default request used by the one shot utilities */
+	TSharedPtr<FWitRequest, ESPMode::ThreadSafe> DefaultRequest{};
 };
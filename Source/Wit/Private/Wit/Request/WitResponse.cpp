@@ -7,6 +7,31 @@
 
 #include "Wit/Request/WitResponse.h"
 
+/**
+ * Get the sections that differ from an earlier response. Every section is treated as changed if either set of checksums is not valid
+ *
+ * @param Previous [in] the checksums of the earlier response
+ * @return the sections that changed
+ */
+EWitResponseChange FWitResponseChecksums::GetChanges(const FWitResponseChecksums& Previous) const
+{
+	const bool bIsComparable = bIsValid && Previous.bIsValid;
+	if (!bIsComparable)
+	{
+		return EWitResponseChange::Text | EWitResponseChange::Intents | EWitResponseChange::Entities | EWitResponseChange::Traits | EWitResponseChange::IsFinal;
+	}
+
+	EWitResponseChange Changes = EWitResponseChange::None;
+
+	if (Text != Previous.Text) { Changes |= EWitResponseChange::Text; }
+	if (Intents != Previous.Intents) { Changes |= EWitResponseChange::Intents; }
+	if (Entities != Previous.Entities) { Changes |= EWitResponseChange::Entities; }
+	if (Traits != Previous.Traits) { Changes |= EWitResponseChange::Traits; }
+	if (IsFinal != Previous.IsFinal) { Changes |= EWitResponseChange::IsFinal; }
+
+	return Changes;
+}
+
 /**
  * Reset the response to its defaults
  */
@@ -18,4 +43,94 @@ void FWitResponse::Reset()
 	AllEntities.Empty(0);
 	Traits.Empty(0);
 	Is_Final = false;
+	AdditionalEntities.Empty(0);
+	bIsAllEntitiesBuilt = true;
+}
+
+/**
+ * Get all the entities for each name. If AllEntities has not been built yet it is built now from the first entity of
+ * each name in Entities followed by any additional entities
+ *
+ * @return all the entities
+ */
+const TMap<FString, FWitEntities>& FWitResponse::GetAllEntities()
+{
+	if (bIsAllEntitiesBuilt)
+	{
+		return AllEntities;
+	}
+
+	AllEntities.Reset();
+	AllEntities.Reserve(Entities.Num());
+
+	for (const TPair<FString, FWitEntity>& Entity : Entities)
+	{
+		FWitEntities& NamedEntities = AllEntities.Add(Entity.Key);
+
+		NamedEntities.Name = Entity.Key;
+		NamedEntities.Entities.Add(Entity.Value);
+	}
+
+	for (TPair<FName, FWitEntity>& Entity : AdditionalEntities)
+	{
+		FWitEntities* NamedEntities = AllEntities.Find(Entity.Key.ToString());
+
+		if (NamedEntities != nullptr)
+		{
+			NamedEntities->Entities.Add(MoveTemp(Entity.Value));
+		}
+	}
+
+	AdditionalEntities.Reset();
+	bIsAllEntitiesBuilt = true;
+
+	return AllEntities;
+}
+
+/**
+ * Visit every entity with the given name in the order they appear in the response
+ *
+ * @param Name [in] the entity name including the role
+ * @param Visitor [in] called for each entity
+ */
+void FWitResponse::ForEachEntity(const FString& Name, TFunctionRef<void(const FWitEntity&)> Visitor) const
+{
+	if (bIsAllEntitiesBuilt)
+	{
+		if (const FWitEntities* NamedEntities = AllEntities.Find(Name))
+		{
+			for (const FWitEntity& Entity : NamedEntities->Entities)
+			{
+				Visitor(Entity);
+			}
+		}
+
+		return;
+	}
+
+	const FWitEntity* FirstEntity = Entities.Find(Name);
+
+	if (FirstEntity == nullptr)
+	{
+		return;
+	}
+
+	Visitor(*FirstEntity);
+
+	// Every additional entity name was interned when decoded so a name that cannot be found has no additional entities
+
+	const FName InternedName(*Name, FNAME_Find);
+
+	if (InternedName.IsNone())
+	{
+		return;
+	}
+
+	for (const TPair<FName, FWitEntity>& Entity : AdditionalEntities)
+	{
+		if (Entity.Key == InternedName)
+		{
+			Visitor(Entity.Value);
+		}
+	}
 }
@@ -0,0 +1,1032 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Request/WitResponseDecoder.h"
+#include "Misc/Crc.h"
+#include "Misc/Parse.h"
+#include "Wit/Request/WitResponse.h"
+
+/**
+ * The name of an object member. This is a view of the raw bytes in the response since member names are compared far more
+ * often than they are kept
+ */
+struct FWitJsonKey
+{
+	/** The start of the name */
+	const ANSICHAR* Data{nullptr};
+
+	/** The length of the name in bytes */
+	int32 Num{0};
+
+	/**
+	 * Does the key match the given name? Like FJsonObjectConverter the comparison ignores case
+	 *
+	 * @param Name [in] the name to compare with
+	 * @return true if it matches
+	 */
+	template <int32 NameSize>
+	bool Equals(const ANSICHAR (&Name)[NameSize]) const
+	{
+		return Num == NameSize - 1 && FCStringAnsi::Strnicmp(Data, Name, Num) == 0;
+	}
+
+	/**
+	 * Convert the key to a string
+	 *
+	 * @return the key as a string
+	 */
+	FString ToString() const
+	{
+		const FUTF8ToTCHAR Converter(Data, Num);
+
+		return FString(Converter.Length(), Converter.Get());
+	}
+};
+
+/**
+ * Minimal pull reader over UTF-8 Json. Values are read straight into their destination and anything that is not wanted is
+ * skipped without being decoded. Type mismatches follow FJsonObjectConverter so numbers can be read as strings and strings
+ * as numbers
+ */
+class FWitJsonReader
+{
+public:
+
+	FWitJsonReader(const uint8* InData, const int32 InNum)
+		: Cursor(reinterpret_cast<const ANSICHAR*>(InData))
+		, End(reinterpret_cast<const ANSICHAR*>(InData) + InNum)
+	{
+		// Deliberately empty
+	}
+
+	/** Has the reader encountered malformed Json? */
+	bool HasError() const
+	{
+		return bHasError;
+	}
+
+	/** Get the current position in the Json */
+	const ANSICHAR* GetCursor() const
+	{
+		return Cursor;
+	}
+
+	/** Is the next value an object? */
+	bool IsObject()
+	{
+		return PeekValue() == '{';
+	}
+
+	/** Is the next value an array? */
+	bool IsArray()
+	{
+		return PeekValue() == '[';
+	}
+
+	/** Start reading an object. If the next value is not an object it is skipped */
+	bool ReadObjectStart()
+	{
+		if (!IsObject())
+		{
+			SkipValue();
+			return false;
+		}
+
+		++Cursor;
+		return true;
+	}
+
+	/** Read the name of the next member of the current object. Returns false at the end of the object */
+	bool ReadNextKey(FWitJsonKey& OutKey)
+	{
+		if (!ReadNextItem('}'))
+		{
+			return false;
+		}
+
+		if (*Cursor != '"')
+		{
+			return SetError();
+		}
+
+		const ANSICHAR* KeyStart = ++Cursor;
+
+		if (!SkipStringBody())
+		{
+			return false;
+		}
+
+		OutKey.Data = KeyStart;
+		OutKey.Num = static_cast<int32>(Cursor - KeyStart - 1);
+
+		SkipWhitespace();
+
+		if (Cursor >= End || *Cursor != ':')
+		{
+			return SetError();
+		}
+
+		++Cursor;
+		return true;
+	}
+
+	/** Start reading an array. If the next value is not an array it is skipped */
+	bool ReadArrayStart()
+	{
+		if (!IsArray())
+		{
+			SkipValue();
+			return false;
+		}
+
+		++Cursor;
+		return true;
+	}
+
+	/** Move to the next element of the current array. Returns false at the end of the array */
+	bool ReadNextElement()
+	{
+		return ReadNextItem(']');
+	}
+
+	/** Read a value as a string */
+	void ReadString(FString& OutValue)
+	{
+		OutValue.Reset();
+
+		const ANSICHAR Next = PeekValue();
+
+		if (Next == '"')
+		{
+			++Cursor;
+			ReadStringBody(OutValue);
+		}
+		else if (Next == '-' || FChar::IsDigit(Next))
+		{
+			OutValue = FString::SanitizeFloat(ReadNumber(), 0);
+		}
+		else if (Next == 't' || Next == 'f')
+		{
+			OutValue = ReadLiteral() ? TEXT("true") : TEXT("false");
+		}
+		else
+		{
+			SkipValue();
+		}
+	}
+
+	/** Read a value as an integer. Strings are parsed so that large ids are not rounded through a double */
+	void ReadInt64(int64& OutValue)
+	{
+		const ANSICHAR Next = PeekValue();
+
+		if (Next == '"')
+		{
+			FString Value;
+			ReadString(Value);
+			OutValue = FCString::Atoi64(*Value);
+		}
+		else if (Next == '-' || FChar::IsDigit(Next))
+		{
+			ANSICHAR Token[64];
+			ReadNumberToken(Token);
+
+			const bool bIsInteger = FCStringAnsi::Strchr(Token, '.') == nullptr && FCStringAnsi::Strchr(Token, 'e') == nullptr && FCStringAnsi::Strchr(Token, 'E') == nullptr;
+
+			OutValue = bIsInteger ? FCStringAnsi::Atoi64(Token) : static_cast<int64>(FCStringAnsi::Atod(Token));
+		}
+		else
+		{
+			SkipValue();
+		}
+	}
+
+	/** Read a value as a 32-bit integer */
+	void ReadInt32(int32& OutValue)
+	{
+		int64 Value = OutValue;
+		ReadInt64(Value);
+		OutValue = static_cast<int32>(Value);
+	}
+
+	/** Read a value as a float */
+	void ReadFloat(float& OutValue)
+	{
+		const ANSICHAR Next = PeekValue();
+
+		if (Next == '"')
+		{
+			FString Value;
+			ReadString(Value);
+			OutValue = FCString::Atof(*Value);
+		}
+		else if (Next == '-' || FChar::IsDigit(Next))
+		{
+			OutValue = static_cast<float>(ReadNumber());
+		}
+		else
+		{
+			SkipValue();
+		}
+	}
+
+	/** Read a value as a bool */
+	void ReadBool(bool& OutValue)
+	{
+		const ANSICHAR Next = PeekValue();
+
+		if (Next == 't' || Next == 'f')
+		{
+			OutValue = ReadLiteral();
+		}
+		else if (Next == '-' || FChar::IsDigit(Next))
+		{
+			OutValue = ReadNumber() != 0.0;
+		}
+		else
+		{
+			SkipValue();
+		}
+	}
+
+	/** Skip over the next value whatever it is */
+	void SkipValue()
+	{
+		const ANSICHAR Next = PeekValue();
+
+		if (Next == '"')
+		{
+			++Cursor;
+			SkipStringBody();
+		}
+		else if (Next == '{' || Next == '[')
+		{
+			// Nested containers only need their brackets balanced. Strings are skipped as a whole so brackets inside them are ignored
+
+			int32 Depth = 0;
+
+			while (Cursor < End)
+			{
+				const ANSICHAR Character = *Cursor++;
+
+				if (Character == '"')
+				{
+					if (!SkipStringBody())
+					{
+						return;
+					}
+				}
+				else if (Character == '{' || Character == '[')
+				{
+					++Depth;
+				}
+				else if ((Character == '}' || Character == ']') && --Depth == 0)
+				{
+					return;
+				}
+			}
+
+			SetError();
+		}
+		else if (Next == '-' || FChar::IsDigit(Next))
+		{
+			ANSICHAR Token[64];
+			ReadNumberToken(Token);
+		}
+		else if (Next == 't' || Next == 'f' || Next == 'n')
+		{
+			ReadLiteral();
+		}
+		else
+		{
+			SetError();
+		}
+	}
+
+private:
+
+	/** Skip whitespace and return the first character of the next value */
+	ANSICHAR PeekValue()
+	{
+		SkipWhitespace();
+
+		return Cursor < End ? *Cursor : '\0';
+	}
+
+	/** Skip whitespace */
+	void SkipWhitespace()
+	{
+		while (Cursor < End && (*Cursor == ' ' || *Cursor == '\t' || *Cursor == '\n' || *Cursor == '\r'))
+		{
+			++Cursor;
+		}
+	}
+
+	/** Move past the separator to the next item of an object or array. Returns false at the closing character */
+	bool ReadNextItem(const ANSICHAR Closing)
+	{
+		SkipWhitespace();
+
+		if (Cursor < End && *Cursor == ',')
+		{
+			++Cursor;
+			SkipWhitespace();
+		}
+
+		if (Cursor >= End)
+		{
+			return SetError();
+		}
+
+		if (*Cursor == Closing)
+		{
+			++Cursor;
+			return false;
+		}
+
+		return true;
+	}
+
+	/** Skip to just past the closing quote of a string whose opening quote has been read */
+	bool SkipStringBody()
+	{
+		while (Cursor < End)
+		{
+			const ANSICHAR Character = *Cursor++;
+
+			if (Character == '"')
+			{
+				return true;
+			}
+
+			if (Character == '\\')
+			{
+				++Cursor;
+			}
+		}
+
+		return SetError();
+	}
+
+	/** Read a string whose opening quote has been read. Runs without escapes are converted from UTF-8 in one go */
+	void ReadStringBody(FString& OutValue)
+	{
+		const ANSICHAR* RunStart = Cursor;
+
+		auto AppendRun = [&OutValue, &RunStart, this]()
+		{
+			if (Cursor > RunStart)
+			{
+				const FUTF8ToTCHAR Converter(RunStart, static_cast<int32>(Cursor - RunStart));
+				OutValue.AppendChars(Converter.Get(), Converter.Length());
+			}
+		};
+
+		while (Cursor < End)
+		{
+			const ANSICHAR Character = *Cursor;
+
+			if (Character == '"')
+			{
+				AppendRun();
+				++Cursor;
+				return;
+			}
+
+			if (Character != '\\')
+			{
+				++Cursor;
+				continue;
+			}
+
+			AppendRun();
+
+			if (++Cursor >= End)
+			{
+				break;
+			}
+
+			const ANSICHAR Escaped = *Cursor++;
+
+			switch (Escaped)
+			{
+			case 'b': OutValue.AppendChar(TEXT('\b')); break;
+			case 'f': OutValue.AppendChar(TEXT('\f')); break;
+			case 'n': OutValue.AppendChar(TEXT('\n')); break;
+			case 'r': OutValue.AppendChar(TEXT('\r')); break;
+			case 't': OutValue.AppendChar(TEXT('\t')); break;
+			case 'u': AppendCodeUnit(OutValue); break;
+			default: OutValue.AppendChar(static_cast<TCHAR>(Escaped)); break;
+			}
+
+			RunStart = Cursor;
+		}
+
+		SetError();
+	}
+
+	/** Append a \u escape. Surrogate pairs are combined when TCHAR is wider than UTF-16 */
+	void AppendCodeUnit(FString& OutValue)
+	{
+		uint32 CodePoint = ReadHex4();
+
+		const bool bIsHighSurrogate = CodePoint >= 0xD800 && CodePoint <= 0xDBFF;
+		const bool bHasLowSurrogate = bIsHighSurrogate && End - Cursor >= 6 && Cursor[0] == '\\' && Cursor[1] == 'u';
+
+		if (bHasLowSurrogate && sizeof(TCHAR) > 2)
+		{
+			Cursor += 2;
+			CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (ReadHex4() - 0xDC00);
+		}
+
+		OutValue.AppendChar(static_cast<TCHAR>(CodePoint));
+	}
+
+	/** Read four hex digits */
+	uint32 ReadHex4()
+	{
+		uint32 Value = 0;
+
+		for (int32 Index = 0; Index < 4 && Cursor < End; ++Index)
+		{
+			Value = (Value << 4) | FParse::HexDigit(*Cursor++);
+		}
+
+		return Value;
+	}
+
+	/** Copy a number into a null terminated buffer */
+	void ReadNumberToken(ANSICHAR (&OutToken)[64])
+	{
+		int32 Length = 0;
+
+		while (Cursor < End && (FChar::IsDigit(*Cursor) || *Cursor == '-' || *Cursor == '+' || *Cursor == '.' || *Cursor == 'e' || *Cursor == 'E'))
+		{
+			if (Length < 63)
+			{
+				OutToken[Length++] = *Cursor;
+			}
+
+			++Cursor;
+		}
+
+		OutToken[Length] = '\0';
+	}
+
+	/** Read a number */
+	double ReadNumber()
+	{
+		ANSICHAR Token[64];
+		ReadNumberToken(Token);
+
+		return FCStringAnsi::Atod(Token);
+	}
+
+	/** Read true, false or null. Returns true only for true */
+	bool ReadLiteral()
+	{
+		const bool bIsTrue = End - Cursor >= 4 && FCStringAnsi::Strncmp(Cursor, "true", 4) == 0;
+
+		while (Cursor < End && FChar::IsAlpha(*Cursor))
+		{
+			++Cursor;
+		}
+
+		return bIsTrue;
+	}
+
+	/** Flag malformed Json and stop reading */
+	bool SetError()
+	{
+		bHasError = true;
+		Cursor = End;
+
+		return false;
+	}
+
+	/** The next character to read */
+	const ANSICHAR* Cursor;
+
+	/** The end of the Json */
+	const ANSICHAR* End;
+
+	/** Has malformed Json been encountered? */
+	bool bHasError{false};
+};
+
+/**
+ * Decode an entity interval object
+ */
+static void DecodeEntityInterval(FWitJsonReader& Reader, FWitEntityInterval& OutInterval)
+{
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (Key.Equals("value")) { Reader.ReadString(OutInterval.Value); }
+		else if (Key.Equals("unit")) { Reader.ReadString(OutInterval.Unit); }
+		else if (Key.Equals("grain")) { Reader.ReadString(OutInterval.Grain); }
+		else if (Key.Equals("product")) { Reader.ReadString(OutInterval.Product); }
+		else { Reader.SkipValue(); }
+	}
+}
+
+/**
+ * Decode an entity normalized object
+ */
+static void DecodeEntityNormalized(FWitJsonReader& Reader, FWitEntityNormalized& OutNormalized)
+{
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (Key.Equals("value")) { Reader.ReadString(OutNormalized.Value); }
+		else if (Key.Equals("unit")) { Reader.ReadString(OutNormalized.Unit); }
+		else { Reader.SkipValue(); }
+	}
+}
+
+/**
+ * Decode an entity value object
+ */
+static void DecodeEntityValue(FWitJsonReader& Reader, FWitEntityValue& OutValue)
+{
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (Key.Equals("value")) { Reader.ReadString(OutValue.Value); }
+		else if (Key.Equals("type")) { Reader.ReadString(OutValue.Type); }
+		else if (Key.Equals("grain")) { Reader.ReadString(OutValue.Grain); }
+		else if (Key.Equals("from")) { DecodeEntityInterval(Reader, OutValue.From); }
+		else if (Key.Equals("to")) { DecodeEntityInterval(Reader, OutValue.To); }
+		else { Reader.SkipValue(); }
+	}
+}
+
+/**
+ * Decode an entity object
+ */
+static void DecodeEntity(FWitJsonReader& Reader, FWitEntity& OutEntity)
+{
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (Key.Equals("value")) { Reader.ReadString(OutEntity.Value); }
+		else if (Key.Equals("name")) { Reader.ReadString(OutEntity.Name); }
+		else if (Key.Equals("id")) { Reader.ReadInt64(OutEntity.Id); }
+		else if (Key.Equals("role")) { Reader.ReadString(OutEntity.Role); }
+		else if (Key.Equals("body")) { Reader.ReadString(OutEntity.Body); }
+		else if (Key.Equals("confidence")) { Reader.ReadFloat(OutEntity.Confidence); }
+		else if (Key.Equals("type")) { Reader.ReadString(OutEntity.Type); }
+		else if (Key.Equals("unit")) { Reader.ReadString(OutEntity.Unit); }
+		else if (Key.Equals("grain")) { Reader.ReadString(OutEntity.Grain); }
+		else if (Key.Equals("start")) { Reader.ReadInt32(OutEntity.Start); }
+		else if (Key.Equals("end")) { Reader.ReadInt32(OutEntity.End); }
+		else if (Key.Equals("from")) { DecodeEntityInterval(Reader, OutEntity.From); }
+		else if (Key.Equals("to")) { DecodeEntityInterval(Reader, OutEntity.To); }
+		else if (Key.Equals("normalized")) { DecodeEntityNormalized(Reader, OutEntity.Normalized); }
+		else if (Key.Equals("values"))
+		{
+			OutEntity.Values.Reset();
+
+			if (Reader.ReadArrayStart())
+			{
+				while (Reader.ReadNextElement())
+				{
+					DecodeEntityValue(Reader, OutEntity.Values.AddDefaulted_GetRef());
+				}
+			}
+		}
+		else { Reader.SkipValue(); }
+	}
+}
+
+/**
+ * Decode an intent object
+ */
+static void DecodeIntent(FWitJsonReader& Reader, FWitIntent& OutIntent)
+{
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (Key.Equals("name")) { Reader.ReadString(OutIntent.Name); }
+		else if (Key.Equals("id")) { Reader.ReadInt64(OutIntent.Id); }
+		else if (Key.Equals("confidence")) { Reader.ReadFloat(OutIntent.Confidence); }
+		else { Reader.SkipValue(); }
+	}
+}
+
+/**
+ * Decode a trait object
+ */
+static void DecodeTrait(FWitJsonReader& Reader, FWitTrait& OutTrait)
+{
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (Key.Equals("value")) { Reader.ReadString(OutTrait.Value); }
+		else if (Key.Equals("id")) { Reader.ReadInt64(OutTrait.Id); }
+		else if (Key.Equals("confidence")) { Reader.ReadFloat(OutTrait.Confidence); }
+		else { Reader.SkipValue(); }
+	}
+}
+
+/**
+ * Decode the entities object. Each name maps to an array of entities. Entities keeps only the first of each as
+ * FJsonObjectConverter does. The rest are kept in AdditionalEntities under the interned name so that each entity is only
+ * decoded and stored once and names are not copied per entity. AllEntities is built from them when needed
+ */
+static void DecodeEntities(FWitJsonReader& Reader, FWitResponse& OutResponse)
+{
+	OutResponse.Entities.Reset();
+	OutResponse.AllEntities.Reset();
+	OutResponse.AdditionalEntities.Reset();
+	OutResponse.bIsAllEntitiesBuilt = false;
+
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		const FString Name = Key.ToString();
+
+		FWitEntity& FirstEntity = OutResponse.Entities.Add(Name);
+		FName InternedName{};
+
+		if (Reader.IsObject())
+		{
+			DecodeEntity(Reader, FirstEntity);
+		}
+		else if (Reader.ReadArrayStart())
+		{
+			bool bIsFirstEntity = true;
+
+			while (Reader.ReadNextElement())
+			{
+				if (bIsFirstEntity)
+				{
+					DecodeEntity(Reader, FirstEntity);
+					bIsFirstEntity = false;
+				}
+				else
+				{
+					if (InternedName.IsNone())
+					{
+						InternedName = FName(*Name);
+					}
+
+					TPair<FName, FWitEntity>& AdditionalEntity = OutResponse.AdditionalEntities.Emplace_GetRef(InternedName, FWitEntity());
+					DecodeEntity(Reader, AdditionalEntity.Value);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Decode the traits object. Each name maps to an array of traits of which only the first is kept as FJsonObjectConverter does
+ */
+static void DecodeTraits(FWitJsonReader& Reader, FWitResponse& OutResponse)
+{
+	OutResponse.Traits.Reset();
+
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		FWitTrait& Trait = OutResponse.Traits.Add(Key.ToString());
+
+		if (Reader.IsObject())
+		{
+			DecodeTrait(Reader, Trait);
+		}
+		else if (Reader.ReadArrayStart())
+		{
+			for (int32 Index = 0; Reader.ReadNextElement(); ++Index)
+			{
+				if (Index == 0)
+				{
+					DecodeTrait(Reader, Trait);
+				}
+				else
+				{
+					Reader.SkipValue();
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Decode a single field of a response object
+ */
+static void DecodeResponseField(FWitJsonReader& Reader, const FWitJsonKey& Key, FWitResponse& OutResponse)
+{
+	if (Key.Equals("text")) { Reader.ReadString(OutResponse.Text); }
+	else if (Key.Equals("intents"))
+	{
+		OutResponse.Intents.Reset();
+
+		if (Reader.ReadArrayStart())
+		{
+			while (Reader.ReadNextElement())
+			{
+				DecodeIntent(Reader, OutResponse.Intents.AddDefaulted_GetRef());
+			}
+		}
+	}
+	else if (Key.Equals("entities")) { DecodeEntities(Reader, OutResponse); }
+	else if (Key.Equals("traits")) { DecodeTraits(Reader, OutResponse); }
+	else if (Key.Equals("is_final")) { Reader.ReadBool(OutResponse.Is_Final); }
+	else { Reader.SkipValue(); }
+}
+
+/**
+ * Decode a response object. If checksums are wanted each section is checksummed over the Json it was decoded from and the
+ * kind of chunk is recorded
+ */
+static void DecodeResponseObject(FWitJsonReader& Reader, FWitResponse& OutResponse, FWitResponseChecksums* OutChecksums)
+{
+	if (!Reader.ReadObjectStart())
+	{
+		return;
+	}
+
+	FWitJsonKey Key;
+
+	while (Reader.ReadNextKey(Key))
+	{
+		const ANSICHAR* ValueStart = Reader.GetCursor();
+		uint32* Checksum = nullptr;
+
+		if (OutChecksums != nullptr)
+		{
+			if (Key.Equals("text")) { Checksum = &OutChecksums->Text; OutChecksums->bHasText = true; }
+			else if (Key.Equals("intents")) { Checksum = &OutChecksums->Intents; OutChecksums->bHasIntents = true; }
+			else if (Key.Equals("entities")) { Checksum = &OutChecksums->Entities; }
+			else if (Key.Equals("traits")) { Checksum = &OutChecksums->Traits; }
+			else if (Key.Equals("is_final")) { Checksum = &OutChecksums->IsFinal; }
+			else if (Key.Equals("type"))
+			{
+				FString Type;
+
+				Reader.ReadString(Type);
+				OutChecksums->bIsFinalTranscription = Type.Equals(TEXT("FINAL_TRANSCRIPTION"));
+
+				continue;
+			}
+		}
+
+		DecodeResponseField(Reader, Key, OutResponse);
+
+		if (Checksum != nullptr)
+		{
+			*Checksum = FCrc::MemCrc32(ValueStart, static_cast<int32>(Reader.GetCursor() - ValueStart), 1);
+		}
+	}
+}
+
+/**
+ * Decode a /message, /speech or /dictation response
+ *
+ * @param Utf8Response [in] the response body
+ * @param OutResponse [out] the decoded response
+ * @param OutChecksums [out] optional checksums of each section of the response
+ * @return true if the response was decoded successfully
+ */
+bool FWitResponseDecoder::DecodeResponse(TArrayView<const uint8> Utf8Response, FWitResponse& OutResponse, FWitResponseChecksums* OutChecksums)
+{
+	const TArrayView<const uint8> Object = FindLastObject(Utf8Response);
+
+	if (Object.Num() == 0)
+	{
+		return false;
+	}
+
+	FWitJsonReader Reader(Object.GetData(), Object.Num());
+
+	if (OutChecksums != nullptr)
+	{
+		*OutChecksums = FWitResponseChecksums{};
+	}
+
+	DecodeResponseObject(Reader, OutResponse, OutChecksums);
+
+	const bool bIsDecoded = !Reader.HasError();
+
+	if (OutChecksums != nullptr)
+	{
+		OutChecksums->bIsValid = bIsDecoded;
+	}
+
+	return bIsDecoded;
+}
+
+/**
+ * Decode a composer response
+ *
+ * @param Utf8Response [in] the response body
+ * @param OutResponse [out] the decoded response
+ * @return true if the response was decoded successfully
+ */
+bool FWitResponseDecoder::DecodeComposerResponse(TArrayView<const uint8> Utf8Response, FWitComposerResponse& OutResponse)
+{
+	const TArrayView<const uint8> Object = FindLastObject(Utf8Response);
+
+	if (Object.Num() == 0)
+	{
+		return false;
+	}
+
+	FWitJsonReader Reader(Object.GetData(), Object.Num());
+	FWitJsonKey Key;
+
+	Reader.ReadObjectStart();
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (Key.Equals("expects_input")) { Reader.ReadBool(OutResponse.Expects_Input); }
+		else if (Key.Equals("action")) { Reader.ReadString(OutResponse.Action); }
+		else if (Key.Equals("response")) { DecodeResponseObject(Reader, OutResponse.Response, nullptr); }
+		else { Reader.SkipValue(); }
+	}
+
+	return !Reader.HasError();
+}
+
+/**
+ * Decode a /voices response
+ *
+ * @param Utf8Response [in] the response body
+ * @param OutResponse [out] the decoded response
+ * @return true if the response was decoded successfully
+ */
+bool FWitResponseDecoder::DecodeVoicesResponse(TArrayView<const uint8> Utf8Response, FWitVoicesResponse& OutResponse)
+{
+	const TArrayView<const uint8> Object = FindLastObject(Utf8Response);
+
+	if (Object.Num() == 0)
+	{
+		return false;
+	}
+
+	FWitJsonReader Reader(Object.GetData(), Object.Num());
+	FWitJsonKey Key;
+
+	Reader.ReadObjectStart();
+
+	while (Reader.ReadNextKey(Key))
+	{
+		if (!Key.Equals("en_us"))
+		{
+			Reader.SkipValue();
+			continue;
+		}
+
+		OutResponse.En_US.Reset();
+
+		if (!Reader.ReadArrayStart())
+		{
+			continue;
+		}
+
+		while (Reader.ReadNextElement())
+		{
+			FWitVoiceDefinition& Voice = OutResponse.En_US.AddDefaulted_GetRef();
+			FWitJsonKey VoiceKey;
+
+			if (!Reader.ReadObjectStart())
+			{
+				continue;
+			}
+
+			while (Reader.ReadNextKey(VoiceKey))
+			{
+				if (VoiceKey.Equals("name")) { Reader.ReadString(Voice.Name); }
+				else if (VoiceKey.Equals("locale")) { Reader.ReadString(Voice.Locale); }
+				else if (VoiceKey.Equals("gender")) { Reader.ReadString(Voice.Gender); }
+				else if (VoiceKey.Equals("styles"))
+				{
+					Voice.Styles.Reset();
+
+					if (Reader.ReadArrayStart())
+					{
+						while (Reader.ReadNextElement())
+						{
+							Reader.ReadString(Voice.Styles.AddDefaulted_GetRef());
+						}
+					}
+				}
+				else { Reader.SkipValue(); }
+			}
+		}
+	}
+
+	return !Reader.HasError();
+}
+
+/**
+ * Find the last top level object in a response body. Chunked speech responses are a sequence of objects and the last one
+ * is the most recent. Braces inside strings are ignored
+ *
+ * @param Utf8Response [in] the response body
+ * @return a view of the last object or an empty view if there is none
+ */
+TArrayView<const uint8> FWitResponseDecoder::FindLastObject(TArrayView<const uint8> Utf8Response)
+{
+	int32 Depth = 0;
+	int32 ObjectStart = INDEX_NONE;
+	int32 LastObjectStart = INDEX_NONE;
+	int32 LastObjectEnd = INDEX_NONE;
+	bool bIsInString = false;
+
+	for (int32 Index = 0; Index < Utf8Response.Num(); ++Index)
+	{
+		const uint8 Character = Utf8Response[Index];
+
+		if (bIsInString)
+		{
+			if (Character == '\\')
+			{
+				++Index;
+			}
+			else if (Character == '"')
+			{
+				bIsInString = false;
+			}
+
+			continue;
+		}
+
+		if (Character == '"')
+		{
+			bIsInString = true;
+		}
+		else if (Character == '{')
+		{
+			if (Depth++ == 0)
+			{
+				ObjectStart = Index;
+			}
+		}
+		else if (Character == '}' && Depth > 0 && --Depth == 0)
+		{
+			LastObjectStart = ObjectStart;
+			LastObjectEnd = Index + 1;
+		}
+	}
+
+	if (LastObjectStart == INDEX_NONE)
+	{
+		return TArrayView<const uint8>();
+	}
+
+	return Utf8Response.Slice(LastObjectStart, LastObjectEnd - LastObjectStart);
+}
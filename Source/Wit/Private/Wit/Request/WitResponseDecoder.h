@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWitComposerResponse;
+struct FWitResponse;
+struct FWitResponseChecksums;
+struct FWitVoicesResponse;
+
+/**
+ * Decodes the known Wit.ai response schemas directly from the UTF-8 response body into their UStructs in a single pass. This
+ * avoids building a Json DOM and converting it through reflection which is expensive for large responses with many entities.
+ * Unknown fields are skipped. The results match FJsonObjectConverter for the fields that the UStructs define. If the body is
+ * a chunked speech response containing several objects then the last object is decoded
+ */
+class FWitResponseDecoder
+{
+public:
+
+	/**
+	 * Decode a /message, /speech or /dictation response. Fields that are not present in the response are left unchanged
+	 *
+	 * @param Utf8Response [in] the response body
+	 * @param OutResponse [out] the decoded response
+	 * @param OutChecksums [out] optional checksums of each section of the response
+	 * @return true if the response was decoded successfully
+	 */
+	static bool DecodeResponse(TArrayView<const uint8> Utf8Response, FWitResponse& OutResponse, FWitResponseChecksums* OutChecksums = nullptr);
+
+	/**
+	 * Decode a composer response. Fields that are not present in the response are left unchanged
+	 *
+	 * @param Utf8Response [in] the response body
+	 * @param OutResponse [out] the decoded response
+	 * @return true if the response was decoded successfully
+	 */
+	static bool DecodeComposerResponse(TArrayView<const uint8> Utf8Response, FWitComposerResponse& OutResponse);
+
+	/**
+	 * Decode a /voices response. Fields that are not present in the response are left unchanged
+	 *
+	 * @param Utf8Response [in] the response body
+	 * @param OutResponse [out] the decoded response
+	 * @return true if the response was decoded successfully
+	 */
+	static bool DecodeVoicesResponse(TArrayView<const uint8> Utf8Response, FWitVoicesResponse& OutResponse);
+
+private:
+
+	/**
+	 * Find the last top level object in a response body
+	 *
+	 * @param Utf8Response [in] the response body
+	 * @return a view of the last object or an empty view if there is none
+	 */
+	static TArrayView<const uint8> FindLastObject(TArrayView<const uint8> Utf8Response);
+};
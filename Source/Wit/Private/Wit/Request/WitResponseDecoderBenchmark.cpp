@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Wit/Request/WitResponse.h"
+#include "Wit/Request/WitResponseDecoder.h"
+#include "Wit/Utilities/WitBenchmark.h"
+#include "Wit/Utilities/WitHelperUtilities.h"
+#include "Wit/Utilities/WitLog.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Create a synthetic response with the given number of entity names. Each name has several entities with nested values
+ * so that the response resembles a large real world multi-entity response
+ *
+ * @param NumEntityNames [in] the number of entity names
+ * @return the response body as UTF-8
+ */
+static TArray<uint8> CreateBenchmarkResponse(const int32 NumEntityNames)
+{
+	FString Response = TEXT("{\"text\":\"set the \\\"lights\\\" in the living room to blue and dim them to fifty percent\",\"intents\":[");
+
+	for (int32 IntentIndex = 0; IntentIndex < 3; ++IntentIndex)
+	{
+		Response += FString::Printf(TEXT("%s{\"id\":\"%d\",\"name\":\"intent_%d\",\"confidence\":0.%d}"), IntentIndex > 0 ? TEXT(",") : TEXT(""),
+			1000 + IntentIndex, IntentIndex, 9 - IntentIndex);
+	}
+
+	Response += TEXT("],\"entities\":{");
+
+	for (int32 NameIndex = 0; NameIndex < NumEntityNames; ++NameIndex)
+	{
+		Response += FString::Printf(TEXT("%s\"entity_%d:role_%d\":["), NameIndex > 0 ? TEXT(",") : TEXT(""), NameIndex, NameIndex);
+
+		for (int32 EntityIndex = 0; EntityIndex < 3; ++EntityIndex)
+		{
+			Response += FString::Printf(TEXT("%s{\"id\":\"%d\",\"name\":\"entity_%d\",\"role\":\"role_%d\",\"start\":%d,\"end\":%d,\"body\":\"value %d\","
+				"\"confidence\":0.87,\"entities\":{},\"value\":\"value %d\",\"type\":\"value\",\"unit\":\"percent\",\"grain\":\"hour\","
+				"\"normalized\":{\"value\":\"%d\",\"unit\":\"percent\"},\"values\":[{\"value\":\"%d\",\"type\":\"value\",\"grain\":\"hour\","
+				"\"from\":{\"value\":\"1\",\"unit\":\"percent\"},\"to\":{\"value\":\"2\",\"unit\":\"percent\"}}]}"),
+				EntityIndex > 0 ? TEXT(",") : TEXT(""), 2000 + NameIndex, NameIndex, NameIndex, EntityIndex * 4, EntityIndex * 4 + 3, EntityIndex, EntityIndex,
+				EntityIndex, EntityIndex);
+		}
+
+		Response += TEXT("]");
+	}
+
+	Response += TEXT("},\"traits\":{\"wit$sentiment\":[{\"id\":\"3000\",\"value\":\"neutral\",\"confidence\":0.6}],"
+		"\"wit$on_off\":[{\"id\":\"3001\",\"value\":\"on\",\"confidence\":0.9}]},\"is_final\":true}");
+
+	const FTCHARToUTF8 Converter(*Response);
+
+	return TArray<uint8>(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+}
+
+/**
+ * Convert a response the way it was converted before the decoder existed. The body is deserialized into a Json DOM which
+ * is then converted through reflection
+ *
+ * @param Utf8Response [in] the response body
+ * @param OutResponse [out] the converted response
+ * @return true if successful
+ */
+static bool ConvertBenchmarkResponseWithReflection(const TArray<uint8>& Utf8Response, FWitResponse& OutResponse)
+{
+	const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Utf8Response.GetData()), Utf8Response.Num());
+	const FString Content(Converter.Length(), Converter.Get());
+
+	TSharedPtr<FJsonObject> Json;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+
+	if (!FJsonSerializer::Deserialize(Reader, Json) || !Json.IsValid())
+	{
+		return false;
+	}
+
+	OutResponse.Reset();
+
+	return FWitHelperUtilities::ConvertJsonToWitResponse(Json, &OutResponse);
+}
+
+/**
+ * Check that the two conversions agree on the fields that matter to matchers
+ */
+static bool AreBenchmarkResponsesEqual(const FWitResponse& Expected, const FWitResponse& Actual)
+{
+	bool bIsEqual = Expected.Text == Actual.Text && Expected.Is_Final == Actual.Is_Final && Expected.Intents.Num() == Actual.Intents.Num()
+		&& Expected.Entities.Num() == Actual.Entities.Num() && Expected.AllEntities.Num() == Actual.AllEntities.Num() && Expected.Traits.Num() == Actual.Traits.Num();
+
+	for (int32 Index = 0; bIsEqual && Index < Expected.Intents.Num(); ++Index)
+	{
+		bIsEqual = Expected.Intents[Index].Name == Actual.Intents[Index].Name && Expected.Intents[Index].Id == Actual.Intents[Index].Id
+			&& FMath::IsNearlyEqual(Expected.Intents[Index].Confidence, Actual.Intents[Index].Confidence);
+	}
+
+	for (const TPair<FString, FWitEntities>& Entities : Expected.AllEntities)
+	{
+		const FWitEntities* ActualEntities = Actual.AllEntities.Find(Entities.Key);
+
+		bIsEqual &= ActualEntities != nullptr && ActualEntities->Entities.Num() == Entities.Value.Entities.Num();
+
+		for (int32 Index = 0; bIsEqual && Index < Entities.Value.Entities.Num(); ++Index)
+		{
+			const FWitEntity& ExpectedEntity = Entities.Value.Entities[Index];
+			const FWitEntity& ActualEntity = ActualEntities->Entities[Index];
+
+			bIsEqual = ExpectedEntity.Value == ActualEntity.Value && ExpectedEntity.Id == ActualEntity.Id && ExpectedEntity.Start == ActualEntity.Start
+				&& ExpectedEntity.Normalized.Value == ActualEntity.Normalized.Value && ExpectedEntity.Values.Num() == ActualEntity.Values.Num();
+		}
+	}
+
+	return bIsEqual;
+}
+
+/**
+ * Usage: Wit.ResponseDecoderBenchmark [NumEntityNames] [NumIterations]
+ */
+static FAutoConsoleCommand ResponseDecoderBenchmarkCommand(
+	TEXT("Wit.ResponseDecoderBenchmark"),
+	TEXT("Compares decoding a large multi-entity response directly against Json deserialization and reflection. Optional arguments are the number of entity names (defaults to 50) and iterations (defaults to 200)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumEntityNames = FWitBenchmark::GetArgument(Args, 0, 50);
+		const int32 NumIterations = FWitBenchmark::GetArgument(Args, 1, 200);
+
+		const TArray<uint8> Utf8Response = CreateBenchmarkResponse(NumEntityNames);
+
+		FWitResponse ReflectionResponse;
+		FWitResponse DecodedResponse;
+
+		const bool bIsReflectionSuccessful = ConvertBenchmarkResponseWithReflection(Utf8Response, ReflectionResponse);
+		const bool bIsDecodeSuccessful = FWitResponseDecoder::DecodeResponse(Utf8Response, DecodedResponse);
+
+		DecodedResponse.GetAllEntities();
+
+		if (!bIsReflectionSuccessful || !bIsDecodeSuccessful)
+		{
+			UE_LOG(LogWit, Warning, TEXT("Wit.ResponseDecoderBenchmark: conversion failed - reflection (%d) decoder (%d)"), bIsReflectionSuccessful, bIsDecodeSuccessful);
+			return;
+		}
+
+		const bool bIsEqual = AreBenchmarkResponsesEqual(ReflectionResponse, DecodedResponse);
+
+		const FWitBenchmarkResult ReflectionResult = FWitBenchmark::Measure(NumIterations, [&Utf8Response]()
+		{
+			FWitResponse Response;
+			ConvertBenchmarkResponseWithReflection(Utf8Response, Response);
+		});
+
+		const FWitBenchmarkResult DecodeResult = FWitBenchmark::Measure(NumIterations, [&Utf8Response]()
+		{
+			FWitResponse Response;
+			FWitResponseDecoder::DecodeResponse(Utf8Response, Response);
+		});
+
+		UE_LOG(LogWit, Display, TEXT("Wit.ResponseDecoderBenchmark: response (%d) bytes (%d) entity names (%d) iterations - results match (%s)"),
+			Utf8Response.Num(), NumEntityNames, NumIterations, bIsEqual ? TEXT("yes") : TEXT("no"));
+
+		// Requests always build AllEntities for Blueprint so that is measured separately from decoding alone
+
+		const FWitBenchmarkResult DecodeWithAllEntitiesResult = FWitBenchmark::Measure(NumIterations, [&Utf8Response]()
+		{
+			FWitResponse Response;
+			FWitResponseDecoder::DecodeResponse(Utf8Response, Response);
+			Response.GetAllEntities();
+		});
+
+		FWitBenchmark::LogComparison(TEXT("Wit.ResponseDecoderBenchmark"), TEXT("Json and reflection"), ReflectionResult, TEXT("decoder"), DecodeResult);
+		FWitBenchmark::LogComparison(TEXT("Wit.ResponseDecoderBenchmark"), TEXT("Json and reflection"), ReflectionResult, TEXT("decoder with all entities"),
+			DecodeWithAllEntitiesResult);
+	}));
+
+#endif
@@ -11,12 +11,14 @@
 #include "JsonObjectConverter.h"
 #include "Wit/Request/WitRequestBuilder.h"
 #include "Wit/Request/WitRequestSubsystem.h"
+#include "Wit/Request/WitResponseDecoder.h"
 #include "Wit/Request/WitRequestTypes.h"
 #include "Wit/Socket/WitSocketSubsystem.h"
 #include "TTS/Configuration/TtsConfiguration.h"
 #include "Wit/Utilities/WitLog.h"
 #include "Wit/Utilities/WitHelperUtilities.h"
 #include "Wit/Utilities/WitTtsSpeechSplitter.h"
+#include "Wit/Utilities/WitWavFileWriter.h"
 
 #ifdef CPP_PLUGIN
 THIRD_PARTY_INCLUDES_START
@@ -57,14 +59,6 @@ using namespace meta::voicesdk::v2;
 THIRD_PARTY_INCLUDES_END
 #endif
 
-#if WITH_EDITORONLY_DATA
-
-// Use for debug recording of the voice input
-
-static TUniquePtr<Audio::FAudioRecordingData> TTSRecordingData;
-
-#endif
-
 /**
  * Wit API constructor
  */
@@ -315,13 +309,16 @@ void UWitTtsService::ConvertTextToSpeechWithSettingsInternal(const bool bNewRequ
 		return;
 	}
 
+	// Audio that is not queued replaces whatever is being synthesized so the earlier request is cancelled rather than left to finish
+
+	if (!bQueueAudio)
+	{
+		CancelSynthesizeRequest();
+	}
+
 	if (RequestSubsystem->IsRequestInProgress())
 	{
 		UE_LOG(LogWit, Warning, TEXT("ConvertTextToSpeechWithSettingsInternal: cannot convert text because a request is already in progress"));
-		if (!bQueueAudio)
-		{
-			bStopInProgressRequest = true;
-		}
 		return;
 	}
 
@@ -344,10 +341,13 @@ void UWitTtsService::ConvertTextToSpeechWithSettingsInternal(const bool bNewRequ
 
 	RequestConfiguration.bShouldUseCustomHttpTimeout = Configuration->Application.Advanced.bIsCustomHttpTimeout;
 	RequestConfiguration.HttpTimeout = Configuration->Application.Advanced.HttpTimeout;
+	RequestConfiguration.ResponseDeadline = Configuration->Application.Advanced.ResponseDeadline;
 	RequestConfiguration.bShouldUseChunkedTransfer = bUseStreaming;
 
-	RequestConfiguration.OnRequestError.AddUObject(this, &UWitTtsService::OnSynthesizeRequestError);
-	RequestConfiguration.OnRequestComplete.AddUObject(this, &UWitTtsService::OnSynthesizeRequestComplete);
+	++SynthesizeGeneration;
+
+	RequestConfiguration.OnRequestError.AddUObject(this, &UWitTtsService::OnSynthesizeRequestError, SynthesizeGeneration);
+	RequestConfiguration.OnRequestComplete.AddUObject(this, &UWitTtsService::OnSynthesizeRequestComplete, SynthesizeGeneration);
 	if (bUseStreaming && AudioType != EWitRequestAudioFormat::Pcm)
 	{
 		UE_LOG(LogWit, Warning, TEXT("ConvertTextToSpeechWithSettingsInternal: Audio streaming is not currently supported for (%s)"), *UEnum::GetValueAsString(AudioType));
@@ -355,7 +355,7 @@ void UWitTtsService::ConvertTextToSpeechWithSettingsInternal(const bool bNewRequ
 	}
 	if (bUseStreaming)
 	{
-		RequestConfiguration.OnRequestProgress.AddUObject(this, &UWitTtsService::OnSynthesizeRequestProgress);
+		RequestConfiguration.OnRequestProgress.AddUObject(this, &UWitTtsService::OnSynthesizeRequestProgress, SynthesizeGeneration);
 	}
 
 	// Construct the body parameters. The only required one is "q" which is the text we want to convert. We could use UStructToJsonObject
@@ -387,6 +387,8 @@ void UWitTtsService::ConvertTextToSpeechWithSettingsInternal(const bool bNewRequ
 	}
 	else
 	{
+		bIsSynthesizeRequestInProgress = true;
+
 		RequestSubsystem->BeginStreamRequest(RequestConfiguration);
 		RequestSubsystem->WriteJsonData(RequestBody.ToSharedRef());
 		RequestSubsystem->EndStreamRequest();
@@ -451,6 +453,41 @@ void UWitTtsService::SplitSpeech(const FTtsConfiguration& ClipSettings, const bo
 	}
 }
 
+/**
+ * Cancel any synthesis in progress and discard any queued text
+ */
+void UWitTtsService::StopSynthesis()
+{
+	QueuedSettings.Empty();
+
+	CancelSynthesizeRequest();
+}
+
+/**
+ * Cancel the synthesize request made by this service if it is in progress. The request is cancelled at the transport so nothing more
+ * is received for it and any callback already on its way is ignored
+ */
+void UWitTtsService::CancelSynthesizeRequest()
+{
+	if (!bIsSynthesizeRequestInProgress)
+	{
+		return;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("CancelSynthesizeRequest: cancelling synthesize request"));
+
+	bIsSynthesizeRequestInProgress = false;
+	++SynthesizeGeneration;
+	SoundWaveProcedural = nullptr;
+
+	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
+
+	if (RequestSubsystem != nullptr)
+	{
+		RequestSubsystem->CancelRequest();
+	}
+}
+
 /**
  * Fetch a list of available voices from Wit
  */
@@ -491,6 +528,7 @@ void UWitTtsService::FetchAvailableVoices()
 
 	RequestConfiguration.bShouldUseCustomHttpTimeout = Configuration->Application.Advanced.bIsCustomHttpTimeout;
 	RequestConfiguration.HttpTimeout = Configuration->Application.Advanced.HttpTimeout;
+	RequestConfiguration.ResponseDeadline = Configuration->Application.Advanced.ResponseDeadline;
 
 	RequestConfiguration.OnRequestError.AddUObject(this, &UWitTtsService::OnVoicesRequestError);
 	RequestConfiguration.OnRequestComplete.AddUObject(this, &UWitTtsService::OnVoicesRequestComplete);
@@ -557,7 +595,7 @@ void UWitTtsService::OnStorageCacheRequestComplete(const TArray<uint8>& BinaryDa
 
 	if (SoundWave == nullptr)
 	{
-		OnSynthesizeRequestError(TEXT("Sound wave creation failed"), TEXT("Creating a sound wave from the response failed"));
+		BroadcastSynthesizeError(TEXT("Sound wave creation failed"), TEXT("Creating a sound wave from the response failed"));
 		return;
 	}
 
@@ -574,9 +612,18 @@ void UWitTtsService::OnStorageCacheRequestComplete(const TArray<uint8>& BinaryDa
  *
  * @param BinaryResponse [in] the final binary response
  * @param JsonResponse [in] the final Json response
+ * @param Generation [in] the synthesize request the response is for
  */
-void UWitTtsService::OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse)
+void UWitTtsService::OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const uint32 Generation)
 {
+	if (Generation != SynthesizeGeneration)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("OnSynthesizeRequestComplete: ignoring response to a cancelled request"));
+		return;
+	}
+
+	bIsSynthesizeRequestInProgress = false;
+
 	UE_LOG(LogWit, Verbose, TEXT("OnSynthesizeRequestComplete - Final response size: %d"), QueuedSettings.Num());
 
 	const FString ClipId = FWitHelperUtilities::GetVoiceClipId(LastRequestedClipSettings);
@@ -586,7 +633,7 @@ void UWitTtsService::OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResp
 
 	if (SoundWave == nullptr)
 	{
-		OnSynthesizeRequestError(TEXT("Sound wave creation failed"), TEXT("Creating a sound wave from the response failed"));
+		BroadcastSynthesizeError(TEXT("Sound wave creation failed"), TEXT("Creating a sound wave from the response failed"));
 		return;
 	}
 
@@ -599,21 +646,21 @@ void UWitTtsService::OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResp
 		StorageCacheHandler->AddClip(ClipId, BinaryResponse, LastRequestedClipSettings);
 	}
 
-#if WITH_EDITORONLY_DATA
-
 	// Output the wav file to a file for debugging purposes
 
 	if (bIsWavFileOutputEnabled)
 	{
 		FWaveModInfo WaveInfo;
 
-		WaveInfo.ReadWaveInfo(BinaryResponse.GetData(), BinaryResponse.Num());
-		WriteRawPCMDataToWavFile(WaveInfo.SampleDataStart, WaveInfo.SampleDataSize, *WaveInfo.pChannels, *WaveInfo.pSamplesPerSec);
-	}
+		const bool bIsValidWav = WaveInfo.ReadWaveInfo(BinaryResponse.GetData(), BinaryResponse.Num()) && *WaveInfo.pBitsPerSample == 16;
 
-#endif
+		if (bIsValidWav)
+		{
+			WriteRawPCMDataToWavFile(WaveInfo.SampleDataStart, WaveInfo.SampleDataSize, *WaveInfo.pChannels, *WaveInfo.pSamplesPerSec);
+		}
+	}
 
-	if (EventHandler != nullptr && !bStopInProgressRequest)
+	if (EventHandler != nullptr)
 	{
 		EventHandler->OnSynthesizeRawResponseMulticast.Broadcast(BinaryResponse);
 		EventHandler->OnSynthesizeRawResponse.Broadcast(ClipId, BinaryResponse, LastRequestedClipSettings);
@@ -631,8 +678,6 @@ void UWitTtsService::OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResp
 		}
 	}
 
-	bStopInProgressRequest = false;
-
 	if (!QueuedSettings.IsEmpty())
 	{
 		ConvertTextToSpeechWithSettingsInternal(false, true);
@@ -643,14 +688,15 @@ void UWitTtsService::OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResp
 *
 * @param BinaryData [in] the binary data
 * @param ClipSettings [in] the clip settings for the clip
+* @param Generation [in] the synthesize request the data is for
 */
-void UWitTtsService::OnSynthesizeRequestProgress(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse)
+void UWitTtsService::OnSynthesizeRequestProgress(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const uint32 Generation)
 {
-	if (bStopInProgressRequest)
+	if (Generation != SynthesizeGeneration)
 	{
-		SoundWaveProcedural = nullptr;
 		return;
 	}
+
 	const uint8* RawData = BinaryResponse.GetData();
 	const int32 RawDataSize = BinaryResponse.Num() % 2 == 0 ? BinaryResponse.Num() : BinaryResponse.Num() - 1;
 	const bool bShouldCheckSize = false;
@@ -662,8 +708,27 @@ void UWitTtsService::OnSynthesizeRequestProgress(const TArray<uint8>& BinaryResp
  *
  * @param ErrorMessage [in] the error message
  * @param HumanReadableErrorMessage [in] longer human readable error message
+ * @param Generation [in] the synthesize request that failed
+ */
+void UWitTtsService::OnSynthesizeRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage, const uint32 Generation)
+{
+	if (Generation != SynthesizeGeneration)
+	{
+		return;
+	}
+
+	bIsSynthesizeRequestInProgress = false;
+
+	BroadcastSynthesizeError(ErrorMessage, HumanReadableErrorMessage);
+}
+
+/**
+ * Report a synthesis error
+ *
+ * @param ErrorMessage [in] the error message
+ * @param HumanReadableErrorMessage [in] longer human readable error message
  */
-void UWitTtsService::OnSynthesizeRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage) const
+void UWitTtsService::BroadcastSynthesizeError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage) const
 {
 	UE_LOG(LogWit, Warning, TEXT("OnSynthesizeRequestError: %s - %s"), *ErrorMessage, *HumanReadableErrorMessage);
 
@@ -691,7 +756,8 @@ void UWitTtsService::OnVoicesRequestComplete(const TArray<uint8>& BinaryResponse
 
 	UE_LOG(LogWit, Verbose, TEXT("OnVoicesRequestComplete - Final response size: %d"), BinaryResponse.Num());
 
-	const bool bIsConversionError = !FJsonObjectConverter::JsonObjectToUStruct(JsonResponse.ToSharedRef(), &EventHandler->VoicesResponse);
+	const bool bIsDecoded = FWitResponseDecoder::DecodeVoicesResponse(BinaryResponse, EventHandler->VoicesResponse);
+	const bool bIsConversionError = !bIsDecoded && (!JsonResponse.IsValid() || !FJsonObjectConverter::JsonObjectToUStruct(JsonResponse.ToSharedRef(), &EventHandler->VoicesResponse));
 	if (bIsConversionError)
 	{
 		OnVoicesRequestError(TEXT("Json To UStruct failed"), TEXT("Converting the Json response to a UStruct failed"));
@@ -786,24 +852,14 @@ void UWitTtsService::AddProceduralData(const uint8* RawData, const int32 RawData
 	}
 }
 
-#if WITH_EDITORONLY_DATA
-
 /**
- * Write the captured voice input to a wav file. The output file will be written to the project folder's Saved/BouncedWavFiles folder as
- * Wit/RecordedVoiceInput.wav. This only works with 16-bit samples
+ * Write the synthesized audio to a wav file. The output file will be written to the project folder's Saved/BouncedWavFiles folder as
+ * Wit/SynthesisOutput_<timestamp>.wav. The data is copied and written in the background. This only works with 16-bit samples
  */
 void UWitTtsService::WriteRawPCMDataToWavFile(const uint8* RawPCMData, const int32 RawPCMDataSize, const int32 NumChannels, const int32 SampleRate)
 {
-	TTSRecordingData.Reset(new Audio::FAudioRecordingData());
-	TTSRecordingData->InputBuffer = Audio::TSampleBuffer<int16>(reinterpret_cast<const int16*>(RawPCMData), RawPCMDataSize / 2, NumChannels, SampleRate);
+	const TSharedRef<FWitWavFileWriter, ESPMode::ThreadSafe> Writer = FWitWavFileWriter::Create(TEXT("SynthesisOutput"), SampleRate, NumChannels);
 
-	const FString WavFileName = TEXT("SynthesisOutput");
-	FString WavFilePath = TEXT("Wit");
-
-	TTSRecordingData->Writer.BeginWriteToWavFile(TTSRecordingData->InputBuffer, WavFileName, WavFilePath, []()
-		{
-			TTSRecordingData.Reset();
-		});
+	Writer->Write(TArrayView<const uint8>(RawPCMData, RawPCMDataSize));
+	Writer->Close();
 }
-
-#endif
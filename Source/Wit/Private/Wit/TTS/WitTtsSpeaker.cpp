@@ -96,7 +96,7 @@ void AWitTtsSpeaker::SpeakWithSettings(const FTtsConfiguration& ClipSettings, bo
 }
 
 /**
- * Stop speaking
+ * Stop speaking. Any synthesis still in progress is cancelled so that it does not start speaking once it arrives
  */
 void AWitTtsSpeaker::Stop()
 {
@@ -104,6 +104,8 @@ void AWitTtsSpeaker::Stop()
 	{
 		AudioComponent->Stop();
 	}
+
+	StopSynthesis();
 }
 
 /**
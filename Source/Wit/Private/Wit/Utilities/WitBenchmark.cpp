@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Utilities/WitBenchmark.h"
+#include "Wit/Utilities/WitLog.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Get a positive integer console argument
+ *
+ * @param Args [in] the console arguments
+ * @param Index [in] the index of the argument
+ * @param DefaultValue [in] the value to use if the argument was not given
+ * @return the argument value clamped to at least 1
+ */
+int32 FWitBenchmark::GetArgument(const TArray<FString>& Args, const int32 Index, const int32 DefaultValue)
+{
+	return Args.IsValidIndex(Index) ? FMath::Max(FCString::Atoi(*Args[Index]), 1) : DefaultValue;
+}
+
+/**
+ * Get a string console argument
+ *
+ * @param Args [in] the console arguments
+ * @param Index [in] the index of the argument
+ * @param DefaultValue [in] the value to use if the argument was not given
+ * @return the argument value
+ */
+FString FWitBenchmark::GetArgument(const TArray<FString>& Args, const int32 Index, const FString& DefaultValue)
+{
+	return Args.IsValidIndex(Index) ? Args[Index] : DefaultValue;
+}
+
+/**
+ * Run an operation repeatedly on the calling thread and measure its average time. Allocations are not counted as that would
+ * mean replacing the engine allocator while other threads are using it
+ *
+ * @param NumIterations [in] the number of times to run the operation
+ * @param Operation [in] the operation to measure
+ * @return the average cost of one iteration
+ */
+FWitBenchmarkResult FWitBenchmark::Measure(const int32 NumIterations, TFunctionRef<void()> Operation)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		Operation();
+	}
+
+	FWitBenchmarkResult Result;
+
+	Result.Time = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+	return Result;
+}
+
+/**
+ * Log the comparison between a baseline and the candidate replacing it
+ *
+ * @param CommandName [in] the name of the console command to prefix the log with
+ * @param BaselineName [in] the name of the baseline
+ * @param Baseline [in] the measured cost of the baseline
+ * @param CandidateName [in] the name of the candidate
+ * @param Candidate [in] the measured cost of the candidate
+ */
+void FWitBenchmark::LogComparison(const TCHAR* CommandName, const TCHAR* BaselineName, const FWitBenchmarkResult& Baseline, const TCHAR* CandidateName,
+	const FWitBenchmarkResult& Candidate)
+{
+	UE_LOG(LogWit, Display, TEXT("%s: %s (%.2f) us - %s (%.2f) us - speedup (%.1fx)"), CommandName, BaselineName, Baseline.Time * 1000000.0,
+		CandidateName, Candidate.Time * 1000000.0, Candidate.Time > 0.0 ? Baseline.Time / Candidate.Time : 0.0);
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * The measured cost of a single benchmarked operation
+ */
+struct FWitBenchmarkResult
+{
+	/** The average time taken by one iteration in seconds */
+	double Time{0.0};
+};
+
+/**
+ * Shared helpers for the Wit.*Benchmark console commands. Commands parse their arguments, measure each variant they
+ * compare and log the results through here so that every benchmark reports in the same way
+ */
+class FWitBenchmark
+{
+public:
+
+	/**
+	 * Get a positive integer console argument
+	 *
+	 * @param Args [in] the console arguments
+	 * @param Index [in] the index of the argument
+	 * @param DefaultValue [in] the value to use if the argument was not given
+	 * @return the argument value clamped to at least 1
+	 */
+	static int32 GetArgument(const TArray<FString>& Args, const int32 Index, const int32 DefaultValue);
+
+	/**
+	 * Get a string console argument
+	 *
+	 * @param Args [in] the console arguments
+	 * @param Index [in] the index of the argument
+	 * @param DefaultValue [in] the value to use if the argument was not given
+	 * @return the argument value
+	 */
+	static FString GetArgument(const TArray<FString>& Args, const int32 Index, const FString& DefaultValue);
+
+	/**
+	 * Run an operation repeatedly on the calling thread and measure its average time
+	 *
+	 * @param NumIterations [in] the number of times to run the operation
+	 * @param Operation [in] the operation to measure
+	 * @return the average cost of one iteration
+	 */
+	static FWitBenchmarkResult Measure(const int32 NumIterations, TFunctionRef<void()> Operation);
+
+	/**
+	 * Log the comparison between a baseline and the candidate replacing it
+	 *
+	 * @param CommandName [in] the name of the console command to prefix the log with
+	 * @param BaselineName [in] the name of the baseline
+	 * @param Baseline [in] the measured cost of the baseline
+	 * @param CandidateName [in] the name of the candidate
+	 * @param Candidate [in] the measured cost of the candidate
+	 */
+	static void LogComparison(const TCHAR* CommandName, const TCHAR* BaselineName, const FWitBenchmarkResult& Baseline, const TCHAR* CandidateName,
+		const FWitBenchmarkResult& Candidate);
+};
+
+#endif
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Utilities/WitWavFileWriter.h"
+#include "Async/Async.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Create a writer for a new recording
+ *
+ * @param Name [in] the name of the recording
+ * @param SampleRate [in] the sample rate of the audio
+ * @param NumChannels [in] the number of channels in the audio
+ * @return the writer
+ */
+TSharedRef<FWitWavFileWriter, ESPMode::ThreadSafe> FWitWavFileWriter::Create(const FString& Name, const int32 SampleRate, const int32 NumChannels)
+{
+	const FString FileName = FString::Printf(TEXT("%s_%s.wav"), *Name, *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S-%s")));
+	const FString FilePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BouncedWavFiles"), TEXT("Wit"), FileName);
+
+	return MakeShared<FWitWavFileWriter, ESPMode::ThreadSafe>(FilePath, SampleRate, NumChannels);
+}
+
+/**
+ * Constructor
+ *
+ * @param InFilePath [in] the path of the file to write
+ * @param InSampleRate [in] the sample rate of the audio
+ * @param InNumChannels [in] the number of channels in the audio
+ */
+FWitWavFileWriter::FWitWavFileWriter(const FString& InFilePath, const int32 InSampleRate, const int32 InNumChannels)
+	: FilePath(InFilePath)
+	, SampleRate(FMath::Max(InSampleRate, 1))
+	, NumChannels(FMath::Max(InNumChannels, 1))
+	, BlockPool(MakeShared<FVoiceAudioBlockPool, ESPMode::ThreadSafe>(BlockSize))
+{
+	// Deliberately empty
+}
+
+/**
+ * Destructor
+ */
+FWitWavFileWriter::~FWitWavFileWriter()
+{
+	// Deliberately empty
+}
+
+/**
+ * Queue audio to be written. The span references the audio so nothing is copied
+ *
+ * @param Data [in] the audio to write
+ * @return true if queued or false if the writer is closed or the queue is full
+ */
+bool FWitWavFileWriter::Write(const FVoiceAudioSpan& Data)
+{
+	FScopeLock Lock(&QueueCriticalSection);
+
+	return Enqueue(Data);
+}
+
+/**
+ * Queue a copy of the given audio to be written. The audio is copied into pooled blocks so the caller's buffer can be
+ * reused immediately
+ *
+ * @param Data [in] the audio to write
+ * @return true if queued or false if the writer is closed or the queue is full
+ */
+bool FWitWavFileWriter::Write(TArrayView<const uint8> Data)
+{
+	FScopeLock Lock(&QueueCriticalSection);
+
+	const bool bIsQueueFull = NumQueuedBytes + Data.Num() > MaximumQueuedBytes;
+
+	if (bIsCloseRequested || bIsQueueFull)
+	{
+		NumDroppedBytes += bIsCloseRequested ? 0 : Data.Num();
+		return false;
+	}
+
+	for (int32 Offset = 0; Offset < Data.Num(); Offset += BlockSize)
+	{
+		const FVoiceAudioBlockRef Block = BlockPool->Acquire(Data.Slice(Offset, FMath::Min(BlockSize, Data.Num() - Offset)));
+
+		Enqueue(FVoiceAudioSpan(Block));
+	}
+
+	return true;
+}
+
+/**
+ * Flush anything queued and close the file. This does not wait for the file to be closed
+ */
+void FWitWavFileWriter::Close()
+{
+	FScopeLock Lock(&QueueCriticalSection);
+
+	if (bIsCloseRequested)
+	{
+		return;
+	}
+
+	bIsCloseRequested = true;
+
+	ScheduleFlush();
+}
+
+/**
+ * Get the path of the file being written
+ *
+ * @return the path
+ */
+const FString& FWitWavFileWriter::GetFilePath() const
+{
+	return FilePath;
+}
+
+/**
+ * Queue a span of audio. Assumes the queue is locked
+ *
+ * @param Data [in] the audio to write
+ * @return true if queued
+ */
+bool FWitWavFileWriter::Enqueue(const FVoiceAudioSpan& Data)
+{
+	if (bIsCloseRequested)
+	{
+		return false;
+	}
+
+	if (Data.IsEmpty())
+	{
+		return true;
+	}
+
+	const bool bIsQueueFull = NumQueuedBytes + Data.Num() > MaximumQueuedBytes;
+
+	if (bIsQueueFull)
+	{
+		NumDroppedBytes += Data.Num();
+		return false;
+	}
+
+	Queue.Add(Data);
+	NumQueuedBytes += Data.Num();
+
+	const bool bShouldFlush = NumQueuedBytes >= FlushThreshold;
+
+	if (bShouldFlush)
+	{
+		ScheduleFlush();
+	}
+
+	return true;
+}
+
+/**
+ * Start a background flush if one is not already running. Assumes the queue is locked. The task holds a reference to the
+ * writer so the writer outlives its owner until everything has been written
+ */
+void FWitWavFileWriter::ScheduleFlush()
+{
+	if (bIsFlushScheduled)
+	{
+		return;
+	}
+
+	bIsFlushScheduled = true;
+
+	Async(EAsyncExecution::ThreadPool, [Self = AsShared()]()
+	{
+		Self->Flush();
+	});
+}
+
+/**
+ * Write everything queued to the file and update the header. Runs in a background task. Only one flush runs at a time so
+ * the file needs no locking of its own. If the writer has been closed the file is closed once the queue is empty
+ */
+void FWitWavFileWriter::Flush()
+{
+	TArray<FVoiceAudioSpan> SpansToWrite;
+	bool bShouldClose = false;
+
+	while (true)
+	{
+		{
+			FScopeLock Lock(&QueueCriticalSection);
+
+			if (Queue.Num() == 0)
+			{
+				bIsFlushScheduled = false;
+				bShouldClose = bIsCloseRequested;
+				break;
+			}
+
+			SpansToWrite = MoveTemp(Queue);
+			Queue.Reset();
+			NumQueuedBytes = 0;
+		}
+
+		const bool bIsFileOpen = FileHandle.IsValid() || OpenFile();
+
+		if (bIsFileOpen)
+		{
+			for (const FVoiceAudioSpan& Span : SpansToWrite)
+			{
+				// The header sizes are 32-bit so anything beyond that is not written
+
+				const bool bIsFileFull = static_cast<uint64>(NumBytesWritten) + Span.Num() > MAX_uint32 - 36;
+
+				if (bIsFileFull || !FileHandle->Write(Span.GetData(), Span.Num()))
+				{
+					break;
+				}
+
+				NumBytesWritten += Span.Num();
+			}
+
+			WriteHeader(NumBytesWritten);
+		}
+
+		// Releasing the spans returns their blocks to their pools
+
+		SpansToWrite.Reset();
+	}
+
+	if (!bShouldClose)
+	{
+		return;
+	}
+
+	const bool bIsFileOpen = FileHandle.IsValid() || OpenFile();
+
+	if (!bIsFileOpen)
+	{
+		return;
+	}
+
+	FileHandle.Reset();
+
+	int64 NumBytesDropped = 0;
+	{
+		FScopeLock Lock(&QueueCriticalSection);
+		NumBytesDropped = NumDroppedBytes;
+	}
+
+	if (NumBytesDropped > 0)
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitWavFileWriter - Flush: dropped (%lld) bytes because the write queue was full (%s)"), NumBytesDropped, *FilePath);
+	}
+
+	UE_LOG(LogWit, Display, TEXT("FWitWavFileWriter - Flush: wrote (%u) bytes of audio to (%s)"), NumBytesWritten, *FilePath);
+}
+
+/**
+ * Open the file and write a placeholder header
+ *
+ * @return true if the file was opened
+ */
+bool FWitWavFileWriter::OpenFile()
+{
+	if (bHasOpenFailed)
+	{
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+	FileHandle.Reset(PlatformFile.OpenWrite(*FilePath));
+
+	if (!FileHandle.IsValid())
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitWavFileWriter - OpenFile: failed to open file for writing (%s)"), *FilePath);
+
+		bHasOpenFailed = true;
+		return false;
+	}
+
+	WriteHeader(0);
+
+	return true;
+}
+
+/**
+ * Write the header describing the given amount of audio data and then return to the end of the file
+ *
+ * @param DataSize [in] the number of bytes of audio data
+ */
+void FWitWavFileWriter::WriteHeader(const uint32 DataSize)
+{
+	constexpr int32 HeaderSize = 44;
+	constexpr uint16 BitsPerSample = 16;
+
+	uint8 Header[HeaderSize];
+	int32 Offset = 0;
+
+	auto WriteTag = [&Header, &Offset](const char* Tag)
+	{
+		FMemory::Memcpy(Header + Offset, Tag, 4);
+		Offset += 4;
+	};
+
+	auto WriteUInt32 = [&Header, &Offset](const uint32 Value)
+	{
+		const uint8 Bytes[4] = { static_cast<uint8>(Value), static_cast<uint8>(Value >> 8), static_cast<uint8>(Value >> 16), static_cast<uint8>(Value >> 24) };
+
+		FMemory::Memcpy(Header + Offset, Bytes, 4);
+		Offset += 4;
+	};
+
+	auto WriteUInt16 = [&Header, &Offset](const uint16 Value)
+	{
+		Header[Offset++] = static_cast<uint8>(Value);
+		Header[Offset++] = static_cast<uint8>(Value >> 8);
+	};
+
+	const uint16 BlockAlign = NumChannels * BitsPerSample / 8;
+
+	WriteTag("RIFF");
+	WriteUInt32(HeaderSize - 8 + DataSize);
+	WriteTag("WAVE");
+	WriteTag("fmt ");
+	WriteUInt32(16);
+	WriteUInt16(1);
+	WriteUInt16(NumChannels);
+	WriteUInt32(SampleRate);
+	WriteUInt32(SampleRate * BlockAlign);
+	WriteUInt16(BlockAlign);
+	WriteUInt16(BitsPerSample);
+	WriteTag("data");
+	WriteUInt32(DataSize);
+
+	FileHandle->Seek(0);
+	FileHandle->Write(Header, HeaderSize);
+	FileHandle->Seek(HeaderSize + static_cast<int64>(DataSize));
+	FileHandle->Flush();
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+
+class IFileHandle;
+
+/**
+ * Streams 16-bit PCM audio to a wav file for debugging. Writes only queue the audio and all file access happens in
+ * background tasks that flush the queue incrementally so recording never hitches the game thread however long it runs.
+ * The queue is bounded and audio that arrives while it is full is dropped rather than allowing memory to grow. The wav
+ * header is kept up to date after every flush so the file is playable even if the recording is never closed. Must be
+ * created with Create so that the background tasks can keep the writer alive until the file is closed
+ */
+class FWitWavFileWriter final : public TSharedFromThis<FWitWavFileWriter, ESPMode::ThreadSafe>
+{
+public:
+
+	/**
+	 * Create a writer for a new recording. The file is written to the project folder's Saved/BouncedWavFiles/Wit folder
+	 * and its name is the given name followed by a timestamp so successive recordings do not overwrite each other
+	 *
+	 * @param Name [in] the name of the recording
+	 * @param SampleRate [in] the sample rate of the audio
+	 * @param NumChannels [in] the number of channels in the audio
+	 * @return the writer
+	 */
+	static TSharedRef<FWitWavFileWriter, ESPMode::ThreadSafe> Create(const FString& Name, const int32 SampleRate, const int32 NumChannels);
+
+	FWitWavFileWriter(const FString& InFilePath, const int32 InSampleRate, const int32 InNumChannels);
+	~FWitWavFileWriter();
+
+	/**
+	 * Queue audio to be written. The span references the audio so nothing is copied
+	 *
+	 * @param Data [in] the audio to write
+	 * @return true if queued or false if the writer is closed or the queue is full
+	 */
+	bool Write(const FVoiceAudioSpan& Data);
+
+	/**
+	 * Queue a copy of the given audio to be written
+	 *
+	 * @param Data [in] the audio to write
+	 * @return true if queued or false if the writer is closed or the queue is full
+	 */
+	bool Write(TArrayView<const uint8> Data);
+
+	/**
+	 * Flush anything queued and close the file. This does not wait for the file to be closed
+	 */
+	void Close();
+
+	/**
+	 * Get the path of the file being written
+	 *
+	 * @return the path
+	 */
+	const FString& GetFilePath() const;
+
+private:
+
+	/** Queue a span of audio. Assumes the queue is locked */
+	bool Enqueue(const FVoiceAudioSpan& Data);
+
+	/** Start a background flush if one is not already running. Assumes the queue is locked */
+	void ScheduleFlush();
+
+	/** Write everything queued to the file. Runs in a background task */
+	void Flush();
+
+	/** Open the file and write a placeholder header */
+	bool OpenFile();
+
+	/** Write the header describing the given amount of audio data */
+	void WriteHeader(const uint32 DataSize);
+
+	/** The maximum number of bytes that may be queued before audio is dropped */
+	static constexpr int32 MaximumQueuedBytes{4 * 1024 * 1024};
+
+	/** The number of queued bytes that triggers a background flush */
+	static constexpr int32 FlushThreshold{64 * 1024};
+
+	/** The size of the blocks used to hold copied audio */
+	static constexpr int32 BlockSize{16 * 1024};
+
+	/** The path of the file being written */
+	const FString FilePath;
+
+	/** The sample rate of the audio */
+	const int32 SampleRate;
+
+	/** The number of channels in the audio */
+	const int32 NumChannels;
+
+	/** Pool for the blocks used to hold copied audio */
+	TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe> BlockPool;
+
+	/** Guards the queue and the flags below */
+	mutable FCriticalSection QueueCriticalSection{};
+
+	/** Audio waiting to be written */
+	TArray<FVoiceAudioSpan> Queue{};
+
+	/** The number of bytes waiting to be written */
+	int32 NumQueuedBytes{0};
+
+	/** The number of bytes dropped because the queue was full */
+	int64 NumDroppedBytes{0};
+
+	/** Is a background flush scheduled or running? */
+	bool bIsFlushScheduled{false};
+
+	/** Has the writer been closed? */
+	bool bIsCloseRequested{false};
+
+	/** The open file. Only ever accessed from the background flush */
+	TUniquePtr<IFileHandle> FileHandle{};
+
+	/** Did opening the file fail? */
+	bool bHasOpenFailed{false};
+
+	/** The number of bytes of audio written to the file */
+	uint32 NumBytesWritten{0};
+};
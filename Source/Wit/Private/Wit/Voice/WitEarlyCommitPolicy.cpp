@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitEarlyCommitPolicy.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Start watching a new request
+ *
+ * @param Configuration [in] the voice configuration containing the early commit settings
+ */
+void FWitEarlyCommitPolicy::Reset(const FVoiceConfiguration& Configuration)
+{
+	bIsEnabled = Configuration.bIsEarlyCommitEnabled;
+	NumRequiredStablePartialResponses = FMath::Max(Configuration.EarlyCommitStablePartialResponses, 1);
+	IntentConfidenceThreshold = Configuration.EarlyCommitIntentConfidenceThreshold;
+	IntentNames = Configuration.EarlyCommitIntentNames;
+	RequiredEntityNames = Configuration.EarlyCommitRequiredEntityNames;
+
+	LastIntentName.Reset();
+	LastEntityValues.Reset();
+	NumStablePartialResponses = 0;
+	bHasCommitted = false;
+}
+
+/**
+ * Examine the next partial response of the request. Any partial response that does not qualify breaks the run of stable
+ * partial responses so it has to start again
+ *
+ * @param Response [in] the partial response
+ * @return true if the request should be committed now
+ */
+bool FWitEarlyCommitPolicy::ShouldCommit(const FWitResponse& Response)
+{
+	if (!bIsEnabled || bHasCommitted)
+	{
+		return false;
+	}
+
+	const FWitIntent* TopIntent = Response.Intents.Num() > 0 ? &Response.Intents[0] : nullptr;
+
+	const bool bIsIntentQualified = TopIntent != nullptr && TopIntent->Confidence > IntentConfidenceThreshold
+		&& (IntentNames.Num() == 0 || IntentNames.Contains(TopIntent->Name));
+
+	TArray<FString> EntityValues;
+
+	if (!bIsIntentQualified || !GatherRequiredEntityValues(Response, EntityValues))
+	{
+		NumStablePartialResponses = 0;
+		return false;
+	}
+
+	const bool bIsUnchanged = NumStablePartialResponses > 0 && TopIntent->Name.Equals(LastIntentName) && EntityValues == LastEntityValues;
+
+	if (bIsUnchanged)
+	{
+		++NumStablePartialResponses;
+	}
+	else
+	{
+		LastIntentName = TopIntent->Name;
+		LastEntityValues = MoveTemp(EntityValues);
+		NumStablePartialResponses = 1;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitEarlyCommitPolicy - ShouldCommit: intent (%s) stable for (%d/%d) partial responses"), *LastIntentName,
+		NumStablePartialResponses, NumRequiredStablePartialResponses);
+
+	bHasCommitted = NumStablePartialResponses >= NumRequiredStablePartialResponses;
+
+	return bHasCommitted;
+}
+
+/**
+ * Get the number of successive partial responses that have been stable
+ *
+ * @return the number of partial responses
+ */
+int32 FWitEarlyCommitPolicy::GetNumStablePartialResponses() const
+{
+	return NumStablePartialResponses;
+}
+
+/**
+ * Gather the values of the required entities in the order they were configured
+ *
+ * @param Response [in] the partial response
+ * @param OutValues [out] the entity values
+ * @return true if every required entity is present
+ */
+bool FWitEarlyCommitPolicy::GatherRequiredEntityValues(const FWitResponse& Response, TArray<FString>& OutValues) const
+{
+	OutValues.Reserve(RequiredEntityNames.Num());
+
+	for (const FString& EntityName : RequiredEntityNames)
+	{
+		const FWitEntity* Entity = Response.Entities.Find(EntityName);
+
+		if (Entity == nullptr)
+		{
+			return false;
+		}
+
+		OutValues.Add(Entity->Value);
+	}
+
+	return true;
+}
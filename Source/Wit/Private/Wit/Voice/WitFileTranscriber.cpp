@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitFileTranscriber.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Wit/Request/WitRequest.h"
+#include "Wit/Request/WitRequestBuilder.h"
+#include "Wit/Request/WitRequestSubsystem.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Start transcribing a batch of files
+ *
+ * @param Paths [in] the files to transcribe
+ * @param Settings [in] the settings to use
+ * @param OnFileTranscribed [in] optional delegate called as each file completes
+ * @param OnComplete [in] delegate called once every file has completed
+ * @return the transcriber. It keeps itself alive until complete
+ */
+TSharedRef<FWitFileTranscriber, ESPMode::ThreadSafe> FWitFileTranscriber::TranscribeFiles(const TArray<FString>& Paths, const FWitFileTranscriptionSettings& Settings,
+	FOnWitFileTranscribedDelegate OnFileTranscribed, FOnWitFileTranscriptionCompleteDelegate OnComplete)
+{
+	TSharedRef<FWitFileTranscriber, ESPMode::ThreadSafe> Transcriber = MakeShared<FWitFileTranscriber, ESPMode::ThreadSafe>(Paths, Settings);
+
+	Transcriber->OnFileTranscribed = MoveTemp(OnFileTranscribed);
+	Transcriber->OnComplete = MoveTemp(OnComplete);
+	Transcriber->SelfReference = Transcriber;
+
+	UE_LOG(LogWit, Display, TEXT("FWitFileTranscriber - TranscribeFiles: transcribing (%d) files with concurrency (%d)"), Paths.Num(), Settings.Concurrency);
+
+	// Starting the first files immediately rather than waiting for the first tick saves a frame of latency
+
+	Transcriber->Tick(0.0f);
+
+	return Transcriber;
+}
+
+/**
+ * Constructor
+ *
+ * @param InPaths [in] the files to transcribe
+ * @param InSettings [in] the settings to use
+ */
+FWitFileTranscriber::FWitFileTranscriber(const TArray<FString>& InPaths, const FWitFileTranscriptionSettings& InSettings)
+	: Paths(InPaths)
+	, Settings(InSettings)
+{
+	Results.SetNum(Paths.Num());
+
+	for (int32 i = 0; i < Paths.Num(); ++i)
+	{
+		Results[i].Path = Paths[i];
+	}
+}
+
+/**
+ * Destructor
+ */
+FWitFileTranscriber::~FWitFileTranscriber()
+{
+	for (const TUniquePtr<FActiveFile>& File : ActiveFiles)
+	{
+		File->Request->CancelRequest();
+	}
+}
+
+/**
+ * Per frame tick function. Keeps up to the maximum number of requests in flight and feeds each one more of its file
+ *
+ * @param DeltaTime [in] the time in seconds since the last tick
+ */
+bool FWitFileTranscriber::Tick(float DeltaTime)
+{
+	if (IsComplete())
+	{
+		return true;
+	}
+
+	const int32 Concurrency = FMath::Max(Settings.Concurrency, 1);
+
+	while (ActiveFiles.Num() < Concurrency && StartNextFile())
+	{
+		// Deliberately empty
+	}
+
+	for (const TUniquePtr<FActiveFile>& File : ActiveFiles)
+	{
+		PumpFile(*File);
+	}
+
+	// Completed files are only removed here so that the request callbacks never invalidate the array while we iterate
+
+	ActiveFiles.RemoveAll([](const TUniquePtr<FActiveFile>& File)
+	{
+		return File->bIsComplete;
+	});
+
+	if (IsComplete())
+	{
+		UE_LOG(LogWit, Display, TEXT("FWitFileTranscriber - Tick: transcribed (%d) files"), Results.Num());
+
+		OnComplete.ExecuteIfBound(Results);
+
+		// Releasing the self reference may destroy us so it must be the last thing we do
+
+		SelfReference.Reset();
+	}
+
+	return true;
+}
+
+/**
+ * Cancel any requests in flight. Files that have not completed are reported as failed
+ */
+void FWitFileTranscriber::Cancel()
+{
+	while (NextFileIndex < Paths.Num())
+	{
+		Results[NextFileIndex].ErrorMessage = TEXT("Cancelled");
+		++NextFileIndex;
+		++NumFilesCompleted;
+	}
+
+	for (const TUniquePtr<FActiveFile>& File : ActiveFiles)
+	{
+		if (!File->bIsComplete)
+		{
+			File->Request->CancelRequest();
+			CompleteFile(*File, false, TEXT("Cancelled"));
+		}
+	}
+}
+
+/**
+ * Have all of the files completed?
+ *
+ * @return true if complete
+ */
+bool FWitFileTranscriber::IsComplete() const
+{
+	return NumFilesCompleted >= Paths.Num();
+}
+
+/**
+ * Get the results so far in the same order as the paths
+ *
+ * @return the results
+ */
+const TArray<FWitFileTranscriptionResult>& FWitFileTranscriber::GetResults() const
+{
+	return Results;
+}
+
+/**
+ * Start the next file if any remain
+ *
+ * @return true if a file was started or failed to start so that the caller should try the next one
+ */
+bool FWitFileTranscriber::StartNextFile()
+{
+	if (NextFileIndex >= Paths.Num())
+	{
+		return false;
+	}
+
+	TUniquePtr<FActiveFile> File = MakeUnique<FActiveFile>();
+
+	File->Index = NextFileIndex++;
+	File->Request = UWitRequestSubsystem::CreateRequest();
+	File->StartTime = FPlatformTime::Seconds();
+
+	const FString& Path = Paths[File->Index];
+
+	if (!OpenFile(Path, *File))
+	{
+		CompleteFile(*File, false, TEXT("Unable to open file"));
+		return true;
+	}
+
+	Results[File->Index].NumBytes = File->Data.Num();
+
+	// Wav files are sent as is and Wit.ai reads their format from the header. Anything else is assumed to be raw 16-bit mono
+
+	FWitRequestConfiguration RequestConfiguration{};
+
+	FWitRequestBuilder::SetRequestConfigurationWithDefaults(RequestConfiguration, Settings.Endpoint, Settings.Application.ClientAccessToken,
+		Settings.Application.Advanced.ApiVersion, Settings.Application.Advanced.URL);
+
+	const bool bIsWavFile = FPaths::GetExtension(Path).Equals(TEXT("wav"), ESearchCase::IgnoreCase);
+
+	if (bIsWavFile)
+	{
+		FWitRequestBuilder::AddFormatContentType(RequestConfiguration, EWitRequestFormat::Wav);
+	}
+	else
+	{
+		FWitRequestBuilder::AddFormatContentType(RequestConfiguration, EWitRequestFormat::Raw);
+		FWitRequestBuilder::AddEncodingContentType(RequestConfiguration, EWitRequestEncoding::SignedInteger);
+		FWitRequestBuilder::AddSampleSizeContentType(RequestConfiguration, EWitRequestSampleSize::Word);
+		FWitRequestBuilder::AddRateContentType(RequestConfiguration, Settings.RawSampleRate);
+		FWitRequestBuilder::AddEndianContentType(RequestConfiguration, EWitRequestEndian::Little);
+	}
+
+	RequestConfiguration.bShouldUseCustomHttpTimeout = Settings.Application.Advanced.bIsCustomHttpTimeout;
+	RequestConfiguration.HttpTimeout = Settings.Application.Advanced.HttpTimeout;
+
+	RequestConfiguration.OnRequestProgress.AddSP(AsShared(), &FWitFileTranscriber::OnRequestProgress, File->Index);
+	RequestConfiguration.OnRequestCompleteWithResponse.AddSP(AsShared(), &FWitFileTranscriber::OnRequestComplete, File->Index);
+	RequestConfiguration.OnRequestError.AddSP(AsShared(), &FWitFileTranscriber::OnRequestError, File->Index);
+
+	File->Request->BeginStreamRequest(RequestConfiguration);
+
+	ActiveFiles.Add(MoveTemp(File));
+
+	return true;
+}
+
+/**
+ * Open the given file for reading. Mapping the file lets the OS page it in as it is uploaded rather than us reading it
+ * all up front. Not every platform supports mapping so we fall back to loading the file
+ *
+ * @param Path [in] the file to open
+ * @param File [out] the file to fill in
+ * @return true if successful
+ */
+bool FWitFileTranscriber::OpenFile(const FString& Path, FActiveFile& File)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	// Files are addressed with 32-bit sizes so anything larger is rejected rather than silently truncated
+
+	const int64 FileSize = PlatformFile.FileSize(*Path);
+
+	if (FileSize > MAX_int32)
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitFileTranscriber - OpenFile: file is too large (%lld bytes) to transcribe (%s)"), FileSize, *Path);
+		return false;
+	}
+
+#if UE_VERSION_OLDER_THAN(5,3,0)
+	File.MappedHandle.Reset(PlatformFile.OpenMapped(*Path));
+#else
+	FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*Path);
+
+	if (MappedResult.HasValue())
+	{
+		File.MappedHandle = MappedResult.StealValue();
+	}
+#endif
+
+	const bool bIsMapped = File.MappedHandle.IsValid() && File.MappedHandle->GetFileSize() > 0;
+
+	if (bIsMapped)
+	{
+		File.MappedRegion.Reset(File.MappedHandle->MapRegion(0, File.MappedHandle->GetFileSize()));
+	}
+
+	if (File.MappedRegion.IsValid())
+	{
+		File.Data = TArrayView<const uint8>(File.MappedRegion->GetMappedPtr(), static_cast<int32>(File.MappedRegion->GetMappedSize()));
+		return true;
+	}
+
+	File.MappedHandle.Reset();
+
+	if (!FFileHelper::LoadFileToArray(File.LoadedData, *Path))
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitFileTranscriber - OpenFile: unable to open file (%s)"), *Path);
+		return false;
+	}
+
+	File.Data = File.LoadedData;
+
+	return true;
+}
+
+/**
+ * Write more of the file to its request once the network has accepted most of what was written before. This keeps at
+ * most a couple of chunks of the file in memory per request however large the file is
+ *
+ * @param File [in] the file to pump
+ */
+void FWitFileTranscriber::PumpFile(FActiveFile& File)
+{
+	if (File.bIsComplete || File.UploadEndTime > 0.0)
+	{
+		return;
+	}
+
+	const int64 NumBytesPending = File.Request->GetNumBytesPendingUpload();
+	const bool bIsUploadFinished = File.NumBytesWritten >= File.Data.Num();
+
+	if (bIsUploadFinished)
+	{
+		if (NumBytesPending == 0)
+		{
+			File.UploadEndTime = FPlatformTime::Seconds();
+			File.Request->EndStreamRequest();
+		}
+
+		return;
+	}
+
+	const int32 ChunkSize = FMath::Max(Settings.UploadChunkSize, 4096);
+
+	if (NumBytesPending >= ChunkSize)
+	{
+		return;
+	}
+
+	const int32 NumBytesToWrite = static_cast<int32>(FMath::Min<int64>(ChunkSize, File.Data.Num() - File.NumBytesWritten));
+
+	File.Request->WriteBinaryData(File.Data.Slice(static_cast<int32>(File.NumBytesWritten), NumBytesToWrite));
+	File.NumBytesWritten += NumBytesToWrite;
+}
+
+/**
+ * Complete the given file and report its result
+ *
+ * @param File [in] the file to complete
+ * @param bIsSuccessful [in] did the request succeed?
+ * @param ErrorMessage [in] the error if not successful
+ */
+void FWitFileTranscriber::CompleteFile(FActiveFile& File, const bool bIsSuccessful, const FString& ErrorMessage)
+{
+	if (File.bIsComplete)
+	{
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds();
+	FWitFileTranscriptionResult& Result = Results[File.Index];
+
+	Result.bIsSuccessful = bIsSuccessful;
+	Result.ErrorMessage = ErrorMessage;
+	Result.TotalTime = EndTime - File.StartTime;
+
+	if (File.UploadEndTime > 0.0)
+	{
+		Result.UploadTime = File.UploadEndTime - File.StartTime;
+		Result.ResponseLatency = EndTime - File.UploadEndTime;
+	}
+
+	File.bIsComplete = true;
+
+	// The file is no longer needed so we release it now rather than waiting for the next tick
+
+	File.MappedRegion.Reset();
+	File.MappedHandle.Reset();
+	File.LoadedData.Empty();
+	File.Data = TArrayView<const uint8>();
+
+	++NumFilesCompleted;
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitFileTranscriber - CompleteFile: (%s) success (%d) total (%.3fs) latency (%.3fs)"), *Result.Path, bIsSuccessful, Result.TotalTime, Result.ResponseLatency);
+
+	OnFileTranscribed.ExecuteIfBound(Result);
+}
+
+/**
+ * Called when a request has a partial response
+ */
+void FWitFileTranscriber::OnRequestProgress(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const int32 Index)
+{
+	FActiveFile* File = FindActiveFile(Index);
+	FWitFileTranscriptionResult& Result = Results[Index];
+
+	const bool bIsFirstPartial = File != nullptr && JsonResponse.IsValid() && Result.FirstPartialTime < 0.0;
+
+	if (bIsFirstPartial)
+	{
+		Result.FirstPartialTime = FPlatformTime::Seconds() - File->StartTime;
+	}
+}
+
+/**
+ * Called when a request completes. The response has already been converted off the game thread
+ */
+void FWitFileTranscriber::OnRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response, const int32 Index)
+{
+	FActiveFile* File = FindActiveFile(Index);
+
+	if (File == nullptr)
+	{
+		return;
+	}
+
+	// Results are handed to Blueprint which reads AllEntities directly
+
+	Results[Index].Response = Response;
+	Results[Index].Response.GetAllEntities();
+
+	CompleteFile(*File, true, FString());
+}
+
+/**
+ * Called when a request errors
+ */
+void FWitFileTranscriber::OnRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const int32 Index)
+{
+	FActiveFile* File = FindActiveFile(Index);
+
+	if (File == nullptr)
+	{
+		return;
+	}
+
+	UE_LOG(LogWit, Warning, TEXT("FWitFileTranscriber - OnRequestError: (%s) failed (%s)"), *Results[Index].Path, *ErrorMessage);
+
+	CompleteFile(*File, false, ErrorMessage);
+}
+
+/**
+ * Find the active file with the given result index
+ *
+ * @param Index [in] the result index
+ * @return the file or null if it is not active
+ */
+FWitFileTranscriber::FActiveFile* FWitFileTranscriber::FindActiveFile(const int32 Index)
+{
+	for (const TUniquePtr<FActiveFile>& File : ActiveFiles)
+	{
+		if (File->Index == Index)
+		{
+			return File.Get();
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitKeywordExtractor.h"
+#include "Containers/Queue.h"
+#include "Misc/Crc.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Compile the keywords of the given entities. The keyword itself and each of its synonyms are searched for and all of them
+ * resolve to the keyword
+ *
+ * @param Entities [in] the entity definitions
+ */
+void FWitKeywordExtractor::Build(const TArray<FWitEntityDefinition>& Entities)
+{
+	EntityNames.Reset();
+	Keywords.Reset();
+	Nodes.Reset();
+
+	Nodes.AddDefaulted();
+
+	for (const FWitEntityDefinition& Entity : Entities)
+	{
+		if (Entity.Keywords.Num() == 0)
+		{
+			continue;
+		}
+
+		const int32 EntityIndex = EntityNames.Add(Entity.Name);
+
+		for (const FWitEntityKeyword& Keyword : Entity.Keywords)
+		{
+			AddPhrase(Keyword.Keyword, EntityIndex, Keyword.Keyword);
+
+			for (const FString& Synonym : Keyword.Synonyms)
+			{
+				AddPhrase(Synonym, EntityIndex, Keyword.Keyword);
+			}
+		}
+	}
+
+	BuildLinks();
+
+	bIsBuilt = true;
+	EntitiesChecksum = CalculateChecksum(Entities);
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitKeywordExtractor - Build: compiled (%d) keywords from (%d) entities into (%d) nodes"), Keywords.Num(),
+		EntityNames.Num(), Nodes.Num());
+}
+
+/**
+ * Has the extractor been built?
+ *
+ * @return true if built
+ */
+bool FWitKeywordExtractor::IsBuilt() const
+{
+	return bIsBuilt;
+}
+
+/**
+ * Was the extractor built from the given entities? The entities are compared by checksum so this is much cheaper than
+ * rebuilding. Only the names and keywords are compared as nothing else is compiled into the extractor
+ *
+ * @param Entities [in] the entity definitions
+ * @return true if built from entities with the same names and keywords
+ */
+bool FWitKeywordExtractor::IsBuiltFrom(const TArray<FWitEntityDefinition>& Entities) const
+{
+	return bIsBuilt && EntitiesChecksum == CalculateChecksum(Entities);
+}
+
+/**
+ * Get the number of keywords and synonyms compiled into the extractor
+ *
+ * @return the number of keywords
+ */
+int32 FWitKeywordExtractor::GetNumKeywords() const
+{
+	return Keywords.Num();
+}
+
+/**
+ * Find the keyword entities mentioned in the given text
+ *
+ * @param Text [in] the text to search
+ * @param OutEntities [out] the entities found in the order they appear
+ */
+void FWitKeywordExtractor::Extract(const FString& Text, TArray<FWitEntity>& OutEntities) const
+{
+	OutEntities.Reset();
+
+	if (Keywords.Num() == 0)
+	{
+		return;
+	}
+
+	// Gather every whole word match as (start, keyword index)
+
+	TArray<TPair<int32, int32>, TInlineAllocator<16>> Matches;
+
+	const int32 TextLength = Text.Len();
+	int32 NodeIndex = 0;
+
+	for (int32 Index = 0; Index < TextLength; ++Index)
+	{
+		const TCHAR Character = FChar::ToLower(Text[Index]);
+		const int32* ChildIndex = Nodes[NodeIndex].Children.Find(Character);
+
+		while (ChildIndex == nullptr && NodeIndex != 0)
+		{
+			NodeIndex = Nodes[NodeIndex].Failure;
+			ChildIndex = Nodes[NodeIndex].Children.Find(Character);
+		}
+
+		NodeIndex = ChildIndex != nullptr ? *ChildIndex : 0;
+
+		const bool bIsEndOfWord = Index + 1 == TextLength || !FChar::IsAlnum(Text[Index + 1]);
+		if (!bIsEndOfWord)
+		{
+			continue;
+		}
+
+		int32 OutputIndex = Nodes[NodeIndex].KeywordIndex != INDEX_NONE ? NodeIndex : Nodes[NodeIndex].Output;
+
+		while (OutputIndex != INDEX_NONE)
+		{
+			const int32 KeywordIndex = Nodes[OutputIndex].KeywordIndex;
+			const int32 Start = Index + 1 - Keywords[KeywordIndex].Length;
+
+			const bool bIsStartOfWord = Start == 0 || !FChar::IsAlnum(Text[Start - 1]);
+			if (bIsStartOfWord)
+			{
+				Matches.Emplace(Start, KeywordIndex);
+			}
+
+			OutputIndex = Nodes[OutputIndex].Output;
+		}
+	}
+
+	// Keep the earliest and then longest of any overlapping matches
+
+	Matches.Sort([this](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+	{
+		return A.Key != B.Key ? A.Key < B.Key : Keywords[A.Value].Length > Keywords[B.Value].Length;
+	});
+
+	int32 NextStart = 0;
+
+	for (const TPair<int32, int32>& Match : Matches)
+	{
+		if (Match.Key < NextStart)
+		{
+			continue;
+		}
+
+		const FKeyword& Keyword = Keywords[Match.Value];
+		FWitEntity& Entity = OutEntities.AddDefaulted_GetRef();
+
+		Entity.Name = EntityNames[Keyword.EntityIndex];
+		Entity.Role = Entity.Name;
+		Entity.Value = Keyword.Value;
+		Entity.Body = Text.Mid(Match.Key, Keyword.Length);
+		Entity.Type = TEXT("value");
+		Entity.Start = Match.Key;
+		Entity.End = Match.Key + Keyword.Length;
+		Entity.Confidence = 1.0f;
+
+		NextStart = Entity.End;
+	}
+}
+
+/**
+ * Add a phrase for the given keyword. If the same phrase is added more than once the first takes precedence
+ *
+ * @param Phrase [in] the phrase to search for
+ * @param EntityIndex [in] the index of the entity name
+ * @param Value [in] the canonical value of the keyword
+ */
+void FWitKeywordExtractor::AddPhrase(const FString& Phrase, const int32 EntityIndex, const FString& Value)
+{
+	const FString SearchPhrase = Phrase.TrimStartAndEnd().ToLower();
+
+	if (SearchPhrase.IsEmpty())
+	{
+		return;
+	}
+
+	int32 NodeIndex = 0;
+
+	for (const TCHAR Character : SearchPhrase)
+	{
+		const int32* ChildIndex = Nodes[NodeIndex].Children.Find(Character);
+
+		if (ChildIndex != nullptr)
+		{
+			NodeIndex = *ChildIndex;
+			continue;
+		}
+
+		// Adding the node may reallocate the array so the parent is looked up again afterwards
+
+		const int32 NewNodeIndex = Nodes.AddDefaulted();
+
+		Nodes[NodeIndex].Children.Add(Character, NewNodeIndex);
+		NodeIndex = NewNodeIndex;
+	}
+
+	if (Nodes[NodeIndex].KeywordIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	FKeyword& Keyword = Keywords.AddDefaulted_GetRef();
+
+	Keyword.EntityIndex = EntityIndex;
+	Keyword.Value = Value;
+	Keyword.Length = SearchPhrase.Len();
+
+	Nodes[NodeIndex].KeywordIndex = Keywords.Num() - 1;
+}
+
+/**
+ * Compute the failure and output links once every phrase has been added. Nodes are visited breadth first so that the links of
+ * every shorter suffix are known before they are needed
+ */
+void FWitKeywordExtractor::BuildLinks()
+{
+	TQueue<int32> NodesToVisit;
+
+	for (const TPair<TCHAR, int32>& Child : Nodes[0].Children)
+	{
+		Nodes[Child.Value].Failure = 0;
+		NodesToVisit.Enqueue(Child.Value);
+	}
+
+	int32 NodeIndex = 0;
+
+	while (NodesToVisit.Dequeue(NodeIndex))
+	{
+		for (const TPair<TCHAR, int32>& Child : Nodes[NodeIndex].Children)
+		{
+			int32 FailureIndex = Nodes[NodeIndex].Failure;
+			const int32* FailureChildIndex = Nodes[FailureIndex].Children.Find(Child.Key);
+
+			while (FailureChildIndex == nullptr && FailureIndex != 0)
+			{
+				FailureIndex = Nodes[FailureIndex].Failure;
+				FailureChildIndex = Nodes[FailureIndex].Children.Find(Child.Key);
+			}
+
+			FNode& ChildNode = Nodes[Child.Value];
+			const int32 ChildFailure = FailureChildIndex != nullptr ? *FailureChildIndex : 0;
+
+			ChildNode.Failure = ChildFailure;
+			ChildNode.Output = Nodes[ChildFailure].KeywordIndex != INDEX_NONE ? ChildFailure : Nodes[ChildFailure].Output;
+
+			NodesToVisit.Enqueue(Child.Value);
+		}
+	}
+}
+
+/**
+ * Calculate a checksum of the names and keywords of the given entities. Entities without keywords are included so that
+ * renaming or reordering them is also detected
+ *
+ * @param Entities [in] the entity definitions
+ * @return the checksum
+ */
+uint32 FWitKeywordExtractor::CalculateChecksum(const TArray<FWitEntityDefinition>& Entities)
+{
+	uint32 Checksum = 0;
+
+	for (const FWitEntityDefinition& Entity : Entities)
+	{
+		Checksum = FCrc::StrCrc32(*Entity.Name, Checksum);
+
+		for (const FWitEntityKeyword& Keyword : Entity.Keywords)
+		{
+			Checksum = FCrc::StrCrc32(*Keyword.Keyword, Checksum);
+
+			for (const FString& Synonym : Keyword.Synonyms)
+			{
+				Checksum = FCrc::StrCrc32(*Synonym, Checksum);
+			}
+		}
+	}
+
+	return Checksum;
+}
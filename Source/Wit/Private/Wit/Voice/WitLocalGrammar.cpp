@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitLocalGrammar.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Start watching a new request
+ *
+ * @param Configuration [in] the voice configuration containing the local grammar settings
+ */
+void FWitLocalGrammar::Reset(const FVoiceConfiguration& Configuration)
+{
+	bIsEnabled = Configuration.bIsLocalGrammarEnabled && Configuration.LocalGrammarPhrases.Num() > 0;
+	bHasMatched = false;
+
+	Phrases.Reset();
+	Nodes.Reset();
+
+	if (!bIsEnabled)
+	{
+		return;
+	}
+
+	Phrases = Configuration.LocalGrammarPhrases;
+	Nodes.AddDefaulted();
+
+	for (int32 PhraseIndex = 0; PhraseIndex < Phrases.Num(); ++PhraseIndex)
+	{
+		AddPhrase(Phrases[PhraseIndex].Phrase, PhraseIndex);
+	}
+}
+
+/**
+ * Is the local grammar enabled and does it have any phrases?
+ *
+ * @return true if enabled
+ */
+bool FWitLocalGrammar::IsEnabled() const
+{
+	return bIsEnabled;
+}
+
+/**
+ * Match the next partial transcription of the request. Partial transcriptions grow as the user speaks so a phrase that is
+ * the start of a longer phrase is never matched from a partial transcription
+ *
+ * @param Transcription [in] the partial transcription
+ * @param OutResponse [out] the response for the matched phrase
+ * @return true if a phrase was confidently matched
+ */
+bool FWitLocalGrammar::Match(const FString& Transcription, FWitResponse& OutResponse)
+{
+	if (!bIsEnabled || bHasMatched)
+	{
+		return false;
+	}
+
+	TArray<FString> Words;
+	Tokenize(Transcription, Words);
+
+	if (Words.Num() == 0)
+	{
+		return false;
+	}
+
+	int32 NodeIndex = 0;
+
+	for (const FString& Word : Words)
+	{
+		const int32* ChildIndex = Nodes[NodeIndex].Children.Find(Word);
+
+		if (ChildIndex == nullptr)
+		{
+			return false;
+		}
+
+		NodeIndex = *ChildIndex;
+	}
+
+	const FNode& Node = Nodes[NodeIndex];
+
+	const bool bIsConfidentMatch = Node.PhraseIndex != INDEX_NONE && Node.Children.Num() == 0;
+	if (!bIsConfidentMatch)
+	{
+		return false;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitLocalGrammar - Match: matched phrase (%s) with intent (%s)"), *Phrases[Node.PhraseIndex].Phrase,
+		*Phrases[Node.PhraseIndex].IntentName);
+
+	MakeResponse(Transcription, Node.PhraseIndex, OutResponse);
+	bHasMatched = true;
+
+	return true;
+}
+
+/**
+ * Split text into lowercase words ignoring punctuation. Apostrophes are kept so that contractions remain a single word
+ *
+ * @param Text [in] the text to split
+ * @param OutWords [out] the words
+ */
+void FWitLocalGrammar::Tokenize(const FString& Text, TArray<FString>& OutWords)
+{
+	OutWords.Reset();
+
+	FString Word;
+
+	for (const TCHAR Character : Text)
+	{
+		const bool bIsWordCharacter = FChar::IsAlnum(Character) || Character == TEXT('\'');
+		if (bIsWordCharacter)
+		{
+			Word.AppendChar(FChar::ToLower(Character));
+		}
+		else if (Word.Len() > 0)
+		{
+			OutWords.Add(MoveTemp(Word));
+			Word.Reset();
+		}
+	}
+
+	if (Word.Len() > 0)
+	{
+		OutWords.Add(MoveTemp(Word));
+	}
+}
+
+/**
+ * Add a phrase to the trie. If the same phrase is configured more than once the first takes precedence
+ *
+ * @param Phrase [in] the phrase to add
+ * @param PhraseIndex [in] the index of the phrase
+ */
+void FWitLocalGrammar::AddPhrase(const FString& Phrase, const int32 PhraseIndex)
+{
+	TArray<FString> Words;
+	Tokenize(Phrase, Words);
+
+	if (Words.Num() == 0)
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitLocalGrammar - AddPhrase: ignoring empty phrase (%d)"), PhraseIndex);
+		return;
+	}
+
+	int32 NodeIndex = 0;
+
+	for (FString& Word : Words)
+	{
+		const int32* ChildIndex = Nodes[NodeIndex].Children.Find(Word);
+
+		if (ChildIndex != nullptr)
+		{
+			NodeIndex = *ChildIndex;
+			continue;
+		}
+
+		// Adding the node may reallocate the array so the parent is looked up again afterwards
+
+		const int32 NewNodeIndex = Nodes.AddDefaulted();
+
+		Nodes[NodeIndex].Children.Add(MoveTemp(Word), NewNodeIndex);
+		NodeIndex = NewNodeIndex;
+	}
+
+	if (Nodes[NodeIndex].PhraseIndex == INDEX_NONE)
+	{
+		Nodes[NodeIndex].PhraseIndex = PhraseIndex;
+	}
+}
+
+/**
+ * Fill in the response for the given phrase. The intent and entities are given full confidence
+ *
+ * @param Transcription [in] the transcription that matched
+ * @param PhraseIndex [in] the index of the matched phrase
+ * @param OutResponse [out] the response
+ */
+void FWitLocalGrammar::MakeResponse(const FString& Transcription, const int32 PhraseIndex, FWitResponse& OutResponse) const
+{
+	const FVoiceLocalGrammarPhrase& Phrase = Phrases[PhraseIndex];
+
+	OutResponse.Reset();
+	OutResponse.Text = Transcription;
+
+	if (!Phrase.IntentName.IsEmpty())
+	{
+		FWitIntent& Intent = OutResponse.Intents.AddDefaulted_GetRef();
+
+		Intent.Name = Phrase.IntentName;
+		Intent.Confidence = 1.0f;
+	}
+
+	for (const TPair<FString, FString>& EntityValue : Phrase.Entities)
+	{
+		FString Name;
+		FString Role;
+
+		if (!EntityValue.Key.Split(TEXT(":"), &Name, &Role))
+		{
+			Name = EntityValue.Key;
+			Role = EntityValue.Key;
+		}
+
+		FWitEntity Entity{};
+
+		Entity.Name = Name;
+		Entity.Role = Role;
+		Entity.Value = EntityValue.Value;
+		Entity.Body = EntityValue.Value;
+		Entity.Confidence = 1.0f;
+
+		const FString Key = FString::Printf(TEXT("%s:%s"), *Name, *Role);
+
+		FWitEntities& AllEntitiesForName = OutResponse.AllEntities.FindOrAdd(Key);
+
+		AllEntitiesForName.Name = Key;
+		AllEntitiesForName.Entities.Add(Entity);
+
+		OutResponse.Entities.Add(Key, MoveTemp(Entity));
+	}
+}
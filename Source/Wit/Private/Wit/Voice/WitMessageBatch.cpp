@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitMessageBatch.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "HAL/PlatformProcess.h"
+#include "Wit/Request/WitRequest.h"
+#include "Wit/Request/WitRequestBuilder.h"
+#include "Wit/Request/WitRequestSubsystem.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Start sending a batch of texts
+ *
+ * @param Texts [in] the texts to send
+ * @param Settings [in] the settings to use
+ * @param OnMessageResult [in] optional delegate called as each text completes
+ * @param OnComplete [in] delegate called once every text has completed
+ * @return the batch. It keeps itself alive until complete
+ */
+TSharedRef<FWitMessageBatch, ESPMode::ThreadSafe> FWitMessageBatch::SendTranscriptions(const TArray<FString>& Texts, const FWitMessageBatchSettings& Settings,
+	FOnWitMessageResultDelegate OnMessageResult, FOnWitMessageBatchCompleteDelegate OnComplete)
+{
+	TSharedRef<FWitMessageBatch, ESPMode::ThreadSafe> Batch = MakeShared<FWitMessageBatch, ESPMode::ThreadSafe>(Texts, Settings);
+
+	Batch->OnMessageResult = MoveTemp(OnMessageResult);
+	Batch->OnComplete = MoveTemp(OnComplete);
+	Batch->SelfReference = Batch;
+
+	UE_LOG(LogWit, Display, TEXT("FWitMessageBatch - SendTranscriptions: sending (%d) texts with concurrency (%d) and rate limit (%.1f) per minute"), Texts.Num(),
+		Settings.Concurrency, Settings.MaximumRequestsPerMinute);
+
+	// Starting the first requests immediately rather than waiting for the first tick saves a frame of latency
+
+	Batch->Tick(0.0f);
+
+	return Batch;
+}
+
+/**
+ * Constructor
+ *
+ * @param InTexts [in] the texts to send
+ * @param InSettings [in] the settings to use
+ */
+FWitMessageBatch::FWitMessageBatch(const TArray<FString>& InTexts, const FWitMessageBatchSettings& InSettings)
+	: Texts(InTexts)
+	, Settings(InSettings)
+{
+	Results.SetNum(Texts.Num());
+
+	for (int32 i = 0; i < Texts.Num(); ++i)
+	{
+		Results[i].Index = i;
+		Results[i].Text = Texts[i];
+	}
+
+	BatchStartTime = FPlatformTime::Seconds();
+}
+
+/**
+ * Destructor
+ */
+FWitMessageBatch::~FWitMessageBatch()
+{
+	for (const TUniquePtr<FActiveMessage>& Message : ActiveMessages)
+	{
+		if (Message->Request.IsValid())
+		{
+			Message->Request->CancelRequest();
+		}
+	}
+}
+
+/**
+ * Per frame tick function. Keeps up to the maximum number of requests in flight within the rate limit and retries any
+ * requests whose backoff has expired
+ *
+ * @param DeltaTime [in] the time in seconds since the last tick
+ */
+bool FWitMessageBatch::Tick(float DeltaTime)
+{
+	// The self reference is only released once completion has been reported. Checking it rather than IsComplete means a
+	// cancelled batch still reports completion on its next tick
+
+	if (!SelfReference.IsValid())
+	{
+		return true;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Retries take priority over new texts so that a throttled text is not starved by the rest of the batch
+
+	for (const TUniquePtr<FActiveMessage>& Message : ActiveMessages)
+	{
+		const bool bShouldRetry = !Message->bIsComplete && Message->RetryTime > 0.0 && Now >= Message->RetryTime && CanStartRequest(Now);
+
+		if (bShouldRetry)
+		{
+			StartRequest(*Message, Now);
+		}
+	}
+
+	const int32 Concurrency = FMath::Max(Settings.Concurrency, 1);
+
+	while (ActiveMessages.Num() < Concurrency && CanStartRequest(Now) && StartNextMessage(Now))
+	{
+		// Deliberately empty
+	}
+
+	// Completed texts are only removed here so that the request callbacks never invalidate the array while we iterate
+
+	ActiveMessages.RemoveAll([](const TUniquePtr<FActiveMessage>& Message)
+	{
+		return Message->bIsComplete;
+	});
+
+	if (IsComplete())
+	{
+		int32 NumSuccessful = 0;
+
+		for (const FWitMessageBatchResult& Result : Results)
+		{
+			NumSuccessful += Result.bIsSuccessful ? 1 : 0;
+		}
+
+		UE_LOG(LogWit, Display, TEXT("FWitMessageBatch - Tick: sent (%d) texts, (%d) successful in (%.2fs)"), Results.Num(), NumSuccessful,
+			Now - BatchStartTime);
+
+		OnComplete.ExecuteIfBound(Results);
+
+		// Releasing the self reference may destroy us so it must be the last thing we do
+
+		SelfReference.Reset();
+	}
+
+	return true;
+}
+
+/**
+ * Block until every text has completed or the timeout expires. Request responses are delivered as game thread tasks and
+ * both the HTTP manager and the batch itself are driven by the core ticker so we pump both here
+ *
+ * @param Timeout [in] the maximum time in seconds to wait. Zero to wait forever
+ * @return true if complete
+ */
+bool FWitMessageBatch::WaitUntilComplete(const double Timeout)
+{
+	check(IsInGameThread());
+
+	// The caller's reference keeps us alive if the self reference is released while we wait
+
+	const TSharedRef<FWitMessageBatch, ESPMode::ThreadSafe> KeepAlive = AsShared();
+
+	const double WaitStartTime = FPlatformTime::Seconds();
+	double LastTickTime = WaitStartTime;
+
+	while (!IsComplete())
+	{
+		const double Now = FPlatformTime::Seconds();
+		const bool bHasTimedOut = Timeout > 0.0 && Now - WaitStartTime >= Timeout;
+
+		if (bHasTimedOut)
+		{
+			UE_LOG(LogWit, Warning, TEXT("FWitMessageBatch - WaitUntilComplete: timed out with (%d) of (%d) texts complete"), NumMessagesCompleted, Texts.Num());
+			return false;
+		}
+
+		const float DeltaTime = static_cast<float>(Now - LastTickTime);
+		LastTickTime = Now;
+
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+#if UE_VERSION_OLDER_THAN(5,0,0)
+		FTicker::GetCoreTicker().Tick(DeltaTime);
+#else
+		FTSTicker::GetCoreTicker().Tick(DeltaTime);
+#endif
+
+		FPlatformProcess::Sleep(0.005f);
+	}
+
+	return true;
+}
+
+/**
+ * Cancel any requests in flight. Texts that have not completed are reported as failed
+ */
+void FWitMessageBatch::Cancel()
+{
+	while (NextMessageIndex < Texts.Num())
+	{
+		Results[NextMessageIndex].ErrorMessage = TEXT("Cancelled");
+		++NextMessageIndex;
+		++NumMessagesCompleted;
+	}
+
+	for (const TUniquePtr<FActiveMessage>& Message : ActiveMessages)
+	{
+		if (Message->bIsComplete)
+		{
+			continue;
+		}
+
+		if (Message->Request.IsValid())
+		{
+			Message->Request->CancelRequest();
+		}
+
+		CompleteMessage(*Message, false, TEXT("Cancelled"));
+	}
+}
+
+/**
+ * Have all of the texts completed?
+ *
+ * @return true if complete
+ */
+bool FWitMessageBatch::IsComplete() const
+{
+	return NumMessagesCompleted >= Texts.Num();
+}
+
+/**
+ * Get the results so far in the same order as the texts
+ *
+ * @return the results
+ */
+const TArray<FWitMessageBatchResult>& FWitMessageBatch::GetResults() const
+{
+	return Results;
+}
+
+/**
+ * Is the rate limit allowing another request to start now?
+ *
+ * @param Now [in] the current time
+ * @return true if a request can start
+ */
+bool FWitMessageBatch::CanStartRequest(const double Now) const
+{
+	return Now >= NextRequestTime;
+}
+
+/**
+ * Start the next text if any remain
+ *
+ * @param Now [in] the current time
+ * @return true if a text was started so that the caller should try the next one
+ */
+bool FWitMessageBatch::StartNextMessage(const double Now)
+{
+	if (NextMessageIndex >= Texts.Num())
+	{
+		return false;
+	}
+
+	TUniquePtr<FActiveMessage> Message = MakeUnique<FActiveMessage>();
+
+	Message->Index = NextMessageIndex++;
+	Message->FirstStartTime = Now;
+
+	Results[Message->Index].QueueTime = Now - BatchStartTime;
+
+	StartRequest(*Message, Now);
+
+	ActiveMessages.Add(MoveTemp(Message));
+
+	return true;
+}
+
+/**
+ * Make a request for the given text. A new request is created for each attempt so that a late callback from an earlier
+ * attempt can be recognised and ignored
+ *
+ * @param Message [in] the text to send
+ * @param Now [in] the current time
+ */
+void FWitMessageBatch::StartRequest(FActiveMessage& Message, const double Now)
+{
+	FWitMessageBatchResult& Result = Results[Message.Index];
+
+	const int32 Attempt = ++Result.NumAttempts;
+
+	Message.Request = UWitRequestSubsystem::CreateRequest();
+	Message.StartTime = Now;
+	Message.RetryTime = 0.0;
+
+	// Requests are spaced evenly rather than sent in bursts so that we never trip the server side rate limit
+
+	if (Settings.MaximumRequestsPerMinute > 0.0f)
+	{
+		NextRequestTime = Now + 60.0 / Settings.MaximumRequestsPerMinute;
+	}
+
+	FWitRequestConfiguration RequestConfiguration{};
+
+	FWitRequestBuilder::SetRequestConfigurationWithDefaults(RequestConfiguration, EWitRequestEndpoint::Message, Settings.Application.ClientAccessToken,
+		Settings.Application.Advanced.ApiVersion, Settings.Application.Advanced.URL);
+
+	const FString EncodedText = FGenericPlatformHttp::UrlEncode(Result.Text);
+	FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::Text, EncodedText);
+
+	RequestConfiguration.bShouldUseCustomHttpTimeout = Settings.Application.Advanced.bIsCustomHttpTimeout;
+	RequestConfiguration.HttpTimeout = Settings.Application.Advanced.HttpTimeout;
+
+	RequestConfiguration.OnRequestCompleteWithResponse.AddSP(AsShared(), &FWitMessageBatch::OnRequestComplete, Message.Index, Attempt);
+	RequestConfiguration.OnRequestError.AddSP(AsShared(), &FWitMessageBatch::OnRequestError, Message.Index, Attempt);
+
+	Message.Request->BeginStreamRequest(RequestConfiguration);
+	Message.Request->EndStreamRequest();
+}
+
+/**
+ * Complete the given text and report its result
+ *
+ * @param Message [in] the text to complete
+ * @param bIsSuccessful [in] did the request succeed?
+ * @param ErrorMessage [in] the error if not successful
+ */
+void FWitMessageBatch::CompleteMessage(FActiveMessage& Message, const bool bIsSuccessful, const FString& ErrorMessage)
+{
+	if (Message.bIsComplete)
+	{
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds();
+	FWitMessageBatchResult& Result = Results[Message.Index];
+
+	Result.bIsSuccessful = bIsSuccessful;
+	Result.ErrorMessage = ErrorMessage;
+	Result.Latency = EndTime - Message.StartTime;
+	Result.TotalTime = EndTime - Message.FirstStartTime;
+
+	Message.bIsComplete = true;
+	Message.RetryTime = 0.0;
+
+	++NumMessagesCompleted;
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitMessageBatch - CompleteMessage: (%s) success (%d) attempts (%d) latency (%.3fs) total (%.3fs)"), *Result.Text, bIsSuccessful,
+		Result.NumAttempts, Result.Latency, Result.TotalTime);
+
+	OnMessageResult.ExecuteIfBound(Result);
+}
+
+/**
+ * Should a request that failed with the given error be retried? Rate limiting, server errors and connection failures are
+ * transient whereas any other client error will fail again
+ *
+ * @param ErrorMessage [in] the error the request failed with
+ * @return true if the request should be retried
+ */
+bool FWitMessageBatch::IsRetryableError(const FString& ErrorMessage)
+{
+	const FString HttpErrorPrefix(TEXT("HTTP Error "));
+
+	if (!ErrorMessage.StartsWith(HttpErrorPrefix))
+	{
+		return false;
+	}
+
+	const int32 ResponseCode = FCString::Atoi(*ErrorMessage.RightChop(HttpErrorPrefix.Len()));
+
+	return ResponseCode == 0 || ResponseCode == 429 || ResponseCode >= 500;
+}
+
+/**
+ * Called when a request completes. The response has already been converted off the game thread. Error responses such as
+ * rate limiting arrive as request errors so that they can be retried
+ */
+void FWitMessageBatch::OnRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response,
+	const int32 Index, const int32 Attempt)
+{
+	FActiveMessage* Message = FindActiveMessage(Index);
+
+	const bool bIsCurrentAttempt = Message != nullptr && Results[Index].NumAttempts == Attempt;
+
+	if (!bIsCurrentAttempt)
+	{
+		return;
+	}
+
+	// Results are handed to Blueprint which reads AllEntities directly
+
+	Results[Index].Response = Response;
+	Results[Index].Response.GetAllEntities();
+
+	CompleteMessage(*Message, true, FString());
+}
+
+/**
+ * Called when a request errors. Transient errors are retried with an exponential backoff and also hold back every other
+ * request for the same time when we have been rate limited
+ */
+void FWitMessageBatch::OnRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const int32 Index, const int32 Attempt)
+{
+	FActiveMessage* Message = FindActiveMessage(Index);
+
+	const bool bIsCurrentAttempt = Message != nullptr && Results[Index].NumAttempts == Attempt && Message->RetryTime <= 0.0;
+
+	if (!bIsCurrentAttempt)
+	{
+		return;
+	}
+
+	const bool bShouldRetry = IsRetryableError(ErrorMessage) && Attempt <= Settings.MaximumRetries;
+
+	if (!bShouldRetry)
+	{
+		UE_LOG(LogWit, Warning, TEXT("FWitMessageBatch - OnRequestError: (%s) failed (%s)"), *Results[Index].Text, *ErrorMessage);
+
+		CompleteMessage(*Message, false, ErrorMessage);
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double Backoff = FMath::Max(Settings.RetryDelay, 0.0f) * FMath::Pow(2.0f, static_cast<float>(Attempt - 1));
+
+	Message->RetryTime = Now + Backoff;
+
+	const bool bWasRateLimited = ErrorMessage.EndsWith(TEXT("429"));
+
+	if (bWasRateLimited)
+	{
+		NextRequestTime = FMath::Max(NextRequestTime, Message->RetryTime);
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("FWitMessageBatch - OnRequestError: (%s) failed (%s), retrying in (%.2fs)"), *Results[Index].Text, *ErrorMessage, Backoff);
+}
+
+/**
+ * Find the active text with the given result index
+ *
+ * @param Index [in] the result index
+ * @return the text or null if it is not active
+ */
+FWitMessageBatch::FActiveMessage* FWitMessageBatch::FindActiveMessage(const int32 Index)
+{
+	for (const TUniquePtr<FActiveMessage>& Message : ActiveMessages)
+	{
+		if (Message->Index == Index)
+		{
+			return Message.Get();
+		}
+	}
+
+	return nullptr;
+}
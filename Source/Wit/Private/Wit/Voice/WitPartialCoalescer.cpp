@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitPartialCoalescer.h"
+
+/**
+ * Start coalescing a new request
+ *
+ * @param Configuration [in] the voice configuration containing the coalescing settings
+ */
+void FWitPartialCoalescer::Reset(const FVoiceConfiguration& Configuration)
+{
+	bIsEnabled = Configuration.bIsPartialCoalescingEnabled;
+	Interval = FMath::Max(Configuration.PartialCoalescingInterval, 0.0f);
+
+	TranscriptionState = FKindState();
+	ResponseState = FKindState();
+	NumDropped = 0;
+}
+
+/**
+ * Is coalescing enabled?
+ *
+ * @return true if enabled
+ */
+bool FWitPartialCoalescer::IsEnabled() const
+{
+	return bIsEnabled;
+}
+
+/**
+ * Offer a new partial for delivery. A partial held back replaces any pending partial of the same kind which is counted as dropped
+ *
+ * @param Kind [in] the kind of partial
+ * @param Now [in] the current time in seconds
+ * @return true if it should be delivered now
+ */
+bool FWitPartialCoalescer::Submit(const EWitPartialKind Kind, const double Now)
+{
+	if (!bIsEnabled)
+	{
+		return true;
+	}
+
+	FKindState& State = GetState(Kind);
+
+	if (CanDeliver(State, Now))
+	{
+		State.bIsPending = false;
+		MarkDelivered(State, Now);
+
+		return true;
+	}
+
+	NumDropped += State.bIsPending ? 1 : 0;
+	State.bIsPending = true;
+
+	return false;
+}
+
+/**
+ * Take the pending partials if they are now due for delivery. Each kind is checked against its own budget
+ *
+ * @param Now [in] the current time in seconds
+ * @param bIsForced [in] should pending partials be taken regardless of their budget?
+ * @param bOutIsTranscriptionDue [out] should the pending transcription be delivered?
+ * @param bOutIsResponseDue [out] should the pending response be delivered?
+ * @return true if anything should be delivered
+ */
+bool FWitPartialCoalescer::Flush(const double Now, const bool bIsForced, bool& bOutIsTranscriptionDue, bool& bOutIsResponseDue)
+{
+	bOutIsTranscriptionDue = TranscriptionState.bIsPending && (bIsForced || CanDeliver(TranscriptionState, Now));
+	bOutIsResponseDue = ResponseState.bIsPending && (bIsForced || CanDeliver(ResponseState, Now));
+
+	if (bOutIsTranscriptionDue)
+	{
+		TranscriptionState.bIsPending = false;
+		MarkDelivered(TranscriptionState, Now);
+	}
+
+	if (bOutIsResponseDue)
+	{
+		ResponseState.bIsPending = false;
+		MarkDelivered(ResponseState, Now);
+	}
+
+	return bOutIsTranscriptionDue || bOutIsResponseDue;
+}
+
+/**
+ * Discard any pending partials
+ */
+void FWitPartialCoalescer::Drop()
+{
+	NumDropped += (TranscriptionState.bIsPending ? 1 : 0) + (ResponseState.bIsPending ? 1 : 0);
+
+	TranscriptionState.bIsPending = false;
+	ResponseState.bIsPending = false;
+}
+
+/**
+ * Is a partial of the given kind pending?
+ *
+ * @param Kind [in] the kind of partial
+ * @return true if pending
+ */
+bool FWitPartialCoalescer::IsPending(const EWitPartialKind Kind) const
+{
+	return GetState(Kind).bIsPending;
+}
+
+/**
+ * Get the number of partials that have been dropped since the request started
+ *
+ * @return the number of partials
+ */
+int32 FWitPartialCoalescer::GetNumDropped() const
+{
+	return NumDropped;
+}
+
+/**
+ * Get the state of the given kind of partial
+ *
+ * @param Kind [in] the kind of partial
+ * @return the state
+ */
+FWitPartialCoalescer::FKindState& FWitPartialCoalescer::GetState(const EWitPartialKind Kind)
+{
+	return Kind == EWitPartialKind::Transcription ? TranscriptionState : ResponseState;
+}
+
+/**
+ * Get the state of the given kind of partial
+ *
+ * @param Kind [in] the kind of partial
+ * @return the state
+ */
+const FWitPartialCoalescer::FKindState& FWitPartialCoalescer::GetState(const EWitPartialKind Kind) const
+{
+	return Kind == EWitPartialKind::Transcription ? TranscriptionState : ResponseState;
+}
+
+/**
+ * Can a delivery of the given kind be made now? Only one delivery of each kind is made per frame and the interval must have
+ * passed since the last one
+ *
+ * @param State [in] the state of the kind of partial
+ * @param Now [in] the current time in seconds
+ * @return true if a delivery can be made
+ */
+bool FWitPartialCoalescer::CanDeliver(const FKindState& State, const double Now) const
+{
+	const bool bHasDeliveredThisFrame = State.LastDeliveryFrame == GFrameCounter;
+	const bool bIsIntervalElapsed = State.LastDeliveryFrame == MAX_uint64 || Now - State.LastDeliveryTime >= Interval;
+
+	return !bHasDeliveredThisFrame && bIsIntervalElapsed;
+}
+
+/**
+ * Record that a delivery of the given kind was made now
+ *
+ * @param State [in] the state of the kind of partial
+ * @param Now [in] the current time in seconds
+ */
+void FWitPartialCoalescer::MarkDelivered(FKindState& State, const double Now)
+{
+	State.LastDeliveryTime = Now;
+	State.LastDeliveryFrame = GFrameCounter;
+}
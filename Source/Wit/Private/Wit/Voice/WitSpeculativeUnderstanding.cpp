@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitSpeculativeUnderstanding.h"
+#include "Wit/Request/WitMessageCache.h"
+#include "Wit/Utilities/WitLog.h"
+
+/**
+ * Start watching a new request. A request that was still awaiting its speculative response is counted as a miss
+ *
+ * @param Configuration [in] the voice configuration containing the speculation settings
+ */
+void FWitSpeculativeUnderstanding::Reset(const FVoiceConfiguration& Configuration)
+{
+	Reset(Configuration.bIsSpeculativeUnderstandingEnabled, Configuration.SpeculativeUnderstandingStableTime, Configuration.SpeculativeUnderstandingMaximumRequests);
+}
+
+/**
+ * Start watching a new request with explicit settings. A request that was still awaiting its speculative response is counted as a miss
+ *
+ * @param bInIsEnabled [in] is speculation enabled?
+ * @param InStableTime [in] how long in seconds the transcription must be unchanged before speculating
+ * @param InMaximumSpeculations [in] the maximum number of speculations for the request
+ */
+void FWitSpeculativeUnderstanding::Reset(const bool bInIsEnabled, const float InStableTime, const int32 InMaximumSpeculations)
+{
+	Abandon();
+
+	bIsEnabled = bInIsEnabled;
+	StableTime = FMath::Max(InStableTime, 0.0f);
+	MaximumSpeculations = FMath::Max(InMaximumSpeculations, 1);
+
+	LastTranscription.Reset();
+	LastRawTranscription.Reset();
+	LastChangeTime = 0.0;
+	SpeculativeTranscription.Reset();
+	State = EState::None;
+	Response.Reset();
+	FinalTranscription.Reset();
+	NumSpeculations = 0;
+	bIsFinalMatched = false;
+	bIsResolved = false;
+}
+
+/**
+ * Is speculation enabled?
+ *
+ * @return true if enabled
+ */
+bool FWitSpeculativeUnderstanding::IsEnabled() const
+{
+	return bIsEnabled;
+}
+
+/**
+ * Track the latest partial transcription. Only a change in the normalized text restarts the stable time
+ *
+ * @param Transcription [in] the partial transcription
+ * @param Now [in] the current time in seconds
+ */
+void FWitSpeculativeUnderstanding::UpdateTranscription(const FString& Transcription, const double Now)
+{
+	const FString NormalizedTranscription = FWitMessageCache::NormalizeText(Transcription);
+
+	if (NormalizedTranscription.Equals(LastTranscription))
+	{
+		return;
+	}
+
+	LastTranscription = NormalizedTranscription;
+	LastRawTranscription = Transcription;
+	LastChangeTime = Now;
+}
+
+/**
+ * Should a speculative request be made now? A speculation is made once the transcription has been stable for long enough and
+ * differs from the current speculation, up to the maximum number per request
+ *
+ * @param Now [in] the current time in seconds
+ * @param OutTranscription [out] the transcription to send
+ * @return true if a speculative request should be made
+ */
+bool FWitSpeculativeUnderstanding::ShouldSpeculate(const double Now, FString& OutTranscription)
+{
+	const bool bCanSpeculate = bIsEnabled && !bIsFinalMatched && !bIsResolved && NumSpeculations < MaximumSpeculations && !LastTranscription.IsEmpty();
+
+	if (!bCanSpeculate)
+	{
+		return false;
+	}
+
+	const bool bIsStable = Now - LastChangeTime >= StableTime;
+	const bool bIsNewTranscription = State == EState::None || !LastTranscription.Equals(SpeculativeTranscription);
+
+	if (!bIsStable || !bIsNewTranscription)
+	{
+		return false;
+	}
+
+	SpeculativeTranscription = LastTranscription;
+	State = EState::Requested;
+	Response.Reset();
+
+	++SpeculationId;
+	++NumSpeculations;
+
+	OutTranscription = LastRawTranscription;
+
+	return true;
+}
+
+/**
+ * Get the id of the current speculation
+ *
+ * @return the id
+ */
+uint32 FWitSpeculativeUnderstanding::GetSpeculationId() const
+{
+	return SpeculationId;
+}
+
+/**
+ * Store the response to a speculative request
+ *
+ * @param InSpeculationId [in] the id of the speculation the response is for
+ * @param InResponse [in] the response
+ * @return true if the response is for the current speculation
+ */
+bool FWitSpeculativeUnderstanding::SetResponse(const uint32 InSpeculationId, const FWitResponse& InResponse)
+{
+	const bool bIsCurrent = InSpeculationId == SpeculationId && State == EState::Requested;
+
+	if (!bIsCurrent)
+	{
+		return false;
+	}
+
+	Response = InResponse;
+	State = EState::Ready;
+
+	// The response is used in place of the final response so it takes the final transcription if that is already known
+
+	if (bIsFinalMatched)
+	{
+		Response.Text = FinalTranscription;
+	}
+
+	return true;
+}
+
+/**
+ * Record that a speculative request failed. If the final transcription already matched then the request is a miss
+ *
+ * @param InSpeculationId [in] the id of the speculation that failed
+ */
+void FWitSpeculativeUnderstanding::SetFailed(const uint32 InSpeculationId)
+{
+	const bool bIsCurrent = InSpeculationId == SpeculationId && State == EState::Requested;
+
+	if (!bIsCurrent)
+	{
+		return;
+	}
+
+	State = EState::Failed;
+
+	if (bIsFinalMatched)
+	{
+		RecordOutcome(false);
+	}
+}
+
+/**
+ * Compare the final transcription against the current speculation
+ *
+ * @param Transcription [in] the final transcription
+ * @return the outcome
+ */
+EWitSpeculationResult FWitSpeculativeUnderstanding::ResolveFinalTranscription(const FString& Transcription)
+{
+	if (bIsResolved || bIsFinalMatched || State == EState::None)
+	{
+		return EWitSpeculationResult::Miss;
+	}
+
+	const bool bIsMatch = State != EState::Failed && FWitMessageCache::NormalizeText(Transcription).Equals(SpeculativeTranscription);
+
+	if (!bIsMatch)
+	{
+		RecordOutcome(false);
+		return EWitSpeculationResult::Miss;
+	}
+
+	bIsFinalMatched = true;
+	FinalTranscription = Transcription;
+	Response.Text = Transcription;
+
+	if (State == EState::Requested)
+	{
+		return EWitSpeculationResult::Pending;
+	}
+
+	RecordOutcome(true);
+
+	return EWitSpeculationResult::Hit;
+}
+
+/**
+ * Is the final transcription known to match with the speculative response still to arrive?
+ *
+ * @return true if waiting for the speculative response
+ */
+bool FWitSpeculativeUnderstanding::IsAwaitingResponse() const
+{
+	return bIsFinalMatched && !bIsResolved && State == EState::Requested;
+}
+
+/**
+ * Resolve a pending match once the speculative response has arrived
+ *
+ * @return true if the speculative response can now be used
+ */
+bool FWitSpeculativeUnderstanding::ResolvePending()
+{
+	const bool bIsHit = bIsFinalMatched && !bIsResolved && State == EState::Ready;
+
+	if (bIsHit)
+	{
+		RecordOutcome(true);
+	}
+
+	return bIsHit;
+}
+
+/**
+ * Give up on a speculation that was still awaiting its response. It is counted as a miss
+ */
+void FWitSpeculativeUnderstanding::Abandon()
+{
+	const bool bIsUnresolved = State != EState::None && !bIsResolved;
+
+	if (bIsUnresolved)
+	{
+		RecordOutcome(false);
+	}
+}
+
+/**
+ * Get the speculative response
+ *
+ * @return the response
+ */
+const FWitResponse& FWitSpeculativeUnderstanding::GetResponse() const
+{
+	return Response;
+}
+
+/**
+ * Get the fraction of requests with a speculation where the speculation was used
+ *
+ * @return the hit rate in the range 0 to 1
+ */
+float FWitSpeculativeUnderstanding::GetHitRate() const
+{
+	return NumResolved > 0 ? static_cast<float>(NumHits) / NumResolved : 0.0f;
+}
+
+/**
+ * Get the number of requests with a speculation that have been resolved
+ *
+ * @return the number of requests
+ */
+int32 FWitSpeculativeUnderstanding::GetNumResolved() const
+{
+	return NumResolved;
+}
+
+/**
+ * Record the outcome of the current request
+ *
+ * @param bIsHit [in] was the speculation used?
+ */
+void FWitSpeculativeUnderstanding::RecordOutcome(const bool bIsHit)
+{
+	if (bIsResolved)
+	{
+		return;
+	}
+
+	bIsResolved = true;
+
+	++NumResolved;
+	NumHits += bIsHit ? 1 : 0;
+
+	UE_LOG(LogWit, Display, TEXT("FWitSpeculativeUnderstanding - RecordOutcome: speculation %s, hit rate (%.1f%%) over (%d) requests"), bIsHit ? TEXT("hit") : TEXT("missed"),
+		GetHitRate() * 100.0f, NumResolved);
+}
@@ -9,11 +9,14 @@
 #include "Engine/Engine.h"
 #include "JsonObjectConverter.h"
 #include "Voice/Capture/VoiceCaptureSubsystem.h"
+#include "Voice/Capture/VoiceCaptureSubscription.h"
+#include "Voice/Input/VoicePushInput.h"
 #include "Wit/Request/WitRequestBuilder.h"
+#include "Wit/Request/WitRequest.h"
 #include "Wit/Request/WitRequestSubsystem.h"
+#include "Wit/Voice/WitVoiceSession.h"
 #include "Wit/Utilities/WitLog.h"
 #include "AudioMixerDevice.h"
-#include "Wit/Utilities/WitHelperUtilities.h"
 
 #ifdef CPP_PLUGIN
 THIRD_PARTY_INCLUDES_START
@@ -55,15 +58,6 @@ using namespace meta::voicesdk::v2;
 THIRD_PARTY_INCLUDES_END
 #endif
 
-#if WITH_EDITORONLY_DATA
-
-// Use for debug recording of the voice input
-
-static TUniquePtr<Audio::FAudioRecordingData> RecordingData;
-static TArray<uint8> RecordedVoiceInputBuffer;
-
-#endif
-
 /**
  * Constructor
  */
@@ -71,6 +65,10 @@ UWitVoiceService::UWitVoiceService()
 	: Super()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+
+	// Each service streams through its own session and request so any number of services can be active at once
+
+	Session = MakeShared<FWitVoiceSession>(UWitRequestSubsystem::CreateRequest());
 }
 
 /**
@@ -93,24 +91,45 @@ void UWitVoiceService::BeginDestroy()
 {
 	UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
 
+	const bool bIsSubscribed = VoiceCaptureSubsystem != nullptr && CaptureSubscription.IsValid();
+
+	if (bIsSubscribed)
+	{
+		VoiceCaptureSubsystem->Unsubscribe(CaptureSubscription.ToSharedRef());
+		CaptureSubscription.Reset();
+	}
+
+	// Other consumers may still be sharing the voice capture in which case we leave it running for them
+
 	const bool bIsVoiceCaptureAvailable = VoiceCaptureSubsystem != nullptr && VoiceCaptureSubsystem->IsCaptureAvailable();
+	const bool bIsVoiceCaptureInUse = bIsVoiceCaptureAvailable && VoiceCaptureSubsystem->GetNumActiveSubscriptions() > 0;
 	
-	if (bIsVoiceCaptureAvailable)
+	if (bIsVoiceCaptureAvailable && !bIsVoiceCaptureInUse)
 	{
 		VoiceCaptureSubsystem->Shutdown();
 	}
 
-	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
-	const bool bIsRequestInProgress = RequestSubsystem != nullptr && RequestSubsystem->IsRequestInProgress();
+	const bool bIsRequestInProgress = Session.IsValid() && Session->GetRequest().IsRequestInProgress();
 	
 	if (bIsRequestInProgress)
 	{
-		RequestSubsystem->CancelRequest();
+		Session->GetRequest().CancelRequest();
 	}
 
+	for (const TSharedRef<FWitRequest, ESPMode::ThreadSafe>& RetiringRequest : RetiringRequests)
+	{
+		RetiringRequest->CancelRequest();
+	}
+
+	RetiringRequests.Empty();
+
+	CancelSpeculativeRequest();
+
 	bIsVoiceInputActive = false;
 	bIsVoiceStreamingActive = false;
 
+	MessageCache.Save();
+
 	Super::BeginDestroy();
 }
 
@@ -125,8 +144,20 @@ void UWitVoiceService::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// Partials can still arrive after voice input is deactivated while the request finishes so they are flushed first
+
+	FlushPartials(false);
+	UpdateSpeculativeUnderstanding();
+
 	if (!bIsVoiceInputActive)
 	{
+		// Once the request has finished there is nothing more to do until voice input is next activated
+
+		if (!IsRequestInProgress())
+		{
+			SetComponentTickEnabled(false);
+		}
+
 		return;
 	}
 	
@@ -136,16 +167,34 @@ void UWitVoiceService::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 	}
 
 	UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
-	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();	
-	const bool bIsRequiredSubsystems = VoiceCaptureSubsystem != nullptr && RequestSubsystem != nullptr;
 	
-	if (!bIsRequiredSubsystems || !VoiceCaptureSubsystem->IsCapturing())
+	if (VoiceCaptureSubsystem == nullptr)
+	{
+		return;
+	}
+
+	// Voice data either comes from our subscription to the shared voice capture or from a push input
+
+	const bool bIsPushInput = PushInput.IsValid();
+	const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& InputSubscription = Session->GetInput();
+
+	if (!InputSubscription.IsValid())
 	{
 		return;
 	}
 
-	const bool bIsVoiceDataAvailable = VoiceCaptureSubsystem->Read();
-	const float CurrentVoiceAmplitude =  VoiceCaptureSubsystem->GetCurrentAmplitude();
+	if (!bIsPushInput)
+	{
+		if (!VoiceCaptureSubsystem->IsCapturing() || !CaptureSubscription.IsValid())
+		{
+			return;
+		}
+
+		VoiceCaptureSubsystem->Read();
+	}
+
+	const bool bIsVoiceDataAvailable = InputSubscription->GetNumQueuedBytes() > 0;
+	const float CurrentVoiceAmplitude = bIsPushInput ? PushInput->GetCurrentAmplitude() : VoiceCaptureSubsystem->GetCurrentAmplitude();
 
 	LastActivateTime += DeltaTime;
 
@@ -158,6 +207,7 @@ void UWitVoiceService::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 			
 		if (!bIsWakeThresholdReached || !bIsWakeTimeReached)
 		{
+			Session->Discard();
 			return;
 		}
 	
@@ -166,33 +216,28 @@ void UWitVoiceService::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 	
 	LastWakeTime += DeltaTime;
 
-	// Check for and read any new voice data that is available. Voice data may or may not be available depending on
-	// whether the user breaks a pre-defined volume threshold
+	// Drain any new voice data that has been queued for us through processing and into the request. Voice data may or may
+	// not be available depending on whether the user breaks a pre-defined volume threshold
 	
-	if (bIsVoiceDataAvailable && RequestSubsystem->IsRequestInProgress())
+	Session->Pump();
+
+	// A push input tells us when it has finished. Once everything it pushed has been streamed we can deactivate
+
+	const bool bIsPushInputFinished = bIsPushInput && PushInput->IsEndOfStream() && InputSubscription->GetNumQueuedBytes() == 0;
+
+	if (bIsPushInputFinished)
 	{
-#if WITH_EDITORONLY_DATA
-		
-		if (Configuration->Voice.bIsWavFileRecordingEnabled)
-		{
-			RecordedVoiceInputBuffer.Append(VoiceCaptureSubsystem->GetVoiceBuffer());
-		}
+		UE_LOG(LogWit, Display, TEXT("TickComponent: deactivating voice input - push input has ended"));
 
-#endif
-#ifdef CPP_PLUGIN
-#if PLATFORM_ANDROID
-		if (!StreamInputProvider)
+		const bool bDidDeactivate = DoDeactivateVoiceInput();
+		const bool bShouldCallStopEvent = bDidDeactivate && Events != nullptr;
+
+		if (bShouldCallStopEvent)
 		{
-			UE_LOG(LogWit, Error, TEXT("TickComponent: Not Initialized"));
-			return;
+			Events->OnStopVoiceInputDueToDeactivation.Broadcast();
 		}
-		std::unique_ptr<folly::IOBuf> chunk;
 
-		StreamInputProvider->writeBytes(folly::IOBuf::copyBuffer(&VoiceCaptureSubsystem->GetVoiceBuffer(), VoiceCaptureSubsystem->GetVoiceBuffer().Num()));
-#endif
-#else
-		RequestSubsystem->WriteBinaryData(VoiceCaptureSubsystem->GetVoiceBuffer());
-#endif
+		return;
 	}
 
 	// Keep track of whether we are actually receiving suitable voice input. This is used in deciding when to auto deactivate
@@ -214,6 +259,20 @@ void UWitVoiceService::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 	// 2. If we exceed a user definable duration since we last received valid voice data
 
 	const bool bIsTooLongSinceVoiceDataReceived = (LastVoiceTime >= Configuration->Voice.KeepAliveTime);
+
+	// In continuous streaming a long request is handed over to a new one instead of deactivating. This happens at the first pause
+	// after the segment time so that words are rarely split, or regardless once the request reaches its maximum length
+
+	const bool bIsSegmentComplete = LastWakeTime >= ContinuousSegmentTime && !bIsAmplitudeAboveMinimumVolume;
+	const bool bIsSegmentFull = LastWakeTime >= Configuration->Voice.MaximumRecordingTime;
+	const bool bShouldRollOver = bIsContinuousStreamingEnabled && !bIsPushInput && !bIsTooLongSinceVoiceDataReceived && (bIsSegmentComplete || bIsSegmentFull);
+
+	if (bShouldRollOver)
+	{
+		RollOverStreamRequest();
+		return;
+	}
+
 	const bool bIsTooLongSinceActivated = (LastWakeTime >= Configuration->Voice.MaximumRecordingTime);
 	const bool bShouldDeactivate = (bIsTooLongSinceVoiceDataReceived || bIsTooLongSinceActivated);
 	
@@ -251,7 +310,8 @@ void UWitVoiceService::SetConfiguration(UWitAppConfigurationAsset* Configuration
 
 	if (bShouldEnableEmulation)
 	{
-		VoiceCaptureSubsystem->EnableEmulation(Configuration->Voice.EmulationCaptureMode, Configuration->Voice.EmulationCaptureSoundWave, Configuration->Voice.TtsExperienceTag);
+		VoiceCaptureSubsystem->EnableEmulation(Configuration->Voice.EmulationCaptureMode, Configuration->Voice.EmulationCaptureSoundWave, Configuration->Voice.TtsExperienceTag,
+			Configuration->Voice.EmulationCaptureSpeed);
 	}
 }
 
@@ -280,13 +340,11 @@ bool UWitVoiceService::ActivateVoiceInput()
 		return false;
 	}
 
-	// Prevent attempts to activate more than one WitAPI component at a time by ensuring that all required subsystems are available and not in use
+	// Each component streams through its own request so other components may be active at the same time
 	
 	UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
-	const UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
-	const bool bIsRequiredSubsystems = VoiceCaptureSubsystem != nullptr && RequestSubsystem != nullptr;
 	
-	if (!bIsRequiredSubsystems)
+	if (VoiceCaptureSubsystem == nullptr)
 	{
 		UE_LOG(LogWit, Warning, TEXT("ActivateVoiceInput: cannot activate voice input because required subsystems do not exist"));
 		return false;
@@ -304,19 +362,22 @@ bool UWitVoiceService::ActivateVoiceInput()
 			return false;
 		}
 	}
-	else if (VoiceCaptureSubsystem->IsCapturing())
-	{
-		UE_LOG(LogWit, Warning, TEXT("ActivateVoiceInput: cannot activate voice input because capture is already in progress"));
-		return false;
-	}
 
-	if (RequestSubsystem->IsRequestInProgress())
+	// The voice capture may already be running for other consumers in which case we simply share it
+
+	if (!CaptureSubscription.IsValid())
 	{
-		UE_LOG(LogWit, Warning, TEXT("ActivateVoiceInput: cannot activate voice input because a request is already in progress"));
-		return false;
+		constexpr int32 MaxQueuedDuration = 1;
+		const int32 MaxQueuedBytes = VoiceCaptureSubsystem->SampleRate * VoiceCaptureSubsystem->NumChannels * sizeof(int16) * MaxQueuedDuration;
+
+		CaptureSubscription = VoiceCaptureSubsystem->Subscribe(TEXT("WitVoiceService"), MaxQueuedBytes, EVoiceCaptureBackpressure::DropOldest);
 	}
+
+	CancelSupersededRequests();
 	
-	bIsVoiceInputActive = VoiceCaptureSubsystem->Start();
+	Session->SetInput(CaptureSubscription);
+	
+	bIsVoiceInputActive = VoiceCaptureSubsystem->Start(CaptureSubscription.ToSharedRef());
 	
 	if (!bIsVoiceInputActive)
 	{
@@ -342,6 +403,127 @@ bool UWitVoiceService::ActivateVoiceInput()
 		NoiseGateThreshold->Set(Configuration->Voice.MicNoiseThreshold);
 	}
 	
+	OnVoiceInputActivated();
+	
+	return true;
+}
+
+/**
+ * Starts streaming voice input pushed through the given push input instead of capturing it from the microphone
+ *
+ * @param PushInputToUse [in] the push input to stream from
+ * @return true if the activation was successful
+ */
+bool UWitVoiceService::ActivateVoiceInputWithPushInput(const TSharedRef<FVoicePushInput, ESPMode::ThreadSafe>& PushInputToUse)
+{
+	const bool bHasConfiguration = Configuration != nullptr && !Configuration->Application.ClientAccessToken.IsEmpty();
+	
+	if (!bHasConfiguration)
+	{
+		UE_LOG(LogWit, Warning, TEXT("ActivateVoiceInputWithPushInput: cannot active voice input because no configuration found. Please assign a configuration and access token"));
+		return false;
+	}
+	
+	if (bIsVoiceInputActive)
+	{
+		UE_LOG(LogWit, Warning, TEXT("ActivateVoiceInputWithPushInput: cannot activate voice input because it is already active on this component"));
+		return false;
+	}
+
+	CancelSupersededRequests();
+
+	PushInput = PushInputToUse;
+	Session->SetInput(PushInput->GetSubscription());
+	bIsVoiceInputActive = true;
+
+	UE_LOG(LogWit, Display, TEXT("ActivateVoiceInputWithPushInput: activated voice input"));
+
+	OnVoiceInputActivated();
+
+	// Pushed voice input has no wake threshold. Everything pushed is streamed
+
+	BeginStreamRequest();
+
+	return true;
+}
+
+/**
+ * Enable or disable continuous streaming. This takes effect from the next time streaming begins
+ *
+ * @param bIsEnabled [in] should streaming be continuous
+ * @param SegmentTime [in] once a request has streamed for this many seconds it is handed over at the next pause in speech
+ * @param OverlapTime [in] how many seconds of the most recent voice data are also sent to the next request
+ */
+void UWitVoiceService::SetContinuousStreaming(const bool bIsEnabled, const float SegmentTime, const float OverlapTime)
+{
+	bIsContinuousStreamingEnabled = bIsEnabled;
+	ContinuousSegmentTime = FMath::Max(SegmentTime, 1.0f);
+	ContinuousOverlapTime = FMath::Clamp(OverlapTime, 0.0f, 2.0f);
+}
+
+/**
+ * Transcribes a batch of wav or raw 16-bit files using this component's configuration
+ *
+ * @param Paths [in] the files to transcribe
+ * @param Concurrency [in] the maximum number of requests in flight at once
+ * @param OnComplete [in] called with the results once every file has completed
+ * @param Endpoint [in] the endpoint to use. Either Speech or Dictation
+ * @return the transcriber or null if there is no configuration
+ */
+TSharedPtr<FWitFileTranscriber, ESPMode::ThreadSafe> UWitVoiceService::TranscribeFiles(const TArray<FString>& Paths, const int32 Concurrency,
+	FOnWitFileTranscriptionCompleteDelegate OnComplete, const EWitRequestEndpoint Endpoint) const
+{
+	const bool bHasConfiguration = Configuration != nullptr && !Configuration->Application.ClientAccessToken.IsEmpty();
+	
+	if (!bHasConfiguration)
+	{
+		UE_LOG(LogWit, Warning, TEXT("TranscribeFiles: cannot transcribe files because no configuration found. Please assign a configuration and access token"));
+		return nullptr;
+	}
+
+	FWitFileTranscriptionSettings Settings{};
+
+	Settings.Application = Configuration->Application;
+	Settings.Endpoint = Endpoint;
+	Settings.Concurrency = Concurrency;
+
+	return FWitFileTranscriber::TranscribeFiles(Paths, Settings, FOnWitFileTranscribedDelegate(), MoveTemp(OnComplete));
+}
+
+/**
+ * Sends a batch of texts to Wit.ai for interpretation using this component's configuration
+ *
+ * @param Texts [in] the texts to interpret
+ * @param Concurrency [in] the maximum number of requests in flight at once
+ * @param MaximumRequestsPerMinute [in] the maximum number of requests started per minute. Zero for no limit
+ * @param OnComplete [in] called with the results once every text has completed
+ * @return the batch or null if there is no configuration
+ */
+TSharedPtr<FWitMessageBatch, ESPMode::ThreadSafe> UWitVoiceService::SendTranscriptions(const TArray<FString>& Texts, const int32 Concurrency,
+	const float MaximumRequestsPerMinute, FOnWitMessageBatchCompleteDelegate OnComplete) const
+{
+	const bool bHasConfiguration = Configuration != nullptr && !Configuration->Application.ClientAccessToken.IsEmpty();
+	
+	if (!bHasConfiguration)
+	{
+		UE_LOG(LogWit, Warning, TEXT("SendTranscriptions: cannot send transcriptions because no configuration found. Please assign a configuration and access token"));
+		return nullptr;
+	}
+
+	FWitMessageBatchSettings Settings{};
+
+	Settings.Application = Configuration->Application;
+	Settings.Concurrency = Concurrency;
+	Settings.MaximumRequestsPerMinute = MaximumRequestsPerMinute;
+
+	return FWitMessageBatch::SendTranscriptions(Texts, Settings, FOnWitMessageResultDelegate(), MoveTemp(OnComplete));
+}
+
+/**
+ * Common setup once voice input has been activated
+ */
+void UWitVoiceService::OnVoiceInputActivated()
+{
 	// We enable the tick in order to be able to handle auto-deactivation and reading data into the request
 
 	SetComponentTickEnabled(true);
@@ -349,6 +531,12 @@ bool UWitVoiceService::ActivateVoiceInput()
 	LastVoiceTime = 0.0f;
 	LastActivateTime = 0.0f;
 	LastWakeTime = 0.0f;
+
+	// Processing is prepared now so that background noise is learnt from the voice input heard before the wake threshold is reached
+
+	const UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
+
+	Session->ConfigureProcessing(Configuration->Voice, VoiceCaptureSubsystem->SampleRate, VoiceCaptureSubsystem->NumChannels);
 	
 	// Notify that we've started accepting voice input
 
@@ -356,8 +544,6 @@ bool UWitVoiceService::ActivateVoiceInput()
 	{
 		Events->OnStartVoiceInput.Broadcast();
 	}
-	
-	return true;
 }
 
 /**
@@ -405,6 +591,32 @@ bool UWitVoiceService::ActivateVoiceInputImmediatelyWithRequestOptions(const FSt
 	return ActivateVoiceInputImmediately();
 }
 
+/**
+ * Cancel requests from an earlier activation that are still waiting for their responses. Activating again means the user has moved
+ * on so their results would be stale. Cancelled requests report nothing more so late partials and responses are never parsed
+ */
+void UWitVoiceService::CancelSupersededRequests()
+{
+	if (Session->GetRequest().IsRequestInProgress())
+	{
+		UE_LOG(LogWit, Display, TEXT("CancelSupersededRequests: cancelling the request from the previous activation"));
+
+		Session->GetRequest().CancelRequest();
+	}
+
+	// Retiring requests are only cancelled here as they are removed once no longer in progress
+
+	for (const TSharedRef<FWitRequest, ESPMode::ThreadSafe>& RetiringRequest : RetiringRequests)
+	{
+		RetiringRequest->CancelRequest();
+	}
+
+	DropPartials();
+
+	SpeculativeUnderstanding.Abandon();
+	CancelSpeculativeRequest();
+}
+
 /**
  * Start a streamed Wit request
  */
@@ -413,7 +625,6 @@ void UWitVoiceService::BeginStreamRequest()
 	UE_LOG(LogWit, Display, TEXT("BeginStreamRequest: starting stream request"));
 	
 	const UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
-	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
 	
 #ifdef CPP_PLUGIN
 #if PLATFORM_ANDROID
@@ -441,8 +652,52 @@ void UWitVoiceService::BeginStreamRequest()
 	StreamInputProvider->setEncoding(AudioEncoding::SignedInteger);
 	StreamInputProvider->setEndian(Endian::LittleEndian);
 	StreamInputProvider->setSampleRate(VoiceCaptureSubsystem->SampleRate);
+
+	// The SDK owns the request so processed voice data is written to its input provider instead
+
+	Session->SetStreamWriter([this](const FVoiceAudioSpan& StreamSpan)
+	{
+		StreamInputProvider->writeBytes(folly::IOBuf::copyBuffer(StreamSpan.GetData(), StreamSpan.Num()));
+	});
 #endif
 #else
+	BeginSpeechRequest(Session->GetRequest(), VoiceCaptureSubsystem->SampleRate);
+#endif
+	bIsVoiceStreamingActive = true;
+
+	// Anything still waiting for an earlier segment of the previous stream is delivered now as that segment may never arrive
+
+	ReleaseFinalResponses(true);
+
+	StreamStartSegment = RequestSegment;
+	NextFinalSegment = RequestSegment;
+	LastFinalSegmentText.Reset();
+
+	Session->Configure(Configuration->Voice, VoiceCaptureSubsystem->SampleRate, VoiceCaptureSubsystem->NumChannels, Configuration->Voice.bIsWavFileRecordingEnabled);
+
+	// In continuous streaming the most recent voice data is kept so it can also be sent to the next request when handing over
+
+	const int32 FrameSize = VoiceCaptureSubsystem->NumChannels * sizeof(int16);
+	const int32 BoundarySize = FMath::RoundToInt(ContinuousOverlapTime * VoiceCaptureSubsystem->SampleRate) * FrameSize;
+
+	Session->SetBoundarySize(bIsContinuousStreamingEnabled ? BoundarySize : 0);
+
+	// Notify that we've started sending voice data
+
+	if (Events != nullptr)
+	{
+		Events->OnMinimumWakeThresholdHit.Broadcast();
+	}
+}
+
+/**
+ * Configure and begin a speech request
+ *
+ * @param Request [in] the request to begin
+ * @param SampleRate [in] the sample rate of the voice data
+ */
+void UWitVoiceService::BeginSpeechRequest(FWitRequest& Request, const int32 SampleRate)
+{
 	// Construct the request with the desired configuration. We use the /speech endpoint in Wit.ai. See the Wit.ai documentation for more
 	// specifics of the parameters to this endpoint
 
@@ -453,15 +708,22 @@ void UWitVoiceService::BeginStreamRequest()
 	FWitRequestBuilder::AddFormatContentType(RequestConfiguration, Format);
 	FWitRequestBuilder::AddEncodingContentType(RequestConfiguration, Encoding);
 	FWitRequestBuilder::AddSampleSizeContentType(RequestConfiguration, SampleSize);
-	FWitRequestBuilder::AddRateContentType(RequestConfiguration, VoiceCaptureSubsystem->SampleRate);
+	FWitRequestBuilder::AddRateContentType(RequestConfiguration, SampleRate);
 	FWitRequestBuilder::AddEndianContentType(RequestConfiguration, EWitRequestEndian::Little);
 
 	RequestConfiguration.bShouldUseCustomHttpTimeout = Configuration->Application.Advanced.bIsCustomHttpTimeout;
 	RequestConfiguration.HttpTimeout = Configuration->Application.Advanced.HttpTimeout;
+	RequestConfiguration.ResponseDeadline = Configuration->Application.Advanced.ResponseDeadline;
 
-	RequestConfiguration.OnRequestError.AddUObject(this, &UWitVoiceService::OnWitRequestError);
-	RequestConfiguration.OnRequestProgress.AddUObject(this, &UWitVoiceService::OnSpeechRequestProgress);
-	RequestConfiguration.OnRequestComplete.AddUObject(this, &UWitVoiceService::OnSpeechRequestComplete);
+	// Responses are tagged with the segment so those from a request that has been handed over can be told apart
+
+	++RequestSegment;
+
+	RequestConfiguration.OnRequestError.AddUObject(this, &UWitVoiceService::OnSpeechRequestError, RequestSegment);
+	// Partial responses are converted off the game thread. The decoder also tells transcriptions from responses so no Json is needed
+
+	RequestConfiguration.OnRequestProgressWithResponse.AddUObject(this, &UWitVoiceService::OnSpeechRequestProgress, RequestSegment);
+	RequestConfiguration.OnRequestCompleteWithResponse.AddUObject(this, &UWitVoiceService::OnSpeechRequestComplete, RequestSegment);
 
 	if (Events != nullptr)
 	{
@@ -471,24 +733,70 @@ void UWitVoiceService::BeginStreamRequest()
 	// Begin a streamed request to Wit.ai. For a streamed request we open an HTTP request to the server and continually write data as it
 	// becomes available. This greatly reduces latency over waiting for the whole voice data and then sending it
 
-	RequestSubsystem->BeginStreamRequest(RequestConfiguration);
-#endif
-	bIsVoiceStreamingActive = true;
+	LastPartialChecksums = FWitResponseChecksums{};
+	EarlyCommitPolicy.Reset(Configuration->Voice);
+	LocalGrammar.Reset(Configuration->Voice);
+	LastKeywordEntities.Reset();
 
-	// Notify that we've started sending voice data
+	SpeculativeUnderstanding.Reset(Configuration->Voice);
+	CancelSpeculativeRequest();
+
+	PartialCoalescer.Reset(Configuration->Voice);
+	PendingPartialTranscription.Reset();
+	PendingPartialResponseChanges = EWitResponseChange::None;
 
 	if (Events != nullptr)
 	{
-		Events->OnMinimumWakeThresholdHit.Broadcast();
+		Events->NumDroppedPartials = 0;
 	}
 
-#if WITH_EDITORONLY_DATA
-	
-	if (Configuration->Voice.bIsWavFileRecordingEnabled)
+	// The entities are refreshed whenever the app configuration is updated so we rebuild if they have changed since the last build
+
+	const bool bShouldBuildKeywordExtractor = Configuration->Voice.bIsKeywordExtractionEnabled && !KeywordExtractor.IsBuiltFrom(Configuration->Application.Data.Entities);
+	if (bShouldBuildKeywordExtractor)
+	{
+		KeywordExtractor.Build(Configuration->Application.Data.Entities);
+	}
+
+	Request.BeginStreamRequest(RequestConfiguration);
+}
+
+/**
+ * Hand streaming over to a new request without deactivating voice input. The new request begins before the current one is
+ * ended so there is no gap in streaming, and the current request is left to finalize in the background
+ */
+void UWitVoiceService::RollOverStreamRequest()
+{
+#ifdef CPP_PLUGIN
+	UE_LOG(LogWit, Warning, TEXT("RollOverStreamRequest: continuous streaming is not supported via CPP_PLUGIN"));
+#else
+	const UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
+
+	if (VoiceCaptureSubsystem == nullptr)
+	{
+		return;
+	}
+
+	RetiringRequests.RemoveAll([](const TSharedRef<FWitRequest, ESPMode::ThreadSafe>& RetiringRequest)
+	{
+		return !RetiringRequest->IsRequestInProgress();
+	});
+
+	UE_LOG(LogWit, Display, TEXT("RollOverStreamRequest: handing over to the next request after (%.2f) seconds"), LastWakeTime);
+
+	const TSharedRef<FWitRequest, ESPMode::ThreadSafe> NextRequest = UWitRequestSubsystem::CreateRequest();
+
+	BeginSpeechRequest(NextRequest.Get(), VoiceCaptureSubsystem->SampleRate);
+
+	const TSharedRef<FWitRequest, ESPMode::ThreadSafe> PreviousRequest = Session->HandOver(NextRequest);
+
+	if (PreviousRequest->IsRequestInProgress())
 	{
-		RecordedVoiceInputBuffer.Reset();
+		PreviousRequest->EndStreamRequest();
+		RetiringRequests.Add(PreviousRequest);
 	}
 
+	LastWakeTime = 0.0f;
 #endif
 }
 
@@ -531,21 +839,29 @@ bool UWitVoiceService::DoDeactivateVoiceInput()
 	}
 	
 	UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
-	const bool bIsVoiceCapturing = VoiceCaptureSubsystem != nullptr && VoiceCaptureSubsystem->IsCapturing();
+	const bool bIsVoiceCapturing = VoiceCaptureSubsystem != nullptr && CaptureSubscription.IsValid() && CaptureSubscription->IsActive();
 	
-	if (bIsVoiceCapturing)
+	if (PushInput.IsValid())
+	{
+		PushInput.Reset();
+	}
+	else if (bIsVoiceCapturing)
 	{
-		VoiceCaptureSubsystem->Stop();
+		VoiceCaptureSubsystem->Stop(CaptureSubscription.ToSharedRef());
 	}
 	else
 	{
 		UE_LOG(LogWit, Warning, TEXT("DeactivateVoiceInput: cannot deactivate voice capture because capture is not in progress"));
 	}
 
+	// Stream whatever is still queued along with the voice data held back by processing so the end of the speech is not lost
+
+	Session->Pump();
+	Session->Flush();
+
 	// End the streamed request. This will tell the HTTP client to send any remaining data and the close the request
 
-	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
-	const bool bIsRequestInProgress = RequestSubsystem != nullptr && RequestSubsystem->IsRequestInProgress();
+	const bool bIsRequestInProgress = Session->GetRequest().IsRequestInProgress();
 	
 	if (bIsRequestInProgress)
 	{
@@ -559,7 +875,7 @@ bool UWitVoiceService::DoDeactivateVoiceInput()
 		StreamInputProvider->writeEndOfStream();
 #endif
 #else
-		RequestSubsystem->EndStreamRequest();
+		Session->GetRequest().EndStreamRequest();
 #endif
 	}
 	else
@@ -568,10 +884,17 @@ bool UWitVoiceService::DoDeactivateVoiceInput()
 	}
 
 	UE_LOG(LogWit, Display, TEXT("DeactivateVoiceInput: deactivated voice input"));
+
+	// Partials held back by coalescing are delivered now so that listeners see the last of them as soon as voice input stops
+
+	FlushPartials(true);
 	
-	// We disable the tick as it is only really needed when voice input is activate to handle auto-deactivation
+	// The tick is mostly needed while voice input is active to handle auto-deactivation. While the request finishes it keeps
+	// delivering partials and speculating so it is left running and disables itself once the request is complete
+
+	const bool bShouldKeepTicking = Session->GetRequest().IsRequestInProgress();
 	
-	SetComponentTickEnabled(false);
+	SetComponentTickEnabled(bShouldKeepTicking);
 
 	bIsVoiceInputActive = false;
 	bIsVoiceStreamingActive = false;
@@ -583,16 +906,10 @@ bool UWitVoiceService::DoDeactivateVoiceInput()
 		Events->OnStopVoiceInput.Broadcast();
 	}
 	
-	// If desired write the recorded data to a wav file
-
-#if WITH_EDITORONLY_DATA
-	
-	if (Configuration->Voice.bIsWavFileRecordingEnabled)
-	{
-		WriteRawPCMDataToWavFile(RecordedVoiceInputBuffer.GetData(), RecordedVoiceInputBuffer.Num(), VoiceCaptureSubsystem->NumChannels, VoiceCaptureSubsystem->SampleRate);
-	}
+	// If recording the voice input finish the wav file. The recording has been streamed to disk as it was captured so
+	// this only closes the file
 
-#endif
+	Session->FinishRecording();
 	
 	return true;
 }
@@ -619,6 +936,11 @@ float UWitVoiceService::GetVoiceInputVolume() const
 		return 0.0f;
 	}
 
+	if (PushInput.IsValid())
+	{
+		return PushInput->GetCurrentAmplitude();
+	}
+
 	const UVoiceCaptureSubsystem* VoiceCaptureSubsystem = GEngine->GetEngineSubsystem<UVoiceCaptureSubsystem>();
 
 	if (VoiceCaptureSubsystem == nullptr)
@@ -640,16 +962,13 @@ bool UWitVoiceService::IsVoiceStreamingActive() const
 }
 
 /**
- * Is any Wit.ai request currently in progress?
+ * Is a Wit.ai request from this component currently in progress?
  *
  * @return true if in progress otherwise false
  */
 bool UWitVoiceService::IsRequestInProgress() const
 {
-	const UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
-	const bool bIsRequestInProgress = RequestSubsystem != nullptr && RequestSubsystem->IsRequestInProgress();
-
-	return bIsRequestInProgress;
+	return Session->GetRequest().IsRequestInProgress();
 }
 
 /**
@@ -667,15 +986,7 @@ void UWitVoiceService::SendTranscription(const FString& Text)
 		return;
 	}
 
-	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
-
-	if (RequestSubsystem == nullptr)
-	{
-		UE_LOG(LogWit, Warning, TEXT("SendTranscription: cannot send transcription because request subsystem does not exist"));
-		return;
-	}
-
-	if (RequestSubsystem->IsRequestInProgress())
+	if (Session->GetRequest().IsRequestInProgress())
 	{
 		UE_LOG(LogWit, Warning, TEXT("SendTranscription: cannot send transcription because a request is already in progress"));
 		return;
@@ -720,28 +1031,59 @@ void UWitVoiceService::SendTranscription(const FString& Text)
 
 	RequestConfiguration.bShouldUseCustomHttpTimeout = Configuration->Application.Advanced.bIsCustomHttpTimeout;
 	RequestConfiguration.HttpTimeout = Configuration->Application.Advanced.HttpTimeout;
+	RequestConfiguration.ResponseDeadline = Configuration->Application.Advanced.ResponseDeadline;
 
 	RequestConfiguration.OnRequestError.AddUObject(this, &UWitVoiceService::OnWitRequestError);
-	RequestConfiguration.OnRequestComplete.AddUObject(this, &UWitVoiceService::OnMessageRequestComplete);
+
+	const FString MessageEndpoint = RequestConfiguration.Endpoint;
+	const TMap<FString, FString> MessageParameters = RequestConfiguration.Parameters;
 
 	if (Events != nullptr)
 	{
 		Events->OnRequestCustomize.ExecuteIfBound(RequestConfiguration);
 	}
-	
-	RequestSubsystem->BeginStreamRequest(RequestConfiguration);
-	RequestSubsystem->EndStreamRequest();
-#endif
-}
 
-/**
- * Sends a text string to Wit for interpretation
- *
- * @param RequestOptions [in] the RequestOptions string, this could be used for Dynamic Entities
- * @param Text [in] the string we want to interpret
- */
-void UWitVoiceService::SendTranscriptionWithRequestOptions(const FString& Text, const FString& RequestOptions)
-{
+	// The cache is keyed on the text alone so it only applies to plain /message requests. A customized request, such as one
+	// redirected to composer's stateful /event endpoint, can answer the same text differently from turn to turn
+
+	const bool bIsCacheable = RequestConfiguration.Endpoint.Equals(MessageEndpoint, ESearchCase::IgnoreCase)
+		&& RequestConfiguration.Parameters.OrderIndependentCompareEqual(MessageParameters);
+
+	// Repeated text is answered immediately from the cache without making a request
+
+	if (bIsCacheable)
+	{
+		MessageCache.Configure(Configuration->Application);
+
+		FWitResponse CachedResponse{};
+
+		if (MessageCache.Find(Text, CachedResponse))
+		{
+			UE_LOG(LogWit, Display, TEXT("SendTranscription: using cached response for transcription (%s)"), *Text);
+
+			CachedResponse.Text = Text;
+			CachedResponse.Is_Final = true;
+
+			OnRequestComplete(CachedResponse);
+			return;
+		}
+	}
+
+	RequestConfiguration.OnRequestCompleteWithResponse.AddUObject(this, &UWitVoiceService::OnMessageRequestComplete, Text, bIsCacheable);
+	
+	Session->GetRequest().BeginStreamRequest(RequestConfiguration);
+	Session->GetRequest().EndStreamRequest();
+#endif
+}
+
+/**
+ * Sends a text string to Wit for interpretation
+ *
+ * @param RequestOptions [in] the RequestOptions string, this could be used for Dynamic Entities
+ * @param Text [in] the string we want to interpret
+ */
+void UWitVoiceService::SendTranscriptionWithRequestOptions(const FString& Text, const FString& RequestOptions)
+{
 	// TODO: add RequestOptions into the url(or body), which likely will be only dynamic entities. check https://wit.ai/docs/http/20220622/#post__speech_link Arguments section. example post: https://wit.ai/docs/http/20220622/#post__entities__entity_keywords_link 
 
 	UE_LOG(LogWit, Warning, TEXT("SendTranscriptionWithRequestOptions is not implemented yet, will use SendTranscription for now."));
@@ -767,17 +1109,11 @@ void UWitVoiceService::AcceptPartialResponseAndCancelRequest(const FWitResponse&
 	StreamInputProvider->writeEndOfStream();
 #endif
 #else
-	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
-
-	if (RequestSubsystem == nullptr)
-	{
-		UE_LOG(LogWit, Warning, TEXT("SendTranscription: cannot send transcription because request subsystem does not exist"));
-		return;
-	}
-	RequestSubsystem->CancelRequest();
+	Session->GetRequest().CancelRequest();
 #endif
 
 	DeactivateVoiceInput();
+	DropPartials();
 
 	FWitResponse FinalResponse = Response;
 	FinalResponse.Is_Final = true;
@@ -789,108 +1125,649 @@ void UWitVoiceService::AcceptPartialResponseAndCancelRequest(const FWitResponse&
  * Called when a Wit speech request is in progress with any partial transcriptions
  *
  * @param PartialBinaryResponse [in] the partial response as binary
- * @param PartialJsonResponse [in] the partial response as Json
+ * @param PartialJsonResponse [in] the partial response as Json. This is not used and is normally null
+ * @param PartialResponse [in] the partial response already converted off the game thread
+ * @param Checksums [in] the checksums of the sections of the partial response and what kind of chunk it was
+ * @param Segment [in] the segment of the request
  */
-void UWitVoiceService::OnSpeechRequestProgress(const TArray<uint8>& PartialBinaryResponse, const TSharedPtr<FJsonObject> PartialJsonResponse) const
+void UWitVoiceService::OnSpeechRequestProgress(const TArray<uint8>& PartialBinaryResponse, const TSharedPtr<FJsonObject> PartialJsonResponse,
+	const FWitResponse& PartialResponse, const FWitResponseChecksums& Checksums, const uint32 Segment)
 {
+	// A request that has been handed over is still finalizing but the next request is already transcribing so only its final
+	// response is used
+
+	if (Segment != RequestSegment)
+	{
+		return;
+	}
+
+	// Frequent commands in the local grammar are recognized from the transcription alone without waiting for Wit.ai to understand it.
+	// The transcription is copied as listeners may end the request and with it the response
+
+	const FString LocalTranscription = PartialResponse.Text;
+
+	const bool bHasLocalTranscription = Checksums.bHasText;
+	if (bHasLocalTranscription && LocalGrammar.IsEnabled() && MatchLocalGrammar(LocalTranscription))
+	{
+		return;
+	}
+
+	const bool bShouldExtractKeywords = bHasLocalTranscription && Configuration->Voice.bIsKeywordExtractionEnabled && KeywordExtractor.IsBuilt();
+	if (bShouldExtractKeywords)
+	{
+		ExtractKeywordEntities(LocalTranscription);
+	}
+
+	// Transcriptions are tracked for speculative understanding and the final transcription decides whether the speculation is used
+
+	const bool bIsResponseChunk = Checksums.bHasIntents;
+	const bool bIsTranscriptionChunk = bHasLocalTranscription && !bIsResponseChunk;
+	const bool bIsFinalTranscription = bIsTranscriptionChunk && (PartialResponse.Is_Final || Checksums.bIsFinalTranscription);
+
+	const bool bShouldTrackTranscription = bIsTranscriptionChunk && SpeculativeUnderstanding.IsEnabled() && !bIsContinuousStreamingEnabled;
+
+	if (bShouldTrackTranscription)
+	{
+		if (!bIsFinalTranscription)
+		{
+			SpeculativeUnderstanding.UpdateTranscription(LocalTranscription, FPlatformTime::Seconds());
+		}
+		else if (OnFinalTranscription(LocalTranscription))
+		{
+			return;
+		}
+	}
+
+	// Listeners such as the composer service may complete the request themselves when they see the final transcription
+
+	if (bIsFinalTranscription && Events != nullptr)
+	{
+		Events->OnFinalTranscription.Broadcast(LocalTranscription);
+
+		if (!IsRequestInProgress())
+		{
+			return;
+		}
+	}
+
 	// The text field of the final response chunk represents the most recent transcription that Wit.ai was able to discern. We pass this to the user
 	// registered callback as it can be used to display intermediate partial transcriptions which make the application feel more responsive
 
-	if (FWitHelperUtilities::IsWitResponse(PartialJsonResponse))
+	if (bIsResponseChunk)
 	{
-		OnPartialResponse(PartialBinaryResponse, PartialJsonResponse);
+		OnPartialResponse(PartialResponse, Checksums);
 	}
 	else
 	{
-		const FString PartialTranscription = PartialJsonResponse->GetStringField("text");
+		const FString& PartialTranscription = PartialResponse.Text;
+
+		if (Events == nullptr)
+		{
+			return;
+		}
 
-		if (Events != nullptr)
+		if (PartialCoalescer.Submit(EWitPartialKind::Transcription, FPlatformTime::Seconds()))
 		{
 			Events->OnPartialTranscription.Broadcast(PartialTranscription);
 		}
+		else
+		{
+			PendingPartialTranscription = PartialTranscription;
+			Events->NumDroppedPartials = PartialCoalescer.GetNumDropped();
+		}
+	}
+}
+
+/**
+ * Match a partial transcription against the local grammar. On a match the local result either replaces the final response and the
+ * request is cancelled or it is sent as a partial response and the request continues
+ *
+ * @param Transcription [in] the partial transcription
+ * @return true if the request was cancelled
+ */
+bool UWitVoiceService::MatchLocalGrammar(const FString& Transcription)
+{
+	FWitResponse LocalResponse{};
+
+	if (!LocalGrammar.Match(Transcription, LocalResponse))
+	{
+		return false;
+	}
+
+	if (Configuration->Voice.bShouldLocalGrammarCancelRequest)
+	{
+		UE_LOG(LogWit, Display, TEXT("MatchLocalGrammar: matched local phrase - cancelling request (%s)"), *Transcription);
+
+		AcceptPartialResponseAndCancelRequest(LocalResponse);
+		return true;
+	}
+
+	UE_LOG(LogWit, Display, TEXT("MatchLocalGrammar: matched local phrase (%s)"), *Transcription);
+
+	// The local result is not merged into the current response as later partial responses are compared against it
+
+	if (Events != nullptr)
+	{
+		// Matchers check the change mask before handling a partial response. The current mask describes the last response
+		// from Wit.ai rather than the local result so it is replaced while the local result is dispatched
+
+		const int32 PreviousChanges = Events->WitResponseChanges;
+		const EWitResponseChange LocalChanges = EWitResponseChange::Text | EWitResponseChange::Intents | EWitResponseChange::Entities;
+
+		Events->WitResponseChanges = static_cast<int32>(LocalChanges);
+
+		Events->OnWitPartialResponse.Broadcast(true, LocalResponse);
+		Events->OnWitPartialResponseChanges.Broadcast(LocalResponse, Events->WitResponseChanges);
+		Events->MatcherRegistry.DispatchPartialResponse(true, LocalResponse);
+
+		Events->WitResponseChanges = PreviousChanges;
+	}
+
+	return false;
+}
+
+/**
+ * Find the keyword entities in a partial transcription. Successive partial transcriptions usually mention the same entities so they
+ * are only broadcast when they change
+ *
+ * @param Transcription [in] the partial transcription
+ */
+void UWitVoiceService::ExtractKeywordEntities(const FString& Transcription)
+{
+	TArray<FWitEntity> KeywordEntities;
+
+	KeywordExtractor.Extract(Transcription, KeywordEntities);
+
+	bool bIsChanged = KeywordEntities.Num() != LastKeywordEntities.Num();
+
+	for (int32 Index = 0; !bIsChanged && Index < KeywordEntities.Num(); ++Index)
+	{
+		const FWitEntity& Entity = KeywordEntities[Index];
+		const FWitEntity& LastEntity = LastKeywordEntities[Index];
+
+		bIsChanged = Entity.Start != LastEntity.Start || !Entity.Name.Equals(LastEntity.Name) || !Entity.Value.Equals(LastEntity.Value);
+	}
+
+	if (!bIsChanged)
+	{
+		return;
+	}
+
+	LastKeywordEntities = MoveTemp(KeywordEntities);
+
+	if (Events != nullptr)
+	{
+		Events->OnPartialKeywordEntities.Broadcast(LastKeywordEntities);
 	}
 }
 
 /**
  *  Called when received a Wit partial response
  *
- * @param PartialBinaryResponse [in] the partial binary response
- * @param PartialJsonResponse [in] the partial Json response
+ * @param PartialResponse [in] the partial response already converted off the game thread
+ * @param Checksums [in] the checksums of the sections of the partial response
  */
-void UWitVoiceService::OnPartialResponse(const TArray<uint8>& PartialBinaryResponse, const TSharedPtr<FJsonObject> PartialJsonResponse) const
+void UWitVoiceService::OnPartialResponse(const FWitResponse& PartialResponse, const FWitResponseChecksums& Checksums)
 {
 	if (Events == nullptr)
 	{
 		return;		
 	}
-	
-	Events->WitResponse.Reset();
-	
-	const bool bIsConversionError = !FWitHelperUtilities::ConvertJsonToWitResponse(PartialJsonResponse.ToSharedRef(), &Events->WitResponse);
-	
-	if (bIsConversionError)
+
+	// Only the sections that differ from the previous partial response are copied. The first partial response of a request has
+	// nothing to compare against so it is copied in full
+
+	const EWitResponseChange Changes = Checksums.GetChanges(LastPartialChecksums);
+
+	LastPartialChecksums = Checksums;
+
+	if (EnumHasAnyFlags(Changes, EWitResponseChange::Text))
+	{
+		Events->WitResponse.Text = PartialResponse.Text;
+	}
+
+	if (EnumHasAnyFlags(Changes, EWitResponseChange::Intents))
+	{
+		Events->WitResponse.Intents = PartialResponse.Intents;
+	}
+
+	if (EnumHasAnyFlags(Changes, EWitResponseChange::Entities))
+	{
+		Events->WitResponse.Entities = PartialResponse.Entities;
+		Events->WitResponse.AllEntities = PartialResponse.AllEntities;
+		Events->WitResponse.AdditionalEntities = PartialResponse.AdditionalEntities;
+		Events->WitResponse.bIsAllEntitiesBuilt = PartialResponse.bIsAllEntitiesBuilt;
+	}
+
+	if (EnumHasAnyFlags(Changes, EWitResponseChange::Traits))
+	{
+		Events->WitResponse.Traits = PartialResponse.Traits;
+	}
+
+	if (EnumHasAnyFlags(Changes, EWitResponseChange::IsFinal))
+	{
+		Events->WitResponse.Is_Final = PartialResponse.Is_Final;
+	}
+
+	Events->WitResponseChanges = static_cast<int32>(Changes);
+
+	// Unchanged partial responses are still broadcast with an empty change mask and count towards stability
+
+	const bool bShouldCommitEarly = EarlyCommitPolicy.ShouldCommit(Events->WitResponse);
+
+	// A partial response held back by coalescing is replaced by this one so its changes are carried over
+
+	const EWitResponseChange AccumulatedChanges = PendingPartialResponseChanges | Changes;
+
+	if (PartialCoalescer.Submit(EWitPartialKind::Response, FPlatformTime::Seconds()))
+	{
+		PendingPartialResponseChanges = EWitResponseChange::None;
+		Events->WitResponseChanges = static_cast<int32>(AccumulatedChanges);
+
+		Events->OnWitPartialResponse.Broadcast(true, Events->WitResponse);
+		Events->OnWitPartialResponseChanges.Broadcast(Events->WitResponse, Events->WitResponseChanges);
+		Events->MatcherRegistry.DispatchPartialResponse(true, Events->WitResponse);
+	}
+	else
+	{
+		PendingPartialResponseChanges = AccumulatedChanges;
+		Events->NumDroppedPartials = PartialCoalescer.GetNumDropped();
+	}
+
+	// A matcher may already have accepted the partial response in which case the request is no longer in progress
+
+	const bool bIsEarlyCommitNeeded = bShouldCommitEarly && IsRequestInProgress();
+	if (bIsEarlyCommitNeeded)
+	{
+		UE_LOG(LogWit, Display, TEXT("OnPartialResponse: partial response stable for (%d) partial responses - committing early (%s)"),
+			EarlyCommitPolicy.GetNumStablePartialResponses(), *Events->WitResponse.Text);
+
+		AcceptPartialResponseAndCancelRequest(Events->WitResponse);
+	}
+}
+
+/**
+ * Deliver any partials held back by coalescing once they are due. Only the latest of each kind is delivered. A forced flush
+ * delivers them immediately and is used when voice input stops and before the final response so that none are lost. Partials
+ * still held back when the request is no longer in progress are stale and are dropped instead
+ *
+ * @param bIsForced [in] should pending partials be delivered regardless of coalescing?
+ */
+void UWitVoiceService::FlushPartials(const bool bIsForced)
+{
+	if (Events == nullptr || !PartialCoalescer.IsEnabled())
 	{
-		OnWitRequestError(TEXT("Json To UStruct failed"), TEXT("Convering the Json partial response to a UStruct failed"));
 		return;
 	}
 
-	Events->OnWitPartialResponse.Broadcast(true, Events->WitResponse);
+	if (!bIsForced && !IsRequestInProgress())
+	{
+		DropPartials();
+		return;
+	}
+
+	bool bIsTranscriptionDue = false;
+	bool bIsResponseDue = false;
+
+	if (!PartialCoalescer.Flush(FPlatformTime::Seconds(), bIsForced, bIsTranscriptionDue, bIsResponseDue))
+	{
+		return;
+	}
+
+	if (bIsTranscriptionDue)
+	{
+		Events->OnPartialTranscription.Broadcast(PendingPartialTranscription);
+		PendingPartialTranscription.Reset();
+	}
+
+	if (bIsResponseDue)
+	{
+		Events->WitResponseChanges = static_cast<int32>(PendingPartialResponseChanges);
+		PendingPartialResponseChanges = EWitResponseChange::None;
+
+		Events->OnWitPartialResponse.Broadcast(true, Events->WitResponse);
+		Events->OnWitPartialResponseChanges.Broadcast(Events->WitResponse, Events->WitResponseChanges);
+		Events->MatcherRegistry.DispatchPartialResponse(true, Events->WitResponse);
+	}
 }
 
 /**
- * Called when a Wit message(Transcription) request is successfully completed to process the final response payload
+ * Discard any partials held back by coalescing
+ */
+void UWitVoiceService::DropPartials()
+{
+	const bool bHasPendingPartials = PartialCoalescer.IsPending(EWitPartialKind::Transcription) || PartialCoalescer.IsPending(EWitPartialKind::Response);
+
+	if (!bHasPendingPartials)
+	{
+		return;
+	}
+
+	PartialCoalescer.Drop();
+	PendingPartialTranscription.Reset();
+	PendingPartialResponseChanges = EWitResponseChange::None;
+
+	UE_LOG(LogWit, Verbose, TEXT("DropPartials: (%d) partials dropped by coalescing in this request"), PartialCoalescer.GetNumDropped());
+
+	if (Events != nullptr)
+	{
+		Events->NumDroppedPartials = PartialCoalescer.GetNumDropped();
+	}
+}
+
+/**
+ * Make a speculative request if the partial transcription has been stable for long enough. This carries on after voice input is
+ * deactivated as the tick keeps running while the request finishes and the transcription is most likely to be stable then
+ */
+void UWitVoiceService::UpdateSpeculativeUnderstanding()
+{
+	// Customized requests such as those redirected to composer would not be equivalent to a plain /message request
+
+	const bool bIsRequestCustomized = Events != nullptr && Events->OnRequestCustomize.IsBound();
+	const bool bCanSpeculate = Configuration != nullptr && SpeculativeUnderstanding.IsEnabled() && !bIsContinuousStreamingEnabled && !bIsRequestCustomized
+		&& IsRequestInProgress();
+
+	if (!bCanSpeculate)
+	{
+		return;
+	}
+
+	FString Transcription;
+
+	if (SpeculativeUnderstanding.ShouldSpeculate(FPlatformTime::Seconds(), Transcription))
+	{
+		StartSpeculativeRequest(Transcription);
+	}
+}
+
+/**
+ * Send the given transcription to the /message endpoint speculatively. Any earlier speculation is cancelled as it can no longer match
  *
- * @param BinaryResponse [in] the final binary response
- * @param JsonResponse [in] the final Json response
+ * @param Transcription [in] the transcription to send
  */
-void UWitVoiceService::OnMessageRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse)
+void UWitVoiceService::StartSpeculativeRequest(const FString& Transcription)
 {
-	
-	Events->WitResponse.Reset();
-	Events->WitResponse.Is_Final = true;
-	OnRequestComplete(BinaryResponse, JsonResponse, false);
+	CancelSpeculativeRequest();
+
+	const uint32 SpeculationId = SpeculativeUnderstanding.GetSpeculationId();
+
+	// A cached response for the same text makes the speculation free
+
+	MessageCache.Configure(Configuration->Application);
+
+	FWitResponse CachedResponse{};
+
+	if (MessageCache.Find(Transcription, CachedResponse))
+	{
+		UE_LOG(LogWit, Verbose, TEXT("StartSpeculativeRequest: using cached response for speculation (%s)"), *Transcription);
+
+		SpeculativeUnderstanding.SetResponse(SpeculationId, CachedResponse);
+		return;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("StartSpeculativeRequest: speculating on transcription (%s)"), *Transcription);
+
+	FWitRequestConfiguration RequestConfiguration{};
+
+	FWitRequestBuilder::SetRequestConfigurationWithDefaults(RequestConfiguration, EWitRequestEndpoint::Message, Configuration->Application.ClientAccessToken,
+		Configuration->Application.Advanced.ApiVersion, Configuration->Application.Advanced.URL);
+
+	const FString EncodedText = FGenericPlatformHttp::UrlEncode(Transcription);
+	FWitRequestBuilder::AddParameter(RequestConfiguration, EWitParameter::Text, EncodedText);
+
+	RequestConfiguration.bShouldUseCustomHttpTimeout = Configuration->Application.Advanced.bIsCustomHttpTimeout;
+	RequestConfiguration.HttpTimeout = Configuration->Application.Advanced.HttpTimeout;
+	RequestConfiguration.ResponseDeadline = Configuration->Application.Advanced.ResponseDeadline;
+
+	RequestConfiguration.OnRequestCompleteWithResponse.AddUObject(this, &UWitVoiceService::OnSpeculativeRequestComplete, RequestSegment, SpeculationId);
+	RequestConfiguration.OnRequestError.AddUObject(this, &UWitVoiceService::OnSpeculativeRequestError, RequestSegment, SpeculationId);
+
+	SpeculativeRequest = UWitRequestSubsystem::CreateRequest();
+
+	SpeculativeRequest->BeginStreamRequest(RequestConfiguration);
+	SpeculativeRequest->EndStreamRequest();
 }
 
 /**
- * Called when a Wit speech request is successfully completed to process the final response payload
+ * Cancel the speculative request if there is one. This must not be called from the speculative request's own callbacks
+ */
+void UWitVoiceService::CancelSpeculativeRequest()
+{
+	if (!SpeculativeRequest.IsValid())
+	{
+		return;
+	}
+
+	if (SpeculativeRequest->IsRequestInProgress())
+	{
+		SpeculativeRequest->CancelRequest();
+	}
+
+	SpeculativeRequest.Reset();
+}
+
+/**
+ * Compare the final transcription against the speculation
+ *
+ * @param Transcription [in] the final transcription
+ * @return true if the speculative response was used and the request is complete
+ */
+bool UWitVoiceService::OnFinalTranscription(const FString& Transcription)
+{
+	const EWitSpeculationResult Result = SpeculativeUnderstanding.ResolveFinalTranscription(Transcription);
+
+	if (Result == EWitSpeculationResult::Hit)
+	{
+		AcceptSpeculativeResponse();
+		return true;
+	}
+
+	if (Result == EWitSpeculationResult::Pending)
+	{
+		UE_LOG(LogWit, Verbose, TEXT("OnFinalTranscription: final transcription matches speculation - waiting for speculative response (%s)"), *Transcription);
+		return false;
+	}
+
+	CancelSpeculativeRequest();
+
+	return false;
+}
+
+/**
+ * Use the speculative response as the final response. The speech request is cancelled as its understanding is no longer needed
+ */
+void UWitVoiceService::AcceptSpeculativeResponse()
+{
+	const FWitResponse Response = SpeculativeUnderstanding.GetResponse();
+
+	UE_LOG(LogWit, Display, TEXT("AcceptSpeculativeResponse: using speculative response - cancelling request (%s)"), *Response.Text);
+
+	AcceptPartialResponseAndCancelRequest(Response);
+}
+
+/**
+ * Called when a speculative request completes. If the final transcription has already matched then the response is used immediately
+ *
+ * @param BinaryResponse [in] the binary response
+ * @param JsonResponse [in] the Json response
+ * @param Response [in] the response already converted off the game thread
+ * @param Segment [in] the segment of the speech request the speculation was made for
+ * @param SpeculationId [in] the speculation the response is for
+ */
+void UWitVoiceService::OnSpeculativeRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response,
+	const uint32 Segment, const uint32 SpeculationId)
+{
+	if (Segment != RequestSegment)
+	{
+		return;
+	}
+
+	if (!SpeculativeUnderstanding.SetResponse(SpeculationId, Response))
+	{
+		return;
+	}
+
+	const bool bIsHit = IsRequestInProgress() && SpeculativeUnderstanding.ResolvePending();
+
+	if (bIsHit)
+	{
+		AcceptSpeculativeResponse();
+	}
+}
+
+/**
+ * Called when a speculative request errors. The speech request carries on as normal
+ *
+ * @param ErrorMessage [in] the error message
+ * @param HumanReadableMessage [in] a longer human readable error message
+ * @param Segment [in] the segment of the speech request the speculation was made for
+ * @param SpeculationId [in] the speculation that failed
+ */
+void UWitVoiceService::OnSpeculativeRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const uint32 Segment, const uint32 SpeculationId)
+{
+	if (Segment != RequestSegment)
+	{
+		return;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("OnSpeculativeRequestError: speculative request failed (%s)"), *ErrorMessage);
+
+	SpeculativeUnderstanding.SetFailed(SpeculationId);
+}
+
+/**
+ * Get the fraction of speech requests with a speculative /message request where the speculative response was used
+ *
+ * @return the hit rate in the range 0 to 1
+ */
+float UWitVoiceService::GetSpeculativeUnderstandingHitRate() const
+{
+	return SpeculativeUnderstanding.GetHitRate();
+}
+
+/**
+ * Called when a Wit message(Transcription) request is successfully completed to process the final response payload
  *
  * @param BinaryResponse [in] the final binary response
  * @param JsonResponse [in] the final Json response
+ * @param Response [in] the final response already converted off the game thread
+ * @param Text [in] the text that was sent
+ * @param bIsCacheable [in] was this a plain /message request whose response can be cached against the text
  */
-void UWitVoiceService::OnSpeechRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse)
+void UWitVoiceService::OnMessageRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response, const FString Text,
+	const bool bIsCacheable)
 {
-	
-	OnRequestComplete(BinaryResponse, JsonResponse, true);
+	// Error bodies such as rate limiting arrive as request errors so only real responses reach the cache
+
+	if (bIsCacheable)
+	{
+		MessageCache.Add(Text, BinaryResponse);
+	}
+
+	// Message responses are always final but do not necessarily say so
+
+	FWitResponse FinalResponse = Response;
+	FinalResponse.Is_Final = true;
+
+	OnRequestComplete(FinalResponse);
 }
 
 /**
- * Called when a Wit voice request is successfully completed to process the final response payload
+ * Called when a Wit speech request is successfully completed to process the final response payload
  *
  * @param BinaryResponse [in] the final binary response
  * @param JsonResponse [in] the final Json response
- * @param bIsResponseRestNeeded [in] whether to reset the Response Object.
- * 
+ * @param Response [in] the final response already converted off the game thread
+ * @param Segment [in] the segment of the request
  */
-void UWitVoiceService::OnRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const bool bIsResponseRestNeeded)
+void UWitVoiceService::OnSpeechRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response, const uint32 Segment)
 {
-	if (Events == nullptr)
+	// Partials of the same request that are still held back are delivered before the final response so listeners see them in order
+
+	if (Segment == RequestSegment)
 	{
-		return;		
+		FlushPartials(true);
+
+		SpeculativeUnderstanding.Abandon();
+		CancelSpeculativeRequest();
 	}
-	if (bIsResponseRestNeeded)
+
+	// Segments of the current stream are delivered in order. A handed over request can finish after the request that replaced it so
+	// its response is held until every earlier segment has been delivered
+
+	const bool bIsCurrentStream = Segment >= StreamStartSegment && Segment >= NextFinalSegment;
+
+	if (bIsCurrentStream)
 	{
-		Events->WitResponse.Reset();
+		PendingFinalResponses.Add(Segment, Response);
+		ReleaseFinalResponses(false);
 	}
-	
-	
-	const bool bIsConversionError = !FWitHelperUtilities::ConvertJsonToWitResponse(JsonResponse.ToSharedRef(), &Events->WitResponse);
-	if (bIsConversionError)
+	else
 	{
-		OnWitRequestError(TEXT("Json To UStruct failed"), TEXT("Converting the Json response to a UStruct failed"));
-		return;
+		OnRequestComplete(Response);
+	}
+
+	// The final response of a request that has been handed over replaces the current response so the next partial response of
+	// the current request must be converted in full
+
+	if (Segment != RequestSegment)
+	{
+		LastPartialChecksums = FWitResponseChecksums{};
+	}
+}
+
+/**
+ * Deliver the final responses of the current stream in segment order. A segment handed over from the previous one starts with
+ * the overlapping voice data so the words it repeats are removed. A segment that failed is skipped and the one after it is not
+ * trimmed
+ *
+ * @param bShouldReleaseAll [in] should responses still waiting for an earlier segment also be delivered
+ */
+void UWitVoiceService::ReleaseFinalResponses(const bool bShouldReleaseAll)
+{
+	while (PendingFinalResponses.Num() > 0)
+	{
+		TOptional<FWitResponse> FinalResponse;
+
+		if (!PendingFinalResponses.RemoveAndCopyValue(NextFinalSegment, FinalResponse))
+		{
+			if (!bShouldReleaseAll)
+			{
+				return;
+			}
+
+			LastFinalSegmentText.Reset();
+			++NextFinalSegment;
+
+			continue;
+		}
+
+		const uint32 Segment = NextFinalSegment++;
+
+		if (!FinalResponse.IsSet())
+		{
+			LastFinalSegmentText.Reset();
+			continue;
+		}
+
+		const bool bIsOverlappingSegment = Segment > StreamStartSegment && !LastFinalSegmentText.IsEmpty();
+		const FString PreviousSegmentText = MoveTemp(LastFinalSegmentText);
+
+		LastFinalSegmentText = FinalResponse->Text;
+
+		if (bIsOverlappingSegment)
+		{
+			// Speech runs at around three words a second so only that many words can have been spoken during the overlap
+
+			constexpr float WordsPerSecond = 3.0f;
+
+			const int32 MaximumOverlapWords = FMath::Max(FMath::CeilToInt(ContinuousOverlapTime * WordsPerSecond), 1);
+
+			FinalResponse->Text = TrimOverlappingText(PreviousSegmentText, FinalResponse->Text, MaximumOverlapWords);
+		}
+
+		OnRequestComplete(FinalResponse.GetValue());
 	}
-	
-	OnRequestComplete(Events->WitResponse);
 }
 
 /**
@@ -906,12 +1783,43 @@ void UWitVoiceService::OnRequestComplete(const FWitResponse& Response) const
 	}
 	
 	Events->WitResponse = Response;
+	Events->WitResponse.GetAllEntities();
 
 	UE_LOG(LogWit, Display, TEXT("Full transcription received (%s)"), *Events->WitResponse.Text);
 	UE_LOG(LogWit, Verbose, TEXT("UStruct - Text: %s"), *Events->WitResponse.Text);
 
 	Events->OnFullTranscription.Broadcast(Events->WitResponse.Text);
 	Events->OnWitResponse.Broadcast(true, Events->WitResponse);
+	Events->MatcherRegistry.DispatchResponse(true, Events->WitResponse);
+}
+
+/**
+ * Called when a Wit speech request errors. A request that has been handed over no longer owns the current response so its
+ * failure must not reset it or report the still live request as failed
+ *
+ * @param ErrorMessage [in] the error message
+ * @param HumanReadableErrorMessage [in] a longer human readable error message
+ * @param Segment [in] the segment of the request
+ */
+void UWitVoiceService::OnSpeechRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage, const uint32 Segment)
+{
+	// Later segments of the stream must not wait for a response that will never arrive
+
+	const bool bIsCurrentStream = Segment >= StreamStartSegment && Segment >= NextFinalSegment;
+
+	if (bIsCurrentStream)
+	{
+		PendingFinalResponses.Add(Segment, TOptional<FWitResponse>());
+		ReleaseFinalResponses(false);
+	}
+
+	if (Segment != RequestSegment)
+	{
+		UE_LOG(LogWit, Warning, TEXT("OnSpeechRequestError: request that was handed over failed with error: %s - %s"), *ErrorMessage, *HumanReadableErrorMessage);
+		return;
+	}
+
+	OnWitRequestError(ErrorMessage, HumanReadableErrorMessage);
 }
 
 /**
@@ -928,28 +1836,93 @@ void UWitVoiceService::OnWitRequestError(const FString& ErrorMessage, const FStr
 	{
 		Events->WitResponse.Reset();
 		Events->OnWitResponse.Broadcast(false, Events->WitResponse);
+		Events->MatcherRegistry.DispatchResponse(false, Events->WitResponse);
 		Events->OnWitError.Broadcast(ErrorMessage, HumanReadableErrorMessage);
 	}
 }
 
-#if WITH_EDITORONLY_DATA
-
 /**
- * Write the captured voice input to a wav file. The output file will be written to the project folder's Saved/BouncedWavFiles folder as
- * Wit/RecordedVoiceInput.wav. This only works with 16-bit samples
+ * Remove the words at the start of a transcription that repeat the end of the previous transcription. The longest run of words
+ * that ends the previous transcription and starts this one is removed. Case and surrounding punctuation are ignored and the
+ * rest of the transcription is returned exactly as it was
+ *
+ * @param PreviousText [in] the transcription of the previous segment
+ * @param Text [in] the transcription of the segment that overlaps it
+ * @param MaximumOverlapWords [in] the most words that could have been spoken during the overlap
+ * @return the transcription without the repeated words
  */
-void UWitVoiceService::WriteRawPCMDataToWavFile(const uint8* RawPCMData, int32 RawPCMDataSize, int32 NumChannels, int32 SampleRate)
+FString UWitVoiceService::TrimOverlappingText(const FString& PreviousText, const FString& Text, const int32 MaximumOverlapWords)
 {
-	RecordingData.Reset(new Audio::FAudioRecordingData());
-	RecordingData->InputBuffer = Audio::TSampleBuffer<int16>(reinterpret_cast<const int16*>(RawPCMData), RawPCMDataSize / 2, NumChannels, SampleRate);
+	TArray<FString> PreviousWords;
 
-	const FString WavFileName = TEXT("RecordedVoiceInput");
-	FString WavFilePath = TEXT("Wit");
-	
-	RecordingData->Writer.BeginWriteToWavFile(RecordingData->InputBuffer, WavFileName, WavFilePath, []()
+	PreviousText.ParseIntoArrayWS(PreviousWords);
+
+	// We remember where each word ends so that the remaining text can be returned without rebuilding it
+
+	TArray<FString> Words;
+	TArray<int32> WordEnds;
+
+	for (int32 Index = 0; Index < Text.Len() && Words.Num() < MaximumOverlapWords;)
 	{
-		RecordingData.Reset();
-	});
-}
+		while (Index < Text.Len() && FChar::IsWhitespace(Text[Index]))
+		{
+			++Index;
+		}
 
-#endif
+		const int32 WordStart = Index;
+
+		while (Index < Text.Len() && !FChar::IsWhitespace(Text[Index]))
+		{
+			++Index;
+		}
+
+		if (Index > WordStart)
+		{
+			Words.Add(Text.Mid(WordStart, Index - WordStart));
+			WordEnds.Add(Index);
+		}
+	}
+
+	const auto NormalizeWord = [](const FString& Word)
+	{
+		int32 Start = 0;
+		int32 End = Word.Len();
+
+		while (Start < End && !FChar::IsAlnum(Word[Start]))
+		{
+			++Start;
+		}
+
+		while (End > Start && !FChar::IsAlnum(Word[End - 1]))
+		{
+			--End;
+		}
+
+		return Word.Mid(Start, End - Start).ToLower();
+	};
+
+	const int32 MaximumOverlap = FMath::Min(PreviousWords.Num(), Words.Num());
+	int32 NumOverlappingWords = 0;
+
+	for (int32 Overlap = MaximumOverlap; Overlap > 0 && NumOverlappingWords == 0; --Overlap)
+	{
+		const int32 PreviousStart = PreviousWords.Num() - Overlap;
+		bool bIsMatch = true;
+
+		for (int32 Index = 0; bIsMatch && Index < Overlap; ++Index)
+		{
+			bIsMatch = NormalizeWord(PreviousWords[PreviousStart + Index]).Equals(NormalizeWord(Words[Index]));
+		}
+
+		NumOverlappingWords = bIsMatch ? Overlap : 0;
+	}
+
+	if (NumOverlappingWords == 0)
+	{
+		return Text;
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("TrimOverlappingText: removing (%d) words repeated from the previous segment"), NumOverlappingWords);
+
+	return Text.Mid(WordEnds[NumOverlappingWords - 1]).TrimStart();
+}
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "Wit/Voice/WitVoiceSession.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Voice/Capture/Processing/VoiceInputProcessor.h"
+#include "Voice/Capture/Processing/VoiceSilenceSuppressor.h"
+#include "Voice/Capture/VoiceCaptureSubscription.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Wit/Request/WitRequest.h"
+#include "Wit/Utilities/WitWavFileWriter.h"
+
+/**
+ * Constructor
+ *
+ * @param InRequest [in] the request that this session streams into
+ */
+FWitVoiceSession::FWitVoiceSession(const TSharedRef<FWitRequest, ESPMode::ThreadSafe>& InRequest)
+	: Request(InRequest)
+	, InputProcessor(MakeUnique<FVoiceInputProcessor>())
+	, SilenceSuppressor(MakeUnique<FVoiceSilenceSuppressor>())
+{
+	// Deliberately empty
+}
+
+/**
+ * Destructor
+ */
+FWitVoiceSession::~FWitVoiceSession()
+{
+	FinishRecording();
+}
+
+/**
+ * Set the source of voice input
+ *
+ * @param InInput [in] the input to read from
+ */
+void FWitVoiceSession::SetInput(const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& InInput)
+{
+	Input = InInput;
+}
+
+/**
+ * Get the source of voice input
+ *
+ * @return the input
+ */
+const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& FWitVoiceSession::GetInput() const
+{
+	return Input;
+}
+
+/**
+ * Redirect processed voice data to the given writer instead of the request
+ *
+ * @param InStreamWriter [in] the writer to use or an unbound function to write to the request
+ */
+void FWitVoiceSession::SetStreamWriter(TFunction<void(const FVoiceAudioSpan&)> InStreamWriter)
+{
+	StreamWriter = MoveTemp(InStreamWriter);
+}
+
+/**
+ * Prepare the processing for a new stream of voice data. Any previous recording is finished and a new one started if
+ * recording is enabled
+ *
+ * @param VoiceConfiguration [in] the voice configuration to use
+ * @param SampleRate [in] the sample rate of the voice data
+ * @param NumChannels [in] the number of channels in the voice data
+ * @param bIsRecordingEnabled [in] should the processed voice data be recorded to a wav file for debugging
+ */
+void FWitVoiceSession::Configure(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels, const bool bIsRecordingEnabled)
+{
+	InputProcessor->Configure(VoiceConfiguration, SampleRate, NumChannels);
+	SilenceSuppressor->Configure(VoiceConfiguration, SampleRate, NumChannels);
+
+	BoundarySpans.Reset();
+	NumBoundaryBytes = 0;
+
+	FinishRecording();
+
+	if (bIsRecordingEnabled)
+	{
+		Recorder = FWitWavFileWriter::Create(TEXT("RecordedVoiceInput"), SampleRate, NumChannels);
+	}
+}
+
+/**
+ * Prepare the processing of voice input ahead of streaming so that background noise can be learnt while waiting for speech.
+ * Configuring again when streaming starts keeps what was learnt
+ *
+ * @param VoiceConfiguration [in] the voice configuration to use
+ * @param SampleRate [in] the sample rate of the voice data
+ * @param NumChannels [in] the number of channels in the voice data
+ */
+void FWitVoiceSession::ConfigureProcessing(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels)
+{
+	InputProcessor->Configure(VoiceConfiguration, SampleRate, NumChannels);
+}
+
+/**
+ * Read all queued voice input, process it and write it to the request. If the session is not streaming then anything
+ * queued is discarded rather than left to build up
+ *
+ * @return the number of bytes written
+ */
+int32 FWitVoiceSession::Pump()
+{
+	if (!Input.IsValid())
+	{
+		return 0;
+	}
+
+	if (!IsStreaming())
+	{
+		Input->Flush();
+		return 0;
+	}
+
+	int32 NumBytesWritten = 0;
+	FVoiceAudioSpan CapturedData{};
+
+	while (Input->Read(CapturedData))
+	{
+		// Noise suppression and gain control work in whole hops so the processed data may lag slightly behind the captured data
+
+		const FVoiceAudioSpan ProcessedData = InputProcessor->Process(CapturedData);
+
+		NumBytesWritten += WriteProcessedData(ProcessedData);
+	}
+
+	return NumBytesWritten;
+}
+
+/**
+ * Discard all queued voice input without streaming it. This is the audio heard while waiting for speech to start so it is
+ * used to learn the background noise before the request begins
+ */
+void FWitVoiceSession::Discard()
+{
+	if (!Input.IsValid())
+	{
+		return;
+	}
+
+	FVoiceAudioSpan CapturedData{};
+
+	while (Input->Read(CapturedData))
+	{
+		InputProcessor->LearnNoise(CapturedData);
+	}
+}
+
+/**
+ * Write any processed voice data still held back by processing at the end of the stream. Without this up to a hop of the
+ * final speech would be lost
+ *
+ * @return the number of bytes written
+ */
+int32 FWitVoiceSession::Flush()
+{
+	if (!IsStreaming())
+	{
+		return 0;
+	}
+
+	return WriteProcessedData(InputProcessor->Flush());
+}
+
+/**
+ * Write processed voice data through silence suppression to the request and record it if recording is enabled
+ *
+ * @param ProcessedData [in] the processed voice data
+ * @return the number of bytes written
+ */
+int32 FWitVoiceSession::WriteProcessedData(const FVoiceAudioSpan& ProcessedData)
+{
+	if (ProcessedData.IsEmpty())
+	{
+		return 0;
+	}
+
+	// The recorder references the processed span rather than copying it and writes it to disk in the background
+
+	if (Recorder.IsValid())
+	{
+		Recorder->Write(ProcessedData);
+	}
+
+	// Long stretches of silence may be collapsed before streaming in which case there may be nothing to write.
+	// The spans reference the pooled capture blocks directly so nothing is copied on the way to the request
+
+	int32 NumBytesWritten = 0;
+	const TArray<FVoiceAudioSpan>& StreamData = SilenceSuppressor->Process(ProcessedData);
+
+	for (const FVoiceAudioSpan& StreamSpan : StreamData)
+	{
+		if (StreamWriter)
+		{
+			StreamWriter(StreamSpan);
+		}
+		else
+		{
+			Request->WriteBinaryData(StreamSpan);
+		}
+
+		if (BoundarySize > 0)
+		{
+			KeepBoundaryData(StreamSpan);
+		}
+
+		NumBytesWritten += StreamSpan.Num();
+	}
+
+	return NumBytesWritten;
+}
+
+/**
+ * Is the session able to stream voice data?
+ *
+ * @return true if streaming
+ */
+bool FWitVoiceSession::IsStreaming() const
+{
+	return StreamWriter || Request->IsRequestInProgress();
+}
+
+/**
+ * Get the request that this session streams into
+ *
+ * @return the request
+ */
+FWitRequest& FWitVoiceSession::GetRequest() const
+{
+	return Request.Get();
+}
+
+/**
+ * Keep the most recently streamed voice data so that it can be handed over to the next request
+ *
+ * @param NumBytes [in] the number of bytes to keep or zero to keep nothing
+ */
+void FWitVoiceSession::SetBoundarySize(const int32 NumBytes)
+{
+	BoundarySize = FMath::Max(NumBytes, 0);
+
+	if (BoundarySize == 0)
+	{
+		BoundarySpans.Reset();
+		NumBoundaryBytes = 0;
+	}
+}
+
+/**
+ * Hand streaming over to the next request without interrupting the voice input. Processing carries on unchanged so the
+ * next request receives exactly what the previous one would have
+ *
+ * @param NextRequest [in] the request to stream into from now on. It must already have begun
+ * @return the previous request which the caller is responsible for ending
+ */
+TSharedRef<FWitRequest, ESPMode::ThreadSafe> FWitVoiceSession::HandOver(const TSharedRef<FWitRequest, ESPMode::ThreadSafe>& NextRequest)
+{
+	TSharedRef<FWitRequest, ESPMode::ThreadSafe> PreviousRequest = Request;
+
+	Request = NextRequest;
+
+	for (const FVoiceAudioSpan& BoundarySpan : BoundarySpans)
+	{
+		Request->WriteBinaryData(BoundarySpan);
+	}
+
+	return PreviousRequest;
+}
+
+/**
+ * Keep the given streamed span as boundary data discarding anything older than the boundary size. The oldest span is
+ * trimmed rather than dropped so exactly the boundary size is kept
+ *
+ * @param StreamSpan [in] the span that was streamed
+ */
+void FWitVoiceSession::KeepBoundaryData(const FVoiceAudioSpan& StreamSpan)
+{
+	BoundarySpans.Add(StreamSpan);
+	NumBoundaryBytes += StreamSpan.Num();
+
+	int32 NumExcessBytes = NumBoundaryBytes - BoundarySize;
+	int32 NumSpansToRemove = 0;
+
+	while (NumExcessBytes > 0 && NumExcessBytes >= BoundarySpans[NumSpansToRemove].Num())
+	{
+		NumExcessBytes -= BoundarySpans[NumSpansToRemove].Num();
+		NumBoundaryBytes -= BoundarySpans[NumSpansToRemove].Num();
+		++NumSpansToRemove;
+	}
+
+	if (NumSpansToRemove > 0)
+	{
+#if UE_VERSION_OLDER_THAN(5,4,0)
+		BoundarySpans.RemoveAt(0, NumSpansToRemove, false);
+#else
+		BoundarySpans.RemoveAt(0, NumSpansToRemove, EAllowShrinking::No);
+#endif
+	}
+
+	if (NumExcessBytes > 0)
+	{
+		FVoiceAudioSpan& OldestSpan = BoundarySpans[0];
+
+		OldestSpan = FVoiceAudioSpan(OldestSpan.Block, OldestSpan.Offset + NumExcessBytes, OldestSpan.NumBytes - NumExcessBytes);
+		NumBoundaryBytes -= NumExcessBytes;
+	}
+}
+
+/**
+ * Finish any recording started when the session was last configured. The file is closed in the background
+ */
+void FWitVoiceSession::FinishRecording()
+{
+	if (!Recorder.IsValid())
+	{
+		return;
+	}
+
+	Recorder->Close();
+	Recorder.Reset();
+}
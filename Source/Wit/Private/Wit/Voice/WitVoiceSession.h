@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+
+class FVoiceCaptureSubscription;
+class FVoiceInputProcessor;
+class FVoiceSilenceSuppressor;
+class FWitRequest;
+class FWitWavFileWriter;
+struct FVoiceConfiguration;
+
+/**
+ * A single voice streaming session. The session owns everything needed to take voice input from a source through
+ * processing and into a Wit.ai request so any number of sessions can stream at the same time. For example one per
+ * split-screen player or one per remote player on a dedicated server
+ */
+class FWitVoiceSession final
+{
+public:
+
+	/**
+	 * Constructor
+	 *
+	 * @param InRequest [in] the request that this session streams into
+	 */
+	explicit FWitVoiceSession(const TSharedRef<FWitRequest, ESPMode::ThreadSafe>& InRequest);
+	~FWitVoiceSession();
+
+	/**
+	 * Set the source of voice input. This is either a subscription to the voice capture or the queue of a push input
+	 *
+	 * @param InInput [in] the input to read from
+	 */
+	void SetInput(const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& InInput);
+
+	/**
+	 * Get the source of voice input
+	 *
+	 * @return the input
+	 */
+	const TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& GetInput() const;
+
+	/**
+	 * Redirect processed voice data to the given writer instead of the request
+	 *
+	 * @param InStreamWriter [in] the writer to use or an unbound function to write to the request
+	 */
+	void SetStreamWriter(TFunction<void(const FVoiceAudioSpan&)> InStreamWriter);
+
+	/**
+	 * Prepare the processing for a new stream of voice data
+	 *
+	 * @param VoiceConfiguration [in] the voice configuration to use
+	 * @param SampleRate [in] the sample rate of the voice data
+	 * @param NumChannels [in] the number of channels in the voice data
+	 * @param bIsRecordingEnabled [in] should the processed voice data be recorded to a wav file for debugging
+	 */
+	void Configure(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels, const bool bIsRecordingEnabled);
+
+	/**
+	 * Prepare the processing of voice input ahead of streaming so that background noise can be learnt while waiting for speech
+	 *
+	 * @param VoiceConfiguration [in] the voice configuration to use
+	 * @param SampleRate [in] the sample rate of the voice data
+	 * @param NumChannels [in] the number of channels in the voice data
+	 */
+	void ConfigureProcessing(const FVoiceConfiguration& VoiceConfiguration, const int32 SampleRate, const int32 NumChannels);
+
+	/**
+	 * Read all queued voice input, process it and write it to the request
+	 *
+	 * @return the number of bytes written
+	 */
+	int32 Pump();
+
+	/**
+	 * Discard all queued voice input without streaming it. Background noise is still learnt from it
+	 */
+	void Discard();
+
+	/**
+	 * Write any processed voice data still held back by processing at the end of the stream
+	 *
+	 * @return the number of bytes written
+	 */
+	int32 Flush();
+
+	/**
+	 * Is the session able to stream voice data?
+	 *
+	 * @return true if streaming
+	 */
+	bool IsStreaming() const;
+
+	/**
+	 * Get the request that this session streams into
+	 *
+	 * @return the request
+	 */
+	FWitRequest& GetRequest() const;
+
+	/**
+	 * Keep the most recently streamed voice data so that it can be handed over to the next request
+	 *
+	 * @param NumBytes [in] the number of bytes to keep or zero to keep nothing
+	 */
+	void SetBoundarySize(const int32 NumBytes);
+
+	/**
+	 * Hand streaming over to the next request without interrupting the voice input. The kept voice data is written to the next
+	 * request first so that speech at the boundary is not lost
+	 *
+	 * @param NextRequest [in] the request to stream into from now on. It must already have begun
+	 * @return the previous request which the caller is responsible for ending
+	 */
+	TSharedRef<FWitRequest, ESPMode::ThreadSafe> HandOver(const TSharedRef<FWitRequest, ESPMode::ThreadSafe>& NextRequest);
+
+	/**
+	 * Finish any recording started when the session was last configured. The file is closed in the background
+	 */
+	void FinishRecording();
+
+private:
+
+	/** Write processed voice data through silence suppression to the request */
+	int32 WriteProcessedData(const FVoiceAudioSpan& ProcessedData);
+
+	/** Keep the given streamed span as boundary data discarding anything older than the boundary size */
+	void KeepBoundaryData(const FVoiceAudioSpan& StreamSpan);
+
+	/** The request that this session streams into */
+	TSharedRef<FWitRequest, ESPMode::ThreadSafe> Request;
+
+	/** The source of voice input */
+	TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe> Input{};
+
+	/** Optional writer that processed voice data is redirected to */
+	TFunction<void(const FVoiceAudioSpan&)> StreamWriter{};
+
+	/** Used to apply noise suppression and gain control before the voice input is streamed */
+	TUniquePtr<FVoiceInputProcessor> InputProcessor{};
+
+	/** Used to collapse long stretches of silence before they are streamed */
+	TUniquePtr<FVoiceSilenceSuppressor> SilenceSuppressor{};
+
+	/** The most recently streamed voice data. The spans reference the pooled capture blocks so nothing is copied */
+	TArray<FVoiceAudioSpan> BoundarySpans{};
+
+	/** The number of bytes in the boundary spans */
+	int32 NumBoundaryBytes{0};
+
+	/** The number of bytes of boundary data to keep */
+	int32 BoundarySize{0};
+
+	/** Streams processed voice data to a wav file for debugging. Null if not recording */
+	TSharedPtr<FWitWavFileWriter, ESPMode::ThreadSafe> Recorder{};
+};
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Voice/Capture/VoiceCaptureSubscription.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Voice/Input/VoicePushInput.h"
+#include "Wit/Configuration/WitAppConfiguration.h"
+#include "Wit/Request/WitRequest.h"
+#include "Wit/Request/WitRequestBuilder.h"
+#include "Wit/Request/WitRequestSubsystem.h"
+#include "Wit/Voice/WitVoiceSession.h"
+#include "Wit/Utilities/WitBenchmark.h"
+#include "Wit/Utilities/WitLog.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Measures how voice sessions scale by streaming the same synthetic utterance through 1, 8 and then 32 concurrent sessions.
+ * Intended to be run against a local stand-in server (see scripts/wit_stand_in_server.js) so that the numbers reflect the
+ * client rather than the network. Usage: Wit.VoiceSessionBenchmark [Url]
+ */
+#if UE_VERSION_OLDER_THAN(5,0,0)
+class FWitVoiceSessionBenchmark final : public FTickerObjectBase
+#else
+class FWitVoiceSessionBenchmark final : public FTSTickerObjectBase
+#endif
+{
+public:
+
+	explicit FWitVoiceSessionBenchmark(const FString& InUrl)
+		: Url(InUrl)
+	{
+		UE_LOG(LogWit, Display, TEXT("FWitVoiceSessionBenchmark - Constructor: starting benchmark against (%s)"), *Url);
+
+		BeginStage();
+	}
+
+	virtual ~FWitVoiceSessionBenchmark() override
+	{
+		for (const TSharedRef<FSimulatedSession, ESPMode::ThreadSafe>& SimulatedSession : SimulatedSessions)
+		{
+			SimulatedSession->Session->GetRequest().CancelRequest();
+		}
+	}
+
+	/**
+	 * FTickerObjectBase overrides
+	 */
+	virtual bool Tick(float DeltaTime) override
+	{
+		if (bIsComplete)
+		{
+			return true;
+		}
+
+		const int32 NumFramesToPush = FMath::RoundToInt(DeltaTime * SampleRate);
+		bool bIsStageComplete = true;
+
+		for (const TSharedRef<FSimulatedSession, ESPMode::ThreadSafe>& SimulatedSession : SimulatedSessions)
+		{
+			TickSession(SimulatedSession.Get(), NumFramesToPush);
+
+			bIsStageComplete &= SimulatedSession->bIsComplete;
+		}
+
+		if (bIsStageComplete)
+		{
+			EndStage();
+		}
+
+		return true;
+	}
+
+	/** Is the whole benchmark complete? */
+	bool IsComplete() const
+	{
+		return bIsComplete;
+	}
+
+private:
+
+	/** The state of a single simulated player */
+	struct FSimulatedSession
+	{
+		/** The voice input that the synthetic utterance is pushed through */
+		TSharedPtr<FVoicePushInput, ESPMode::ThreadSafe> PushInput{};
+
+		/** The session being measured */
+		TUniquePtr<FWitVoiceSession> Session{};
+
+		/** The number of frames of the utterance that have been pushed so far */
+		int32 NumFramesPushed{0};
+
+		/** The time at which the end of speech was sent */
+		double EndOfSpeechTime{0.0};
+
+		/** The time taken to receive the final response after the end of speech */
+		double ResponseLatency{0.0};
+
+		/** The time spent pumping voice data into the request */
+		double PumpTime{0.0};
+
+		/** Has the request finished one way or another? */
+		bool bIsComplete{false};
+
+		/** Did the request fail? */
+		bool bHasFailed{false};
+
+		void OnRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse)
+		{
+			ResponseLatency = FPlatformTime::Seconds() - EndOfSpeechTime;
+			bIsComplete = true;
+		}
+
+		void OnRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage)
+		{
+			UE_LOG(LogWit, Warning, TEXT("FWitVoiceSessionBenchmark - OnRequestError: request failed (%s)"), *ErrorMessage);
+
+			bHasFailed = true;
+			bIsComplete = true;
+		}
+	};
+
+	/** Create the sessions for the current stage and start streaming */
+	void BeginStage()
+	{
+		const int32 NumSessions = StageSizes[StageIndex];
+
+		SimulatedSessions.Reset(NumSessions);
+
+		for (int32 i = 0; i < NumSessions; ++i)
+		{
+			TSharedRef<FSimulatedSession, ESPMode::ThreadSafe> SimulatedSession = MakeShared<FSimulatedSession, ESPMode::ThreadSafe>();
+
+			SimulatedSession->PushInput = FVoicePushInput::Create(FVoicePushFormat{SampleRate, 1, EVoicePushSampleFormat::Int16});
+			SimulatedSession->Session = MakeUnique<FWitVoiceSession>(UWitRequestSubsystem::CreateRequest());
+			SimulatedSession->Session->SetInput(SimulatedSession->PushInput->GetSubscription());
+			SimulatedSession->Session->Configure(FVoiceConfiguration{}, SampleRate, 1, false);
+
+			FWitRequestConfiguration RequestConfiguration{};
+
+			FWitRequestBuilder::SetRequestConfigurationWithDefaults(RequestConfiguration, EWitRequestEndpoint::Speech, TEXT("benchmark"),
+				FWitAppAdvancedConfiguration{}.ApiVersion, Url);
+			FWitRequestBuilder::AddFormatContentType(RequestConfiguration, EWitRequestFormat::Raw);
+			FWitRequestBuilder::AddEncodingContentType(RequestConfiguration, EWitRequestEncoding::SignedInteger);
+			FWitRequestBuilder::AddSampleSizeContentType(RequestConfiguration, EWitRequestSampleSize::Word);
+			FWitRequestBuilder::AddRateContentType(RequestConfiguration, SampleRate);
+			FWitRequestBuilder::AddEndianContentType(RequestConfiguration, EWitRequestEndian::Little);
+
+			RequestConfiguration.OnRequestComplete.AddSP(SimulatedSession, &FSimulatedSession::OnRequestComplete);
+			RequestConfiguration.OnRequestError.AddSP(SimulatedSession, &FSimulatedSession::OnRequestError);
+
+			SimulatedSession->Session->GetRequest().BeginStreamRequest(RequestConfiguration);
+
+			SimulatedSessions.Add(SimulatedSession);
+		}
+
+		StageStartTime = FPlatformTime::Seconds();
+	}
+
+	/** Push the next part of the utterance in realtime and pump it into the request */
+	void TickSession(FSimulatedSession& SimulatedSession, const int32 NumFramesToPush)
+	{
+		if (SimulatedSession.bIsComplete || SimulatedSession.EndOfSpeechTime > 0.0)
+		{
+			return;
+		}
+
+		const int32 NumFramesRemaining = UtteranceNumFrames - SimulatedSession.NumFramesPushed;
+		const int32 NumFrames = FMath::Min(NumFramesToPush, NumFramesRemaining);
+
+		if (NumFrames > 0)
+		{
+			SimulatedSession.PushInput->Push(MakeArrayView(Utterance.GetData() + SimulatedSession.NumFramesPushed, NumFrames));
+			SimulatedSession.NumFramesPushed += NumFrames;
+		}
+
+		const bool bIsUtterancePushed = SimulatedSession.NumFramesPushed >= UtteranceNumFrames;
+
+		if (bIsUtterancePushed && !SimulatedSession.PushInput->IsEndOfStream())
+		{
+			SimulatedSession.PushInput->EndOfStream();
+		}
+
+		const double PumpStartTime = FPlatformTime::Seconds();
+
+		SimulatedSession.Session->Pump();
+
+		SimulatedSession.PumpTime += FPlatformTime::Seconds() - PumpStartTime;
+
+		const bool bIsEndOfSpeech = SimulatedSession.PushInput->IsEndOfStream() && SimulatedSession.Session->GetInput()->GetNumQueuedBytes() == 0;
+
+		if (bIsEndOfSpeech)
+		{
+			SimulatedSession.EndOfSpeechTime = FPlatformTime::Seconds();
+			SimulatedSession.Session->GetRequest().EndStreamRequest();
+		}
+	}
+
+	/** Report the results of the current stage and move on to the next */
+	void EndStage()
+	{
+		const double WallTime = FPlatformTime::Seconds() - StageStartTime;
+
+		int32 NumSucceeded = 0;
+		int32 NumFailed = 0;
+		double TotalLatency = 0.0;
+		double MaxLatency = 0.0;
+		double TotalPumpTime = 0.0;
+
+		for (const TSharedRef<FSimulatedSession, ESPMode::ThreadSafe>& SimulatedSession : SimulatedSessions)
+		{
+			TotalPumpTime += SimulatedSession->PumpTime;
+
+			if (SimulatedSession->bHasFailed)
+			{
+				++NumFailed;
+				continue;
+			}
+
+			++NumSucceeded;
+			TotalLatency += SimulatedSession->ResponseLatency;
+			MaxLatency = FMath::Max(MaxLatency, SimulatedSession->ResponseLatency);
+		}
+
+		const double AverageLatency = NumSucceeded > 0 ? TotalLatency / NumSucceeded : 0.0;
+		const double AveragePumpTime = SimulatedSessions.Num() > 0 ? TotalPumpTime / SimulatedSessions.Num() : 0.0;
+
+		UE_LOG(LogWit, Display, TEXT("FWitVoiceSessionBenchmark - EndStage: sessions (%d) wall (%.3fs) latency avg (%.2fms) max (%.2fms) pump per session (%.3fms) failed (%d)"),
+			SimulatedSessions.Num(), WallTime, AverageLatency * 1000.0, MaxLatency * 1000.0, AveragePumpTime * 1000.0, NumFailed);
+
+		SimulatedSessions.Reset();
+
+		++StageIndex;
+
+		if (StageIndex >= UE_ARRAY_COUNT(StageSizes))
+		{
+			UE_LOG(LogWit, Display, TEXT("FWitVoiceSessionBenchmark - EndStage: benchmark complete"));
+
+			bIsComplete = true;
+			return;
+		}
+
+		BeginStage();
+	}
+
+	/** Create the synthetic utterance. A voiced tone with a slow syllable-like envelope */
+	static TArray<int16> CreateUtterance()
+	{
+		TArray<int16> Samples;
+
+		Samples.SetNumUninitialized(UtteranceNumFrames);
+
+		for (int32 i = 0; i < UtteranceNumFrames; ++i)
+		{
+			const float Time = static_cast<float>(i) / SampleRate;
+			const float Envelope = 0.5f - 0.5f * FMath::Cos(2.0f * PI * 4.0f * Time);
+			const float Voice = FMath::Sin(2.0f * PI * 180.0f * Time) + 0.5f * FMath::Sin(2.0f * PI * 360.0f * Time);
+
+			Samples[i] = static_cast<int16>(Envelope * Voice * 8000.0f);
+		}
+
+		return Samples;
+	}
+
+	/** The wire sample rate. Pushed data at this rate takes the fast path through the push input */
+	static constexpr int32 SampleRate{16000};
+
+	/** The length of the synthetic utterance */
+	static constexpr int32 UtteranceNumFrames{SampleRate * 3 / 2};
+
+	/** The number of concurrent sessions in each stage */
+	static constexpr int32 StageSizes[] = {1, 8, 32};
+
+	/** The server to stream to */
+	const FString Url{};
+
+	/** The synthetic utterance shared by all sessions */
+	const TArray<int16> Utterance{CreateUtterance()};
+
+	/** The index of the current stage */
+	int32 StageIndex{0};
+
+	/** The time at which the current stage started */
+	double StageStartTime{0.0};
+
+	/** Has every stage completed? */
+	bool bIsComplete{false};
+
+	/** The sessions in the current stage */
+	TArray<TSharedRef<FSimulatedSession, ESPMode::ThreadSafe>> SimulatedSessions{};
+};
+
+constexpr int32 FWitVoiceSessionBenchmark::StageSizes[];
+
+/** The benchmark currently running if any */
+static TUniquePtr<FWitVoiceSessionBenchmark> VoiceSessionBenchmark;
+
+static FAutoConsoleCommand VoiceSessionBenchmarkCommand(
+	TEXT("Wit.VoiceSessionBenchmark"),
+	TEXT("Streams a synthetic utterance through 1, 8 and 32 concurrent voice sessions and reports latency. Optional argument is the server URL (defaults to http://127.0.0.1:8080)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const bool bIsAlreadyRunning = VoiceSessionBenchmark.IsValid() && !VoiceSessionBenchmark->IsComplete();
+
+		if (bIsAlreadyRunning)
+		{
+			UE_LOG(LogWit, Warning, TEXT("Wit.VoiceSessionBenchmark: a benchmark is already running"));
+			return;
+		}
+
+		const FString Url = FWitBenchmark::GetArgument(Args, 0, FString(TEXT("http://127.0.0.1:8080")));
+
+		VoiceSessionBenchmark = MakeUnique<FWitVoiceSessionBenchmark>(Url);
+	}));
+
+#endif
@@ -40,5 +40,23 @@ struct WIT_API FComposerConfiguration
 	/** Delay from action completion and response to listen for graph continuation */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Composer|Configuration")
 	float ContinueDelay{0.0f};
+
+	/**
+	 * Should the composer turn be prefetched from a stable partial transcription? If the final transcription matches, the prefetched
+	 * response is used straight away and its phrase is spoken without waiting for the speech request to finish. Each prefetch is sent
+	 * with its own throwaway session id and a copy of the turn's context map so an unused prefetch never advances the live session.
+	 * A used prefetch is therefore not seen by the live session so only enable this for stateless graphs whose state is carried
+	 * entirely in the context map
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Composer|Prefetch")
+	bool bIsSpeculativePrefetchEnabled{false};
+
+	/** How long in seconds the partial transcription must be unchanged before the turn is prefetched */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Composer|Prefetch", meta=(ClampMin = 0, ClampMax = 2, EditCondition = "bIsSpeculativePrefetchEnabled"))
+	float SpeculativePrefetchStableTime{0.3f};
+
+	/** The maximum number of prefetches made for each turn. A new prefetch replaces the previous one */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Composer|Prefetch", meta=(ClampMin = 1, ClampMax = 5, EditCondition = "bIsSpeculativePrefetchEnabled"))
+	int32 SpeculativePrefetchMaximumRequests{1};
 	
 };
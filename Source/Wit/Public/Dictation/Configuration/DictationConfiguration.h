@@ -29,4 +29,19 @@ struct WIT_API FDictationConfiguration
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Dictation|Configuration", meta=(ClampMin = 60))
 	float MaximumRecordingTime{300.0f};
 
+	/**
+	 * Whether dictation should continue without gaps between requests. Voice capture keeps running and the next request begins
+	 * before the current one finalizes so no speech is lost between them
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Dictation|Continuous")
+	bool bIsContinuousDictationEnabled{false};
+
+	/** Once a request has streamed for this many seconds it is handed over to the next request at the next pause in speech */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Dictation|Continuous", meta=(ClampMin = 1, ClampMax = 300, EditCondition = "bIsContinuousDictationEnabled"))
+	float ContinuousSegmentTime{15.0f};
+
+	/** How many seconds of the most recent voice input are sent to both requests when handing over */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Dictation|Continuous", meta=(ClampMin = 0, ClampMax = 2, EditCondition = "bIsContinuousDictationEnabled"))
+	float ContinuousOverlapTime{0.3f};
+
 };
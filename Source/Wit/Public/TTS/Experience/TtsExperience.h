@@ -42,6 +42,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category="TTS")
 	virtual void ConvertTextToSpeechWithSettings(const FTtsConfiguration& ClipSettings, bool bQueueAudio = true) override;
 
+	UFUNCTION(BlueprintCallable, Category="TTS")
+	virtual void StopSynthesis() override;
+
 	UFUNCTION(BlueprintCallable, Category="TTS")
 	virtual void FetchAvailableVoices() override;
 	
@@ -44,6 +44,11 @@ public:
 	 */
 	virtual void ConvertTextToSpeechWithSettings(const FTtsConfiguration& ClipSettings, bool bQueueAudio = true) = 0;
 
+	/**
+	 * Cancel any synthesis in progress and discard any queued text. The response to the cancelled request is ignored
+	 */
+	virtual void StopSynthesis() = 0;
+
 	/**
 	 * Fetch a list of available voices from Wit
 	 */
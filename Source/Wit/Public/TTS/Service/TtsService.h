@@ -65,6 +65,7 @@ public:
 	virtual bool IsRequestInProgress() const override { return false; }
 	virtual void ConvertTextToSpeech(const FString& TextToConvert, bool bQueueAudio = true) override {}
 	virtual void ConvertTextToSpeechWithSettings(const FTtsConfiguration& ClipSettings, bool bQueueAudio = true) override {}
+	virtual void StopSynthesis() override {}
 	virtual void FetchAvailableVoices() override {}
 
 protected:
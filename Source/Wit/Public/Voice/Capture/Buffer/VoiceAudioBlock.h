@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Templates/RefCounting.h"
+
+class FVoiceAudioBlockPool;
+
+/**
+ * A fixed size block of audio data owned by a pool. Blocks are reference counted and are returned to their pool when
+ * the last reference is released. This allows captured audio to be shared between consumers without copying it and
+ * without allocating once the pool has warmed up. Blocks can be released from any thread
+ */
+class WIT_API FVoiceAudioBlock
+{
+public:
+
+	FVoiceAudioBlock(const TSharedRef<FVoiceAudioBlockPool, ESPMode::ThreadSafe>& OwningPool, const int32 Capacity);
+
+	/**
+	 * Reference counting used by TRefCountPtr
+	 */
+	uint32 AddRef() const;
+	uint32 Release() const;
+	uint32 GetRefCount() const;
+
+	/**
+	 * Get write access to the block data. This should only be used by the producer before the block is shared
+	 *
+	 * @return pointer to the start of the block data
+	 */
+	uint8* GetData();
+
+	/**
+	 * Get read access to the block data
+	 *
+	 * @return pointer to the start of the block data
+	 */
+	const uint8* GetData() const;
+
+	/**
+	 * Get the number of valid bytes in the block
+	 *
+	 * @return the number of bytes
+	 */
+	int32 Num() const;
+
+	/**
+	 * Set the number of valid bytes in the block. This is clamped to the capacity
+	 *
+	 * @param NewNum [in] the number of bytes
+	 */
+	void SetNum(const int32 NewNum);
+
+	/**
+	 * Get the maximum number of bytes the block can hold
+	 *
+	 * @return the capacity in bytes
+	 */
+	int32 GetCapacity() const;
+
+private:
+
+	/** The pool that the block is returned to when no longer referenced */
+	TWeakPtr<FVoiceAudioBlockPool, ESPMode::ThreadSafe> Pool{};
+
+	/** The number of outstanding references */
+	mutable FThreadSafeCounter RefCount{};
+
+	/** The block storage. This is allocated once at the full capacity */
+	TArray<uint8> Data{};
+
+	/** The number of valid bytes */
+	int32 NumBytes{0};
+};
+
+/** A shared reference to an audio block */
+typedef TRefCountPtr<FVoiceAudioBlock> FVoiceAudioBlockRef;
+
+/**
+ * A range of bytes within a shared audio block. Consumers that only need part of a block use this rather than copying
+ */
+struct WIT_API FVoiceAudioSpan
+{
+	FVoiceAudioSpan() = default;
+	explicit FVoiceAudioSpan(const FVoiceAudioBlockRef& InBlock);
+	FVoiceAudioSpan(const FVoiceAudioBlockRef& InBlock, const int32 InOffset, const int32 InNumBytes);
+
+	/**
+	 * Does the span contain any data?
+	 *
+	 * @return true if empty
+	 */
+	bool IsEmpty() const;
+
+	/**
+	 * Get the number of bytes in the span
+	 *
+	 * @return the number of bytes
+	 */
+	int32 Num() const;
+
+	/**
+	 * Get read access to the span data
+	 *
+	 * @return pointer to the start of the span or nullptr if empty
+	 */
+	const uint8* GetData() const;
+
+	/**
+	 * Get the span as an array view
+	 *
+	 * @return the view
+	 */
+	TArrayView<const uint8> GetView() const;
+
+	/** The block containing the data */
+	FVoiceAudioBlockRef Block{};
+
+	/** The offset in bytes of the span within the block */
+	int32 Offset{0};
+
+	/** The number of bytes in the span */
+	int32 NumBytes{0};
+};
+
+/**
+ * A thread safe pool of fixed size audio blocks. Pools must be created with MakeShared so that blocks can find their way
+ * back. Blocks that outlive their pool are simply deleted when released
+ */
+class WIT_API FVoiceAudioBlockPool final : public TSharedFromThis<FVoiceAudioBlockPool, ESPMode::ThreadSafe>
+{
+public:
+
+	explicit FVoiceAudioBlockPool(const int32 InBlockSize);
+	~FVoiceAudioBlockPool();
+
+	/**
+	 * Acquire an empty block from the pool. A new block is allocated only if there are no free blocks
+	 *
+	 * @return the block
+	 */
+	FVoiceAudioBlockRef Acquire();
+
+	/**
+	 * Acquire a block from the pool and fill it with a copy of the given data
+	 *
+	 * @param Data [in] the data to copy. This must not be larger than the block size
+	 * @return the block
+	 */
+	FVoiceAudioBlockRef Acquire(TArrayView<const uint8> Data);
+
+	/**
+	 * Pre-allocate free blocks so that the pool does not need to grow later
+	 *
+	 * @param NumBlocks [in] the number of free blocks to ensure are available
+	 */
+	void Reserve(const int32 NumBlocks);
+
+	/**
+	 * Get the size in bytes of the blocks in this pool
+	 *
+	 * @return the size in bytes
+	 */
+	int32 GetBlockSize() const;
+
+	/**
+	 * Get the number of blocks the pool has ever allocated. This stops growing once the pool reaches its steady state
+	 *
+	 * @return the number of blocks
+	 */
+	int32 GetNumAllocatedBlocks() const;
+
+private:
+
+	friend class FVoiceAudioBlock;
+
+	/** Return an unreferenced block to the free list */
+	void Recycle(FVoiceAudioBlock* Block);
+
+	/** The size of each block in bytes */
+	const int32 BlockSize;
+
+	/** Guards the free list */
+	mutable FCriticalSection FreeBlocksCriticalSection{};
+
+	/** Blocks that are available for reuse */
+	TArray<FVoiceAudioBlock*> FreeBlocks{};
+
+	/** The number of blocks ever allocated by this pool */
+	FThreadSafeCounter NumAllocatedBlocks{};
+};
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+
+/**
+ * What a subscription does when a consumer falls behind and its queue is full
+ */
+enum class EVoiceCaptureBackpressure : uint8
+{
+	/** Discard the oldest queued data to make room. Suited to consumers that only care about the most recent audio */
+	DropOldest,
+
+	/** Discard newly captured data until the consumer catches up. Suited to consumers that need an unbroken start */
+	DropNewest,
+
+	/** Never discard data. The queue grows until the consumer reads it */
+	Unbounded
+};
+
+/**
+ * A single consumer of the shared voice capture. Each subscription has its own queue of captured audio and read cursor so
+ * several consumers can read the same microphone stream at their own pace. Queued audio references the pooled capture
+ * blocks so fanning out to many subscribers does not copy any data. Reading is thread safe
+ */
+class WIT_API FVoiceCaptureSubscription final
+{
+public:
+
+	/**
+	 * Constructor
+	 *
+	 * @param InName [in] the name of the subscriber. Used for logging
+	 * @param InMaxQueuedBytes [in] the maximum number of bytes that can be queued before backpressure applies
+	 * @param InBackpressure [in] what to do when the queue is full
+	 */
+	FVoiceCaptureSubscription(const FName& InName, const int32 InMaxQueuedBytes, const EVoiceCaptureBackpressure InBackpressure);
+
+	/**
+	 * Read the next span of queued voice data and advance the read cursor past it
+	 *
+	 * @param OutSpan [out] the span that was read
+	 * @param MaxBytes [in] the maximum number of bytes to read. Should be a multiple of the sample size
+	 * @return true if any data was read
+	 */
+	bool Read(FVoiceAudioSpan& OutSpan, const int32 MaxBytes = MAX_int32);
+
+	/**
+	 * Discard all queued voice data
+	 */
+	void Flush();
+
+	/**
+	 * Get the number of bytes waiting to be read
+	 *
+	 * @return the number of bytes
+	 */
+	int32 GetNumQueuedBytes() const;
+
+	/**
+	 * Get the total number of bytes discarded due to backpressure since the subscription was last started
+	 *
+	 * @return the number of bytes
+	 */
+	int64 GetNumDroppedBytes() const;
+
+	/**
+	 * Is the subscription currently receiving voice data?
+	 *
+	 * @return true if active
+	 */
+	bool IsActive() const;
+
+	/**
+	 * Get the name of the subscriber
+	 *
+	 * @return the name
+	 */
+	const FName& GetName() const;
+
+private:
+
+	friend class UVoiceCaptureSubsystem;
+	friend class FVoicePushInput;
+
+	/** Set whether the subscription is receiving voice data. Any queued data is discarded */
+	void SetActive(const bool bIsNewActive);
+
+	/** Queue newly captured voice data applying the backpressure policy if needed */
+	void Push(const FVoiceAudioSpan& Span);
+
+	/** Remove spans from the front of the queue */
+	void RemoveFrontSpans(const int32 NumSpans);
+
+	/** The name of the subscriber */
+	const FName Name{};
+
+	/** The maximum number of bytes that can be queued before backpressure applies */
+	const int32 MaxQueuedBytes{0};
+
+	/** What to do when the queue is full */
+	const EVoiceCaptureBackpressure Backpressure{EVoiceCaptureBackpressure::DropOldest};
+
+	/** Is the subscription receiving voice data? */
+	bool bIsActive{false};
+
+	/** The number of bytes waiting to be read */
+	int32 NumQueuedBytes{0};
+
+	/** The total number of bytes discarded due to backpressure */
+	int64 NumDroppedBytes{0};
+
+	/** Queued voice data. The front span is trimmed as it is read so it always starts at the read cursor */
+	TArray<FVoiceAudioSpan> QueuedSpans{};
+
+	/** Guards access from the reading thread */
+	mutable FCriticalSection CriticalSection{};
+};
@@ -9,6 +9,8 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/EngineSubsystem.h"
+#include "Voice/Capture/Buffer/VoiceAudioBlock.h"
+#include "Voice/Capture/VoiceCaptureSubscription.h"
 #include "Voice/Configuration/VoiceConfiguration.h"
 #include "VoiceCaptureSubsystem.generated.h"
 
@@ -18,7 +20,7 @@ class USoundWave;
  * UE4 Voice Capture wrapper for Wit.ai integration
  */
 UCLASS()
-class UVoiceCaptureSubsystem final : public UEngineSubsystem
+class WIT_API UVoiceCaptureSubsystem final : public UEngineSubsystem
 {
 	GENERATED_BODY()
 	
@@ -50,18 +52,35 @@ public:
 	void Shutdown();
 	
 	/**
-	 * Starts capturing voice data. Captured voice data is buffered in the internal buffer
-	 * up until the maximum specified duration
+	 * Create a new subscription to the voice capture. The subscription does not receive any data until it is started
 	 *
+	 * @param Name [in] the name of the subscriber. Used for logging
+	 * @param MaxQueuedBytes [in] the maximum number of bytes that can be queued before backpressure applies
+	 * @param Backpressure [in] what to do when the subscriber falls behind
+	 * @return the new subscription
+	 */
+	TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe> Subscribe(const FName& Name, const int32 MaxQueuedBytes, const EVoiceCaptureBackpressure Backpressure);
+
+	/**
+	 * Remove a subscription. The subscription is stopped if it is still active
+	 *
+	 * @param Subscription [in] the subscription to remove
+	 */
+	void Unsubscribe(const TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription);
+
+	/**
+	 * Starts delivering voice data to a subscription. The capture device is started if this is the first active subscription
+	 *
+	 * @param Subscription [in] the subscription to start
 	 * @return true if successfully started
 	 */
-	bool Start();
+	bool Start(const TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription);
 
 	/**
-	 * Reads data from the voice capture module into the internal buffer for processing
-	 * This should typically be called every frame
+	 * Reads data from the voice capture module and delivers it to every active subscription. This should typically be
+	 * called every frame by each consumer but the device is only read once per frame. Must be called on the game thread
 	 *
-	 * @return true if any data was read
+	 * @return true if any data was read this frame
 	 */
 	bool Read();
 
@@ -73,9 +92,19 @@ public:
 	float GetCurrentAmplitude() const;
 	
 	/**
-	 * Stop capturing voice data. Should be paired with Start
+	 * Stop delivering voice data to a subscription. The capture device is stopped when there are no more active subscriptions.
+	 * Should be paired with Start
+	 *
+	 * @param Subscription [in] the subscription to stop
+	 */
+	void Stop(const TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe>& Subscription);
+
+	/**
+	 * Get the number of subscriptions currently receiving voice data
+	 *
+	 * @return the number of active subscriptions
 	 */
-	void Stop();
+	int32 GetNumActiveSubscriptions() const;
 
 	/**
 	 * Is the subsystem currently available to capture?
@@ -95,14 +124,21 @@ public:
 	 * Enable the use of the null capture
 	 */
 	UFUNCTION()
-	void EnableEmulation(EVoiceCaptureEmulationMode EmulationModeToUse, USoundWave* SoundWaveToUse, const FName& Tag);
+	void EnableEmulation(EVoiceCaptureEmulationMode EmulationModeToUse, USoundWave* SoundWaveToUse, const FName& Tag, const float SpeedToUse = 1.0f);
 
 	/**
 	 * Get read access to the latest voice data
 	 *
-	 * @return reference to the voice data
+	 * @return view of the voice data
 	 */
-	const TArray<uint8>& GetVoiceBuffer() const;
+	TArrayView<const uint8> GetVoiceBuffer() const;
+
+	/**
+	 * Get a shared reference to the block holding the latest voice data. Consumers can hold on to the block without copying it
+	 *
+	 * @return the block or an invalid reference if no data has been read
+	 */
+	const FVoiceAudioBlockRef& GetVoiceBlock() const;
 	
 	/** The sample rate of the captured voice data. UE4 by default captures at 8k. Changing this rate may cause it not to function correctly */
 	const int32 SampleRate{16000};
@@ -136,6 +172,11 @@ private:
 	  * Create the emulation voice capture
 	  */
 	void CreateEmulationVoiceCapture();
+
+	/**
+	  * Create the pool of blocks that voice data is read into
+	  */
+	void CreateVoiceBlockPool();
 	
 	/** UE4's voice capture implementation */
 	TSharedPtr<class IVoiceCapture> VoiceCapture{};
@@ -143,8 +184,20 @@ private:
 	/** The size in bytes of the internal buffer we use for storing voice data */
 	int32 MaxBufferSize{0};
 
-	/** Buffer that stores the captured voice data */
-	TArray<uint8> VoiceBuffer{};
+	/** Pool of blocks that captured voice data is read into. Each block holds up to MaxBufferSize bytes */
+	TSharedPtr<FVoiceAudioBlockPool, ESPMode::ThreadSafe> VoiceBlockPool{};
+
+	/** Block that holds the most recently captured voice data */
+	FVoiceAudioBlockRef VoiceBlock{};
+
+	/** Every consumer of the voice capture */
+	TArray<TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe>> Subscriptions{};
+
+	/** The frame on which the voice capture was last read */
+	uint64 LastReadFrameNumber{MAX_uint64};
+
+	/** Was any voice data read on the last read frame? */
+	bool bWasDataReadOnLastFrame{false};
 
 	/** Allow the use of emulation if unable to initialise mic input */
 	EVoiceCaptureEmulationMode EmulationCaptureMode{EVoiceCaptureEmulationMode::None};
@@ -156,4 +209,7 @@ private:
 	/** Set Tag for TTS speaker which is used to create sound wave from TTS to use with the null capture */
 	UPROPERTY()
 	FName TtsExperienceTag{};
+
+	/** Playback speed of the null capture relative to realtime */
+	float EmulationCaptureSpeed{1.0f};
 };
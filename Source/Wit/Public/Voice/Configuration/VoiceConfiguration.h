@@ -23,6 +23,33 @@ enum class EVoiceCaptureEmulationMode : uint8
 	// OnMicFail
 };
 
+/**
+ * A phrase recognized locally from the partial transcriptions and the result it produces
+ */
+USTRUCT(BlueprintType)
+struct WIT_API FVoiceLocalGrammarPhrase
+{
+	GENERATED_BODY()
+
+	/**
+	 * The phrase to recognize. Case and punctuation are ignored
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Local Grammar")
+	FString Phrase{};
+
+	/**
+	 * The intent produced when the phrase is recognized
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Local Grammar")
+	FString IntentName{};
+
+	/**
+	 * The entities produced when the phrase is recognized. Keys are the entity name in name:role form and values are the entity value
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Local Grammar")
+	TMap<FString, FString> Entities{};
+};
+
 /**
  * Voice configuration for /speech endpoint of Wit.ai.
  */
@@ -70,8 +97,162 @@ struct WIT_API FVoiceConfiguration
 	float MaximumRecordingTime{20.0f};
 
 	/**
-	 * If set to true this will record the voice input and write it to a named wav file for debugging. The output file will be written to
-	 * the project folder's Saved/BouncedWavFiles folder as Wit/RecordedVoiceInput.wav
+	 * If set to true then long stretches of silence in the middle of an utterance will be collapsed before being streamed to Wit.ai.
+	 * This reduces the amount of data sent during long dictation sessions
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Silence Suppression")
+	bool bIsSilenceSuppressionEnabled{false};
+
+	/**
+	 * Voice input below this volume is considered to be silence for the purposes of suppression
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Silence Suppression", meta=(ClampMin = 0, ClampMax = 1, EditCondition = "bIsSilenceSuppressionEnabled"))
+	float SilenceSuppressionMaximumVolume{0.02f};
+
+	/**
+	 * Silence is streamed unchanged until it lasts this long. Any further silence is dropped until voice input resumes
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Silence Suppression", meta=(ClampMin = 0, ClampMax = 10, EditCondition = "bIsSilenceSuppressionEnabled"))
+	float SilenceSuppressionMinimumTime{0.5f};
+
+	/**
+	 * The duration of the comfort silence inserted when voice input resumes after silence has been dropped. This keeps the
+	 * timing between words plausible for the recognizer
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Silence Suppression", meta=(ClampMin = 0, ClampMax = 1, EditCondition = "bIsSilenceSuppressionEnabled"))
+	float SilenceSuppressionComfortTime{0.1f};
+
+	/**
+	 * If set to true then stationary background noise is removed from the voice input before it is streamed to Wit.ai
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Processing")
+	bool bIsNoiseSuppressionEnabled{false};
+
+	/**
+	 * How aggressively the estimated background noise is removed. Higher values remove more noise but may distort the voice
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Processing", meta=(ClampMin = 0, ClampMax = 4, EditCondition = "bIsNoiseSuppressionEnabled"))
+	float NoiseSuppressionStrength{1.5f};
+
+	/**
+	 * The minimum gain applied to any frequency when removing noise. Keeping a little of the noise reduces audible artifacts
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Processing", meta=(ClampMin = 0, ClampMax = 1, EditCondition = "bIsNoiseSuppressionEnabled"))
+	float NoiseSuppressionMinimumGain{0.1f};
+
+	/**
+	 * If set to true then the volume of the voice input is automatically adjusted towards the target volume before it is streamed to Wit.ai
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Processing")
+	bool bIsAutomaticGainControlEnabled{false};
+
+	/**
+	 * The average (RMS) volume that automatic gain control tries to achieve
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Processing", meta=(ClampMin = 0.01, ClampMax = 1, EditCondition = "bIsAutomaticGainControlEnabled"))
+	float AutomaticGainControlTargetVolume{0.1f};
+
+	/**
+	 * The maximum amount by which automatic gain control may amplify the voice input
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Processing", meta=(ClampMin = 1, ClampMax = 32, EditCondition = "bIsAutomaticGainControlEnabled"))
+	float AutomaticGainControlMaximumGain{8.0f};
+
+	/**
+	 * If set to true a request is committed as soon as its partial responses are stable rather than waiting for the trailing silence
+	 * and the final response. The most recent partial response is used as the final response and the request is cancelled
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Early Commit")
+	bool bIsEarlyCommitEnabled{false};
+
+	/**
+	 * The number of successive partial responses that must have the same top intent and required entity values before committing
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Early Commit", meta=(ClampMin = 1, ClampMax = 20, EditCondition = "bIsEarlyCommitEnabled"))
+	int32 EarlyCommitStablePartialResponses{3};
+
+	/**
+	 * The confidence the top intent must exceed in each of those partial responses
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Early Commit", meta=(ClampMin = 0, ClampMax = 1, EditCondition = "bIsEarlyCommitEnabled"))
+	float EarlyCommitIntentConfidenceThreshold{0.8f};
+
+	/**
+	 * The intents that can be committed early. If empty then any intent can be
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Early Commit", meta=(EditCondition = "bIsEarlyCommitEnabled"))
+	TArray<FString> EarlyCommitIntentNames{};
+
+	/**
+	 * The entities (in name:role form) that must be present with unchanged values in each of those partial responses
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Early Commit", meta=(EditCondition = "bIsEarlyCommitEnabled"))
+	TArray<FString> EarlyCommitRequiredEntityNames{};
+
+	/**
+	 * If set to true each partial transcription is checked against the local grammar phrases. When a transcription exactly matches
+	 * a phrase that no longer phrase begins with, the phrase's intent and entities are produced immediately without waiting for Wit.ai
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Local Grammar")
+	bool bIsLocalGrammarEnabled{false};
+
+	/**
+	 * The phrases to recognize locally. These are intended for a small set of frequent commands
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Local Grammar", meta=(EditCondition = "bIsLocalGrammarEnabled"))
+	TArray<FVoiceLocalGrammarPhrase> LocalGrammarPhrases{};
+
+	/**
+	 * If set to true the request is cancelled when a phrase is recognized and the local result is used as the final response. Otherwise
+	 * the local result is sent as a partial response and the request continues
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Local Grammar", meta=(EditCondition = "bIsLocalGrammarEnabled"))
+	bool bShouldLocalGrammarCancelRequest{true};
+
+	/**
+	 * If set to true the keywords and synonyms of the app's keyword entities are searched for in each partial transcription and any found
+	 * are sent to OnPartialKeywordEntities. The app's entities must have been refreshed in the configuration to include their keywords
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Local Grammar")
+	bool bIsKeywordExtractionEnabled{false};
+
+	/**
+	 * If set to true partial transcriptions and partial responses are delivered at most once per frame and once per coalescing interval.
+	 * Partials that arrive in between are held back and only the latest is delivered. The number dropped is reported in the voice events
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Partial Coalescing")
+	bool bIsPartialCoalescingEnabled{false};
+
+	/**
+	 * The minimum time in seconds between delivered partials. Zero limits delivery to once per frame only
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Partial Coalescing", meta=(ClampMin = 0, ClampMax = 2, EditCondition = "bIsPartialCoalescingEnabled"))
+	float PartialCoalescingInterval{0.0f};
+
+	/**
+	 * If set to true a /message request is made for the partial transcription once it has been unchanged for a short time while the speech
+	 * request continues. If the final transcription matches, the /message response is used as the final response without waiting for the
+	 * speech request to finish understanding. Not used with continuous streaming
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speculative Understanding")
+	bool bIsSpeculativeUnderstandingEnabled{false};
+
+	/**
+	 * How long in seconds the partial transcription must be unchanged before a speculative request is made
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speculative Understanding", meta=(ClampMin = 0, ClampMax = 2, EditCondition = "bIsSpeculativeUnderstandingEnabled"))
+	float SpeculativeUnderstandingStableTime{0.25f};
+
+	/**
+	 * The maximum number of speculative requests made for each speech request. A new speculation replaces the previous one
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speculative Understanding", meta=(ClampMin = 1, ClampMax = 10, EditCondition = "bIsSpeculativeUnderstandingEnabled"))
+	int32 SpeculativeUnderstandingMaximumRequests{2};
+
+	/**
+	 * If set to true this will record the voice input and write it to a named wav file for debugging. The recording is streamed to disk in the
+	 * background as it is captured and each activation is written to the project folder's Saved/BouncedWavFiles folder as
+	 * Wit/RecordedVoiceInput_<timestamp>.wav
 	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
 	bool bIsWavFileRecordingEnabled{false};
@@ -87,6 +268,14 @@ struct WIT_API FVoiceConfiguration
 	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
 	USoundWave* EmulationCaptureSoundWave{};
+
+	/**
+	 * The playback speed of emulated voice capture relative to realtime. Higher values allow automated tests to push many
+	 * utterances quickly. Zero plays back as fast as the voice capture is read
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug", meta=(ClampMin = 0))
+	float EmulationCaptureSpeed{1.0f};
+
 	/**
 	 * If set then the TtsExperience's response will be used for null voice capture
 	 */
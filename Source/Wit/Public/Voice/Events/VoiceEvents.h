@@ -9,6 +9,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Voice/Matcher/VoiceResponseMatcherRegistry.h"
 #include "Wit/Request/WitResponse.h"
 #include "Wit/Request/WitRequestConfiguration.h"
 #include "VoiceEvents.generated.h"
@@ -16,6 +17,8 @@
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnWitEventDelegate);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnWitTranscriptionDelegate, const FString&, Transcription);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWitResponseDelegate, const bool, bIsSuccessful, const FWitResponse&, WitResponse);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWitResponseChangesDelegate, const FWitResponse&, WitResponse, int32, Changes);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnWitKeywordEntitiesDelegate, const TArray<FWitEntity>&, Entities);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWitErrorDelegate, const FString&, ErrorMessage, const FString&, HumanReadableMessage);
 DECLARE_DELEGATE_OneParam(FOnWitRequestCustomizeDelegate, FWitRequestConfiguration&);
 
@@ -36,6 +39,20 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Transient, Category = "Voice")
 	FWitResponse WitResponse{};
 
+	/**
+	 * The sections of WitResponse that changed with the most recent partial response as a mask of EWitResponseChange flags. Every
+	 * partial response is broadcast so listeners can use this to skip work when nothing they care about changed
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "Voice", meta = (Bitmask, BitmaskEnum = "EWitResponseChange"))
+	int32 WitResponseChanges{0};
+
+	/**
+	 * The number of partial transcriptions and partial responses of the current request that were dropped by partial coalescing because
+	 * a later one superseded them before they were delivered
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Transient, Category = "Voice")
+	int32 NumDroppedPartials{0};
+
 	/**
 	 * Callback to call when a Wit request has been fully processed. The callback receives the full WitResponse
 	 * which can be used to do any required processing
@@ -49,6 +66,13 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnWitResponseDelegate OnWitPartialResponse{};
 
+	/**
+	 * Callback to call whenever a partial Response is received from VoiceService along with the mask of EWitResponseChange flags
+	 * for the sections that changed since the previous partial Response. The mask is zero if nothing changed
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnWitResponseChangesDelegate OnWitPartialResponseChanges{};
+
 	/**
 	 * Callback to call when there is a Wit error 
 	 */
@@ -66,6 +90,20 @@ public:
 	 */
 	UPROPERTY(BlueprintAssignable)
 	FOnWitTranscriptionDelegate OnFullTranscription{};
+
+	/**
+	 * Callback to call as soon as the speech request reports its final transcription. This is before Wit.ai has finished
+	 * understanding it and so before OnFullTranscription
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnWitTranscriptionDelegate OnFinalTranscription{};
+
+	/**
+	 * Callback to call whenever the keyword entities found locally in the partial transcription change. This is called before Wit.ai
+	 * has understood the transcription so games can react to entity mentions mid-utterance
+	 */
+	UPROPERTY(BlueprintAssignable)
+	FOnWitKeywordEntitiesDelegate OnPartialKeywordEntities{};
 	
 	/**
 	 * Called when voice capture starts capturing voice data
@@ -109,4 +147,10 @@ public:
 	 */
 	FOnWitRequestCustomizeDelegate OnRequestCustomize{};
 
+	/**
+	 * The response matchers listening to these events. Responses are passed only to the matchers that might match them
+	 * rather than every matcher being bound to OnWitResponse
+	 */
+	FVoiceResponseMatcherRegistry MatcherRegistry{};
+
 };
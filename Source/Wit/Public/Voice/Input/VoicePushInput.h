@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FVoiceAudioBlockPool;
+class FVoiceCaptureSubscription;
+
+/**
+ * The sample formats that can be pushed
+ */
+enum class EVoicePushSampleFormat : uint8
+{
+	Int16,
+	Float32
+};
+
+/**
+ * Describes the PCM data that will be pushed. Channels are interleaved
+ */
+struct WIT_API FVoicePushFormat
+{
+	/** The sample rate of the pushed data */
+	int32 SampleRate{16000};
+
+	/** The number of interleaved channels in the pushed data */
+	int32 NumChannels{1};
+
+	/** The format of each sample */
+	EVoicePushSampleFormat SampleFormat{EVoicePushSampleFormat::Int16};
+};
+
+/**
+ * A source of voice input that is fed by pushing PCM data rather than capturing from a microphone. Data can be pushed from
+ * any thread, for example decoded VOIP packets on a dedicated server or a prerecorded corpus. Pushed data is converted to
+ * the 16-bit 16kHz mono format that Wit.ai expects and is queued until a voice service streams it
+ */
+class WIT_API FVoicePushInput final
+{
+public:
+
+	/** The smallest and largest sample rates we accept */
+	static constexpr int32 MinimumSampleRate = 8000;
+	static constexpr int32 MaximumSampleRate = 48000;
+
+	/** The largest number of channels we accept */
+	static constexpr int32 MaximumNumChannels = 8;
+
+	/**
+	 * Create a push input. The requested format is negotiated to the nearest format we support
+	 *
+	 * @param RequestedFormat [in] the format the caller would like to push
+	 * @return the push input. Use GetFormat to find the format that must actually be pushed
+	 */
+	static TSharedRef<FVoicePushInput, ESPMode::ThreadSafe> Create(const FVoicePushFormat& RequestedFormat);
+
+	/**
+	 * Negotiate a format against what we support
+	 *
+	 * @param RequestedFormat [in] the format the caller would like to push
+	 * @param OutFormat [out] the nearest supported format
+	 * @return true if the requested format is supported as is
+	 */
+	static bool NegotiateFormat(const FVoicePushFormat& RequestedFormat, FVoicePushFormat& OutFormat);
+
+	explicit FVoicePushInput(const FVoicePushFormat& InFormat);
+	~FVoicePushInput();
+
+	/**
+	 * Push interleaved 16-bit samples. Can be called from any thread
+	 *
+	 * @param Samples [in] the samples to push. Must be a whole number of frames
+	 * @param Timestamp [in] the time in seconds of the first frame relative to the start of the stream or a negative value if unknown
+	 * @return true if the samples were accepted
+	 */
+	bool Push(TArrayView<const int16> Samples, const double Timestamp = -1.0);
+
+	/**
+	 * Push interleaved floating point samples in the range [-1,1]. Can be called from any thread
+	 *
+	 * @param Samples [in] the samples to push. Must be a whole number of frames
+	 * @param Timestamp [in] the time in seconds of the first frame relative to the start of the stream or a negative value if unknown
+	 * @return true if the samples were accepted
+	 */
+	bool Push(TArrayView<const float> Samples, const double Timestamp = -1.0);
+
+	/**
+	 * Indicate that no more data will be pushed. The voice service deactivates once all pushed data has been streamed
+	 */
+	void EndOfStream();
+
+	/**
+	 * Has the end of the stream been reached?
+	 *
+	 * @return true if EndOfStream has been called
+	 */
+	bool IsEndOfStream() const;
+
+	/**
+	 * Get the format that must be pushed
+	 *
+	 * @return the negotiated format
+	 */
+	const FVoicePushFormat& GetFormat() const;
+
+	/**
+	 * Get the amplitude of the most recently pushed data
+	 *
+	 * @return the amplitude in the range [0,1]
+	 */
+	float GetCurrentAmplitude() const;
+
+	/**
+	 * Get the stream time in seconds of the end of the most recently pushed data
+	 *
+	 * @return the time in seconds
+	 */
+	double GetStreamTime() const;
+
+	/**
+	 * Get the queue that converted voice data is delivered to. Used by the voice service to stream the data
+	 *
+	 * @return the subscription
+	 */
+	TSharedRef<FVoiceCaptureSubscription, ESPMode::ThreadSafe> GetSubscription() const;
+
+private:
+
+	/** Design the low pass filter used to prevent aliasing when downsampling */
+	void CreateLowPassFilter();
+
+	/** Push mono floating point frames that have already been downmixed */
+	void PushMono(const float* Frames, const int32 NumFrames, const double Timestamp);
+
+	/** Resample, convert and queue mono floating point frames */
+	void WriteMono(const float* Frames, const int32 NumFrames);
+
+	/** Queue the given number of frames of silence at the output sample rate */
+	void WriteSilence(const int32 NumOutputFrames);
+
+	/** Queue output samples. The samples are split across as many blocks as needed */
+	void WriteOutput(const int16* Samples, const int32 NumSamples);
+
+	/** The negotiated format */
+	const FVoicePushFormat Format{};
+
+	/** Has the end of the stream been reached? */
+	bool bIsEndOfStream{false};
+
+	/** The amplitude of the most recently pushed data */
+	float CurrentAmplitude{0.0f};
+
+	/** The stream time in seconds of the end of the most recently pushed data */
+	double StreamTime{0.0};
+
+	/** The resampler read position in input frames relative to the start of the current push */
+	double ResamplePosition{0.0};
+
+	/** The last input frame of the previous push. Used to interpolate across push boundaries */
+	float PreviousFrame{0.0f};
+
+	/** The low pass filter applied before downsampling. Empty if the pushed data is not downsampled */
+	TArray<float> LowPassTaps{};
+
+	/** The last input frames of the previous push that the low pass filter still needs */
+	TArray<float> LowPassHistory{};
+
+	/** Scratch space used for downmixing, filtering and resampling */
+	TArray<float> MonoFrames{};
+	TArray<float> FilterInput{};
+	TArray<float> FilteredFrames{};
+	TArray<int16> OutputSamples{};
+
+	/** The pool that converted data is written to */
+	TSharedPtr<FVoiceAudioBlockPool, ESPMode::ThreadSafe> BlockPool{};
+
+	/** The queue that converted data is delivered to */
+	TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe> Subscription{};
+
+	/** Serializes pushes from multiple threads */
+	mutable FCriticalSection CriticalSection{};
+};
@@ -62,5 +62,17 @@ public:
 	 * @param Response [in] the full response as a UStruct
 	 */
 	virtual void OnWitResponse(const bool bIsSuccessful, const FWitResponse& Response) override;
+
+	/**
+	 * The intent that a response must have as its top intent for this matcher to match
+	 *
+	 * @return the intent name
+	 */
+	virtual FString GetRequiredIntentName() const override;
+
+protected:
+
+	/** The sections of a response that this matcher uses. Only the intents are needed */
+	virtual EWitResponseChange GetRelevantResponseChanges() const override;
 	
 };
@@ -100,4 +100,11 @@ public:
 	 */
 	virtual void OnWitResponse(const bool bIsSuccessful, const FWitResponse& Response) override;
 
+	/**
+	 * The intent that a response must have as its top intent for this matcher to match
+	 *
+	 * @return the intent name or empty if the intent is not required
+	 */
+	virtual FString GetRequiredIntentName() const override;
+
 };
@@ -94,5 +94,12 @@ public:
 	 * @param Response [in] the full response as a UStruct
 	 */
 	virtual void OnWitResponse(const bool bIsSuccessful, const FWitResponse& Response) override;
+
+	/**
+	 * The intent that a response must have as its top intent for this matcher to match
+	 *
+	 * @return the intent name or empty if the intent is not required
+	 */
+	virtual FString GetRequiredIntentName() const override;
 	
 };
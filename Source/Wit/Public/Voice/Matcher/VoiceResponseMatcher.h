@@ -13,6 +13,8 @@
 #include "Wit/Request/WitResponse.h"
 #include "VoiceResponseMatcher.generated.h"
 
+class UVoiceEvents;
+
 /**
  * Base class for all response matchers. Implements shared functionality
  */
@@ -68,12 +70,48 @@ public:
 	UFUNCTION()
 	virtual void OnWitResponse(const bool bIsSuccessful, const FWitResponse& Response) {};
 
+	/**
+	 * Callback that is called when a Wit.ai partial response is received. Partial responses are only passed on to OnWitResponse
+	 * if a section of the response that the matcher uses has changed
+	 * 
+	 * @param bIsSuccessful [in] true if the response was successful
+	 * @param Response [in] the partial response as a UStruct
+	 */
+	UFUNCTION()
+	void OnWitPartialResponse(const bool bIsSuccessful, const FWitResponse& Response);
+
+	/**
+	 * Re-register this matcher with its voice experience. Matchers are indexed by the intent they require when play starts
+	 * so this must be called after changing the intent or whether it is required at runtime
+	 */
+	UFUNCTION(BlueprintCallable, Category="Matcher")
+	void UpdateRegistration();
+
+	/**
+	 * The intent that a response must have as its top intent for this matcher to match. Matchers that return a name are
+	 * only passed responses whose top intent has that name
+	 *
+	 * @return the intent name or empty if the matcher must see every response
+	 */
+	virtual FString GetRequiredIntentName() const;
+
 protected:
 	
 	/** Called when play is started */
 	virtual void BeginPlay() override;
 
+	/** Called when play ends */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** Called to check and response to partial responses */
 	void AcceptPartialResponse(const FWitResponse& Response);
 
+	/** The sections of a response that this matcher uses. By default this is the intents and entities */
+	virtual EWitResponseChange GetRelevantResponseChanges() const;
+
+private:
+
+	/** The events that this matcher is registered with */
+	TWeakObjectPtr<UVoiceEvents> VoiceEvents{};
+
 };
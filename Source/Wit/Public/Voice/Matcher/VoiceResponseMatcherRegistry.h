@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UVoiceResponseMatcher;
+struct FWitResponse;
+
+/**
+ * Dispatches responses to the matchers registered with a voice experience. Matchers that require an intent are indexed
+ * by its name so a response is only passed to the matchers whose intent is the top intent in the response plus any
+ * matchers that cannot be indexed. This keeps the cost of each response proportional to the number of matchers that can
+ * actually match rather than the number of matchers in the level
+ */
+class WIT_API FVoiceResponseMatcherRegistry
+{
+public:
+
+	/**
+	 * Register a matcher. If the matcher is already registered it is re-indexed so this can also be used after changing
+	 * the intent the matcher requires
+	 *
+	 * @param Matcher [in] the matcher to register
+	 */
+	void Register(UVoiceResponseMatcher* Matcher);
+
+	/**
+	 * Unregister a matcher
+	 *
+	 * @param Matcher [in] the matcher to unregister
+	 */
+	void Unregister(UVoiceResponseMatcher* Matcher);
+
+	/**
+	 * Pass a final response to the candidate matchers
+	 *
+	 * @param bIsSuccessful [in] true if the response was successful
+	 * @param Response [in] the response
+	 */
+	void DispatchResponse(const bool bIsSuccessful, const FWitResponse& Response);
+
+	/**
+	 * Pass a partial response to the candidate matchers that are also used for partial responses
+	 *
+	 * @param bIsSuccessful [in] true if the response was successful
+	 * @param Response [in] the partial response
+	 */
+	void DispatchPartialResponse(const bool bIsSuccessful, const FWitResponse& Response);
+
+	/**
+	 * Get the number of registered matchers
+	 *
+	 * @return the number of matchers
+	 */
+	int32 Num() const;
+
+private:
+
+	/**
+	 * Gather the matchers that might match the given response. The matchers are copied because matching can cause
+	 * further responses to be dispatched or matchers to be registered
+	 */
+	void GatherCandidates(const bool bIsSuccessful, const FWitResponse& Response, TArray<TWeakObjectPtr<UVoiceResponseMatcher>>& OutCandidates) const;
+
+	/** Matchers that require an intent indexed by the interned intent name */
+	TMap<FName, TArray<TWeakObjectPtr<UVoiceResponseMatcher>>> MatchersByIntentName{};
+
+	/** Matchers that do not require an intent so must see every response */
+	TArray<TWeakObjectPtr<UVoiceResponseMatcher>> UnindexedMatchers{};
+
+	/** The intent name each registered matcher was indexed by. None for unindexed matchers */
+	TMap<TObjectKey<UVoiceResponseMatcher>, FName> RegisteredIntentNames{};
+};
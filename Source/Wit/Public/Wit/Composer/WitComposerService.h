@@ -14,8 +14,11 @@
 #include "Composer/Handlers/Action/ComposerActionHandler.h"
 #include "Composer/Handlers/Speech/ComposerSpeechHandler.h"
 #include "Voice/Experience/VoiceExperience.h"
+#include "Wit/Voice/WitSpeculativeUnderstanding.h"
 #include "WitComposerService.generated.h"
 
+class FWitRequest;
+
 /**
  * Component that encapsulates the Wit Composer API. Provides functionality for making complex interactive experiences
  */
@@ -76,6 +79,14 @@ public:
 	UFUNCTION(BlueprintGetter, Category = "Composer|ContextMap")
 	UComposerContextMap* GetContextMap() const { return CurrentContextMap; }
 
+	/**
+	 * Get the fraction of voice turns with a prefetch where the prefetched response was used
+	 *
+	 * @return the hit rate in the range 0 to 1
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Composer|Prefetch")
+	float GetSpeculativePrefetchHitRate() const;
+
 protected:
 
 	virtual void BeginPlay() override;
@@ -107,6 +118,36 @@ private:
 	/** Are we allowed to continue after an action/speech? */
 	bool CanContinue() const;
 
+	/** Prefetch the turn if the partial transcription has been stable for long enough */
+	void UpdatePrefetch();
+
+	/** Send the given transcription to the composer event endpoint with the turn's session and context map */
+	void StartPrefetchRequest(const FString& Transcription);
+
+	/** Cancel the prefetch request if there is one */
+	void CancelPrefetchRequest();
+
+	/** Give up on the current turn's prefetch */
+	void EndPrefetchTurn();
+
+	/** Use the prefetched response in place of the speech request's response */
+	void AcceptPrefetch();
+
+	/** Called when a prefetch request completes */
+	void OnPrefetchRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response,
+		const uint32 SpeculationId);
+
+	/** Called when a prefetch request errors */
+	void OnPrefetchRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const uint32 SpeculationId);
+
+	/** Callbacks that we will connect to the voice events */
+
+	UFUNCTION()
+	void OnPrefetchPartialTranscription(const FString& Transcription);
+
+	UFUNCTION()
+	void OnPrefetchFinalTranscription(const FString& Transcription);
+
 	/** Unique session id for the current session */
 	FString SessionId{};
 
@@ -125,6 +166,24 @@ private:
 	/** Count down delay timer after continue is allowed */
 	float ContinueDelayTimer{0.0f};
 
+	/** Decides when to prefetch the current voice turn and whether the prefetch can be used */
+	FWitSpeculativeUnderstanding SpeculativePrefetch{};
+
+	/** The prefetch request for the current voice turn if any */
+	TSharedPtr<FWitRequest, ESPMode::ThreadSafe> PrefetchRequest{};
+
+	/** Is a voice turn routed to composer in progress? */
+	bool bIsPrefetchTurnActive{false};
+
+	/** The encoded context map sent with the current voice turn so that the prefetch matches it */
+	FString PrefetchContextMap{};
+
+	/** The raw prefetched response */
+	TArray<uint8> PrefetchBinaryResponse{};
+
+	/** The prefetched response as Json */
+	TSharedPtr<FJsonObject> PrefetchJsonResponse{};
+
 	/**
 	 * The voice experience that composer will use
 	 */
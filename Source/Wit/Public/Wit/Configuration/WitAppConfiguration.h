@@ -37,6 +37,36 @@ struct WIT_API FWitAppAdvancedConfiguration
 	/** Custom request timeout in seconds. This is only used if bIsCustomHttpTimeout is set to true */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Overrides", meta=(ClampMin = 1, ClampMax = 180))
 	float HttpTimeout{180.0f};
+
+	/**
+	 * Time in seconds after a voice, TTS or composer request has finished sending by which its response must arrive. Requests that miss
+	 * it are cancelled and fail with a deadline error rather than delivering a stale result. Zero for no deadline
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Overrides", meta=(ClampMin = 0, ClampMax = 180))
+	float ResponseDeadline{0.0f};
+
+	/**
+	 * Should responses to text sent with SendTranscription be cached? Repeated text is then answered locally and immediately without a request.
+	 * Text is normalized by ignoring case and surrounding or repeated whitespace
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Response Cache")
+	bool bIsMessageCacheEnabled{false};
+
+	/** How long in seconds a cached response remains valid. Zero means cached responses never expire */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Response Cache", meta=(ClampMin = 0, EditCondition = "bIsMessageCacheEnabled"))
+	float MessageCacheTimeToLive{3600.0f};
+
+	/** The maximum number of cached responses. The least recently used response is discarded when the cache is full */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Response Cache", meta=(ClampMin = 1, ClampMax = 100000, EditCondition = "bIsMessageCacheEnabled"))
+	int32 MessageCacheMaximumEntries{256};
+
+	/** Should the cache be saved to the project's Saved folder so it is available between runs? */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Response Cache", meta=(EditCondition = "bIsMessageCacheEnabled"))
+	bool bIsMessageCachePersistent{false};
+
+	/** The version of the app's training. Change this whenever the app is retrained so that responses cached for the earlier version are not used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Response Cache", meta=(EditCondition = "bIsMessageCacheEnabled"))
+	FString MessageCacheAppVersion{};
 	
 };
 
@@ -48,6 +48,9 @@ protected:
 
 private:
 
+	/** Pass the continuous dictation settings on to the voice service */
+	void ConfigureContinuousDictation() const;
+
 	/** Callback to redirect the speech endpoint to the dictation equivalent */
 	void OnDictationRequestCustomize(FWitRequestConfiguration& RequestConfiguration);
 
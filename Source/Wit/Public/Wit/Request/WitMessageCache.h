@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWitAppConfiguration;
+struct FWitResponse;
+
+/**
+ * A local cache of /message responses keyed by normalized text, the app and its version and the API version. Responses are
+ * kept as their original response body and decoded when they are found. Entries expire after a configurable time and the
+ * least recently used entry is discarded when the cache is full. The cache can optionally be saved to disk so that it is
+ * available between runs. Each app and version is saved to its own file and entries saved by other instances are merged
+ * rather than overwritten. Only successful responses should be added
+ */
+class WIT_API FWitMessageCache
+{
+public:
+
+	/**
+	 * Apply the cache settings from the given configuration. This loads the cache from disk the first time a persistent
+	 * cache is configured
+	 *
+	 * @param Configuration [in] the app configuration
+	 */
+	void Configure(const FWitAppConfiguration& Configuration);
+
+	/**
+	 * Is the cache enabled?
+	 *
+	 * @return true if enabled
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * Find the cached response for the given text
+	 *
+	 * @param Text [in] the text that was sent
+	 * @param OutResponse [out] the cached response
+	 * @return true if a valid response was found
+	 */
+	bool Find(const FString& Text, FWitResponse& OutResponse);
+
+	/**
+	 * Add the response for the given text to the cache. A persistent cache is saved periodically as responses are added
+	 *
+	 * @param Text [in] the text that was sent
+	 * @param ResponseBody [in] the body of the response
+	 */
+	void Add(const FString& Text, const TArray<uint8>& ResponseBody);
+
+	/**
+	 * Remove every cached response
+	 */
+	void Empty();
+
+	/**
+	 * Save the cache to disk if it is persistent and has changed
+	 */
+	void Save();
+
+	/**
+	 * Normalize text for use as a cache key. Case is ignored and whitespace is trimmed and collapsed
+	 *
+	 * @param Text [in] the text to normalize
+	 * @return the normalized text
+	 */
+	static FString NormalizeText(const FString& Text);
+
+private:
+
+	/** A single cached response */
+	struct FEntry
+	{
+		/** The body of the response */
+		TArray<uint8> ResponseBody{};
+
+		/** When the response was received */
+		FDateTime CreationTime{};
+
+		/** When the entry was last used relative to other entries */
+		uint64 LastUseCount{0};
+	};
+
+	/** Make the key for the given text */
+	FString MakeKey(const FString& Text) const;
+
+	/** Has the given entry expired? */
+	bool IsExpired(const FEntry& Entry, const FDateTime& Now) const;
+
+	/** Discard the least recently used entries until the cache is within its size limit */
+	void Trim();
+
+	/** Load the cache from disk */
+	void Load();
+
+	/** Merge the entries saved on disk into the cache */
+	void Merge();
+
+	/** Get the path of the file the cache for the current app and version is saved to */
+	FString MakeFilePath() const;
+
+	/** The version of the cache file format */
+	static constexpr int32 FileVersion{1};
+
+	/** The minimum time in seconds between saves as responses are added */
+	static constexpr double SaveInterval{10.0};
+
+	/** The cached responses */
+	TMap<FString, FEntry> Entries{};
+
+	/** Is the cache enabled? */
+	bool bIsEnabled{false};
+
+	/** Is the cache saved to disk? */
+	bool bIsPersistent{false};
+
+	/** Has the cache been loaded from disk? */
+	bool bHasLoaded{false};
+
+	/** Has the cache changed since it was last saved? */
+	bool bIsDirty{false};
+
+	/** How long in seconds a cached response remains valid. Zero for forever */
+	double TimeToLive{0.0};
+
+	/** The maximum number of cached responses */
+	int32 MaximumEntries{1};
+
+	/** Identifies the app, its version and the API version at the start of every key */
+	FString KeyPrefix{};
+
+	/** The path of the file the cache is saved to */
+	FString FilePath{};
+
+	/** When the cache was last saved */
+	double LastSaveTime{0.0};
+
+	/** Incremented on every use to order entries by when they were last used */
+	uint64 UseCount{0};
+};
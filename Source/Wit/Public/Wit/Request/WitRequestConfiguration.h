@@ -11,10 +11,14 @@
 #include "WitRequestConfiguration.generated.h"
 
 class FJsonObject;
+struct FWitResponse;
+struct FWitResponseChecksums;
 
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnWitRequestErrorDelegate, const FString&, const FString&);
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnWitRequestProgressDelegate, const TArray<uint8>&, const TSharedPtr<FJsonObject>);
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnWitRequestCompleteDelegate, const TArray<uint8>&, const TSharedPtr<FJsonObject>);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnWitRequestResponseDelegate, const TArray<uint8>&, const TSharedPtr<FJsonObject>, const FWitResponse&);
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnWitRequestProgressResponseDelegate, const TArray<uint8>&, const TSharedPtr<FJsonObject>, const FWitResponse&, const FWitResponseChecksums&);
 
 /**
  * A compact configuration for setting up a Wit.ai request. Use the methods in FWitRequestBuilder to construct this
@@ -58,10 +62,27 @@ struct WIT_API FWitRequestConfiguration
 
 	/** Optional callback to use when the request is in progress */
 	FOnWitRequestProgressDelegate OnRequestProgress{};
+
+	/**
+	 * Optional callback to use when the request is in progress with each partial response already converted to an FWitResponse off
+	 * the game thread along with checksums of its sections. The Json is null unless OnRequestProgress is also bound or
+	 * bShouldKeepJsonResponse is set
+	 */
+	FOnWitRequestProgressResponseDelegate OnRequestProgressWithResponse{};
 	
 	/** Optional callback to use when the request is complete */
 	FOnWitRequestCompleteDelegate OnRequestComplete{};
 
+	/**
+	 * Optional callback to use when the request is complete with the response already converted to an FWitResponse off the game
+	 * thread. Only successful responses are passed on and anything else is reported through OnRequestError. The Json is null
+	 * unless OnRequestComplete is also bound or bShouldKeepJsonResponse is set
+	 */
+	FOnWitRequestResponseDelegate OnRequestCompleteWithResponse{};
+
+	/** Should the callbacks with a converted response also be given it as Json? Parsing it costs more than converting the response */
+	bool bShouldKeepJsonResponse{false};
+
 	/** Tracks whether we should use the HTTP 1 chunked transfer protocol in the request */
 	bool bShouldUseChunkedTransfer{false};
 
@@ -70,4 +91,10 @@ struct WIT_API FWitRequestConfiguration
 
 	/** Custom timeout duration. This is only used if bShouldUseCustomHttpTimeout is true */
 	float HttpTimeout{180.0f};
+
+	/**
+	 * Optional time in seconds from finishing the request until its response must be complete. If it passes the request is
+	 * cancelled and fails with a deadline error. Unlike the HTTP timeout this does not include time spent streaming. Zero for no deadline
+	 */
+	float ResponseDeadline{0.0f};
 };
@@ -181,6 +181,56 @@ struct WIT_API FWitEntities
 
 };
 
+/**
+ * Flags describing which sections of a response changed when it was updated from a partial response
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EWitResponseChange : uint8
+{
+	None = 0 UMETA(Hidden),
+	Text = 1 << 0,
+	Intents = 1 << 1,
+	Entities = 1 << 2,
+	Traits = 1 << 3,
+	IsFinal = 1 << 4
+};
+
+ENUM_CLASS_FLAGS(EWitResponseChange);
+
+/**
+ * Checksums of the Json of each section of a decoded response. Comparing them with those of an earlier response tells which
+ * sections changed without comparing the decoded sections. A section that is not in the response has a checksum of zero.
+ * The decoder also records what kind of chunk it was so that streamed chunks can be handled without parsing them again
+ */
+struct WIT_API FWitResponseChecksums
+{
+	uint32 Text{0};
+	uint32 Intents{0};
+	uint32 Entities{0};
+	uint32 Traits{0};
+	uint32 IsFinal{0};
+
+	/** Were the checksums filled in when the response was decoded? */
+	bool bIsValid{false};
+
+	/** Did the response contain text? */
+	bool bHasText{false};
+
+	/** Did the response contain intents? Only understood responses do so this tells them apart from transcriptions */
+	bool bHasIntents{false};
+
+	/** Was the response typed as a final transcription? Some API versions mark final transcriptions this way rather than with is_final */
+	bool bIsFinalTranscription{false};
+
+	/**
+	 * Get the sections that differ from an earlier response. Every section is treated as changed if either set of checksums is not valid
+	 *
+	 * @param Previous [in] the checksums of the earlier response
+	 * @return the sections that changed
+	 */
+	EWitResponseChange GetChanges(const FWitResponseChecksums& Previous) const;
+};
+
 /**
  * Representation of the full JSON object used by Wit.ai responses. See the Wit.ai
  * documentation for the meaning of each specific field.
@@ -206,7 +256,12 @@ struct WIT_API FWitResponse
 	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voice Experience")
 	TMap<FString, FWitEntity> Entities{};
-	
+
+	/**
+	 * All the entities for each name. This is always filled in for final responses delivered through voice events, message
+	 * batches and file transcription. Partial responses and other decoded responses build it on first use so from C++ prefer
+	 * GetAllEntities or ForEachEntity to reading it directly
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voice Experience")
 	TMap<FString, FWitEntities> AllEntities{};
 
@@ -220,6 +275,31 @@ struct WIT_API FWitResponse
 	 * Reset the response to its defaults
 	 */
 	void Reset();
+
+	/**
+	 * Get all the entities for each name. If AllEntities has not been built yet it is built now
+	 *
+	 * @return all the entities
+	 */
+	const TMap<FString, FWitEntities>& GetAllEntities();
+
+	/**
+	 * Visit every entity with the given name in the order they appear in the response. This does not need AllEntities to
+	 * have been built
+	 *
+	 * @param Name [in] the entity name including the role
+	 * @param Visitor [in] called for each entity
+	 */
+	void ForEachEntity(const FString& Name, TFunctionRef<void(const FWitEntity&)> Visitor) const;
+
+	/**
+	 * The entities after the first for each name, keyed by interned name. Together with Entities these are all the entities
+	 * in the response while AllEntities has not been built
+	 */
+	TArray<TPair<FName, FWitEntity>> AdditionalEntities{};
+
+	/** Does AllEntities hold all the entities in the response? */
+	bool bIsAllEntitiesBuilt{true};
 };
 
 /**
@@ -295,6 +375,23 @@ struct WIT_API FWitEntityShortDefinition
 	int64 Id{0};
 };
 
+/**
+ * Representation of the JSON keyword object used by Wit.ai /entities/<entity_name> endpoint
+ */
+USTRUCT(BlueprintType)
+struct WIT_API FWitEntityKeyword
+{
+	GENERATED_BODY()
+
+	/** The canonical value of the keyword */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voice Experience")
+	FString Keyword{};
+
+	/** The phrases that resolve to the keyword */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voice Experience")
+	TArray<FString> Synonyms{};
+};
+
 /**
  * Representation of the JSON entity object used by Wit.ai /entities endpoint 
  */
@@ -318,6 +415,10 @@ struct WIT_API FWitEntityDefinition
 	/** The roles associated with this entity */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voice Experience")
 	TArray<FString> Roles{};
+
+	/** The keywords of a keywords entity. These are only available from the detailed /entities/<entity_name> endpoint */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voice Experience")
+	TArray<FWitEntityKeyword> Keywords{};
 };
 
 /**
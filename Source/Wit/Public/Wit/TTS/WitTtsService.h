@@ -52,19 +52,16 @@ public:
 	virtual bool IsRequestInProgress() const override;
 	virtual void ConvertTextToSpeech(const FString& TextToConvert, bool bQueueAudio = true) override;
 	virtual void ConvertTextToSpeechWithSettings(const FTtsConfiguration& ClipSettings, bool bQueueAudio = true) override;
+	virtual void StopSynthesis() override;
 	virtual void FetchAvailableVoices() override;
 
-#if WITH_EDITORONLY_DATA
-
 	/**
-	 * If set to true this will record the voice input and write it to a named wav file for debugging. The output file will be written to
-	 * the project folder's Saved/BouncedWavFiles folder as Wit/RecordedVoiceInput.wav
+	 * If set to true this will write each synthesized clip to a wav file for debugging. The output files will be written in the background to
+	 * the project folder's Saved/BouncedWavFiles folder as Wit/SynthesisOutput_<timestamp>.wav
 	 */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TTS|Debug")
 	bool bIsWavFileOutputEnabled{false};
 
-#endif
-
 protected:
 	
 	/** Called when the component is started */
@@ -97,8 +94,11 @@ private:
 	/** Previous data index used to process raw data */
 	int32 PreviousDataIndex{0};
 
-	/** Stop the request that is currently in progress */
-	bool bStopInProgressRequest;
+	/** Is a synthesize request made by this service in progress on the shared request? */
+	bool bIsSynthesizeRequestInProgress{false};
+
+	/** Incremented for each synthesize request and when one is cancelled so that callbacks for an earlier request are ignored */
+	uint32 SynthesizeGeneration{0};
 
 	/** Clip settings enqueued */
 	TArray<FTtsConfiguration> QueuedSettings;
@@ -106,13 +106,9 @@ private:
 	/** Current status of the WebSocket connection */
 	SocketState SocketStatus;
 
-#if WITH_EDITORONLY_DATA
-	
-	/** Write the captured voice input to a wav file */
+	/** Write the synthesized audio to a wav file */
 	static void WriteRawPCMDataToWavFile(const uint8* RawPCMData, const int32 RawPCMDataSize, const int32 NumChannels, const int32 SampleRate);
 
-#endif
-
 	/**
 	 * Sends a text string to Wit for conversion to speech with custom settings
 	 *
@@ -142,11 +138,17 @@ private:
 	/** Called when a storage cache request is fully completed to process the loaded data */
 	void OnStorageCacheRequestComplete(const TArray<uint8>& BinaryData, const FTtsConfiguration& ClipSettings) const;
 
+	/** Cancel the synthesize request made by this service if it is in progress */
+	void CancelSynthesizeRequest();
+
 	/** Called when a Wit synthesize request is fully completed to process the response payload */
-	void OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse);
+	void OnSynthesizeRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const uint32 Generation);
 
 	/** Called when a synthesize request errors */
-	void OnSynthesizeRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage) const;
+	void OnSynthesizeRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage, const uint32 Generation);
+
+	/** Report a synthesis error */
+	void BroadcastSynthesizeError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage) const;
 
 	/** Called when a Wit voices request is fully completed to process the response payload */
 	void OnVoicesRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse);
@@ -161,7 +163,7 @@ private:
 	FTtsConfiguration LastRequestedClipSettings{};
 
 	/** Called when a Wit synthesize request is in progress to process the incremental payload */
-	void OnSynthesizeRequestProgress(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse);
+	void OnSynthesizeRequestProgress(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const uint32 Generation);
 
 	/** Adds incremental raw data to the Procedural Sound Wave buffer queue */
 	void AddProceduralData(const uint8* RawData, const int32 RawDataSize, bool bShouldCheckSize);
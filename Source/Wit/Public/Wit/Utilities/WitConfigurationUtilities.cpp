@@ -7,8 +7,10 @@
 
 #include "WitConfigurationUtilities.h"
 #include "Engine/Engine.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
 #include "Wit/Request/WitRequestSubsystem.h"
 #include "Wit/Request/WitRequestBuilder.h"
+#include "Wit/Request/WitResponseDecoder.h"
 #include "Wit/Utilities/WitLog.h"
 #include "Wit/Utilities/WitHelperUtilities.h"
 #include "JsonObjectConverter.h"
@@ -279,7 +281,7 @@ void FWitConfigurationUtilities::OnEntitiesRequestComplete(const TArray<uint8>&
 	UE_LOG(LogWit, Verbose, TEXT("OnEntitiesRequestComplete - Final response size: %d"), BinaryResponse.Num());
 
 	// We can't use the Json object because it will only contain the final entry of the array. We therefore use the binary data and convert it as an array
-	// TODO - in Unity we actually grab the detailed entity data using /entities/<entity_name> 
+	// The keywords are not included in the list so they are filled in afterwards by requesting the details of each entity
 
 	const FUTF8ToTCHAR DataAsCharacters(reinterpret_cast<const ANSICHAR*>(BinaryResponse.GetData()), BinaryResponse.Num());
 	const FString JsonArrayString = FString(DataAsCharacters.Length(), DataAsCharacters.Get());
@@ -294,7 +296,7 @@ void FWitConfigurationUtilities::OnEntitiesRequestComplete(const TArray<uint8>&
 
 	UE_LOG(LogWit, Verbose, TEXT("OnEntitiesRequestComplete - Received entities: %d"), Configuration->Application.Data.Entities.Num());
 
-	RequestTraitList();
+	RequestEntityDetails(0);
 }
 
 /**
@@ -307,6 +309,110 @@ void FWitConfigurationUtilities::OnEntitiesRequestError(const FString& ErrorMess
 	RequestTraitList();
 }
 
+/**
+ * Requests the details of the next custom entity at or after the given index. The entity list does not include the keywords of
+ * keyword entities so each custom entity is requested in turn. Built-in entities have no keywords and are skipped
+ *
+ * @param StartIndex [in] the index of the first entity to consider
+ */
+void FWitConfigurationUtilities::RequestEntityDetails(const int32 StartIndex)
+{
+	const TArray<FWitEntityDefinition>& Entities = Configuration->Application.Data.Entities;
+
+	int32 Index = StartIndex;
+
+	while (Entities.IsValidIndex(Index) && Entities[Index].Name.StartsWith(TEXT("wit$")))
+	{
+		++Index;
+	}
+
+	if (!Entities.IsValidIndex(Index))
+	{
+		RequestTraitList();
+		return;
+	}
+
+	FWitRequestConfiguration RequestConfiguration{};
+
+	if (!SetupListRequest(RequestConfiguration, EWitRequestEndpoint::GetEntities, true))
+	{
+		Configuration = nullptr;
+		return;
+	}
+
+	// Fill in the resolved endpoint
+
+	RequestConfiguration.Endpoint = FString::Format(TEXT("entities/{0}"), {FGenericPlatformHttp::UrlEncode(Entities[Index].Name)});
+
+	RequestConfiguration.OnRequestError.AddStatic(&FWitConfigurationUtilities::OnEntityDetailsRequestError, Index);
+	RequestConfiguration.OnRequestComplete.AddStatic(&FWitConfigurationUtilities::OnEntityDetailsRequestComplete, Index);
+
+	UWitRequestSubsystem* RequestSubsystem = GEngine->GetEngineSubsystem<UWitRequestSubsystem>();
+
+	RequestSubsystem->BeginStreamRequest(RequestConfiguration);
+	RequestSubsystem->EndStreamRequest();
+}
+
+/**
+ * Called when a Wit entity details request is successfully completed. The response will contain the lookups and keywords of the entity
+ *
+ * @param BinaryResponse [in] the binary response
+ * @param JsonResponse [in] the Json response
+ * @param Index [in] the index of the entity
+ */
+void FWitConfigurationUtilities::OnEntityDetailsRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const int32 Index)
+{
+	UE_LOG(LogWit, Verbose, TEXT("OnEntityDetailsRequestComplete - Final response size: %d"), BinaryResponse.Num());
+
+	// Roles are objects in the detailed response rather than the strings of the list response so only the fields we need are read
+
+	FWitEntityDefinition& Entity = Configuration->Application.Data.Entities[Index];
+	const TArray<TSharedPtr<FJsonValue>>* KeywordValues = nullptr;
+
+	Entity.Keywords.Reset();
+
+	if (JsonResponse.IsValid())
+	{
+		JsonResponse->TryGetStringArrayField(TEXT("lookups"), Entity.Lookups);
+	}
+
+	if (JsonResponse.IsValid() && JsonResponse->TryGetArrayField(TEXT("keywords"), KeywordValues))
+	{
+		for (const TSharedPtr<FJsonValue>& KeywordValue : *KeywordValues)
+		{
+			const TSharedPtr<FJsonObject>* KeywordObject = nullptr;
+
+			if (!KeywordValue.IsValid() || !KeywordValue->TryGetObject(KeywordObject))
+			{
+				continue;
+			}
+
+			FWitEntityKeyword& Keyword = Entity.Keywords.AddDefaulted_GetRef();
+
+			(*KeywordObject)->TryGetStringField(TEXT("keyword"), Keyword.Keyword);
+			(*KeywordObject)->TryGetStringArrayField(TEXT("synonyms"), Keyword.Synonyms);
+		}
+	}
+
+	UE_LOG(LogWit, Verbose, TEXT("OnEntityDetailsRequestComplete - Received entity (%s) keywords: %d"), *Entity.Name, Entity.Keywords.Num());
+
+	RequestEntityDetails(Index + 1);
+}
+
+/**
+ * Called when an entity details request errors. The entity is left without keywords and the next entity is requested
+ *
+ * @param ErrorMessage [in] the error message
+ * @param HumanReadableErrorMessage [in] a longer human readable error message
+ * @param Index [in] the index of the entity
+ */
+void FWitConfigurationUtilities::OnEntityDetailsRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage, const int32 Index)
+{
+	UE_LOG(LogWit, Warning, TEXT("OnEntityDetailsRequestError - request failed with error: %s - %s"), *ErrorMessage, *HumanReadableErrorMessage);
+
+	RequestEntityDetails(Index + 1);
+}
+
 /**
  * Requests the available list of traits for an app
  */
@@ -395,7 +501,8 @@ void FWitConfigurationUtilities::OnVoicesRequestComplete(const TArray<uint8>& Bi
 	UE_LOG(LogWit, Verbose, TEXT("OnVoicesRequestComplete - Final response size: %d"), BinaryResponse.Num());
 
 	FWitVoicesResponse VoicesResponse;
-	const bool bIsConversionError = !FJsonObjectConverter::JsonObjectToUStruct(JsonResponse.ToSharedRef(), &VoicesResponse);
+	const bool bIsDecoded = FWitResponseDecoder::DecodeVoicesResponse(BinaryResponse, VoicesResponse);
+	const bool bIsConversionError = !bIsDecoded && (!JsonResponse.IsValid() || !FJsonObjectConverter::JsonObjectToUStruct(JsonResponse.ToSharedRef(), &VoicesResponse));
 	
 	if (bIsConversionError)
 	{
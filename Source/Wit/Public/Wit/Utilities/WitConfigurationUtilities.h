@@ -37,6 +37,9 @@ private:
 	static void RequestEntityList();
 	static void RequestTraitList();
 
+	/** Request the details of the next custom entity at or after the given index */
+	static void RequestEntityDetails(const int32 StartIndex);
+
 	/** Request the list of voices for an app */
 	static void RequestVoiceList();
 
@@ -56,6 +59,10 @@ private:
 	static void OnEntitiesRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse);
 	static void OnEntitiesRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage);
 
+	/** Called when a Wit entity details request is completed */
+	static void OnEntityDetailsRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const int32 Index);
+	static void OnEntityDetailsRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage, const int32 Index);
+
 	/** Called when a Wit traits request is completed */
 	static void OnTraitsRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse);
 	static void OnTraitsRequestError(const FString& ErrorMessage, const FString& HumanReadableErrorMessage);
@@ -235,27 +235,20 @@ const FWitEntity* FWitHelperUtilities::FindMatchingEntity(const FWitResponse& Re
  */
 bool FWitHelperUtilities::FindMatchingEntities(const FWitResponse& Response, const FString& EntityName, const float ConfidenceThreshold, FWitEntities& MatchingEntities)
 {
-	const bool bIsNoEntity = Response.AllEntities.Num() == 0;
+	const bool bIsNoEntity = Response.Entities.Num() == 0 && Response.AllEntities.Num() == 0;
 	
 	if (bIsNoEntity)
 	{
 		return false;
 	}
 
-	const FWitEntities* Entities = Response.AllEntities.Find(EntityName);
-
-	if (Entities == nullptr)
-	{
-		return false;
-	}
-	
-	for (auto& MatchingEntity : Entities->Entities)
+	Response.ForEachEntity(EntityName, [&MatchingEntities, ConfidenceThreshold](const FWitEntity& MatchingEntity)
 	{
 		if (MatchingEntity.Confidence > ConfidenceThreshold)
 		{
 			MatchingEntities.Entities.Add(MatchingEntity);
 		}
-	}
+	});
 
 	if (MatchingEntities.Entities.Num() ==0)
 	{
@@ -608,6 +601,11 @@ bool FWitHelperUtilities::IsWitResponse(const TSharedPtr<FJsonObject> JsonRespon
 
 void FWitHelperUtilities::ConvertJsonToAllEntities(FWitResponse* WitResponse, const TSharedPtr<FJsonObject>* EntitiesJsonObject)
 {
+	// AllEntities is built directly from the Json so anything left from a decoded response is stale
+
+	WitResponse->AdditionalEntities.Reset();
+	WitResponse->bIsAllEntitiesBuilt = true;
+
 	for (const auto& Entities : WitResponse->Entities)
 	{
 		const FString Key = *Entities.Key;
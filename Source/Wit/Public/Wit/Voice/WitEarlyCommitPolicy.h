@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Wit/Request/WitResponse.h"
+
+/**
+ * Watches the successive partial responses of a request and decides when they are stable enough to commit without waiting
+ * for the final response. A response is stable once the same top intent, above the confidence threshold, and the same values
+ * for every required entity have been seen in the configured number of successive partial responses. Command style
+ * interactions rarely change after this point so committing saves the trailing silence and the server finalization time
+ */
+class WIT_API FWitEarlyCommitPolicy
+{
+public:
+
+	/**
+	 * Start watching a new request
+	 *
+	 * @param Configuration [in] the voice configuration containing the early commit settings
+	 */
+	void Reset(const FVoiceConfiguration& Configuration);
+
+	/**
+	 * Examine the next partial response of the request
+	 *
+	 * @param Response [in] the partial response
+	 * @return true if the request should be committed now. This is only ever true once per request
+	 */
+	bool ShouldCommit(const FWitResponse& Response);
+
+	/**
+	 * Get the number of successive partial responses that have been stable
+	 *
+	 * @return the number of partial responses
+	 */
+	int32 GetNumStablePartialResponses() const;
+
+private:
+
+	/** Gather the values of the required entities. Returns false if any are missing */
+	bool GatherRequiredEntityValues(const FWitResponse& Response, TArray<FString>& OutValues) const;
+
+	/** Is early commit enabled? */
+	bool bIsEnabled{false};
+
+	/** The number of successive stable partial responses needed to commit */
+	int32 NumRequiredStablePartialResponses{1};
+
+	/** The confidence the top intent must exceed */
+	float IntentConfidenceThreshold{0.0f};
+
+	/** The intents that can be committed. Empty for any intent */
+	TArray<FString> IntentNames{};
+
+	/** The entities that must be present with unchanged values */
+	TArray<FString> RequiredEntityNames{};
+
+	/** The top intent of the most recent stable partial response */
+	FString LastIntentName{};
+
+	/** The required entity values of the most recent stable partial response */
+	TArray<FString> LastEntityValues{};
+
+	/** The number of successive stable partial responses */
+	int32 NumStablePartialResponses{0};
+
+	/** Has the request already been committed? */
+	bool bHasCommitted{false};
+};
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/MappedFileHandle.h"
+#include "Containers/Ticker.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Wit/Configuration/WitAppConfiguration.h"
+#include "Wit/Request/WitRequestTypes.h"
+#include "Wit/Request/WitResponse.h"
+
+class FJsonObject;
+class FWitRequest;
+
+/**
+ * The outcome of transcribing a single file
+ */
+struct WIT_API FWitFileTranscriptionResult
+{
+	/** The path of the file that was transcribed */
+	FString Path{};
+
+	/** Did the request succeed? */
+	bool bIsSuccessful{false};
+
+	/** The error if the request did not succeed */
+	FString ErrorMessage{};
+
+	/** The final response */
+	FWitResponse Response{};
+
+	/** The size of the file in bytes */
+	int64 NumBytes{0};
+
+	/** The time in seconds from starting the request until the whole file had been accepted by the network */
+	double UploadTime{0.0};
+
+	/** The time in seconds from starting the request until the first partial response */
+	double FirstPartialTime{-1.0};
+
+	/** The time in seconds from the whole file being uploaded until the final response */
+	double ResponseLatency{0.0};
+
+	/** The time in seconds from starting the request until the final response */
+	double TotalTime{0.0};
+};
+
+DECLARE_DELEGATE_OneParam(FOnWitFileTranscribedDelegate, const FWitFileTranscriptionResult&);
+DECLARE_DELEGATE_OneParam(FOnWitFileTranscriptionCompleteDelegate, const TArray<FWitFileTranscriptionResult>&);
+
+/**
+ * Settings for a batch of file transcriptions
+ */
+struct WIT_API FWitFileTranscriptionSettings
+{
+	/** The application to send the requests to */
+	FWitAppConfiguration Application{};
+
+	/** The endpoint to use. Either Speech or Dictation */
+	EWitRequestEndpoint Endpoint{EWitRequestEndpoint::Speech};
+
+	/** The maximum number of requests in flight at once */
+	int32 Concurrency{4};
+
+	/** The sample rate of raw files. Files with a .wav extension describe their own format */
+	int32 RawSampleRate{16000};
+
+	/** The maximum number of bytes queued for upload per request. More of the file is read as the network accepts it */
+	int32 UploadChunkSize{64 * 1024};
+};
+
+/**
+ * Transcribes a batch of wav or raw 16-bit files with several concurrent /speech or /dictation requests. Each file is
+ * memory mapped and streamed to its request in chunks as the network accepts it. A chunk is released by the request once it
+ * has been sent so only a couple of chunks per request are held in memory however large the files are. Files of 2 GB or more
+ * are rejected. Results are returned in the same order as the paths along with timing for offline evaluation. Must be
+ * created with MakeShared and is ticked on the game thread until complete
+ */
+#if UE_VERSION_OLDER_THAN(5,0,0)
+class WIT_API FWitFileTranscriber final : public TSharedFromThis<FWitFileTranscriber, ESPMode::ThreadSafe>, public FTickerObjectBase
+#else
+class WIT_API FWitFileTranscriber final : public TSharedFromThis<FWitFileTranscriber, ESPMode::ThreadSafe>, public FTSTickerObjectBase
+#endif
+{
+public:
+
+	/**
+	 * Start transcribing a batch of files
+	 *
+	 * @param Paths [in] the files to transcribe
+	 * @param Settings [in] the settings to use
+	 * @param OnFileTranscribed [in] optional delegate called as each file completes
+	 * @param OnComplete [in] delegate called once every file has completed
+	 * @return the transcriber. It keeps itself alive until complete
+	 */
+	static TSharedRef<FWitFileTranscriber, ESPMode::ThreadSafe> TranscribeFiles(const TArray<FString>& Paths, const FWitFileTranscriptionSettings& Settings,
+		FOnWitFileTranscribedDelegate OnFileTranscribed, FOnWitFileTranscriptionCompleteDelegate OnComplete);
+
+	FWitFileTranscriber(const TArray<FString>& InPaths, const FWitFileTranscriptionSettings& InSettings);
+	virtual ~FWitFileTranscriber() override;
+
+	/**
+	 * FTickerObjectBase overrides
+	 */
+	virtual bool Tick(float DeltaTime) override;
+
+	/**
+	 * Cancel any requests in flight. Files that have not completed are reported as failed
+	 */
+	void Cancel();
+
+	/**
+	 * Have all of the files completed?
+	 *
+	 * @return true if complete
+	 */
+	bool IsComplete() const;
+
+	/**
+	 * Get the results so far in the same order as the paths
+	 *
+	 * @return the results
+	 */
+	const TArray<FWitFileTranscriptionResult>& GetResults() const;
+
+private:
+
+	/** A file that is currently being transcribed */
+	struct FActiveFile
+	{
+		/** Index of the file in the results */
+		int32 Index{INDEX_NONE};
+
+		/** The request the file is streamed to */
+		TSharedPtr<FWitRequest, ESPMode::ThreadSafe> Request{};
+
+		/** The mapped file. Null if the file could not be mapped and was loaded instead */
+		TUniquePtr<IMappedFileHandle> MappedHandle{};
+
+		/** The mapped region of the file */
+		TUniquePtr<IMappedFileRegion> MappedRegion{};
+
+		/** The file contents if it could not be mapped */
+		TArray<uint8> LoadedData{};
+
+		/** View of the file contents */
+		TArrayView<const uint8> Data{};
+
+		/** The number of bytes written to the request so far */
+		int64 NumBytesWritten{0};
+
+		/** The time the request started */
+		double StartTime{0.0};
+
+		/** The time the whole file was accepted by the network */
+		double UploadEndTime{0.0};
+
+		/** Has the request finished? */
+		bool bIsComplete{false};
+	};
+
+	/** Start the next file if any remain */
+	bool StartNextFile();
+
+	/** Open the given file for reading */
+	static bool OpenFile(const FString& Path, FActiveFile& File);
+
+	/** Write more of the file to its request if the network has accepted what was written before */
+	void PumpFile(FActiveFile& File);
+
+	/** Complete the given file and report its result */
+	void CompleteFile(FActiveFile& File, const bool bIsSuccessful, const FString& ErrorMessage);
+
+	/** Called when a request has a partial response */
+	void OnRequestProgress(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const int32 Index);
+
+	/** Called when a request completes */
+	void OnRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response, const int32 Index);
+
+	/** Called when a request errors */
+	void OnRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const int32 Index);
+
+	/** Find the active file with the given result index */
+	FActiveFile* FindActiveFile(const int32 Index);
+
+	/** The files to transcribe */
+	const TArray<FString> Paths{};
+
+	/** The settings to use */
+	const FWitFileTranscriptionSettings Settings{};
+
+	/** The results in the same order as the paths */
+	TArray<FWitFileTranscriptionResult> Results{};
+
+	/** The files currently being transcribed */
+	TArray<TUniquePtr<FActiveFile>> ActiveFiles{};
+
+	/** The index of the next file to start */
+	int32 NextFileIndex{0};
+
+	/** The number of files that have completed */
+	int32 NumFilesCompleted{0};
+
+	/** Called as each file completes */
+	FOnWitFileTranscribedDelegate OnFileTranscribed{};
+
+	/** Called once every file has completed */
+	FOnWitFileTranscriptionCompleteDelegate OnComplete{};
+
+	/** Keeps the transcriber alive until complete */
+	TSharedPtr<FWitFileTranscriber, ESPMode::ThreadSafe> SelfReference{};
+};
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Wit/Request/WitResponse.h"
+
+/**
+ * Finds the keywords and synonyms of an app's keyword entities in text. Every keyword is compiled into a single Aho-Corasick
+ * automaton so text is searched for all of them in one pass that is linear in the length of the text. Matching ignores case
+ * and only whole words match. Where matches overlap the earliest and then longest is kept
+ */
+class WIT_API FWitKeywordExtractor
+{
+public:
+
+	/**
+	 * Compile the keywords of the given entities. Entities without keywords are ignored
+	 *
+	 * @param Entities [in] the entity definitions
+	 */
+	void Build(const TArray<FWitEntityDefinition>& Entities);
+
+	/**
+	 * Has the extractor been built?
+	 *
+	 * @return true if built
+	 */
+	bool IsBuilt() const;
+
+	/**
+	 * Was the extractor built from the given entities? Used to rebuild the extractor when the entities are refreshed
+	 *
+	 * @param Entities [in] the entity definitions
+	 * @return true if built from entities with the same names and keywords
+	 */
+	bool IsBuiltFrom(const TArray<FWitEntityDefinition>& Entities) const;
+
+	/**
+	 * Get the number of keywords and synonyms compiled into the extractor
+	 *
+	 * @return the number of keywords
+	 */
+	int32 GetNumKeywords() const;
+
+	/**
+	 * Find the keyword entities mentioned in the given text
+	 *
+	 * @param Text [in] the text to search
+	 * @param OutEntities [out] the entities found in the order they appear
+	 */
+	void Extract(const FString& Text, TArray<FWitEntity>& OutEntities) const;
+
+private:
+
+	/** A keyword or synonym to search for */
+	struct FKeyword
+	{
+		/** The index of the entity name */
+		int32 EntityIndex{INDEX_NONE};
+
+		/** The canonical value of the keyword */
+		FString Value{};
+
+		/** The length of the phrase searched for */
+		int32 Length{0};
+	};
+
+	/** A node in the automaton */
+	struct FNode
+	{
+		/** The index of the next node for each character */
+		TMap<TCHAR, int32> Children{};
+
+		/** The node for the longest proper suffix of this node that is also in the automaton */
+		int32 Failure{0};
+
+		/** The nearest node on the failure chain where a keyword ends or INDEX_NONE */
+		int32 Output{INDEX_NONE};
+
+		/** The index of the keyword ending at this node or INDEX_NONE */
+		int32 KeywordIndex{INDEX_NONE};
+	};
+
+	/** Add a phrase for the given keyword */
+	void AddPhrase(const FString& Phrase, const int32 EntityIndex, const FString& Value);
+
+	/** Compute the failure and output links once every phrase has been added */
+	void BuildLinks();
+
+	/** Calculate a checksum of the names and keywords of the given entities */
+	static uint32 CalculateChecksum(const TArray<FWitEntityDefinition>& Entities);
+
+	/** The names of the entities */
+	TArray<FString> EntityNames{};
+
+	/** The keywords and synonyms */
+	TArray<FKeyword> Keywords{};
+
+	/** The automaton nodes. The first node is the root */
+	TArray<FNode> Nodes{};
+
+	/** Has the extractor been built? */
+	bool bIsBuilt{false};
+
+	/** The checksum of the entities the extractor was built from */
+	uint32 EntitiesChecksum{0};
+};
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Wit/Request/WitResponse.h"
+
+/**
+ * Recognizes a small set of exact phrases in partial transcriptions without waiting for Wit.ai to understand them. The
+ * phrases are held in a trie of words so a transcription is matched with a single walk over its words. A match is only
+ * confident when the whole transcription is a phrase and no longer phrase begins with it, since a longer phrase could
+ * still be spoken
+ */
+class WIT_API FWitLocalGrammar
+{
+public:
+
+	/**
+	 * Start watching a new request. The trie is rebuilt from the configured phrases
+	 *
+	 * @param Configuration [in] the voice configuration containing the local grammar settings
+	 */
+	void Reset(const FVoiceConfiguration& Configuration);
+
+	/**
+	 * Is the local grammar enabled and does it have any phrases?
+	 *
+	 * @return true if enabled
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * Match the next partial transcription of the request
+	 *
+	 * @param Transcription [in] the partial transcription
+	 * @param OutResponse [out] the response for the matched phrase
+	 * @return true if a phrase was confidently matched. This is only ever true once per request
+	 */
+	bool Match(const FString& Transcription, FWitResponse& OutResponse);
+
+	/**
+	 * Split text into lowercase words ignoring punctuation
+	 *
+	 * @param Text [in] the text to split
+	 * @param OutWords [out] the words
+	 */
+	static void Tokenize(const FString& Text, TArray<FString>& OutWords);
+
+private:
+
+	/** A node in the trie of phrase words */
+	struct FNode
+	{
+		/** The index of the next node for each word */
+		TMap<FString, int32> Children{};
+
+		/** The index of the phrase ending at this node or INDEX_NONE */
+		int32 PhraseIndex{INDEX_NONE};
+	};
+
+	/** Add a phrase to the trie */
+	void AddPhrase(const FString& Phrase, const int32 PhraseIndex);
+
+	/** Fill in the response for the given phrase */
+	void MakeResponse(const FString& Transcription, const int32 PhraseIndex, FWitResponse& OutResponse) const;
+
+	/** Is the local grammar enabled? */
+	bool bIsEnabled{false};
+
+	/** Has a phrase already been matched in the request? */
+	bool bHasMatched{false};
+
+	/** The configured phrases */
+	TArray<FVoiceLocalGrammarPhrase> Phrases{};
+
+	/** The trie nodes. The first node is the root */
+	TArray<FNode> Nodes{};
+};
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Misc/EngineVersionComparison.h"
+#include "Wit/Configuration/WitAppConfiguration.h"
+#include "Wit/Request/WitResponse.h"
+
+class FJsonObject;
+class FWitRequest;
+
+/**
+ * The outcome of understanding a single text
+ */
+struct WIT_API FWitMessageBatchResult
+{
+	/** The index of the text in the batch */
+	int32 Index{INDEX_NONE};
+
+	/** The text that was sent */
+	FString Text{};
+
+	/** Did the request succeed? */
+	bool bIsSuccessful{false};
+
+	/** The error if the request did not succeed */
+	FString ErrorMessage{};
+
+	/** The final response */
+	FWitResponse Response{};
+
+	/** The number of requests made including retries */
+	int32 NumAttempts{0};
+
+	/** The time in seconds from starting the batch until the first request for this text was made */
+	double QueueTime{0.0};
+
+	/** The time in seconds from making the last request until its response */
+	double Latency{0.0};
+
+	/** The time in seconds from making the first request until the final response including any retries */
+	double TotalTime{0.0};
+};
+
+DECLARE_DELEGATE_OneParam(FOnWitMessageResultDelegate, const FWitMessageBatchResult&);
+DECLARE_DELEGATE_OneParam(FOnWitMessageBatchCompleteDelegate, const TArray<FWitMessageBatchResult>&);
+
+/**
+ * Settings for a batch of /message requests
+ */
+struct WIT_API FWitMessageBatchSettings
+{
+	/** The application to send the requests to */
+	FWitAppConfiguration Application{};
+
+	/** The maximum number of requests in flight at once */
+	int32 Concurrency{8};
+
+	/** The maximum number of requests started per minute so that the batch stays within the app's rate limit. Zero for no limit */
+	float MaximumRequestsPerMinute{0.0f};
+
+	/** The number of times a request is retried after it is rate limited, a server error or a connection failure */
+	int32 MaximumRetries{2};
+
+	/** The time in seconds to wait before the first retry. This doubles with each further retry */
+	float RetryDelay{1.0f};
+};
+
+/**
+ * Sends a batch of texts to the /message endpoint with several concurrent requests. Requests are paced so that the batch
+ * never exceeds the configured rate and are retried with a backoff when throttled. Results are returned in the same order as
+ * the texts along with timing for offline evaluation. Must be created with MakeShared and is ticked on the game thread until
+ * complete. Commandlets which have no game loop can call WaitUntilComplete instead
+ */
+#if UE_VERSION_OLDER_THAN(5,0,0)
+class WIT_API FWitMessageBatch final : public TSharedFromThis<FWitMessageBatch, ESPMode::ThreadSafe>, public FTickerObjectBase
+#else
+class WIT_API FWitMessageBatch final : public TSharedFromThis<FWitMessageBatch, ESPMode::ThreadSafe>, public FTSTickerObjectBase
+#endif
+{
+public:
+
+	/**
+	 * Start sending a batch of texts
+	 *
+	 * @param Texts [in] the texts to send
+	 * @param Settings [in] the settings to use
+	 * @param OnMessageResult [in] optional delegate called as each text completes
+	 * @param OnComplete [in] delegate called once every text has completed
+	 * @return the batch. It keeps itself alive until complete
+	 */
+	static TSharedRef<FWitMessageBatch, ESPMode::ThreadSafe> SendTranscriptions(const TArray<FString>& Texts, const FWitMessageBatchSettings& Settings,
+		FOnWitMessageResultDelegate OnMessageResult, FOnWitMessageBatchCompleteDelegate OnComplete);
+
+	FWitMessageBatch(const TArray<FString>& InTexts, const FWitMessageBatchSettings& InSettings);
+	virtual ~FWitMessageBatch() override;
+
+	/**
+	 * FTickerObjectBase overrides
+	 */
+	virtual bool Tick(float DeltaTime) override;
+
+	/**
+	 * Block until every text has completed or the timeout expires. This pumps the core ticker and game thread tasks itself
+	 * and so is only intended for commandlets and other contexts without a game loop
+	 *
+	 * @param Timeout [in] the maximum time in seconds to wait. Zero to wait forever
+	 * @return true if complete
+	 */
+	bool WaitUntilComplete(const double Timeout = 0.0);
+
+	/**
+	 * Cancel any requests in flight. Texts that have not completed are reported as failed
+	 */
+	void Cancel();
+
+	/**
+	 * Have all of the texts completed?
+	 *
+	 * @return true if complete
+	 */
+	bool IsComplete() const;
+
+	/**
+	 * Get the results so far in the same order as the texts
+	 *
+	 * @return the results
+	 */
+	const TArray<FWitMessageBatchResult>& GetResults() const;
+
+private:
+
+	/** A text that is currently being sent */
+	struct FActiveMessage
+	{
+		/** Index of the text in the results */
+		int32 Index{INDEX_NONE};
+
+		/** The current request */
+		TSharedPtr<FWitRequest, ESPMode::ThreadSafe> Request{};
+
+		/** The time the first request started */
+		double FirstStartTime{0.0};
+
+		/** The time the current request started */
+		double StartTime{0.0};
+
+		/** The time after which the request should be retried. Zero if not waiting to retry */
+		double RetryTime{0.0};
+
+		/** Has the text completed? */
+		bool bIsComplete{false};
+	};
+
+	/** Is the rate limit allowing another request to start now? */
+	bool CanStartRequest(const double Now) const;
+
+	/** Start the next text if any remain */
+	bool StartNextMessage(const double Now);
+
+	/** Make a request for the given text */
+	void StartRequest(FActiveMessage& Message, const double Now);
+
+	/** Complete the given text and report its result */
+	void CompleteMessage(FActiveMessage& Message, const bool bIsSuccessful, const FString& ErrorMessage);
+
+	/** Should a request that failed with the given error be retried? */
+	static bool IsRetryableError(const FString& ErrorMessage);
+
+	/** Called when a request completes */
+	void OnRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response, const int32 Index,
+		const int32 Attempt);
+
+	/** Called when a request errors */
+	void OnRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const int32 Index, const int32 Attempt);
+
+	/** Find the active text with the given result index */
+	FActiveMessage* FindActiveMessage(const int32 Index);
+
+	/** The texts to send */
+	const TArray<FString> Texts{};
+
+	/** The settings to use */
+	const FWitMessageBatchSettings Settings{};
+
+	/** The results in the same order as the texts */
+	TArray<FWitMessageBatchResult> Results{};
+
+	/** The texts currently being sent */
+	TArray<TUniquePtr<FActiveMessage>> ActiveMessages{};
+
+	/** The index of the next text to start */
+	int32 NextMessageIndex{0};
+
+	/** The number of texts that have completed */
+	int32 NumMessagesCompleted{0};
+
+	/** The time the batch started */
+	double BatchStartTime{0.0};
+
+	/** The earliest time the next request may start */
+	double NextRequestTime{0.0};
+
+	/** Called as each text completes */
+	FOnWitMessageResultDelegate OnMessageResult{};
+
+	/** Called once every text has completed */
+	FOnWitMessageBatchCompleteDelegate OnComplete{};
+
+	/** Keeps the batch alive until complete */
+	TSharedPtr<FWitMessageBatch, ESPMode::ThreadSafe> SelfReference{};
+};
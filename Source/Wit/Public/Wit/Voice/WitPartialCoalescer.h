@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+
+/**
+ * The kinds of partial result that are coalesced independently
+ */
+enum class EWitPartialKind : uint8
+{
+	Transcription,
+	Response
+};
+
+/**
+ * Limits how often the partial results of a request are delivered to listeners. Each kind of partial has its own budget of
+ * at most one delivery per frame and per configured interval so that one kind never starves the other. A partial that arrives
+ * while delivery is held back is kept as pending and replaced by any later partial of the same kind so that only the latest
+ * is ever delivered. Replaced and discarded partials are counted as dropped
+ */
+class WIT_API FWitPartialCoalescer
+{
+public:
+
+	/**
+	 * Start coalescing a new request
+	 *
+	 * @param Configuration [in] the voice configuration containing the coalescing settings
+	 */
+	void Reset(const FVoiceConfiguration& Configuration);
+
+	/**
+	 * Is coalescing enabled?
+	 *
+	 * @return true if enabled
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * Offer a new partial for delivery
+	 *
+	 * @param Kind [in] the kind of partial
+	 * @param Now [in] the current time in seconds
+	 * @return true if it should be delivered now. Otherwise it is held as pending until the next flush
+	 */
+	bool Submit(const EWitPartialKind Kind, const double Now);
+
+	/**
+	 * Take the pending partials if they are now due for delivery
+	 *
+	 * @param Now [in] the current time in seconds
+	 * @param bIsForced [in] should pending partials be taken regardless of their budget?
+	 * @param bOutIsTranscriptionDue [out] should the pending transcription be delivered?
+	 * @param bOutIsResponseDue [out] should the pending response be delivered?
+	 * @return true if anything should be delivered
+	 */
+	bool Flush(const double Now, const bool bIsForced, bool& bOutIsTranscriptionDue, bool& bOutIsResponseDue);
+
+	/**
+	 * Discard any pending partials. Used when the request finishes as its final response supersedes them
+	 */
+	void Drop();
+
+	/**
+	 * Is a partial of the given kind pending?
+	 *
+	 * @param Kind [in] the kind of partial
+	 * @return true if pending
+	 */
+	bool IsPending(const EWitPartialKind Kind) const;
+
+	/**
+	 * Get the number of partials that have been dropped since the request started
+	 *
+	 * @return the number of partials
+	 */
+	int32 GetNumDropped() const;
+
+private:
+
+	/** The delivery state of a single kind of partial */
+	struct FKindState
+	{
+		/** The time of the last delivery */
+		double LastDeliveryTime{0.0};
+
+		/** The frame of the last delivery */
+		uint64 LastDeliveryFrame{MAX_uint64};
+
+		/** Is a partial pending? */
+		bool bIsPending{false};
+	};
+
+	/** Get the state of the given kind of partial */
+	FKindState& GetState(const EWitPartialKind Kind);
+	const FKindState& GetState(const EWitPartialKind Kind) const;
+
+	/** Can a delivery be made now? */
+	bool CanDeliver(const FKindState& State, const double Now) const;
+
+	/** Record that a delivery was made now */
+	static void MarkDelivered(FKindState& State, const double Now);
+
+	/** Is coalescing enabled? */
+	bool bIsEnabled{false};
+
+	/** The minimum time in seconds between deliveries of the same kind */
+	double Interval{0.0};
+
+	/** The state of partial transcriptions */
+	FKindState TranscriptionState{};
+
+	/** The state of partial responses */
+	FKindState ResponseState{};
+
+	/** The number of partials dropped since the request started */
+	int32 NumDropped{0};
+};
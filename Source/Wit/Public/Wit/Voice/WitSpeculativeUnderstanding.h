@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Voice/Configuration/VoiceConfiguration.h"
+#include "Wit/Request/WitResponse.h"
+
+/**
+ * The outcome of comparing the final transcription against the speculated transcription
+ */
+enum class EWitSpeculationResult : uint8
+{
+	/** The final transcription matched and the speculative response is ready to use */
+	Hit,
+
+	/** The final transcription matched but the speculative response has not arrived yet */
+	Pending,
+
+	/** There was no speculation or the final transcription did not match it */
+	Miss
+};
+
+/**
+ * Decides when the partial transcription of a speech request has been stable for long enough to speculatively send it to the
+ * /message endpoint, and whether the speculative response can be used once the final transcription is known. Understanding
+ * takes the server several hundred milliseconds after the final transcription so a speculative response that matches lets
+ * the intents be delivered that much earlier. Hit rate statistics are kept across requests to show whether it pays off. The
+ * composer service uses the same policy to prefetch composer turns
+ */
+class WIT_API FWitSpeculativeUnderstanding
+{
+public:
+
+	/**
+	 * Start watching a new request. Statistics are kept
+	 *
+	 * @param Configuration [in] the voice configuration containing the speculation settings
+	 */
+	void Reset(const FVoiceConfiguration& Configuration);
+
+	/**
+	 * Start watching a new request with explicit settings. Statistics are kept
+	 *
+	 * @param bInIsEnabled [in] is speculation enabled?
+	 * @param InStableTime [in] how long in seconds the transcription must be unchanged before speculating
+	 * @param InMaximumSpeculations [in] the maximum number of speculations for the request
+	 */
+	void Reset(const bool bInIsEnabled, const float InStableTime, const int32 InMaximumSpeculations);
+
+	/**
+	 * Is speculation enabled?
+	 *
+	 * @return true if enabled
+	 */
+	bool IsEnabled() const;
+
+	/**
+	 * Track the latest partial transcription
+	 *
+	 * @param Transcription [in] the partial transcription
+	 * @param Now [in] the current time in seconds
+	 */
+	void UpdateTranscription(const FString& Transcription, const double Now);
+
+	/**
+	 * Should a speculative request be made now? If so the speculation is recorded as started
+	 *
+	 * @param Now [in] the current time in seconds
+	 * @param OutTranscription [out] the transcription to send
+	 * @return true if a speculative request should be made
+	 */
+	bool ShouldSpeculate(const double Now, FString& OutTranscription);
+
+	/**
+	 * Get the id of the current speculation. Responses to earlier speculations are ignored
+	 *
+	 * @return the id
+	 */
+	uint32 GetSpeculationId() const;
+
+	/**
+	 * Store the response to a speculative request
+	 *
+	 * @param SpeculationId [in] the id of the speculation the response is for
+	 * @param Response [in] the response
+	 * @return true if the response is for the current speculation
+	 */
+	bool SetResponse(const uint32 SpeculationId, const FWitResponse& Response);
+
+	/**
+	 * Record that a speculative request failed
+	 *
+	 * @param SpeculationId [in] the id of the speculation that failed
+	 */
+	void SetFailed(const uint32 SpeculationId);
+
+	/**
+	 * Compare the final transcription against the current speculation
+	 *
+	 * @param Transcription [in] the final transcription
+	 * @return the outcome
+	 */
+	EWitSpeculationResult ResolveFinalTranscription(const FString& Transcription);
+
+	/**
+	 * Is the final transcription known to match with the speculative response still to arrive?
+	 *
+	 * @return true if waiting for the speculative response
+	 */
+	bool IsAwaitingResponse() const;
+
+	/**
+	 * Resolve a pending match once the speculative response has arrived
+	 *
+	 * @return true if the speculative response can now be used
+	 */
+	bool ResolvePending();
+
+	/**
+	 * Give up on a speculation that was still awaiting its response. It is counted as a miss
+	 */
+	void Abandon();
+
+	/**
+	 * Get the speculative response. Only valid after a hit
+	 *
+	 * @return the response
+	 */
+	const FWitResponse& GetResponse() const;
+
+	/**
+	 * Get the fraction of requests with a speculation where the speculation was used
+	 *
+	 * @return the hit rate in the range 0 to 1
+	 */
+	float GetHitRate() const;
+
+	/**
+	 * Get the number of requests with a speculation that have been resolved
+	 *
+	 * @return the number of requests
+	 */
+	int32 GetNumResolved() const;
+
+private:
+
+	/** The state of the current speculation */
+	enum class EState : uint8
+	{
+		None,
+		Requested,
+		Ready,
+		Failed
+	};
+
+	/** Record the outcome of the current request */
+	void RecordOutcome(const bool bIsHit);
+
+	/** Is speculation enabled? */
+	bool bIsEnabled{false};
+
+	/** How long in seconds the partial transcription must be unchanged before speculating */
+	double StableTime{0.0};
+
+	/** The maximum number of speculative requests per speech request */
+	int32 MaximumSpeculations{1};
+
+	/** The latest partial transcription normalized for comparison */
+	FString LastTranscription{};
+
+	/** The latest partial transcription as it was received */
+	FString LastRawTranscription{};
+
+	/** When the partial transcription last changed */
+	double LastChangeTime{0.0};
+
+	/** The normalized transcription of the current speculation */
+	FString SpeculativeTranscription{};
+
+	/** The state of the current speculation */
+	EState State{EState::None};
+
+	/** The response to the current speculation */
+	FWitResponse Response{};
+
+	/** The final transcription once it has matched */
+	FString FinalTranscription{};
+
+	/** Identifies the current speculation */
+	uint32 SpeculationId{0};
+
+	/** The number of speculations made for the current request */
+	int32 NumSpeculations{0};
+
+	/** Has the final transcription matched the current speculation? */
+	bool bIsFinalMatched{false};
+
+	/** Has the outcome of the current request been recorded? */
+	bool bIsResolved{false};
+
+	/** The number of requests with a speculation that have been resolved */
+	int32 NumResolved{0};
+
+	/** The number of those requests where the speculation was used */
+	int32 NumHits{0};
+};
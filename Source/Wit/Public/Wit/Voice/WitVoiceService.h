@@ -8,8 +8,17 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Misc/Optional.h"
 #include "Voice/Service/VoiceService.h"
+#include "Wit/Request/WitMessageCache.h"
 #include "Wit/Request/WitRequestTypes.h"
+#include "Wit/Voice/WitEarlyCommitPolicy.h"
+#include "Wit/Voice/WitFileTranscriber.h"
+#include "Wit/Voice/WitMessageBatch.h"
+#include "Wit/Voice/WitKeywordExtractor.h"
+#include "Wit/Voice/WitLocalGrammar.h"
+#include "Wit/Voice/WitPartialCoalescer.h"
+#include "Wit/Voice/WitSpeculativeUnderstanding.h"
 #include "WitVoiceService.generated.h"
 
 #ifdef CPP_PLUGIN
@@ -22,6 +31,11 @@ THIRD_PARTY_INCLUDES_END
 #endif
 
 class FJsonObject;
+class FVoiceCaptureSubscription;
+class FVoicePushInput;
+class FWitRequest;
+class FWitVoiceSession;
+
 /**
  * Component that encapsulates the Wit Voice Command API. Provides functionality for making speech and message requests
  * to Wit.ai to interpret and extract meaning. To use it simply attach the UWitVoiceService component in the hierarchy of any Actor
@@ -59,6 +73,61 @@ public:
 	virtual void SendTranscriptionWithRequestOptions(const FString& Text, const FString& RequestOptions) override;
 	virtual void AcceptPartialResponseAndCancelRequest(const FWitResponse& Response) override;
 
+	/**
+	 * Starts streaming voice input pushed through the given push input instead of capturing it from the microphone. Streaming
+	 * to Wit.ai begins immediately and voice input deactivates once the push input has ended and all its data has been sent
+	 *
+	 * @param PushInputToUse [in] the push input to stream from
+	 * @return true if the activation was successful
+	 */
+	bool ActivateVoiceInputWithPushInput(const TSharedRef<FVoicePushInput, ESPMode::ThreadSafe>& PushInputToUse);
+
+	/**
+	 * Enable or disable continuous streaming. When enabled voice input is not deactivated when a request grows too long. Instead
+	 * the next request begins before the current one finalizes while capture keeps running, and the most recent voice data is
+	 * sent to both so that nothing spoken at the boundary is lost. Words repeated at the start of the next request's transcription
+	 * because of the overlap are removed from its final response
+	 *
+	 * @param bIsEnabled [in] should streaming be continuous
+	 * @param SegmentTime [in] once a request has streamed for this many seconds it is handed over at the next pause in speech
+	 * @param OverlapTime [in] how many seconds of the most recent voice data are also sent to the next request
+	 */
+	void SetContinuousStreaming(const bool bIsEnabled, const float SegmentTime, const float OverlapTime);
+
+	/**
+	 * Transcribes a batch of wav or raw 16-bit files using this component's configuration. This is independent of live voice
+	 * input and is intended for offline evaluation of utterance corpora
+	 *
+	 * @param Paths [in] the files to transcribe
+	 * @param Concurrency [in] the maximum number of requests in flight at once
+	 * @param OnComplete [in] called with the results once every file has completed
+	 * @param Endpoint [in] the endpoint to use. Either Speech or Dictation
+	 * @return the transcriber or null if there is no configuration
+	 */
+	TSharedPtr<FWitFileTranscriber, ESPMode::ThreadSafe> TranscribeFiles(const TArray<FString>& Paths, const int32 Concurrency,
+		FOnWitFileTranscriptionCompleteDelegate OnComplete, const EWitRequestEndpoint Endpoint = EWitRequestEndpoint::Speech) const;
+
+	/**
+	 * Sends a batch of texts to Wit.ai for interpretation using this component's configuration. Unlike SendTranscription several
+	 * requests can be in flight at once and the responses are not broadcast through the voice events. This is intended for
+	 * offline evaluation of utterance corpora
+	 *
+	 * @param Texts [in] the texts to interpret
+	 * @param Concurrency [in] the maximum number of requests in flight at once
+	 * @param MaximumRequestsPerMinute [in] the maximum number of requests started per minute. Zero for no limit
+	 * @param OnComplete [in] called with the results once every text has completed
+	 * @return the batch or null if there is no configuration
+	 */
+	TSharedPtr<FWitMessageBatch, ESPMode::ThreadSafe> SendTranscriptions(const TArray<FString>& Texts, const int32 Concurrency,
+		const float MaximumRequestsPerMinute, FOnWitMessageBatchCompleteDelegate OnComplete) const;
+
+	/**
+	 * Get the fraction of speech requests with a speculative /message request where the speculative response was used
+	 *
+	 * @return the hit rate in the range 0 to 1
+	 */
+	float GetSpeculativeUnderstandingHitRate() const;
+
 protected:
 	
 	virtual void BeginPlay() override;
@@ -66,40 +135,87 @@ protected:
 	
 private:
 
-#if WITH_EDITOR
-
-	/** Write the captured voice input to a wav file */
-	static void WriteRawPCMDataToWavFile(const uint8* RawPCMData, int32 RawPCMDataSize, int32 NumChannels, int32 SampleRate);
-
-#endif
-
 	/** Start the Wit speech request */
 	void BeginStreamRequest();
 
 	/** Do the actual bulk of the deactivation */
 	bool DoDeactivateVoiceInput();
 
+	/** Cancel requests from an earlier activation that are still waiting for their responses */
+	void CancelSupersededRequests();
+
+	/** Configure and begin a speech request */
+	void BeginSpeechRequest(FWitRequest& Request, const int32 SampleRate);
+
+	/** Hand streaming over to a new request without deactivating voice input */
+	void RollOverStreamRequest();
+
+	/** Common setup once voice input has been activated */
+	void OnVoiceInputActivated();
+
 	/** Called when a Wit speech request is in progress to retrieve any changes to the response payload */
-	void OnSpeechRequestProgress(const TArray<uint8>& PartialBinaryResponse, const TSharedPtr<FJsonObject> PartialJsonResponse) const;
+	void OnSpeechRequestProgress(const TArray<uint8>& PartialBinaryResponse, const TSharedPtr<FJsonObject> PartialJsonResponse, const FWitResponse& PartialResponse,
+		const FWitResponseChecksums& Checksums, const uint32 Segment);
+
+	/** Match a partial transcription against the local grammar. Returns true if the request was cancelled */
+	bool MatchLocalGrammar(const FString& Transcription);
+
+	/** Find the keyword entities in a partial transcription and broadcast them if they changed */
+	void ExtractKeywordEntities(const FString& Transcription);
 
 	/** Called when received a Wit partial response */
-	void OnPartialResponse(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse) const;
+	void OnPartialResponse(const FWitResponse& PartialResponse, const FWitResponseChecksums& Checksums);
+
+	/** Deliver any partials held back by coalescing once they are due or immediately if forced */
+	void FlushPartials(const bool bIsForced);
+
+	/** Discard any partials held back by coalescing */
+	void DropPartials();
+
+	/** Make a speculative request if the partial transcription has been stable for long enough */
+	void UpdateSpeculativeUnderstanding();
+
+	/** Send the given transcription to the /message endpoint speculatively */
+	void StartSpeculativeRequest(const FString& Transcription);
+
+	/** Cancel the speculative request if there is one */
+	void CancelSpeculativeRequest();
+
+	/** Compare the final transcription against the speculation. Returns true if the speculative response was used */
+	bool OnFinalTranscription(const FString& Transcription);
+
+	/** Use the speculative response as the final response */
+	void AcceptSpeculativeResponse();
+
+	/** Called when a speculative request completes */
+	void OnSpeculativeRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response,
+		const uint32 Segment, const uint32 SpeculationId);
+
+	/** Called when a speculative request errors */
+	void OnSpeculativeRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const uint32 Segment, const uint32 SpeculationId);
 	
 	/** Called when a Wit message(Transcription) request is fully completed to process the response payload */
-	void OnMessageRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse);
+	void OnMessageRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response, const FString Text,
+		const bool bIsCacheable);
 	
 	/** Called when a Wit speech request is fully completed to process the response payload */
-	void OnSpeechRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse);
-	
-	/** Called when a Wit voice request is fully completed to process the response payload */
-	void OnRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const bool bIsResponseRestNeeded);
+	void OnSpeechRequestComplete(const TArray<uint8>& BinaryResponse, const TSharedPtr<FJsonObject> JsonResponse, const FWitResponse& Response, const uint32 Segment);
 	
+	/** Deliver the final responses of the current stream that are ready in segment order */
+	void ReleaseFinalResponses(const bool bShouldReleaseAll);
+
 	/** Called when a Wit voice request is fully completed to process the response payload */
 	void OnRequestComplete(const FWitResponse& Response) const;
 
+	/** Called when a Wit speech request errors */
+	void OnSpeechRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage, const uint32 Segment);
+
 	/** Called when a Wit request errors */
 	void OnWitRequestError(const FString& ErrorMessage, const FString& HumanReadableMessage) const;
 
+	/** Remove the words at the start of a transcription that repeat the end of the previous transcription */
+	static FString TrimOverlappingText(const FString& PreviousText, const FString& Text, const int32 MaximumOverlapWords);
+
 	/** The audio format that will be passed to Wit when making /speech requests. Currently only Raw is supported */
 	const EWitRequestFormat Format{EWitRequestFormat::Raw};
 
@@ -124,6 +240,75 @@ private:
 	/** Used to track how long since we reached wake volume when capturing */
 	float LastWakeTime{0.0f};
 
+	/** Our subscription to the shared voice capture */
+	TSharedPtr<FVoiceCaptureSubscription, ESPMode::ThreadSafe> CaptureSubscription{};
+
+	/** The push input we are streaming from. If not set then we stream from the voice capture */
+	TSharedPtr<FVoicePushInput, ESPMode::ThreadSafe> PushInput{};
+
+	/** The session that takes voice input through processing and into this service's own Wit.ai request */
+	TSharedPtr<FWitVoiceSession> Session{};
+
+	/** The checksums of the last partial response of the current request. Used to only copy the sections of the next partial response that change */
+	FWitResponseChecksums LastPartialChecksums{};
+
+	/** Decides when the partial responses of the current request are stable enough to commit early */
+	FWitEarlyCommitPolicy EarlyCommitPolicy{};
+
+	/** Recognizes frequent commands from the partial transcriptions of the current request */
+	FWitLocalGrammar LocalGrammar{};
+
+	/** Limits how often the partials of the current request are delivered */
+	FWitPartialCoalescer PartialCoalescer{};
+
+	/** The latest partial transcription held back by coalescing */
+	FString PendingPartialTranscription{};
+
+	/** The sections of the response changed by partial responses held back by coalescing */
+	EWitResponseChange PendingPartialResponseChanges{EWitResponseChange::None};
+
+	/** Decides when to speculatively understand the partial transcription of the current request and whether the result can be used */
+	FWitSpeculativeUnderstanding SpeculativeUnderstanding{};
+
+	/** The speculative /message request for the current request if any */
+	TSharedPtr<FWitRequest, ESPMode::ThreadSafe> SpeculativeRequest{};
+
+	/** Finds the app's keyword entities in partial transcriptions. Built from the app data the first time it is needed */
+	FWitKeywordExtractor KeywordExtractor{};
+
+	/** The keyword entities found in the most recent partial transcription of the current request */
+	TArray<FWitEntity> LastKeywordEntities{};
+
+	/** Is continuous streaming enabled? */
+	bool bIsContinuousStreamingEnabled{false};
+
+	/** How long in seconds a request streams before it is handed over at the next pause */
+	float ContinuousSegmentTime{15.0f};
+
+	/** How long in seconds of voice data is sent to both requests when handing over */
+	float ContinuousOverlapTime{0.3f};
+
+	/** Identifies the current speech request. Responses from requests that have been handed over carry an earlier segment */
+	uint32 RequestSegment{0};
+
+	/** The first segment of the current stream. Later segments of the same stream start with voice data overlapping the previous one */
+	uint32 StreamStartSegment{0};
+
+	/** The segment of the current stream whose final response is to be delivered next */
+	uint32 NextFinalSegment{0};
+
+	/** Final responses of the current stream waiting for those of earlier segments. Unset if the segment failed */
+	TMap<uint32, TOptional<FWitResponse>> PendingFinalResponses{};
+
+	/** The untrimmed transcription of the most recently delivered final response of the current stream. Used to remove the overlap from the next segment */
+	FString LastFinalSegmentText{};
+
+	/** Requests that have been handed over and are still finalizing */
+	TArray<TSharedRef<FWitRequest, ESPMode::ThreadSafe>> RetiringRequests{};
+
+	/** Answers repeated text sent with SendTranscription without making a request */
+	FWitMessageCache MessageCache{};
+
 #ifdef CPP_PLUGIN
 #if PLATFORM_ANDROID
 	std::shared_ptr<IAudioStreamInputProvider> StreamInputProvider;
@@ -9,9 +9,16 @@
 
 #include "SWitUnderstandingViewerTab.h"
 #include "Misc/EngineVersionComparison.h"
+#include "DesktopPlatformModule.h"
 #include "DetailLayoutBuilder.h"
+#include "IDesktopPlatform.h"
+#include "Framework/Application/SlateApplication.h"
 #include "Voice/Experience/VoiceExperience.h"
+#include "Widgets/Input/SSpinBox.h"
 #include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/STableRow.h"
+#include "Wit/Configuration/WitAppConfigurationAsset.h"
 #include "Engine/Selection.h"
 #include "Editor.h"
 #include "EditorStyleSet.h"
@@ -19,6 +26,111 @@
 
 #define LOCTEXT_NAMESPACE "SWitUnderstandingViewerTab"
 
+/**
+ * Names of the columns in the corpus results table
+ */
+namespace WitCorpusColumns
+{
+	static const FName Utterance(TEXT("Utterance"));
+	static const FName Expected(TEXT("Expected"));
+	static const FName Actual(TEXT("Actual"));
+	static const FName Confidence(TEXT("Confidence"));
+	static const FName Latency(TEXT("Latency"));
+	static const FName Status(TEXT("Status"));
+}
+
+/**
+ * Row widget for a single corpus result
+ */
+class SWitCorpusResultRow final : public SMultiColumnTableRow<TSharedPtr<FWitCorpusItem>>
+{
+public:
+
+	SLATE_BEGIN_ARGS(SWitCorpusResultRow) {}
+	SLATE_END_ARGS()
+
+	/** Define the slate layout for the row */
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable, TSharedPtr<FWitCorpusItem> InItem)
+	{
+		Item = InItem;
+
+		SMultiColumnTableRow<TSharedPtr<FWitCorpusItem>>::Construct(FSuperRowType::FArguments(), OwnerTable);
+	}
+
+	/** Generate the widget for the given column */
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		return SNew(STextBlock)
+			.Font(IDetailLayoutBuilder::GetDetailFont())
+			.Text(GetColumnText(ColumnName))
+			.ColorAndOpacity(GetColumnColor(ColumnName));
+	}
+
+private:
+
+	/** Get the text to display in the given column */
+	FText GetColumnText(const FName& ColumnName) const
+	{
+		if (ColumnName == WitCorpusColumns::Utterance)
+		{
+			return FText::FromString(Item->Text);
+		}
+		
+		if (ColumnName == WitCorpusColumns::Expected)
+		{
+			return FText::FromString(Item->ExpectedIntent);
+		}
+
+		if (!Item->bIsComplete)
+		{
+			return ColumnName == WitCorpusColumns::Status ? LOCTEXT("CorpusStatusPending", "Pending") : FText::GetEmpty();
+		}
+
+		if (ColumnName == WitCorpusColumns::Actual)
+		{
+			return FText::FromString(Item->ActualIntent);
+		}
+
+		if (ColumnName == WitCorpusColumns::Confidence)
+		{
+			return FText::FromString(FString::Printf(TEXT("%.3f"), Item->Confidence));
+		}
+
+		if (ColumnName == WitCorpusColumns::Latency)
+		{
+			return FText::FromString(FString::Printf(TEXT("%.0f ms"), Item->Latency * 1000.0));
+		}
+
+		if (!Item->bIsSuccessful)
+		{
+			return FText::FromString(Item->ErrorMessage);
+		}
+
+		if (!Item->HasExpectation())
+		{
+			return LOCTEXT("CorpusStatusDone", "Done");
+		}
+
+		return Item->IsCorrect() ? LOCTEXT("CorpusStatusCorrect", "Correct") : LOCTEXT("CorpusStatusIncorrect", "Incorrect");
+	}
+
+	/** Get the color to display the given column in. Failures are highlighted in the status column */
+	FSlateColor GetColumnColor(const FName& ColumnName) const
+	{
+		const bool bIsFailure = Item->bIsComplete && (!Item->bIsSuccessful || (Item->HasExpectation() && !Item->IsCorrect()));
+
+		if (ColumnName == WitCorpusColumns::Status && bIsFailure)
+		{
+			return FLinearColor(0.9f, 0.2f, 0.2f, 1.0f);
+		}
+
+		return FSlateColor::UseForeground();
+	}
+
+	/** The corpus item this row displays */
+	TSharedPtr<FWitCorpusItem> Item{};
+};
+
 /**
  * Construct the panel for the understanding viewer
  *
@@ -173,10 +285,183 @@ void SWitUnderstandingViewerTab::Construct(const FArguments& InArgs)
 					]
 				]	
 			]
+
+			+ SVerticalBox::Slot().Padding(0,10).AutoHeight()
+			[
+				SNew(SBox)
+			]
+
+			// Section to run a whole corpus of utterances and report the accuracy and latency
+			
+			+ SVerticalBox::Slot().AutoHeight().Padding(5)
+			[
+				SNew(STextBlock)
+				.Font(FCoreStyle::GetDefaultFontStyle("Bold", 9))
+				.ColorAndOpacity( FLinearColor( 0.5f, 0.5f, 0.5f, 1.0f ) )
+				.Text(LOCTEXT("CorpusTitle", "Batch corpus"))
+			]
+
+			+ SVerticalBox::Slot().AutoHeight()
+			[
+				SNew(SBorder)
+				.Padding(5)
+				.BorderImage( WitEditorHelperUtilities::GetBrush("ToolPanel.GroupBorder") )
+				.Content()
+				[
+					SNew(SVerticalBox)
+
+					+ SVerticalBox::Slot().Padding(0, 1).AutoHeight()
+					[
+						SNew(SHorizontalBox)
+						
+						+ SHorizontalBox::Slot().VAlign(VAlign_Center).FillWidth(0.1f).Padding(10, 0)
+						[
+							SNew(STextBlock)
+							.Font(IDetailLayoutBuilder::GetDetailFont())
+							.ToolTipText(LOCTEXT("CorpusTooltip", "A CSV file of utterances and expected intents or a JSON array of objects with text and intent fields"))
+							.Text(LOCTEXT("CorpusLabel", "Corpus"))
+						]
+
+						+ SHorizontalBox::Slot().VAlign(VAlign_Center).FillWidth(0.9f).Padding(0, 1, 10, 1)
+						[
+							SNew(SHorizontalBox)
+
+							+ SHorizontalBox::Slot().VAlign(VAlign_Center).FillWidth(1.0f)
+							[
+								SNew(STextBlock)
+								.Font(IDetailLayoutBuilder::GetDetailFont())
+								.Text(this, &SWitUnderstandingViewerTab::GetCorpusPathText)
+							]
+
+							+ SHorizontalBox::Slot().AutoWidth().Padding(5, 0, 0, 0)
+							[
+								SNew(SButton)
+								.ToolTipText(LOCTEXT("LoadCorpusTooltip", "Load a corpus of utterances from a CSV or JSON file"))
+								.Text(LOCTEXT("LoadCorpusButton", "Load..."))
+								.IsEnabled(this, &SWitUnderstandingViewerTab::IsLoadCorpusButtonEnabled)
+								.OnClicked(this, &SWitUnderstandingViewerTab::OnLoadCorpusButtonClicked)
+							]
+						]
+					]
+
+					+ SVerticalBox::Slot().Padding(0, 1).AutoHeight()
+					[
+						SNew(SHorizontalBox)
+						
+						+ SHorizontalBox::Slot().VAlign(VAlign_Center).FillWidth(0.1f).Padding(10, 0)
+						[
+							SNew(STextBlock)
+							.Font(IDetailLayoutBuilder::GetDetailFont())
+							.ToolTipText(LOCTEXT("ConcurrencyTooltip", "The maximum number of requests in flight at once"))
+							.Text(LOCTEXT("ConcurrencyLabel", "Concurrency"))
+						]
+
+						+ SHorizontalBox::Slot().FillWidth(0.9f).Padding(0, 1, 10, 1)
+						[
+							SNew(SSpinBox<int32>)
+							.Font(IDetailLayoutBuilder::GetDetailFont())
+							.MinValue(1)
+							.MaxValue(64)
+							.Value(this, &SWitUnderstandingViewerTab::GetCorpusConcurrency)
+							.OnValueChanged(this, &SWitUnderstandingViewerTab::OnCorpusConcurrencyChanged)
+						]
+					]
+
+					+ SVerticalBox::Slot().Padding(0, 1).AutoHeight()
+					[
+						SNew(SHorizontalBox)
+						
+						+ SHorizontalBox::Slot().VAlign(VAlign_Center).FillWidth(0.1f).Padding(10, 0)
+						[
+							SNew(STextBlock)
+							.Font(IDetailLayoutBuilder::GetDetailFont())
+							.ToolTipText(LOCTEXT("RateLimitTooltip", "The maximum number of requests started per minute so that the run stays within the app's rate limit. Zero for no limit"))
+							.Text(LOCTEXT("RateLimitLabel", "Requests per minute"))
+						]
+
+						+ SHorizontalBox::Slot().FillWidth(0.9f).Padding(0, 1, 10, 1)
+						[
+							SNew(SSpinBox<float>)
+							.Font(IDetailLayoutBuilder::GetDetailFont())
+							.MinValue(0.0f)
+							.MaxValue(6000.0f)
+							.Delta(1.0f)
+							.Value(this, &SWitUnderstandingViewerTab::GetCorpusRequestsPerMinute)
+							.OnValueChanged(this, &SWitUnderstandingViewerTab::OnCorpusRequestsPerMinuteChanged)
+						]
+					]
+
+					+ SVerticalBox::Slot().Padding(0, 0).AutoHeight()
+					[
+						SNew(SHorizontalBox)
+
+						+ SHorizontalBox::Slot().VAlign(VAlign_Center).FillWidth(1.0f).Padding(10, 5, 10, 2)
+						[
+							SNew(STextBlock)
+							.Font(IDetailLayoutBuilder::GetDetailFont())
+							.AutoWrapText(true)
+							.Text(this, &SWitUnderstandingViewerTab::GetCorpusSummaryText)
+						]
+			
+						+ SHorizontalBox::Slot().AutoWidth().HAlign(HAlign_Right).Padding(0, 5, 5, 2)
+						[
+							SNew(SButton)
+							.ToolTipText(LOCTEXT("RunCorpusTooltip", "Send every utterance in the corpus to Wit.ai using the selected voice experience's configuration"))
+							.Text(this, &SWitUnderstandingViewerTab::GetRunCorpusButtonText)
+							.IsEnabled(this, &SWitUnderstandingViewerTab::IsRunCorpusButtonEnabled)
+							.OnClicked(this, &SWitUnderstandingViewerTab::OnRunCorpusButtonClicked)
+						]
+
+						+ SHorizontalBox::Slot().AutoWidth().HAlign(HAlign_Right).Padding(0, 5, 10, 2)
+						[
+							SNew(SButton)
+							.ToolTipText(LOCTEXT("ExportReportTooltip", "Export the results and summary as a JSON or CSV report"))
+							.Text(LOCTEXT("ExportReportButton", "Export..."))
+							.IsEnabled(this, &SWitUnderstandingViewerTab::IsExportReportButtonEnabled)
+							.OnClicked(this, &SWitUnderstandingViewerTab::OnExportReportButtonClicked)
+						]
+					]
+
+					// The list is given a fixed height because a list view inside a scroll box would otherwise generate every row
+
+					+ SVerticalBox::Slot().Padding(10, 5).AutoHeight()
+					[
+						SNew(SBox)
+						.HeightOverride(400.0f)
+						[
+							SAssignNew(CorpusListView, SListView<TSharedPtr<FWitCorpusItem>>)
+							.ListItemsSource(&CorpusItems)
+							.SelectionMode(ESelectionMode::None)
+							.OnGenerateRow(this, &SWitUnderstandingViewerTab::OnGenerateCorpusRow)
+							.HeaderRow
+							(
+								SNew(SHeaderRow)
+								+ SHeaderRow::Column(WitCorpusColumns::Utterance).DefaultLabel(LOCTEXT("UtteranceColumn", "Utterance")).FillWidth(0.35f)
+								+ SHeaderRow::Column(WitCorpusColumns::Expected).DefaultLabel(LOCTEXT("ExpectedColumn", "Expected")).FillWidth(0.15f)
+								+ SHeaderRow::Column(WitCorpusColumns::Actual).DefaultLabel(LOCTEXT("ActualColumn", "Actual")).FillWidth(0.15f)
+								+ SHeaderRow::Column(WitCorpusColumns::Confidence).DefaultLabel(LOCTEXT("ConfidenceColumn", "Confidence")).FillWidth(0.1f)
+								+ SHeaderRow::Column(WitCorpusColumns::Latency).DefaultLabel(LOCTEXT("LatencyColumn", "Latency")).FillWidth(0.1f)
+								+ SHeaderRow::Column(WitCorpusColumns::Status).DefaultLabel(LOCTEXT("StatusColumn", "Status")).FillWidth(0.15f)
+							)
+						]
+					]
+				]
+			]
 		]
 	];
 }
 
+/**
+ * Destructor. Cancels any corpus run in progress
+ */
+SWitUnderstandingViewerTab::~SWitUnderstandingViewerTab()
+{
+	if (CorpusBatch.IsValid())
+	{
+		CorpusBatch->Cancel();
+	}
+}
+
 /**
  * Whether we should show the selection usage message
  * 
@@ -358,6 +643,291 @@ FReply SWitUnderstandingViewerTab::OnUtteranceKeyDown(const FGeometry&, const FK
 	}
 }
 
+/**
+ * Callback when the load corpus button is clicked. Asks the user for a corpus file and loads it
+ * 
+ * @return whether the reply was handled or not
+ */
+FReply SWitUnderstandingViewerTab::OnLoadCorpusButtonClicked()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+
+	if (DesktopPlatform == nullptr)
+	{
+		return FReply::Handled();
+	}
+
+	TArray<FString> Paths;
+
+	const bool bIsFileSelected = DesktopPlatform->OpenFileDialog(FSlateApplication::Get().FindBestParentWindowHandleForDialogs(AsShared()),
+		LOCTEXT("LoadCorpusTitle", "Load corpus").ToString(), FPaths::GetPath(CorpusPath), FString(),
+		TEXT("Corpus files (*.csv;*.json)|*.csv;*.json"), EFileDialogFlags::None, Paths);
+
+	if (!bIsFileSelected || Paths.Num() == 0)
+	{
+		return FReply::Handled();
+	}
+
+	CorpusPath = Paths[0];
+
+	if (!FWitUnderstandingCorpus::LoadCorpus(CorpusPath, CorpusItems))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("OnLoadCorpusButtonClicked: unable to load any utterances from (%s)"), *CorpusPath);
+	}
+
+	CorpusSummary = FWitUnderstandingCorpus::CalculateSummary(CorpusItems);
+	CorpusListView->RequestListRefresh();
+
+	return FReply::Handled();
+}
+
+/**
+ * Callback when the run corpus button is clicked. This starts sending the whole corpus to Wit.ai or cancels the run in progress
+ * 
+ * @return whether the reply was handled or not
+ */
+FReply SWitUnderstandingViewerTab::OnRunCorpusButtonClicked()
+{
+	if (CorpusBatch.IsValid())
+	{
+		CorpusBatch->Cancel();
+		return FReply::Handled();
+	}
+
+	const AVoiceExperience* VoiceExperience = GetSelectedVoiceExperience();
+
+	if (VoiceExperience == nullptr || VoiceExperience->Configuration == nullptr || CorpusItems.Num() == 0)
+	{
+		return FReply::Handled();
+	}
+
+	TArray<FString> Texts;
+	Texts.Reserve(CorpusItems.Num());
+
+	for (const TSharedPtr<FWitCorpusItem>& Item : CorpusItems)
+	{
+		*Item = FWitCorpusItem{Item->Text, Item->ExpectedIntent};
+		Texts.Add(Item->Text);
+	}
+
+	CorpusSummary = FWitUnderstandingCorpus::CalculateSummary(CorpusItems);
+	CorpusListView->RequestListRefresh();
+
+	// The corpus goes straight to the request layer so that it does not disturb the voice experience's own requests and events
+
+	FWitMessageBatchSettings Settings{};
+
+	Settings.Application = VoiceExperience->Configuration->Application;
+	Settings.Concurrency = CorpusConcurrency;
+	Settings.MaximumRequestsPerMinute = CorpusRequestsPerMinute;
+
+	CorpusBatch = FWitMessageBatch::SendTranscriptions(Texts, Settings, FOnWitMessageResultDelegate::CreateSP(this, &SWitUnderstandingViewerTab::OnCorpusResult),
+		FOnWitMessageBatchCompleteDelegate::CreateSP(this, &SWitUnderstandingViewerTab::OnCorpusComplete));
+
+	return FReply::Handled();
+}
+
+/**
+ * Callback when the export report button is clicked. Asks the user for a file and writes the report to it
+ * 
+ * @return whether the reply was handled or not
+ */
+FReply SWitUnderstandingViewerTab::OnExportReportButtonClicked()
+{
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+
+	if (DesktopPlatform == nullptr)
+	{
+		return FReply::Handled();
+	}
+
+	TArray<FString> Paths;
+
+	const bool bIsFileSelected = DesktopPlatform->SaveFileDialog(FSlateApplication::Get().FindBestParentWindowHandleForDialogs(AsShared()),
+		LOCTEXT("ExportReportTitle", "Export report").ToString(), FPaths::GetPath(CorpusPath), FPaths::GetBaseFilename(CorpusPath) + TEXT("_report.json"),
+		TEXT("JSON report (*.json)|*.json|CSV report (*.csv)|*.csv"), EFileDialogFlags::None, Paths);
+
+	if (!bIsFileSelected || Paths.Num() == 0)
+	{
+		return FReply::Handled();
+	}
+
+	if (!FWitUnderstandingCorpus::ExportReport(Paths[0], CorpusItems, FWitUnderstandingCorpus::CalculateSummary(CorpusItems)))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("OnExportReportButtonClicked: unable to write report (%s)"), *Paths[0]);
+	}
+
+	return FReply::Handled();
+}
+
+/**
+ * Determines if the load corpus button should be enabled or not. The corpus cannot change during a run
+ * 
+ * @return true if enabled otherwise false
+ */
+bool SWitUnderstandingViewerTab::IsLoadCorpusButtonEnabled() const
+{
+	return !CorpusBatch.IsValid();
+}
+
+/**
+ * Determines if the run corpus button should be enabled or not. It is always enabled during a run so that the run can be cancelled
+ * 
+ * @return true if enabled otherwise false
+ */
+bool SWitUnderstandingViewerTab::IsRunCorpusButtonEnabled() const
+{
+	if (CorpusBatch.IsValid())
+	{
+		return true;
+	}
+
+	const AVoiceExperience* VoiceExperience = GetSelectedVoiceExperience();
+
+	return VoiceExperience != nullptr && VoiceExperience->Configuration != nullptr && CorpusItems.Num() > 0;
+}
+
+/**
+ * Determines if the export report button should be enabled or not
+ * 
+ * @return true if enabled otherwise false
+ */
+bool SWitUnderstandingViewerTab::IsExportReportButtonEnabled() const
+{
+	return !CorpusBatch.IsValid() && CorpusSummary.NumComplete > 0;
+}
+
+/**
+ * Gets the text of the run corpus button
+ * 
+ * @return the text to display
+ */
+FText SWitUnderstandingViewerTab::GetRunCorpusButtonText() const
+{
+	return CorpusBatch.IsValid() ? LOCTEXT("CancelCorpusButton", "Cancel") : LOCTEXT("RunCorpusButton", "Run");
+}
+
+/**
+ * Gets the text to display for the loaded corpus
+ * 
+ * @return the text to display
+ */
+FText SWitUnderstandingViewerTab::GetCorpusPathText() const
+{
+	if (CorpusPath.IsEmpty())
+	{
+		return LOCTEXT("NoCorpus", "No corpus loaded");
+	}
+
+	return FText::FromString(FString::Printf(TEXT("%s (%d utterances)"), *CorpusPath, CorpusItems.Num()));
+}
+
+/**
+ * Gets the summary of the current corpus results
+ * 
+ * @return the text to display
+ */
+FText SWitUnderstandingViewerTab::GetCorpusSummaryText() const
+{
+	if (CorpusSummary.NumComplete == 0)
+	{
+		return FText::GetEmpty();
+	}
+
+	return FText::FromString(FString::Printf(TEXT("Complete %d/%d, errors %d, accuracy %.1f%% (%d/%d), latency mean %.0f ms, p50 %.0f ms, p90 %.0f ms, p99 %.0f ms, max %.0f ms"),
+		CorpusSummary.NumComplete, CorpusSummary.NumItems, CorpusSummary.NumErrors, CorpusSummary.Accuracy * 100.0f, CorpusSummary.NumCorrect,
+		CorpusSummary.NumWithExpectation, CorpusSummary.LatencyMean * 1000.0, CorpusSummary.LatencyP50 * 1000.0, CorpusSummary.LatencyP90 * 1000.0,
+		CorpusSummary.LatencyP99 * 1000.0, CorpusSummary.LatencyMax * 1000.0));
+}
+
+/**
+ * Callbacks used by the corpus concurrency spin box
+ */
+int32 SWitUnderstandingViewerTab::GetCorpusConcurrency() const
+{
+	return CorpusConcurrency;
+}
+
+void SWitUnderstandingViewerTab::OnCorpusConcurrencyChanged(int32 InValue)
+{
+	CorpusConcurrency = InValue;
+}
+
+/**
+ * Callbacks used by the corpus rate limit spin box
+ */
+float SWitUnderstandingViewerTab::GetCorpusRequestsPerMinute() const
+{
+	return CorpusRequestsPerMinute;
+}
+
+void SWitUnderstandingViewerTab::OnCorpusRequestsPerMinuteChanged(float InValue)
+{
+	CorpusRequestsPerMinute = InValue;
+}
+
+/**
+ * Generate the row widget for a corpus result
+ *
+ * @param Item [in] the corpus item to display
+ * @param OwnerTable [in] the list view that owns the row
+ * @return the row widget
+ */
+TSharedRef<ITableRow> SWitUnderstandingViewerTab::OnGenerateCorpusRow(TSharedPtr<FWitCorpusItem> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SWitCorpusResultRow, OwnerTable, Item);
+}
+
+/**
+ * Callback when a single corpus utterance completes. The summary is only recalculated periodically because doing so for every
+ * result would be quadratic in the size of the corpus
+ *
+ * @param Result [in] the result of the utterance
+ */
+void SWitUnderstandingViewerTab::OnCorpusResult(const FWitMessageBatchResult& Result)
+{
+	if (!CorpusItems.IsValidIndex(Result.Index))
+	{
+		return;
+	}
+
+	FWitUnderstandingCorpus::ApplyResult(Result, *CorpusItems[Result.Index]);
+
+	++CorpusSummary.NumComplete;
+
+	const bool bShouldUpdateSummary = CorpusSummary.NumComplete % 50 == 0;
+
+	if (bShouldUpdateSummary)
+	{
+		CorpusSummary = FWitUnderstandingCorpus::CalculateSummary(CorpusItems);
+	}
+
+	CorpusListView->RequestListRefresh();
+}
+
+/**
+ * Callback when the whole corpus completes or is cancelled
+ *
+ * @param Results [in] the results of every utterance
+ */
+void SWitUnderstandingViewerTab::OnCorpusComplete(const TArray<FWitMessageBatchResult>& Results)
+{
+	for (const FWitMessageBatchResult& Result : Results)
+	{
+		const bool bIsUnreported = CorpusItems.IsValidIndex(Result.Index) && !CorpusItems[Result.Index]->bIsComplete;
+
+		if (bIsUnreported)
+		{
+			FWitUnderstandingCorpus::ApplyResult(Result, *CorpusItems[Result.Index]);
+		}
+	}
+
+	CorpusSummary = FWitUnderstandingCorpus::CalculateSummary(CorpusItems);
+	CorpusListView->RequestListRefresh();
+
+	CorpusBatch.Reset();
+}
+
 /**
  * Gets the selected WitVoiceExperience in the scene (if any)
  * 
@@ -10,7 +10,10 @@
 #include "CoreMinimal.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
 #include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
 #include "Wit/Request/WitResponse.h"
+#include "Wit/Voice/WitMessageBatch.h"
+#include "WitUnderstandingCorpus.h"
 #include "SWitUnderstandingViewerTab.generated.h"
 
 class AVoiceExperience;
@@ -51,6 +54,9 @@ class SWitUnderstandingViewerTab : public SCompoundWidget
 	/** Define the slate layout for the widget */
 	void Construct(const FArguments& InArgs);
 
+	/** Cancels any corpus run in progress */
+	virtual ~SWitUnderstandingViewerTab() override;
+
 protected:
 
 	/** Gets the currently selected voice experience or null if there is none */ 
@@ -71,6 +77,32 @@ protected:
 	EVisibility GetWaitMessageVisibility() const;
 	EVisibility GetResultVisibility() const;
 
+	/** Callbacks used by the corpus batch mode buttons */
+	FReply OnLoadCorpusButtonClicked();
+	FReply OnRunCorpusButtonClicked();
+	FReply OnExportReportButtonClicked();
+	bool IsLoadCorpusButtonEnabled() const;
+	bool IsRunCorpusButtonEnabled() const;
+	bool IsExportReportButtonEnabled() const;
+	FText GetRunCorpusButtonText() const;
+
+	/** Callbacks used to display the corpus details and summary */
+	FText GetCorpusPathText() const;
+	FText GetCorpusSummaryText() const;
+
+	/** Callbacks used by the corpus batch mode settings */
+	int32 GetCorpusConcurrency() const;
+	void OnCorpusConcurrencyChanged(int32 InValue);
+	float GetCorpusRequestsPerMinute() const;
+	void OnCorpusRequestsPerMinuteChanged(float InValue);
+
+	/** Generate the row widget for a corpus result */
+	TSharedRef<ITableRow> OnGenerateCorpusRow(TSharedPtr<FWitCorpusItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Callbacks from the corpus batch as each utterance and then the whole corpus completes */
+	void OnCorpusResult(const FWitMessageBatchResult& Result);
+	void OnCorpusComplete(const TArray<FWitMessageBatchResult>& Results);
+
 	/** The current text entered by the user as an utterance */
 	FText UtteranceText{};
 
@@ -79,5 +111,26 @@ protected:
 
 	/** A UObject wrapper for the response structure so that we can display it in the details widget */
 	UWitResponseObject* ResponseObject{};
+
+	/** The path of the currently loaded corpus */
+	FString CorpusPath{};
+
+	/** The utterances in the currently loaded corpus and their results */
+	TArray<TSharedPtr<FWitCorpusItem>> CorpusItems{};
+
+	/** Statistics for the current corpus results */
+	FWitCorpusSummary CorpusSummary{};
+
+	/** List view that displays the corpus results. Only the visible rows are generated so large corpora remain responsive */
+	TSharedPtr<SListView<TSharedPtr<FWitCorpusItem>>> CorpusListView{};
+
+	/** The corpus run in progress if any */
+	TSharedPtr<FWitMessageBatch, ESPMode::ThreadSafe> CorpusBatch{};
+
+	/** The maximum number of corpus requests in flight at once */
+	int32 CorpusConcurrency{8};
+
+	/** The maximum number of corpus requests started per minute. Zero for no limit */
+	float CorpusRequestsPerMinute{0.0f};
 	
 };
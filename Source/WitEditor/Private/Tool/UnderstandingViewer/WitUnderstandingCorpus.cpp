@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "WitUnderstandingCorpus.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/Csv/CsvParser.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Wit/Voice/WitMessageBatch.h"
+
+/**
+ * Load a corpus from a CSV or JSON file
+ *
+ * @param Path [in] the file to load
+ * @param OutItems [out] the utterances loaded
+ * @return true if successful
+ */
+bool FWitUnderstandingCorpus::LoadCorpus(const FString& Path, TArray<TSharedPtr<FWitCorpusItem>>& OutItems)
+{
+	OutItems.Reset();
+
+	FString Content;
+
+	if (!FFileHelper::LoadFileToString(Content, *Path))
+	{
+		return false;
+	}
+
+	const bool bIsCsvFile = FPaths::GetExtension(Path).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+
+	if (bIsCsvFile)
+	{
+		return LoadCsvCorpus(Content, OutItems);
+	}
+
+	return LoadJsonCorpus(Content, OutItems);
+}
+
+/**
+ * Fill in a corpus item from the result of sending it. The highest confidence intent is taken as the answer
+ *
+ * @param Result [in] the result of the request
+ * @param Item [out] the item to update
+ */
+void FWitUnderstandingCorpus::ApplyResult(const FWitMessageBatchResult& Result, FWitCorpusItem& Item)
+{
+	Item.bIsComplete = true;
+	Item.bIsSuccessful = Result.bIsSuccessful;
+	Item.ErrorMessage = Result.ErrorMessage;
+	Item.Latency = Result.Latency;
+	Item.NumAttempts = Result.NumAttempts;
+	Item.ActualIntent.Reset();
+	Item.Confidence = 0.0f;
+
+	for (const FWitIntent& Intent : Result.Response.Intents)
+	{
+		if (Intent.Confidence > Item.Confidence || Item.ActualIntent.IsEmpty())
+		{
+			Item.ActualIntent = Intent.Name;
+			Item.Confidence = Intent.Confidence;
+		}
+	}
+}
+
+/**
+ * Calculate the aggregate statistics for a corpus
+ *
+ * @param Items [in] the utterances and their results
+ * @return the summary
+ */
+FWitCorpusSummary FWitUnderstandingCorpus::CalculateSummary(const TArray<TSharedPtr<FWitCorpusItem>>& Items)
+{
+	FWitCorpusSummary Summary{};
+
+	Summary.NumItems = Items.Num();
+
+	TArray<double> Latencies;
+	Latencies.Reserve(Items.Num());
+
+	for (const TSharedPtr<FWitCorpusItem>& Item : Items)
+	{
+		if (!Item->bIsComplete)
+		{
+			continue;
+		}
+
+		++Summary.NumComplete;
+
+		if (!Item->bIsSuccessful)
+		{
+			++Summary.NumErrors;
+		}
+		else
+		{
+			Latencies.Add(Item->Latency);
+		}
+
+		if (Item->HasExpectation())
+		{
+			++Summary.NumWithExpectation;
+			Summary.NumCorrect += Item->IsCorrect() ? 1 : 0;
+		}
+	}
+
+	if (Summary.NumWithExpectation > 0)
+	{
+		Summary.Accuracy = static_cast<float>(Summary.NumCorrect) / Summary.NumWithExpectation;
+	}
+
+	if (Latencies.Num() == 0)
+	{
+		return Summary;
+	}
+
+	Latencies.Sort();
+
+	double TotalLatency = 0.0;
+
+	for (const double Latency : Latencies)
+	{
+		TotalLatency += Latency;
+	}
+
+	Summary.LatencyMean = TotalLatency / Latencies.Num();
+	Summary.LatencyP50 = GetPercentile(Latencies, 0.5);
+	Summary.LatencyP90 = GetPercentile(Latencies, 0.9);
+	Summary.LatencyP99 = GetPercentile(Latencies, 0.99);
+	Summary.LatencyMax = Latencies.Last();
+
+	return Summary;
+}
+
+/**
+ * Export a report of a corpus run. The format is CSV if the path has a .csv extension and JSON otherwise
+ *
+ * @param Path [in] the file to write
+ * @param Items [in] the utterances and their results
+ * @param Summary [in] the aggregate statistics
+ * @return true if successful
+ */
+bool FWitUnderstandingCorpus::ExportReport(const FString& Path, const TArray<TSharedPtr<FWitCorpusItem>>& Items, const FWitCorpusSummary& Summary)
+{
+	FString Output;
+
+	const bool bIsCsvFile = FPaths::GetExtension(Path).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+
+	if (bIsCsvFile)
+	{
+		// The summary is left out of the CSV report so that it loads cleanly into spreadsheets. It is easy to recalculate there
+
+		Output += TEXT("text,expected_intent,actual_intent,confidence,correct,latency,attempts,error\n");
+
+		for (const TSharedPtr<FWitCorpusItem>& Item : Items)
+		{
+			Output += FString::Printf(TEXT("%s,%s,%s,%.4f,%d,%.4f,%d,%s\n"), *EscapeCsvValue(Item->Text), *EscapeCsvValue(Item->ExpectedIntent),
+				*EscapeCsvValue(Item->ActualIntent), Item->Confidence, Item->IsCorrect() ? 1 : 0, Item->Latency, Item->NumAttempts,
+				*EscapeCsvValue(Item->ErrorMessage));
+		}
+
+		return FFileHelper::SaveStringToFile(Output, *Path);
+	}
+
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+
+	Writer->WriteObjectStart();
+
+	Writer->WriteObjectStart(TEXT("summary"));
+	Writer->WriteValue(TEXT("utterances"), Summary.NumItems);
+	Writer->WriteValue(TEXT("complete"), Summary.NumComplete);
+	Writer->WriteValue(TEXT("errors"), Summary.NumErrors);
+	Writer->WriteValue(TEXT("with_expectation"), Summary.NumWithExpectation);
+	Writer->WriteValue(TEXT("correct"), Summary.NumCorrect);
+	Writer->WriteValue(TEXT("accuracy"), Summary.Accuracy);
+	Writer->WriteValue(TEXT("latency_mean"), Summary.LatencyMean);
+	Writer->WriteValue(TEXT("latency_p50"), Summary.LatencyP50);
+	Writer->WriteValue(TEXT("latency_p90"), Summary.LatencyP90);
+	Writer->WriteValue(TEXT("latency_p99"), Summary.LatencyP99);
+	Writer->WriteValue(TEXT("latency_max"), Summary.LatencyMax);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteArrayStart(TEXT("results"));
+
+	for (const TSharedPtr<FWitCorpusItem>& Item : Items)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("text"), Item->Text);
+		Writer->WriteValue(TEXT("expected_intent"), Item->ExpectedIntent);
+		Writer->WriteValue(TEXT("actual_intent"), Item->ActualIntent);
+		Writer->WriteValue(TEXT("confidence"), Item->Confidence);
+		Writer->WriteValue(TEXT("correct"), Item->IsCorrect());
+		Writer->WriteValue(TEXT("latency"), Item->Latency);
+		Writer->WriteValue(TEXT("attempts"), Item->NumAttempts);
+		Writer->WriteValue(TEXT("error"), Item->ErrorMessage);
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return FFileHelper::SaveStringToFile(Output, *Path);
+}
+
+/**
+ * Load a corpus from CSV text. A first row whose first cell is "text" is treated as a header
+ *
+ * @param Content [in] the CSV text
+ * @param OutItems [out] the utterances loaded
+ * @return true if successful
+ */
+bool FWitUnderstandingCorpus::LoadCsvCorpus(const FString& Content, TArray<TSharedPtr<FWitCorpusItem>>& OutItems)
+{
+	const FCsvParser Parser(Content);
+	const FCsvParser::FRows& Rows = Parser.GetRows();
+
+	for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		const TArray<const TCHAR*>& Row = Rows[RowIndex];
+
+		if (Row.Num() == 0)
+		{
+			continue;
+		}
+
+		const FString Text = FString(Row[0]).TrimStartAndEnd();
+		const bool bIsHeader = RowIndex == 0 && Text.Equals(TEXT("text"), ESearchCase::IgnoreCase);
+
+		if (bIsHeader || Text.IsEmpty())
+		{
+			continue;
+		}
+
+		TSharedPtr<FWitCorpusItem> Item = MakeShared<FWitCorpusItem>();
+
+		Item->Text = Text;
+		Item->ExpectedIntent = Row.Num() > 1 ? FString(Row[1]).TrimStartAndEnd() : FString();
+
+		OutItems.Add(Item);
+	}
+
+	return OutItems.Num() > 0;
+}
+
+/**
+ * Load a corpus from JSON text. Either a top level array or an object with an "utterances" array is accepted
+ *
+ * @param Content [in] the JSON text
+ * @param OutItems [out] the utterances loaded
+ * @return true if successful
+ */
+bool FWitUnderstandingCorpus::LoadJsonCorpus(const FString& Content, TArray<TSharedPtr<FWitCorpusItem>>& OutItems)
+{
+	TSharedPtr<FJsonValue> RootValue;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+
+	if (!FJsonSerializer::Deserialize(Reader, RootValue) || !RootValue.IsValid())
+	{
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* Utterances = nullptr;
+
+	if (RootValue->Type == EJson::Array)
+	{
+		Utterances = &RootValue->AsArray();
+	}
+	else if (RootValue->Type == EJson::Object)
+	{
+		RootValue->AsObject()->TryGetArrayField(TEXT("utterances"), Utterances);
+	}
+
+	if (Utterances == nullptr)
+	{
+		return false;
+	}
+
+	for (const TSharedPtr<FJsonValue>& Utterance : *Utterances)
+	{
+		const TSharedPtr<FJsonObject>* UtteranceObject = nullptr;
+
+		if (!Utterance.IsValid() || !Utterance->TryGetObject(UtteranceObject))
+		{
+			continue;
+		}
+
+		TSharedPtr<FWitCorpusItem> Item = MakeShared<FWitCorpusItem>();
+
+		const bool bHasText = (*UtteranceObject)->TryGetStringField(TEXT("text"), Item->Text) && !Item->Text.TrimStartAndEnd().IsEmpty();
+
+		if (!bHasText)
+		{
+			continue;
+		}
+
+		(*UtteranceObject)->TryGetStringField(TEXT("intent"), Item->ExpectedIntent);
+
+		OutItems.Add(Item);
+	}
+
+	return OutItems.Num() > 0;
+}
+
+/**
+ * Get the given percentile from sorted values using the nearest rank
+ *
+ * @param SortedValues [in] the values in ascending order
+ * @param Percentile [in] the percentile in the range 0 to 1
+ * @return the value at the percentile
+ */
+double FWitUnderstandingCorpus::GetPercentile(const TArray<double>& SortedValues, const double Percentile)
+{
+	const int32 Rank = FMath::CeilToInt(Percentile * SortedValues.Num());
+
+	return SortedValues[FMath::Clamp(Rank - 1, 0, SortedValues.Num() - 1)];
+}
+
+/**
+ * Quote a value for writing to CSV if it contains any characters that need it
+ *
+ * @param Value [in] the value to escape
+ * @return the escaped value
+ */
+FString FWitUnderstandingCorpus::EscapeCsvValue(const FString& Value)
+{
+	int32 Index = INDEX_NONE;
+
+	const bool bNeedsQuotes = Value.FindChar(TEXT(','), Index) || Value.FindChar(TEXT('"'), Index) || Value.FindChar(TEXT('\n'), Index);
+
+	if (!bNeedsQuotes)
+	{
+		return Value;
+	}
+
+	return FString::Printf(TEXT("\"%s\""), *Value.Replace(TEXT("\""), TEXT("\"\"")));
+}
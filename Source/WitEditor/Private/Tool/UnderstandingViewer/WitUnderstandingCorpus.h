@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWitMessageBatchResult;
+
+/**
+ * A single utterance in a corpus along with the result of sending it to Wit.ai
+ */
+struct FWitCorpusItem
+{
+	/** The utterance to send */
+	FString Text{};
+
+	/** The intent we expect Wit.ai to return. Empty if there is no expectation */
+	FString ExpectedIntent{};
+
+	/** The highest confidence intent Wit.ai returned */
+	FString ActualIntent{};
+
+	/** The confidence of the returned intent */
+	float Confidence{0.0f};
+
+	/** Has the utterance been sent and a result received? */
+	bool bIsComplete{false};
+
+	/** Did the request succeed? */
+	bool bIsSuccessful{false};
+
+	/** The error if the request did not succeed */
+	FString ErrorMessage{};
+
+	/** The time in seconds from making the request until its response */
+	double Latency{0.0};
+
+	/** The number of requests made including retries */
+	int32 NumAttempts{0};
+
+	/** Is there an expected intent to compare against? */
+	bool HasExpectation() const
+	{
+		return !ExpectedIntent.IsEmpty();
+	}
+
+	/** Did Wit.ai return the expected intent? */
+	bool IsCorrect() const
+	{
+		return bIsSuccessful && ActualIntent.Equals(ExpectedIntent, ESearchCase::IgnoreCase);
+	}
+};
+
+/**
+ * Aggregate statistics for a corpus run
+ */
+struct FWitCorpusSummary
+{
+	/** The number of utterances in the corpus */
+	int32 NumItems{0};
+
+	/** The number of utterances with a result */
+	int32 NumComplete{0};
+
+	/** The number of requests that failed */
+	int32 NumErrors{0};
+
+	/** The number of completed utterances that have an expected intent */
+	int32 NumWithExpectation{0};
+
+	/** The number of completed utterances where the expected intent was returned */
+	int32 NumCorrect{0};
+
+	/** The fraction of utterances with an expectation where the expected intent was returned */
+	float Accuracy{0.0f};
+
+	/** Latency percentiles in seconds over successful requests */
+	double LatencyMean{0.0};
+	double LatencyP50{0.0};
+	double LatencyP90{0.0};
+	double LatencyP99{0.0};
+	double LatencyMax{0.0};
+};
+
+/**
+ * Loading, scoring and exporting of utterance corpora for the understanding viewer batch mode
+ */
+class FWitUnderstandingCorpus
+{
+public:
+
+	/**
+	 * Load a corpus from a CSV or JSON file. CSV files have the utterance in the first column and an optional expected intent
+	 * in the second with an optional header row. JSON files are an array of objects with a "text" field and an optional
+	 * "intent" field which matches the Wit.ai utterance export format
+	 *
+	 * @param Path [in] the file to load
+	 * @param OutItems [out] the utterances loaded
+	 * @return true if successful
+	 */
+	static bool LoadCorpus(const FString& Path, TArray<TSharedPtr<FWitCorpusItem>>& OutItems);
+
+	/**
+	 * Fill in a corpus item from the result of sending it
+	 *
+	 * @param Result [in] the result of the request
+	 * @param Item [out] the item to update
+	 */
+	static void ApplyResult(const FWitMessageBatchResult& Result, FWitCorpusItem& Item);
+
+	/**
+	 * Calculate the aggregate statistics for a corpus
+	 *
+	 * @param Items [in] the utterances and their results
+	 * @return the summary
+	 */
+	static FWitCorpusSummary CalculateSummary(const TArray<TSharedPtr<FWitCorpusItem>>& Items);
+
+	/**
+	 * Export a report of a corpus run. The format is CSV if the path has a .csv extension and JSON otherwise
+	 *
+	 * @param Path [in] the file to write
+	 * @param Items [in] the utterances and their results
+	 * @param Summary [in] the aggregate statistics
+	 * @return true if successful
+	 */
+	static bool ExportReport(const FString& Path, const TArray<TSharedPtr<FWitCorpusItem>>& Items, const FWitCorpusSummary& Summary);
+
+private:
+
+	/** Load a corpus from CSV text */
+	static bool LoadCsvCorpus(const FString& Content, TArray<TSharedPtr<FWitCorpusItem>>& OutItems);
+
+	/** Load a corpus from JSON text */
+	static bool LoadJsonCorpus(const FString& Content, TArray<TSharedPtr<FWitCorpusItem>>& OutItems);
+
+	/** Get the given percentile from sorted values */
+	static double GetPercentile(const TArray<double>& SortedValues, const double Percentile);
+
+	/** Quote a value for writing to CSV */
+	static FString EscapeCsvValue(const FString& Value);
+};
@@ -20,6 +20,7 @@ public class WitEditor : ModuleRules
 			new string[] {
 				"Core",
 				"CoreUObject",
+				"DesktopPlatform",
 				"Engine",
 				"HTTP",
 				"InputCore",
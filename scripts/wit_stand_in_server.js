@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Minimal local stand-in for the Wit.ai /speech and /message endpoints. It accepts streamed requests, waits for the
+// request body to finish and then answers with a canned response. Intended for benchmarks such as
+// Wit.VoiceSessionBenchmark so that measurements are not dominated by the network.
+//
+// Usage: node wit_stand_in_server.js [port] [responseDelayMs]
+
+const http = require("http");
+
+const port = parseInt(process.argv[2] || "8080", 10);
+const responseDelayMs = parseInt(process.argv[3] || "0", 10);
+
+function createResponse(text) {
+  return {
+    text: text,
+    intents: [{ id: "0", name: "benchmark", confidence: 1.0 }],
+    entities: {},
+    traits: {},
+    is_final: true
+  };
+}
+
+let numActiveRequests = 0;
+let numCompletedRequests = 0;
+
+const server = http.createServer((request, response) => {
+  const url = new URL(request.url, `http://${request.headers.host}`);
+  let numBytesReceived = 0;
+
+  numActiveRequests++;
+
+  request.on("data", (chunk) => {
+    numBytesReceived += chunk.length;
+  });
+
+  request.on("end", () => {
+    const text = url.pathname === "/message" ? url.searchParams.get("q") || "" : `received ${numBytesReceived} bytes`;
+    const body = JSON.stringify(createResponse(text));
+
+    setTimeout(() => {
+      response.writeHead(200, { "Content-Type": "application/json" });
+      response.end(body);
+
+      numActiveRequests--;
+      numCompletedRequests++;
+
+      console.log(`${request.method} ${url.pathname} ${numBytesReceived} bytes (active ${numActiveRequests}, completed ${numCompletedRequests})`);
+    }, responseDelayMs);
+  });
+});
+
+server.listen(port, () => {
+  console.log(`Wit stand-in server listening on http://127.0.0.1:${port}`);
+});